@@ -0,0 +1,3 @@
+CREATE INDEX IF NOT EXISTS idx_effective_albumartist ON songs (effective_albumartist);
+
+UPDATE schema_version SET version=24;
@@ -4,7 +4,7 @@ CREATE TABLE IF NOT EXISTS schema_version (
 
 DELETE FROM schema_version;
 
-INSERT INTO schema_version (version) VALUES (23);
+INSERT INTO schema_version (version) VALUES (24);
 
 CREATE TABLE IF NOT EXISTS directories (
   path TEXT NOT NULL,
@@ -1155,6 +1155,8 @@ CREATE INDEX IF NOT EXISTS idx_comp_artist ON songs (compilation_effective, arti
 
 CREATE INDEX IF NOT EXISTS idx_albumartist ON songs (albumartist);
 
+CREATE INDEX IF NOT EXISTS idx_effective_albumartist ON songs (effective_albumartist);
+
 CREATE INDEX IF NOT EXISTS idx_albumartistsort ON songs (albumartistsort);
 
 CREATE INDEX IF NOT EXISTS idx_artist ON songs (artist);
@@ -21,6 +21,7 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <optional>
 #include <utility>
 
@@ -30,6 +31,7 @@
 #include <QThread>
 #include <QMutex>
 #include <QSet>
+#include <QHash>
 #include <QMap>
 #include <QList>
 #include <QVariant>
@@ -44,6 +46,7 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -59,12 +62,21 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// Each URL is bound in four encodings, this keeps a query below SQLite's default limit of 999 bound values.
+constexpr qint64 kUrlsPerQuery = 200;
+// The URL index is reloaded when this many rows were deleted, or a quarter of its size if that is more.
+constexpr qint64 kUrlIndexMaxRemoved = 1000;
+}  // namespace
+
 CollectionBackend::CollectionBackend(QObject *parent)
     : CollectionBackendInterface(parent),
       db_(nullptr),
       task_manager_(nullptr),
       source_(Song::Source::Unknown),
-      original_thread_(nullptr) {
+      original_thread_(nullptr),
+      url_index_loaded_(false),
+      url_index_removed_(0) {
 
   original_thread_ = thread();
 
@@ -250,6 +262,8 @@ void CollectionBackend::ChangeDirPath(const int id, const QString &old_path, con
 
   t.Commit();
 
+  ResetUrlIndex(false);
+
 }
 
 CollectionDirectoryList CollectionBackend::GetAllDirectories() {
@@ -637,6 +651,30 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
   CollectionTask task(task_manager_, tr("Updating %1 database.").arg(Song::TextForSource(source_)));
   ScopedTransaction transaction(&db);
 
+  // The statements are kept by the database between batches, so SQLite only parses them once per connection.
+  SqlQuery check_dir(db);
+  if (!dirs_table_.isEmpty()) {
+    check_dir.PrepareCached(db_.get(), QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
+  }
+
+  SqlQuery select_by_id(db);
+  select_by_id.PrepareCached(db_.get(), QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(songs_table_));
+
+  SqlQuery select_by_song_id(db);
+  select_by_song_id.PrepareCached(db_.get(), QStringLiteral("SELECT ROWID FROM %1 WHERE song_id = :song_id").arg(songs_table_));
+
+  SqlQuery select_by_url(db);
+  select_by_url.PrepareCached(db_.get(), QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND beginning = :beginning ORDER BY unavailable ASC LIMIT 1").arg(Song::kRowIdColumnSpec, songs_table_));
+
+  SqlQuery update(db);
+  update.PrepareCached(db_.get(), QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+
+  SqlQuery insert(db);
+  insert.PrepareCached(db_.get(), QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
+
+  // Songs are usually added a directory at a time, so remember which directories were already checked.
+  QHash<int, bool> directory_exists;
+
   SongList added_songs;
   SongList changed_songs;
 
@@ -645,34 +683,39 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
     // Do a sanity check first - make sure the song's directory still exists
     // This is to fix a possible race condition when a directory is removed while CollectionWatcher is scanning it.
     if (!dirs_table_.isEmpty()) {
-      SqlQuery check_dir(db);
-      check_dir.prepare(QStringLiteral("SELECT ROWID FROM %1 WHERE ROWID = :id").arg(dirs_table_));
-      check_dir.BindValue(u":id"_s, song.directory_id());
-      if (!check_dir.Exec()) {
-        db_->ReportErrors(check_dir);
-        return;
+      QHash<int, bool>::const_iterator it = directory_exists.constFind(song.directory_id());
+      if (it == directory_exists.constEnd()) {
+        check_dir.BindValue(u":id"_s, song.directory_id());
+        if (!check_dir.Exec()) {
+          db_->ReportErrors(check_dir);
+          return;
+        }
+        it = directory_exists.insert(song.directory_id(), check_dir.next());
+        check_dir.finish();
       }
 
-      if (!check_dir.next()) continue;
+      if (!it.value()) continue;
 
     }
 
     if (song.id() != -1) {  // This song exists in the DB.
 
-      // Get the previous song data first
-      Song old_song(GetSongById(song.id()));
-      if (!old_song.is_valid()) continue;
+      // Make sure it wasn't deleted in the meantime
+      select_by_id.BindValue(u":id"_s, song.id());
+      if (!select_by_id.Exec()) {
+        db_->ReportErrors(select_by_id);
+        return;
+      }
+      const bool exists = select_by_id.next();
+      select_by_id.finish();
+      if (!exists) continue;
 
       // Update
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-        song.BindToQuery(&q);
-        q.BindValue(u":id"_s, song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
+      song.BindToQuery(&update);
+      update.BindValue(u":id"_s, song.id());
+      if (!update.Exec()) {
+        db_->ReportErrors(update);
+        return;
       }
 
       changed_songs << song;
@@ -682,24 +725,26 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
     }
     else if (!song.song_id().isEmpty()) {  // Song has a unique id, check if the song exists.
 
-      // Get the previous song data first
-      Song old_song(GetSongBySongId(song.song_id()));
+      select_by_song_id.BindValue(u":song_id"_s, song.song_id());
+      if (!select_by_song_id.Exec()) {
+        db_->ReportErrors(select_by_song_id);
+        return;
+      }
+
+      const int existing_id = select_by_song_id.next() ? select_by_song_id.value(0).toInt() : -1;
+      select_by_song_id.finish();
 
-      if (old_song.is_valid() && old_song.id() != -1) {
+      if (existing_id != -1) {
 
         Song new_song = song;
-        new_song.set_id(old_song.id());
+        new_song.set_id(existing_id);
 
         // Update
-        {
-          SqlQuery q(db);
-          q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-          new_song.BindToQuery(&q);
-          q.BindValue(u":id"_s, new_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
+        new_song.BindToQuery(&update);
+        update.BindValue(u":id"_s, new_song.id());
+        if (!update.Exec()) {
+          db_->ReportErrors(update);
+          return;
         }
 
         changed_songs << new_song;
@@ -714,33 +759,28 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
       // and there is no UNIQUE(url) constraint to catch it.
       // Match by url and beginning (so distinct CUE tracks sharing one file are kept apart) and include unavailable rows, so a returning file restores its existing row instead of being duplicated.
       Song existing_song(source_);
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND beginning = :beginning ORDER BY unavailable ASC LIMIT 1").arg(Song::kRowIdColumnSpec, songs_table_));
-        q.BindValue(u":url1"_s, song.url().toString());
-        q.BindValue(u":url2"_s, song.url().toString(QUrl::FullyEncoded));
-        q.BindValue(u":url3"_s, song.url().toEncoded(QUrl::FullyDecoded));
-        q.BindValue(u":url4"_s, song.url().toEncoded(QUrl::FullyEncoded));
-        q.BindValue(u":beginning"_s, song.beginning_nanosec());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
-        if (q.next()) {
-          existing_song.InitFromQuery(q, true);
-        }
+      select_by_url.BindValue(u":url1"_s, song.url().toString());
+      select_by_url.BindValue(u":url2"_s, song.url().toString(QUrl::FullyEncoded));
+      select_by_url.BindValue(u":url3"_s, song.url().toEncoded(QUrl::FullyDecoded));
+      select_by_url.BindValue(u":url4"_s, song.url().toEncoded(QUrl::FullyEncoded));
+      select_by_url.BindValue(u":beginning"_s, song.beginning_nanosec());
+      if (!select_by_url.Exec()) {
+        db_->ReportErrors(select_by_url);
+        return;
+      }
+      if (select_by_url.next()) {
+        existing_song.InitFromQuery(select_by_url, true);
       }
+      select_by_url.finish();
       if (existing_song.is_valid() && existing_song.id() != -1) {
         Song new_song = song;
         new_song.set_id(existing_song.id());
         // Don't lose user data: a missed match means the incoming song carries freshly-read (zeroed) statistics.
         new_song.MergeUserSetData(existing_song, true, true);
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-        new_song.BindToQuery(&q);
-        q.BindValue(u":id"_s, new_song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
+        new_song.BindToQuery(&update);
+        update.BindValue(u":id"_s, new_song.id());
+        if (!update.Exec()) {
+          db_->ReportErrors(update);
           return;
         }
         changed_songs << new_song;
@@ -750,18 +790,14 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
 
     // Create new song
 
-    int id = -1;
-    {  // Insert the row and create a new ID
-      SqlQuery q(db);
-      q.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
-      song.BindToQuery(&q);
-      if (!q.Exec()) {
-        db_->ReportErrors(q);
-        return;
-      }
-      // Get the new ID
-      id = q.lastInsertId().toInt();
+    // Insert the row and create a new ID
+    song.BindToQuery(&insert);
+    if (!insert.Exec()) {
+      db_->ReportErrors(insert);
+      return;
     }
+    // Get the new ID
+    const int id = insert.lastInsertId().toInt();
 
     if (id == -1) return;
 
@@ -773,6 +809,9 @@ void CollectionBackend::AddOrUpdateSongs(const SongList &songs) {
 
   transaction.Commit();
 
+  AddToUrlIndex(added_songs);
+  AddToUrlIndex(changed_songs);
+
   if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
   if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
 
@@ -807,6 +846,15 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
     }
   }
 
+  SqlQuery update(db);
+  update.PrepareCached(db_.get(), QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
+
+  SqlQuery insert(db);
+  insert.PrepareCached(db_.get(), QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
+
+  SqlQuery delete_song(db);
+  delete_song.PrepareCached(db_.get(), QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
+
   // Add or update songs.
   const QList new_songs_list = new_songs.values();
   for (const Song &new_song : new_songs_list) {
@@ -817,15 +865,11 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
       if (!new_song.IsAllMetadataEqual(old_song) || !new_song.IsFingerprintEqual(old_song)) {  // Update existing song.
 
-        {
-          SqlQuery q(db);
-          q.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE ROWID = :id").arg(songs_table_, Song::kUpdateSpec));
-          new_song.BindToQuery(&q);
-          q.BindValue(u":id"_s, old_song.id());
-          if (!q.Exec()) {
-            db_->ReportErrors(q);
-            return;
-          }
+        new_song.BindToQuery(&update);
+        update.BindValue(u":id"_s, old_song.id());
+        if (!update.Exec()) {
+          db_->ReportErrors(update);
+          return;
         }
 
         Song new_song_copy(new_song);
@@ -836,18 +880,13 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
     }
     else {  // Add new song
-      int id = -1;
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES (%3)").arg(songs_table_, Song::kColumnSpec, Song::kBindSpec));
-        new_song.BindToQuery(&q);
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
-        // Get the new ID
-        id = q.lastInsertId().toInt();
+      new_song.BindToQuery(&insert);
+      if (!insert.Exec()) {
+        db_->ReportErrors(insert);
+        return;
       }
+      // Get the new ID
+      const int id = insert.lastInsertId().toInt();
 
       if (id == -1) return;
 
@@ -861,14 +900,10 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
   const QList old_songs_list = old_songs.values();
   for (const Song &old_song : old_songs_list) {
     if (!new_songs.contains(old_song.song_id())) {
-      {
-        SqlQuery q(db);
-        q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
-        q.BindValue(u":id"_s, old_song.id());
-        if (!q.Exec()) {
-          db_->ReportErrors(q);
-          return;
-        }
+      delete_song.BindValue(u":id"_s, old_song.id());
+      if (!delete_song.Exec()) {
+        db_->ReportErrors(delete_song);
+        return;
       }
       deleted_songs << old_song;
     }
@@ -876,6 +911,10 @@ void CollectionBackend::UpdateSongsBySongID(const SongMap &new_songs) {
 
   transaction.Commit();
 
+  RemoveFromUrlIndex(deleted_songs.count());
+  AddToUrlIndex(added_songs);
+  AddToUrlIndex(changed_songs);
+
   if (!deleted_songs.isEmpty()) Q_EMIT SongsDeleted(deleted_songs);
   if (!added_songs.isEmpty()) Q_EMIT SongsAdded(added_songs);
   if (!changed_songs.isEmpty()) Q_EMIT SongsChanged(changed_songs);
@@ -892,9 +931,9 @@ void CollectionBackend::UpdateMTimesOnly(const SongList &songs) {
   QSqlDatabase db(db_->Connect());
 
   ScopedTransaction transaction(&db);
+  SqlQuery q(db);
+  q.PrepareCached(db_.get(), QStringLiteral("UPDATE %1 SET mtime = :mtime WHERE ROWID = :id").arg(songs_table_));
   for (const Song &song : songs) {
-    SqlQuery q(db);
-    q.prepare(QStringLiteral("UPDATE %1 SET mtime = :mtime WHERE ROWID = :id").arg(songs_table_));
     q.BindValue(u":mtime"_s, song.mtime());
     q.BindValue(u":id"_s, song.id());
     if (!q.Exec()) {
@@ -916,9 +955,9 @@ void CollectionBackend::DeleteSongs(const SongList &songs) {
   QSqlDatabase db(db_->Connect());
 
   ScopedTransaction transaction(&db);
+  SqlQuery q(db);
+  q.PrepareCached(db_.get(), QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
   for (const Song &song : songs) {
-    SqlQuery q(db);
-    q.prepare(QStringLiteral("DELETE FROM %1 WHERE ROWID = :id").arg(songs_table_));
     q.BindValue(u":id"_s, song.id());
     if (!q.Exec()) {
       db_->ReportErrors(q);
@@ -928,6 +967,8 @@ void CollectionBackend::DeleteSongs(const SongList &songs) {
 
   transaction.Commit();
 
+  RemoveFromUrlIndex(songs.count());
+
   Q_EMIT SongsDeleted(songs);
 
   UpdateTotalSongCountAsync();
@@ -1336,6 +1377,125 @@ SongList CollectionBackend::GetSongsByUrl(const QUrl &url, const bool unavailabl
 }
 
 
+SongList CollectionBackend::GetSongsByUrls(const QList<QUrl> &urls) {
+
+  SongList songs;
+  if (urls.isEmpty()) return songs;
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  for (qint64 i = 0; i < urls.count(); i += kUrlsPerQuery) {
+    const QList<QUrl> urls_chunk = urls.mid(i, kUrlsPerQuery);
+
+    QStringList placeholders;
+    placeholders.reserve(urls_chunk.count() * 4);
+    for (qint64 j = 0; j < urls_chunk.count() * 4; ++j) {
+      placeholders << u":url"_s + QString::number(j);
+    }
+
+    SqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE url IN (%3) AND unavailable = 0").arg(Song::kRowIdColumnSpec, songs_table_, placeholders.join(u", "_s)));
+    for (qint64 j = 0; j < urls_chunk.count(); ++j) {
+      const QUrl &url = urls_chunk[j];
+      q.BindValue(placeholders[j * 4], url.toString());
+      q.BindValue(placeholders[j * 4 + 1], url.toString(QUrl::FullyEncoded));
+      q.BindValue(placeholders[j * 4 + 2], url.toEncoded(QUrl::FullyDecoded));
+      q.BindValue(placeholders[j * 4 + 3], url.toEncoded(QUrl::FullyEncoded));
+    }
+
+    if (!q.Exec()) {
+      db_->ReportErrors(q);
+      return SongList();
+    }
+    while (q.next()) {
+      Song song(source_);
+      song.InitFromQuery(q, true);
+      songs << song;
+    }
+  }
+
+  return songs;
+
+}
+
+bool CollectionBackend::MayContainUrl(const QUrl &url) {
+
+  const size_t key = qHash(UrlKey(url));
+
+  {
+    QMutexLocker l(&url_index_mutex_);
+    if (url_index_loaded_) return url_index_.contains(key);
+  }
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+  LoadUrlIndex(db);
+
+  QMutexLocker index_lock(&url_index_mutex_);
+  // Without an index the song has to be looked up.
+  return !url_index_loaded_ || url_index_.contains(key);
+
+}
+
+void CollectionBackend::LoadUrlIndex(QSqlDatabase &db) {
+
+  // The database mutex is locked before the index, like where songs are added, so no song added in between is missed.
+  QMutexLocker l(&url_index_mutex_);
+  if (url_index_loaded_) return;
+
+  SqlQuery q(db);
+  q.prepare(QStringLiteral("SELECT url FROM %1").arg(songs_table_));
+  if (!q.Exec()) {
+    db_->ReportErrors(q);
+    return;
+  }
+
+  url_index_.clear();
+  while (q.next()) {
+    url_index_.insert(qHash(UrlKey(QUrl::fromEncoded(q.value(0).toByteArray()))));
+  }
+  url_index_removed_ = 0;
+  url_index_loaded_ = true;
+
+  qLog(Debug) << "Loaded URL index of" << songs_table_ << "with" << url_index_.count() << "URLs";
+
+}
+
+void CollectionBackend::AddToUrlIndex(const SongList &songs) {
+
+  QMutexLocker l(&url_index_mutex_);
+  if (!url_index_loaded_) return;
+
+  for (const Song &song : songs) {
+    url_index_.insert(qHash(UrlKey(song.url())));
+  }
+
+}
+
+void CollectionBackend::RemoveFromUrlIndex(const qint64 count) {
+
+  QMutexLocker l(&url_index_mutex_);
+  if (!url_index_loaded_ || count <= 0) return;
+
+  // Removed URLs only cause false positives, but once there are many the index is reloaded on the next lookup.
+  url_index_removed_ += count;
+  if (url_index_removed_ > std::max(kUrlIndexMaxRemoved, static_cast<qint64>(url_index_.count() / 4))) {
+    url_index_.clear();
+    url_index_loaded_ = false;
+  }
+
+}
+
+void CollectionBackend::ResetUrlIndex(const bool loaded) {
+
+  QMutexLocker l(&url_index_mutex_);
+  url_index_.clear();
+  url_index_loaded_ = loaded;
+  url_index_removed_ = 0;
+
+}
+
 Song CollectionBackend::GetSongBySongId(const QString &song_id) {
 
   QMutexLocker l(db_->Mutex());
@@ -1451,107 +1611,46 @@ void CollectionBackend::CompilationsNeedUpdating() {
   QMutexLocker l(db_->Mutex());
   QSqlDatabase db(db_->Connect());
 
-  // Look for albums that have songs by more than one 'effective album artist' in the same directory
-
-  SqlQuery q(db);
-  q.prepare(QStringLiteral("SELECT effective_albumartist, album, url, compilation_detected FROM %1 WHERE unavailable = 0 ORDER BY album").arg(songs_table_));
-  if (!q.Exec()) {
-    db_->ReportErrors(q);
-    return;
-  }
-
-  QMap<QString, CompilationInfo> compilation_info;
-  while (q.next()) {
-    QString artist = q.value(0).toString();
-    QString album = q.value(1).toString();
-    QUrl url = QUrl::fromEncoded(q.value(2).toString().toUtf8());
-    bool compilation_detected = q.value(3).toBool();
-
-    // Ignore songs that don't have an album field set
-    if (album.isEmpty()) continue;
-
-    // Find the directory the song is in
-    QString directory = url.toString(QUrl::PreferLocalFile | QUrl::RemoveFilename);
-
-    CompilationInfo &info = compilation_info[directory + album];
-    info.urls << url;
-    if (!info.artists.contains(artist)) {
-      info.artists << artist;
-    }
-    if (compilation_detected) info.has_compilation_detected++;
-    else info.has_not_compilation_detected++;
-  }
-
-  // Now mark the songs that we think are in compilations
-  SongList changed_songs;
+  // Look for albums that have songs by more than one 'effective album artist' in the same directory.
+  // The directory is the song URL up to and including the last '/', grouping is done in a single pass,
+  // and only songs where the detected flag differs from the stored flag are selected.
+  const QString changed_ids = QStringLiteral("SELECT s.ROWID FROM %1 AS s "
+                                             "INNER JOIN (SELECT album, rtrim(url, replace(url, '/', '')) AS directory, COUNT(DISTINCT IFNULL(effective_albumartist, '')) > 1 AS detected FROM %1 WHERE unavailable = 0 AND album != '' GROUP BY album, directory) AS a "
+                                             "ON s.album = a.album AND rtrim(s.url, replace(s.url, '/', '')) = a.directory "
+                                             "WHERE s.unavailable = 0 AND IFNULL(s.compilation_detected, 0) != a.detected").arg(songs_table_);
 
   ScopedTransaction transaction(&db);
 
-  QMap<QString, CompilationInfo>::const_iterator it = compilation_info.constBegin();
-  for (; it != compilation_info.constEnd(); ++it) {
-    const CompilationInfo &info = it.value();
-
-    // If there were more than one 'effective album artist' for this album directory, then it's a compilation.
-
-    for (const QUrl &url : info.urls) {
-      if (info.artists.count() > 1) {  // This directory+album is a compilation.
-        if (info.has_not_compilation_detected > 0) {  // Run updates if any of the songs is not marked as compilations.
-          UpdateCompilations(db, changed_songs, url, true);
-        }
-      }
-      else {
-        if (info.has_compilation_detected > 0) {
-          UpdateCompilations(db, changed_songs, url, false);
-        }
-      }
-    }
-  }
-
-  transaction.Commit();
-
-  if (!changed_songs.isEmpty()) {
-    Q_EMIT SongsChanged(changed_songs);
-  }
-
-}
-
-bool CollectionBackend::UpdateCompilations(const QSqlDatabase &db, SongList &changed_songs, const QUrl &url, const bool compilation_detected) {
-
-  {  // Get song, so we can tell the model its updated
+  // Get the songs that will flip, so we can tell the model they are updated
+  SongList changed_songs;
+  {
     SqlQuery q(db);
-    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND unavailable = 0").arg(Song::kRowIdColumnSpec, songs_table_));
-    q.BindValue(u":url1"_s, url.toString());
-    q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-    q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-    q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
-    if (q.Exec()) {
-      while (q.next()) {
-        Song song(source_);
-        song.InitFromQuery(q, true);
-        song.set_compilation_detected(compilation_detected);
-        changed_songs << song;
-      }
-    }
-    else {
+    q.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE ROWID IN (%3)").arg(Song::kRowIdColumnSpec, songs_table_, changed_ids));
+    if (!q.Exec()) {
       db_->ReportErrors(q);
-      return false;
+      return;
+    }
+    while (q.next()) {
+      Song song(source_);
+      song.InitFromQuery(q, true);
+      song.set_compilation_detected(!song.compilation_detected());
+      changed_songs << song;
     }
   }
 
-  // Update the song
+  if (changed_songs.isEmpty()) return;
+
+  // SQLite evaluates all SET expressions against the old row, so compilation_effective sees the flipped flag through NOT compilation_detected.
   SqlQuery q(db);
-  q.prepare(QStringLiteral("UPDATE %1 SET compilation_detected = :compilation_detected, compilation_effective = ((compilation OR :compilation_detected OR compilation_on) AND NOT compilation_off) + 0 WHERE (url = :url1 OR url = :url2 OR url = :url3 OR url = :url4) AND unavailable = 0").arg(songs_table_));
-  q.BindValue(u":compilation_detected"_s, static_cast<int>(compilation_detected));
-  q.BindValue(u":url1"_s, url.toString());
-  q.BindValue(u":url2"_s, url.toString(QUrl::FullyEncoded));
-  q.BindValue(u":url3"_s, url.toEncoded(QUrl::FullyDecoded));
-  q.BindValue(u":url4"_s, url.toEncoded(QUrl::FullyEncoded));
+  q.prepare(QStringLiteral("UPDATE %1 SET compilation_detected = (NOT IFNULL(compilation_detected, 0)) + 0, compilation_effective = ((compilation OR NOT IFNULL(compilation_detected, 0) OR compilation_on) AND NOT compilation_off) + 0 WHERE ROWID IN (%2)").arg(songs_table_, changed_ids));
   if (!q.Exec()) {
     db_->ReportErrors(q);
-    return false;
+    return;
   }
 
-  return true;
+  transaction.Commit();
+
+  Q_EMIT SongsChanged(changed_songs);
 
 }
 
@@ -2020,6 +2119,8 @@ void CollectionBackend::DeleteAll() {
     }
 
     t.Commit();
+
+    ResetUrlIndex(true);
   }
 
   Q_EMIT DatabaseReset();
@@ -2052,6 +2153,31 @@ SongList CollectionBackend::ExecuteQuery(const QString &sql, const QVariantList
 
 }
 
+QList<QPair<int, double>> CollectionBackend::ExecuteIdQuery(const QString &sql, const QVariantList &bound_values) {
+
+  QMutexLocker l(db_->Mutex());
+  QSqlDatabase db(db_->Connect());
+
+  SqlQuery query(db);
+  query.prepare(sql);
+  for (const QVariant &v : bound_values) {
+    query.addBindValue(v);
+  }
+  if (!query.Exec()) {
+    db_->ReportErrors(query);
+    return QList<QPair<int, double>>();
+  }
+
+  QList<QPair<int, double>> ids;
+  const bool has_value = query.record().count() > 1;
+  while (query.next()) {
+    ids << qMakePair(query.value(0).toInt(), has_value ? query.value(1).toDouble() : 0.0);
+  }
+
+  return ids;
+
+}
+
 SongList CollectionBackend::GetSongsBy(const QString &artist, const QString &album, const QString &title) {
 
   QMutexLocker l(db_->Mutex());
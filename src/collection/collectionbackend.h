@@ -29,8 +29,11 @@
 
 #include <QtGlobal>
 #include <QObject>
+#include <QMutex>
 #include <QFileInfo>
 #include <QList>
+#include <QPair>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -132,6 +135,15 @@ class CollectionBackendInterface : public QObject {
   // Using default beginning value is suitable when searching for single-section songs.
   virtual Song GetSongByUrl(const QUrl &url, const qint64 beginning = 0) = 0;
   virtual Song GetSongByUrlAndTrack(const QUrl &url, const int track) = 0;
+  // Returns all songs with any of the given URLs, using a single query for the whole list.
+  virtual SongList GetSongsByUrls(const QList<QUrl> &urls) = 0;
+
+  // Answers from memory whether a song with the URL can be in the collection, false means it is definitely not.
+  // A true result can be a false positive, so it still has to be confirmed with one of the queries above.
+  virtual bool MayContainUrl(const QUrl &url) = 0;
+
+  // Canonical form of an URL, used to match songs to their collection entries.
+  static QString UrlKey(const QUrl &url) { return url.isLocalFile() ? url.toLocalFile() : url.toString(QUrl::FullyEncoded); }
 
   virtual void AddDirectoryAsync(const QString &path) = 0;
   virtual void RemoveDirectoryAsync(const CollectionDirectory &dir) = 0;
@@ -207,6 +219,9 @@ class CollectionBackend : public CollectionBackendInterface {
   SongList GetSongsByUrl(const QUrl &url, const bool unavailable = false) override;
   Song GetSongByUrl(const QUrl &url, qint64 beginning = 0) override;
   Song GetSongByUrlAndTrack(const QUrl &url, const int track) override;
+  SongList GetSongsByUrls(const QList<QUrl> &urls) override;
+
+  bool MayContainUrl(const QUrl &url) override;
 
   void AddDirectoryAsync(const QString &path) override;
   void RemoveDirectoryAsync(const CollectionDirectory &dir) override;
@@ -227,6 +242,8 @@ class CollectionBackend : public CollectionBackendInterface {
   SongList GetSongsByFingerprint(const QString &fingerprint) override;
 
   SongList ExecuteQuery(const QString &sql, const QVariantList &bound_values = QVariantList());
+  // Returns the ROWID from the first column of the query, and the second column as a number if the query has one.
+  QList<QPair<int, double>> ExecuteIdQuery(const QString &sql, const QVariantList &bound_values = QVariantList());
 
   void AddOrUpdateSongsAsync(const SongList &songs);
   void UpdateSongsBySongIDAsync(const SongMap &new_songs);
@@ -300,17 +317,6 @@ class CollectionBackend : public CollectionBackendInterface {
   void Error(const QString &error);
 
  private:
-  struct CompilationInfo {
-    CompilationInfo() : has_compilation_detected(0), has_not_compilation_detected(0) {}
-
-    QList<QUrl> urls;
-    QStringList artists;
-
-    int has_compilation_detected;
-    int has_not_compilation_detected;
-  };
-
-  bool UpdateCompilations(const QSqlDatabase &db, SongList &changed_songs, const QUrl &url, const bool compilation_detected);
   AlbumList GetAlbums(const QString &artist, const QString &album_artist, const bool compilation_required = false, const CollectionFilterOptions &opt = CollectionFilterOptions());
   AlbumList GetAlbums(const QString &artist, const bool compilation_required, const CollectionFilterOptions &opt = CollectionFilterOptions());
   CollectionSubdirectoryList SubdirsInDirectory(const int id, QSqlDatabase &db);
@@ -321,6 +327,12 @@ class CollectionBackend : public CollectionBackendInterface {
   Song GetSongBySongId(const QString &song_id, QSqlDatabase &db);
   SongList GetSongsBySongId(const QStringList &song_ids, QSqlDatabase &db);
 
+  // These are called with the database mutex locked.
+  void LoadUrlIndex(QSqlDatabase &db);
+  void AddToUrlIndex(const SongList &songs);
+  void RemoveFromUrlIndex(const qint64 count);
+  void ResetUrlIndex(const bool loaded);
+
  private:
   SharedPtr<Database> db_;
   SharedPtr<TaskManager> task_manager_;
@@ -329,6 +341,13 @@ class CollectionBackend : public CollectionBackendInterface {
   QString dirs_table_;
   QString subdirs_table_;
   QThread *original_thread_;
+
+  // Hashes of the URLs in the songs table. Rows are not removed from it one by one, because several songs can share an URL,
+  // instead it is reloaded once enough rows were deleted.
+  QMutex url_index_mutex_;
+  QSet<size_t> url_index_;
+  bool url_index_loaded_;
+  qint64 url_index_removed_;
 };
 
 #endif  // COLLECTIONBACKEND_H
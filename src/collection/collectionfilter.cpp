@@ -73,6 +73,11 @@ void CollectionFilter::SetFilterString(const QString &filter_string) {
   else {
     FilterParser p(filter_string);
     filter_tree_.reset(p.parse());
+    // Searching needs every song in the tree.
+    CollectionModel *model = qobject_cast<CollectionModel*>(sourceModel());
+    if (model && model->lazy_loading()) {
+      model->FetchChildren(model->IndexToItem(QModelIndex()));
+    }
   }
 
   setFilterFixedString(filter_string);
@@ -110,6 +115,16 @@ void CollectionFilter::GetChildSongs(CollectionItem *item, QSet<int> &song_ids,
 
   switch (item->type) {
     case CollectionItem::Type::Container:{
+      // The songs of a container not fetched yet are read from the database.
+      const SongList lazy_songs = collection_model->LazyContainerSongs(item);
+      for (const Song &song : lazy_songs) {
+        if (filter_tree_ && !filter_tree_->accept(song)) continue;
+        urls << song.url();
+        if (!song_ids.contains(song.id())) {
+          song_ids.insert(song.id());
+          songs << song;
+        }
+      }
       QList<CollectionItem*> children = item->children;
       std::sort(children.begin(), children.end(), std::bind(&CollectionModel::CompareItems, collection_model, std::placeholders::_1, std::placeholders::_2));
       for (CollectionItem *child : children) {
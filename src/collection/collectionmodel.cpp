@@ -99,6 +99,9 @@ CollectionModel::CollectionModel(const SharedPtr<CollectionBackend> backend, con
       total_album_count_(0),
       loading_(false),
       bulk_mode_(false),
+      lazy_fetches_(0),
+      lazy_fetching_all_(false),
+      lazy_generation_(0),
       icon_disk_cache_(new QNetworkDiskCache(this)) {
 
   setObjectName(backend_->source() == Song::Source::Collection ? QLatin1String(QObject::metaObject()->className()) : QStringLiteral("%1%2").arg(Song::DescriptionForSource(backend_->source()), QLatin1String(QObject::metaObject()->className())));
@@ -170,6 +173,9 @@ void CollectionModel::Clear() {
   container_nodes_[1].clear();
   container_nodes_[2].clear();
   divider_nodes_.clear();
+  lazy_containers_.clear();
+  lazy_fetching_all_ = false;
+  ++lazy_generation_;
   pending_art_.clear();
   pending_cache_keys_.clear();
 
@@ -202,7 +208,12 @@ void CollectionModel::ResetInternal() {
   loading->display_text = tr("Loading...");
   EndReset();
 
-  LoadSongsFromSqlAsync();
+  if (options_active_.lazy_loading && !LazyGroupColumns(options_active_.group_by[0]).isEmpty()) {
+    LoadContainersFromSqlAsync();
+  }
+  else {
+    LoadSongsFromSqlAsync();
+  }
 
 }
 
@@ -216,6 +227,7 @@ void CollectionModel::ReloadSettings() {
   const bool sort_skip_articles_for_artists = settings.value(CollectionSettings::kSkipArticlesForArtists, CollectionSettings::kDefaultSkipArticlesForArtists).toBool();
   const bool sort_skip_articles_for_albums = settings.value(CollectionSettings::kSkipArticlesForAlbums, CollectionSettings::kDefaultSkipArticlesForAlbums).toBool();
   const bool use_sort_tags = settings.value(CollectionSettings::kUseSortTags, CollectionSettings::kDefaultUseSortTags).toBool();
+  const bool lazy_loading = settings.value(CollectionSettings::kLazyLoading, CollectionSettings::kDefaultLazyLoading).toBool();
 
   use_disk_cache_ = settings.value(CollectionSettings::kSettingsDiskCacheEnable, CollectionSettings::kDefaultSettingsDiskCacheEnable).toBool();
   QPixmapCache::setCacheLimit(static_cast<int>(MaximumCacheSize(&settings, CollectionSettings::kSettingsCacheSize, CollectionSettings::kSettingsCacheSizeUnit, CollectionSettings::kSettingsCacheSizeDefault) / 1024));
@@ -232,13 +244,15 @@ void CollectionModel::ReloadSettings() {
       show_various_artists != options_current_.show_various_artists ||
       sort_skip_articles_for_artists != options_current_.sort_skip_articles_for_artists ||
       sort_skip_articles_for_albums != options_current_.sort_skip_articles_for_albums ||
-      use_sort_tags != options_current_.use_sort_tags) {
+      use_sort_tags != options_current_.use_sort_tags ||
+      lazy_loading != options_current_.lazy_loading) {
     options_current_.show_pretty_covers = show_pretty_covers;
     options_current_.show_dividers = show_dividers;
     options_current_.show_various_artists = show_various_artists;
     options_current_.sort_skip_articles_for_artists = sort_skip_articles_for_artists;
     options_current_.sort_skip_articles_for_albums = sort_skip_articles_for_albums;
     options_current_.use_sort_tags = use_sort_tags;
+    options_current_.lazy_loading = lazy_loading;
     ScheduleReset();
   }
 
@@ -288,6 +302,37 @@ void CollectionModel::SetFilterMinRating(const float filter_min_rating) {
 
 }
 
+void CollectionModel::SetLazyLoading(const bool lazy_loading) {
+
+  if (options_current_.lazy_loading != lazy_loading) {
+    options_current_.lazy_loading = lazy_loading;
+    ScheduleReset();
+  }
+
+}
+
+bool CollectionModel::hasChildren(const QModelIndex &parent) const {
+
+  if (lazy_containers_.contains(IndexToItem(parent))) return true;
+
+  return SimpleTreeModel<CollectionItem>::hasChildren(parent);
+
+}
+
+bool CollectionModel::canFetchMore(const QModelIndex &parent) const {
+
+  CollectionItem *item = IndexToItem(parent);
+
+  return lazy_containers_.contains(item) && !lazy_containers_.value(item).fetching && !lazy_fetching_all_;
+
+}
+
+void CollectionModel::fetchMore(const QModelIndex &parent) {
+
+  FetchChildren(IndexToItem(parent));
+
+}
+
 QVariant CollectionModel::data(const QModelIndex &idx, const int role) const {
 
   return data(IndexToItem(idx), role);
@@ -459,7 +504,7 @@ void CollectionModel::ScheduleRemoveSongs(const SongList &songs) {
 
 void CollectionModel::ProcessUpdate() {
 
-  if (loading_ || updates_.isEmpty()) {
+  if (loading_ || lazy_fetches_ > 0 || updates_.isEmpty()) {
     timer_update_->stop();
     return;
   }
@@ -670,10 +715,8 @@ void CollectionModel::AddSongsInternal(const SongList &songs) {
     // Sanity check to make sure we don't add songs that are outside the user's filter
     if (!options_active_.filter_options.Matches(song)) continue;
 
-    if (song_nodes_.contains(song.id())) {
-      qLog(Debug) << song.id() << song.title() << "already exists, skipping";
-      continue;
-    }
+    // Already added, by a fetch of a lazy container or an update.
+    if (song_nodes_.contains(song.id())) continue;
 
     // Before we can add each song we need to make sure the required container items already exist in the tree.
     // These depend on which "group by" settings the user has on the collection.
@@ -802,7 +845,8 @@ void CollectionModel::RemoveSongsInternal(const SongList &songs) {
     const QSet<CollectionItem*> parents_copy = parents;
     for (CollectionItem *node : parents_copy) {
       parents.remove(node);
-      if (node->children.count() != 0) continue;
+      // Containers that are not fetched yet still have songs in the database.
+      if (node->children.count() != 0 || lazy_containers_.contains(node)) continue;
 
       // Consider its parent for the next round
       if (node->parent != root_) parents << node->parent;
@@ -1024,6 +1068,279 @@ void CollectionModel::LoadSongsFromSqlAsyncFinished() {
 
 }
 
+QStringList CollectionModel::LazyGroupColumns(const GroupBy group_by) {
+
+  // The columns ContainerKey() depends on for the group by, songs with equal values for these always end up in the same container.
+
+  switch (group_by) {
+    case GroupBy::AlbumArtist:
+      return QStringList() << u"effective_albumartist"_s << u"compilation_effective"_s;
+    case GroupBy::Artist:
+      return QStringList() << u"artist"_s << u"compilation_effective"_s;
+    case GroupBy::Album:
+    case GroupBy::AlbumDisc:
+    case GroupBy::YearAlbum:
+    case GroupBy::YearAlbumDisc:
+    case GroupBy::OriginalYearAlbum:
+    case GroupBy::OriginalYearAlbumDisc:
+      return QStringList() << u"effective_albumartist"_s << u"album"_s << u"album_id"_s << u"grouping"_s << u"disc"_s << u"year"_s << u"originalyear"_s << u"compilation_effective"_s;
+    case GroupBy::Disc:
+      return QStringList() << u"disc"_s;
+    case GroupBy::Year:
+      return QStringList() << u"year"_s;
+    case GroupBy::OriginalYear:
+      return QStringList() << u"year"_s << u"originalyear"_s;
+    case GroupBy::Genre:
+      return QStringList() << u"genre"_s;
+    case GroupBy::Composer:
+      return QStringList() << u"composer"_s;
+    case GroupBy::Performer:
+      return QStringList() << u"performer"_s;
+    case GroupBy::Grouping:
+      return QStringList() << u"grouping"_s;
+    case GroupBy::FileType:
+      return QStringList() << u"filetype"_s;
+    case GroupBy::Format:
+      return QStringList() << u"filetype"_s << u"samplerate"_s << u"bitdepth"_s;
+    case GroupBy::Samplerate:
+      return QStringList() << u"samplerate"_s;
+    case GroupBy::Bitdepth:
+      return QStringList() << u"bitdepth"_s;
+    case GroupBy::Bitrate:
+      return QStringList() << u"bitrate"_s;
+    case GroupBy::None:
+    case GroupBy::GroupByCount:
+      break;
+  }
+
+  return QStringList();
+
+}
+
+void CollectionModel::LoadContainersFromSqlAsync() {
+
+  QFuture<LazyContainerRows> future = QtConcurrent::run(&CollectionModel::LoadContainersFromSql, this, options_active_.filter_options, LazyGroupColumns(options_active_.group_by[0]));
+  QFutureWatcher<LazyContainerRows> *watcher = new QFutureWatcher<LazyContainerRows>(this);
+  QObject::connect(watcher, &QFutureWatcher<LazyContainerRows>::finished, this, &CollectionModel::LoadContainersFromSqlAsyncFinished);
+  watcher->setFuture(future);
+
+}
+
+CollectionModel::LazyContainerRows CollectionModel::LoadContainersFromSql(const CollectionFilterOptions &filter_options, const QStringList &group_columns) {
+
+  LazyContainerRows rows;
+
+  {
+    QMutexLocker l(backend_->db()->Mutex());
+    QSqlDatabase db(backend_->db()->Connect());
+    CollectionQuery q(db, backend_->songs_table(), filter_options);
+    // SQLite takes the bare columns from the row with MIN(ROWID), so every group returns one complete song to create the container from.
+    q.SetColumnSpec(u"MIN(%songs_table.ROWID), "_s + Song::kColumnSpec + u", "_s + group_columns.join(", "_L1));
+    q.SetGroupBy(group_columns.join(", "_L1));
+    if (q.Exec()) {
+      const int group_columns_offset = static_cast<int>(Song::kRowIdColumns.count());
+      while (q.Next()) {
+        LazyContainerRow row;
+        row.song.InitFromQuery(q, true);
+        for (int i = 0; i < group_columns.count(); ++i) {
+          row.group_values << q.Value(group_columns_offset + i);
+        }
+        rows << row;
+      }
+    }
+    else {
+      backend_->ReportErrors(q);
+    }
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != backend_->thread()) {
+    backend_->db()->Close();
+  }
+
+  return rows;
+
+}
+
+void CollectionModel::LoadContainersFromSqlAsyncFinished() {
+
+  QFutureWatcher<LazyContainerRows> *watcher = static_cast<QFutureWatcher<LazyContainerRows>*>(sender());
+  const LazyContainerRows rows = watcher->result();
+  watcher->deleteLater();
+
+  BeginReset();
+  {
+    ScopedFlag bulk(bulk_mode_);
+    AddLazyContainers(rows);
+  }
+  EndReset();
+
+  loading_ = false;
+
+  // An active search needs every song in the tree.
+  if (!filter_->filterRegularExpression().pattern().isEmpty()) {
+    FetchChildren(root_);
+  }
+
+  if (!updates_.isEmpty() && !timer_update_->isActive()) {
+    timer_update_->start();
+  }
+
+}
+
+void CollectionModel::AddLazyContainers(const LazyContainerRows &rows) {
+
+  const GroupBy group_by = options_active_.group_by[0];
+
+  for (const LazyContainerRow &row : rows) {
+    const Song &song = row.song;
+    CollectionItem *container = nullptr;
+    if (options_active_.show_various_artists && IsArtistGroupBy(group_by) && song.is_compilation()) {
+      if (root_->compilation_artist_node_ == nullptr) {
+        CreateCompilationArtistNode(root_);
+      }
+      container = root_->compilation_artist_node_;
+    }
+    else {
+      bool has_unique_album_identifier = false;
+      const QString container_key = ContainerKey(group_by, song, has_unique_album_identifier);
+      container = container_nodes_[0].value(container_key);
+      if (!container) {
+        container = CreateContainerItem(group_by, 0, container_key, song, root_);
+      }
+    }
+
+    LazyContainer &lazy_container = lazy_containers_[container];
+    if (!lazy_container.song.is_valid()) {
+      lazy_container.song = song;
+    }
+    if (container == root_->compilation_artist_node_) {
+      lazy_container.compilation = true;
+    }
+    else {
+      lazy_container.group_values << row.group_values;
+    }
+  }
+
+}
+
+SongList CollectionModel::LoadLazyContainerSongs(const LazyContainer &lazy_container, const CollectionFilterOptions &filter_options, const QStringList &group_columns, const QString &order_by) const {
+
+  SongList songs;
+
+  if (!lazy_container.compilation && lazy_container.group_values.isEmpty()) return songs;
+
+  {
+    QMutexLocker l(backend_->db()->Mutex());
+    QSqlDatabase db(backend_->db()->Connect());
+    CollectionQuery q(db, backend_->songs_table(), filter_options);
+    q.SetColumnSpec(u"%songs_table.ROWID, "_s + Song::kColumnSpec);
+    if (lazy_container.compilation) {
+      q.AddCompilationRequirement(true);
+    }
+    else {
+      // IS instead of = so NULL values match, SQLite can still use the index for it.
+      QStringList group_clauses;
+      QVariantList values;
+      for (const QVariantList &group_values : lazy_container.group_values) {
+        QStringList column_clauses;
+        for (int i = 0; i < group_columns.count() && i < group_values.count(); ++i) {
+          column_clauses << group_columns[i] + " IS ?"_L1;
+          values << group_values[i];
+        }
+        group_clauses << u'(' + column_clauses.join(" AND "_L1) + u')';
+      }
+      q.AddWhereClause(u'(' + group_clauses.join(" OR "_L1) + u')', values);
+    }
+    if (!order_by.isEmpty()) {
+      q.SetOrderBy(order_by);
+    }
+
+    if (q.Exec()) {
+      while (q.Next()) {
+        Song song;
+        song.InitFromQuery(q, true);
+        songs << song;
+      }
+    }
+    else {
+      backend_->ReportErrors(q);
+    }
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != backend_->thread()) {
+    backend_->db()->Close();
+  }
+
+  return songs;
+
+}
+
+SongList CollectionModel::LazyContainerSongs(CollectionItem *item) const {
+
+  if (!lazy_containers_.contains(item)) return SongList();
+
+  return LoadLazyContainerSongs(lazy_containers_.value(item), options_active_.filter_options, LazyGroupColumns(options_active_.group_by[0]), u"album, disc, track, title"_s);
+
+}
+
+void CollectionModel::FetchChildren(CollectionItem *item) {
+
+  if (!item || lazy_containers_.isEmpty() || lazy_fetching_all_) return;
+
+  QFuture<SongList> future;
+  if (item == root_) {
+    // One query for everything is cheaper than one query per container.
+    lazy_fetching_all_ = true;
+    future = QtConcurrent::run(&CollectionModel::LoadSongsFromSql, this, options_active_.filter_options);
+  }
+  else {
+    if (!lazy_containers_.contains(item)) return;
+    LazyContainer &lazy_container = lazy_containers_[item];
+    if (lazy_container.fetching) return;
+    lazy_container.fetching = true;
+    future = QtConcurrent::run(&CollectionModel::LoadLazyContainerSongs, this, lazy_container, options_active_.filter_options, LazyGroupColumns(options_active_.group_by[0]), QString());
+  }
+
+  ++lazy_fetches_;
+  const quint64 generation = lazy_generation_;
+  QFutureWatcher<SongList> *watcher = new QFutureWatcher<SongList>(this);
+  QObject::connect(watcher, &QFutureWatcher<SongList>::finished, this, [this, watcher, item, generation]() {
+    const SongList songs = watcher->result();
+    watcher->deleteLater();
+    LazySongsLoaded(item, generation, songs);
+  });
+  watcher->setFuture(future);
+
+}
+
+void CollectionModel::LazySongsLoaded(CollectionItem *item, const quint64 generation, const SongList &songs) {
+
+  --lazy_fetches_;
+
+  // Fetches from before a reset are dropped, item is gone.
+  if (generation == lazy_generation_) {
+    if (item == root_) {
+      lazy_fetching_all_ = false;
+      lazy_containers_.clear();
+    }
+    else {
+      lazy_containers_.remove(item);
+    }
+
+    // The songs are added ahead of the updates queued while fetching, those are newer.
+    // Songs that are already in the model, from an update or an earlier fetch, are skipped when they are added.
+    for (qint64 i = songs.count(); i > 0; i -= 400LL) {
+      const qint64 first = std::max(0LL, i - 400LL);
+      updates_.prepend(CollectionModelUpdate(CollectionModelUpdate::Type::Add, songs.mid(first, i - first)));
+    }
+  }
+
+  if (!updates_.isEmpty() && !timer_update_->isActive()) {
+    timer_update_->start();
+  }
+
+}
+
 QString CollectionModel::AlbumIconPixmapCacheKey(const CollectionItem *item) const {
 
   return Song::TextForSource(backend_->source()) + QLatin1Char('/') + item->container_key;
@@ -1088,7 +1405,8 @@ QVariant CollectionModel::AlbumIcon(CollectionItem *item) {
   }
 
   // No art is cached and we're not loading it already.  Load art for the first song in the album.
-  const SongList songs = GetChildSongs(item);
+  // Don't fetch unloaded containers from here, this is called while painting.
+  const SongList songs = lazy_containers_.contains(item) ? SongList() << lazy_containers_.value(item).song : GetChildSongs(item);
   if (!songs.isEmpty()) {
     AlbumCoverLoaderOptions cover_loader_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
     cover_loader_options.desired_scaled_size = QSize(kPrettyCoverSize, kPrettyCoverSize);
@@ -1631,6 +1949,15 @@ void CollectionModel::GetChildSongs(CollectionItem *item, SongList &songs, QSet<
 
   switch (item->type) {
     case CollectionItem::Type::Container: {
+      // The songs of a container not fetched yet are read from the database, only songs added by updates are in the model.
+      const SongList lazy_songs = LazyContainerSongs(item);
+      for (const Song &song : lazy_songs) {
+        urls << song.url();
+        if (!song_ids.contains(song.id())) {
+          songs << song;
+          song_ids << song.id();
+        }
+      }
       QList<CollectionItem*> children = item->children;
       std::sort(children.begin(), children.end(), std::bind(&CollectionModel::CompareItems, this, std::placeholders::_1, std::placeholders::_2));
       for (CollectionItem *child : children) {
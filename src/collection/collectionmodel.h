@@ -34,6 +34,7 @@
 #include <QSet>
 #include <QList>
 #include <QMap>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -131,7 +132,8 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
                 sort_skip_articles_for_artists(false),
                 sort_skip_articles_for_albums(false),
                 use_sort_tags(true),
-                separate_albums_by_grouping(false) {}
+                separate_albums_by_grouping(false),
+                lazy_loading(false) {}
 
     Grouping group_by;
     bool show_dividers;
@@ -141,6 +143,7 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
     bool sort_skip_articles_for_albums;
     bool use_sort_tags;
     bool separate_albums_by_grouping;
+    bool lazy_loading;
     CollectionFilterOptions filter_options;
   };
 
@@ -171,8 +174,20 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   const QMap<QString, CollectionItem*> &container_nodes(const int i) const { return container_nodes_[i]; }
   QList<CollectionItem*> song_nodes() const { return song_nodes_.values(); }
 
+  // Lazy loading only creates the first level containers on reset, their children are fetched from the database when expanded.
+  bool lazy_loading() const { return options_active_.lazy_loading; }
+  void SetLazyLoading(const bool lazy_loading);
+
+  // Fetches the children of item in the background if they have not been loaded yet, the root item fetches everything.
+  void FetchChildren(CollectionItem *item);
+  // The songs of a container that has not fetched its children yet, read from the database without adding them to the model.
+  SongList LazyContainerSongs(CollectionItem *item) const;
+
   // QAbstractItemModel
   QVariant data(const QModelIndex &idx, const int role = Qt::DisplayRole) const override;
+  bool hasChildren(const QModelIndex &parent) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
   Qt::ItemFlags flags(const QModelIndex &idx) const override;
   QStringList mimeTypes() const override;
   QMimeData *mimeData(const QModelIndexList &indexes) const override;
@@ -265,6 +280,28 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   void LoadSongsFromSqlAsync();
   SongList LoadSongsFromSql(const CollectionFilterOptions &filter_options = CollectionFilterOptions());
 
+  // A first level container that has not fetched its children yet.
+  // The songs belonging to it are the ones matching any of the group values, or all compilations for the various artists node.
+  struct LazyContainer {
+    LazyContainer() : compilation(false), fetching(false) {}
+    Song song;
+    bool compilation;
+    bool fetching;
+    QList<QVariantList> group_values;
+  };
+  struct LazyContainerRow {
+    Song song;
+    QVariantList group_values;
+  };
+  using LazyContainerRows = QList<LazyContainerRow>;
+
+  static QStringList LazyGroupColumns(const GroupBy group_by);
+  void LoadContainersFromSqlAsync();
+  LazyContainerRows LoadContainersFromSql(const CollectionFilterOptions &filter_options, const QStringList &group_columns);
+  SongList LoadLazyContainerSongs(const LazyContainer &lazy_container, const CollectionFilterOptions &filter_options, const QStringList &group_columns, const QString &order_by = QString()) const;
+  void AddLazyContainers(const LazyContainerRows &rows);
+  void LazySongsLoaded(CollectionItem *item, const quint64 generation, const SongList &songs);
+
   static QString DividerKey(const GroupBy group_by, const Song &song, const QString &sort_text);
   static QString DividerDisplayText(const GroupBy group_by, const QString &key);
 
@@ -281,6 +318,7 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   void ScheduleReset();
   void ProcessUpdate();
   void LoadSongsFromSqlAsyncFinished();
+  void LoadContainersFromSqlAsyncFinished();
   void AlbumCoverLoaded(const quint64 id, const AlbumCoverLoaderResult &result);
 
   // From CollectionBackend
@@ -322,6 +360,14 @@ class CollectionModel : public SimpleTreeModel<CollectionItem> {
   // Keyed on a letter, a year, a century, etc.
   QMap<QString, CollectionItem*> divider_nodes_;
 
+  // First level containers with children not fetched yet
+  QHash<CollectionItem*, LazyContainer> lazy_containers_;
+  // Fetches running in the background, updates wait for them so they are applied on top of the fetched songs.
+  int lazy_fetches_;
+  bool lazy_fetching_all_;
+  // Changed by every reset, so fetches finishing after a reset are dropped.
+  quint64 lazy_generation_;
+
   using ItemAndCacheKey = QPair<CollectionItem*, QString>;
   QMap<quint64, ItemAndCacheKey> pending_art_;
   QSet<QString> pending_cache_keys_;
@@ -92,6 +92,13 @@ void CollectionQuery::AddWhere(const QString &column, const QVariant &value, con
 
 }
 
+void CollectionQuery::AddWhereClause(const QString &where_clause, const QVariantList &values) {
+
+  where_clauses_ << where_clause;
+  bound_values_ << values;
+
+}
+
 void CollectionQuery::AddCompilationRequirement(const bool compilation) {
   // The unary + is added to prevent sqlite from using the index idx_comp_artist.
   where_clauses_ << QStringLiteral("+compilation_effective = %1").arg(compilation ? 1 : 0);
@@ -118,6 +125,8 @@ bool CollectionQuery::Exec() {
 
   if (!where_clauses.isEmpty()) sql += " WHERE "_L1 + where_clauses.join(" AND "_L1);
 
+  if (!group_by_.isEmpty()) sql += " GROUP BY "_L1 + group_by_;
+
   if (!order_by_.isEmpty()) sql += " ORDER BY "_L1 + order_by_;
 
   if (limit_ != -1) sql += " LIMIT "_L1 + QString::number(limit_);
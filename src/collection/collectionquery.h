@@ -47,6 +47,7 @@ class CollectionQuery : public SqlQuery {
 
   QString column_spec() const { return column_spec_; }
   QString order_by() const { return order_by_; }
+  QString group_by() const { return group_by_; }
   QStringList where_clauses() const { return where_clauses_; }
   QVariantList bound_values() const { return bound_values_; }
   bool include_unavailable() const { return include_unavailable_; }
@@ -59,12 +60,18 @@ class CollectionQuery : public SqlQuery {
   // Sets an ORDER BY clause on the query.
   void SetOrderBy(const QString &order_by) { order_by_ = order_by; }
 
+  // Sets a GROUP BY clause on the query.
+  void SetGroupBy(const QString &group_by) { group_by_ = group_by; }
+
   void SetWhereClauses(const QStringList &where_clauses) { where_clauses_ = where_clauses; }
 
   // Adds a fragment of WHERE clause. When executed, this Query will connect all the fragments with AND operator.
   // Please note that IN operator expects a QStringList as value.
   void AddWhere(const QString &column, const QVariant &value, const QString &op = QStringLiteral("="));
 
+  // Adds a complete WHERE clause fragment, with one positional '?' placeholder per value.
+  void AddWhereClause(const QString &where_clause, const QVariantList &values = QVariantList());
+
   void SetBoundValues(const QVariantList &bound_values) { bound_values_ = bound_values; }
   void SetDuplicatesOnly(const bool duplicates_only) { duplicates_only_ = duplicates_only; }
   void SetIncludeUnavailable(const bool include_unavailable) { include_unavailable_ = include_unavailable; }
@@ -79,6 +86,7 @@ class CollectionQuery : public SqlQuery {
 
   QString column_spec_;
   QString order_by_;
+  QString group_by_;
   QStringList where_clauses_;
   QVariantList bound_values_;
 
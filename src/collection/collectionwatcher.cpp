@@ -47,6 +47,7 @@
 #include <QSettings>
 
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/taskmanager.h"
 #include "core/settings.h"
 #include "utilities/imageutils.h"
@@ -69,7 +70,8 @@
 #endif
 
 #ifdef HAVE_SONGTRACKING
-#  include "engine/chromaprinter.h"
+#  include <QFuture>
+#  include "engine/fingerprintservice.h"
 #endif
 #ifdef HAVE_EBUR128
 #  include "engine/ebur128analysis.h"
@@ -83,6 +85,12 @@
 using namespace std::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// Wait for the filesystem to be quiet this long before processing file events, but never hold them back longer than the maximum.
+constexpr auto kFileEventsDelay = 1s;
+constexpr qint64 kFileEventsMaxDelayMsec = 10000;
+}  // namespace
+
 QStringList CollectionWatcher::sValidImages = QStringList() << u"jpg"_s << u"jpeg"_s << u"jp2"_s << u"png"_s << u"gif"_s << u"tiff"_s << u"tif"_s << u"webp"_s;
 
 CollectionWatcher::CollectionWatcher(const Song::Source source,
@@ -116,6 +124,8 @@ CollectionWatcher::CollectionWatcher(const Song::Source source,
       rescan_timer_(new QTimer(this)),
       periodic_scan_timer_(new QTimer(this)),
       rescan_paused_(false),
+      file_events_timer_(new QTimer(this)),
+      file_events_started_(0),
       total_watches_(0),
       cue_parser_(new CueParser(tagreader_client, backend, this)),
       last_scan_time_(0) {
@@ -127,6 +137,9 @@ CollectionWatcher::CollectionWatcher(const Song::Source source,
   rescan_timer_->setInterval(2s);
   rescan_timer_->setSingleShot(true);
 
+  file_events_timer_->setInterval(kFileEventsDelay);
+  file_events_timer_->setSingleShot(true);
+
   periodic_scan_timer_->setInterval(86400 * kMsecPerSec);
   periodic_scan_timer_->setSingleShot(false);
 
@@ -140,7 +153,12 @@ CollectionWatcher::CollectionWatcher(const Song::Source source,
   ReloadSettings();
 
   QObject::connect(fs_watcher_, &FileSystemWatcherInterface::PathChanged, this, &CollectionWatcher::DirectoryChanged, Qt::UniqueConnection);
+  QObject::connect(fs_watcher_, &FileSystemWatcherInterface::FileChanged, this, &CollectionWatcher::FileChanged);
+  QObject::connect(fs_watcher_, &FileSystemWatcherInterface::FileRemoved, this, &CollectionWatcher::FileRemoved);
+  QObject::connect(fs_watcher_, &FileSystemWatcherInterface::FileMoved, this, &CollectionWatcher::FileMoved);
+  QObject::connect(fs_watcher_, &FileSystemWatcherInterface::Overflow, this, &CollectionWatcher::WatcherOverflow);
   QObject::connect(rescan_timer_, &QTimer::timeout, this, &CollectionWatcher::RescanPathsNow);
+  QObject::connect(file_events_timer_, &QTimer::timeout, this, &CollectionWatcher::ProcessFileEvents);
   QObject::connect(periodic_scan_timer_, &QTimer::timeout, this, &CollectionWatcher::IncrementalScanCheck);
 
 }
@@ -557,6 +575,8 @@ void CollectionWatcher::AddDirectory(const CollectionDirectory &dir, const Colle
 
 void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const QString &path, const CollectionSubdirectory &subdir, const quint64 files_count, ScanTransaction *t, const bool force_noincremental) {
 
+  TRACE_SCOPE("collection", "Scan subdirectory");
+
   // A renamed directory can be reached both from its own queued change notification and from its parent's vanished-child check below, so skip it if it was already scanned in this transaction to avoid deleting/adding its songs twice.
   if (t->HasScannedPath(path)) {
     t->AddToProgress(files_count);
@@ -674,227 +694,289 @@ void CollectionWatcher::ScanSubdirectory(const CollectionDirectory &dir, const Q
 
   QSet<QString> cues_processed;
 
+#ifdef HAVE_SONGTRACKING
+  if (song_tracking_) {
+    QueueFingerprints(files_on_disk, songs_in_db, t);
+  }
+#endif
+
   // Now compare the list from the database with the list of files on disk
   const QStringList files_on_disk_copy = files_on_disk;
   for (const QString &file : files_on_disk_copy) {
+    if (stop_or_abort_requested()) break;
+    if (!ScanFile(file, path, songs_in_db, album_art, &cues_processed, t)) {
+      files_on_disk.removeAll(file);
+    }
+  }
 
+#ifdef HAVE_SONGTRACKING
+  // Fingerprints for files that turned out not to need one.
+  CancelFingerprints();
+#endif
+
+  if (stop_or_abort_requested()) return;
+
+  // Look for deleted songs.
+  // files_on_disk holds the on-disk path spelling while the database stores its own; the two can differ purely by Unicode normalization form (NFC vs NFD).
+  // Compare in NFC so a song that was just matched (FindSongsByPath normalizes too) is not also treated as deleted within the same scan.
+  QSet<QString> files_on_disk_nfc;
+  files_on_disk_nfc.reserve(files_on_disk.count());
+  for (const QString &file : std::as_const(files_on_disk)) {
+    files_on_disk_nfc.insert(file.normalized(QString::NormalizationForm_C));
+  }
+  for (const Song &song : std::as_const(songs_in_db)) {
+    const QString file = song.url().toLocalFile();
+    if (!song.unavailable() && !files_on_disk_nfc.contains(file.normalized(QString::NormalizationForm_C)) && !t->files_changed_path_.contains(file)) {
+      qLog(Debug) << "Song deleted from disk:" << file;
+      t->deleted_songs << song;
+    }
+  }
+
+  // Add, update or delete subdir
+  CollectionSubdirectory updated_subdir;
+  updated_subdir.directory_id = t->dir_id();
+  updated_subdir.mtime = path_mtime;
+  updated_subdir.path = path;
+
+  if (!path_info.exists() && updated_subdir.path != dir.path) {
+    t->deleted_subdirs << updated_subdir;
+  }
+  else if (subdir.directory_id == -1) {
+    t->new_subdirs << updated_subdir;
+  }
+  else if (subdir.mtime != updated_subdir.mtime) {
+    t->touched_subdirs << updated_subdir;
+  }
+
+  // Recurse into the new subdirs that we found
+  for (const CollectionSubdirectory &my_new_subdir : std::as_const(my_new_subdirs)) {
     if (stop_or_abort_requested()) return;
+    ScanSubdirectory(dir, my_new_subdir.path, my_new_subdir, 0, t, true);
+  }
 
-    // Associated CUE
-    const QString new_cue = CueParser::FindCueFilename(file);
+}
 
-    SongList matching_songs;
-    if (FindSongsByPath(songs_in_db, file, &matching_songs)) {  // Found matching song in DB by path.
+#ifdef HAVE_SONGTRACKING
 
-      const Song matching_song = matching_songs.first();
+void CollectionWatcher::QueueFingerprints(const QStringList &files, const SongList &songs_in_db, ScanTransaction *t) {
 
-      // The song is in the database and still on disk.
-      // Check the mtime to see if it's been changed since it was added.
+  for (const QString &file : files) {
+    if (fingerprint_futures_.contains(file)) continue;
+    SongList matching_songs;
+    if (FindSongsByPath(songs_in_db, file, &matching_songs)) {
+      // Same checks as ScanFile(), without the CUE sheet and album art changes, those files are fingerprinted when they are scanned.
+      const Song &matching_song = matching_songs.first();
       const QFileInfo fileinfo(file);
-
-      if (!fileinfo.exists()) {
-        // Partially fixes race condition - if file was removed between being added to the list and now.
-        files_on_disk.removeAll(file);
-        t->AddToProgress(1);
+      if (!t->ignores_mtime() && !matching_song.fingerprint().isEmpty() && (matching_song.has_cue() || matching_song.mtime() == fileinfo.lastModified().toSecsSinceEpoch())) {
         continue;
       }
+    }
+    fingerprint_futures_.insert(file, FingerprintService::Instance()->Fingerprint(QUrl::fromLocalFile(file), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background));
+  }
 
-      // CUE sheet's path from collection (if any).
-      qint64 matching_song_cue_mtime = static_cast<qint64>(GetMtimeForCue(matching_song.cue_path()));
+}
 
-      // CUE sheet's path from this file (if any).
-      qint64 new_cue_mtime = 0;
-      if (!new_cue.isEmpty()) {
-        new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue));
-      }
+void CollectionWatcher::CancelFingerprints() {
 
-      const bool cue_added = new_cue_mtime != 0 && !matching_song.has_cue();
-      const bool cue_changed = new_cue_mtime != 0 && matching_song.has_cue() && new_cue != matching_song.cue_path();
-      const bool cue_deleted = matching_song.has_cue() && new_cue_mtime == 0;
+  for (QFuture<FingerprintService::Result> &future : fingerprint_futures_) {
+    future.cancel();
+  }
+  fingerprint_futures_.clear();
 
-      // Watch out for CUE songs which have their mtime equal to qMax(media_file_mtime, cue_sheet_mtime)
-      bool changed = (matching_song.mtime() != qMax(fileinfo.lastModified().toSecsSinceEpoch(), matching_song_cue_mtime)) || cue_deleted || cue_added || cue_changed;
+}
 
-      // Also want to look to see whether the album art has changed
-      const QUrl art_automatic = ArtForSong(file, album_art);
-      if (matching_song.art_automatic() != art_automatic || (!matching_song.art_automatic().isEmpty() && !matching_song.art_automatic_is_valid())) {
-        changed = true;
-      }
+#endif  // HAVE_SONGTRACKING
+
+QString CollectionWatcher::GetFingerprint(const QString &file) {
+
+  QString fingerprint;
 
-      bool missing_fingerprint = false;
-      bool missing_loudness_characteristics = false;
 #ifdef HAVE_SONGTRACKING
-      if (song_tracking_ && matching_song.fingerprint().isEmpty()) {
-        missing_fingerprint = true;
-      }
-#endif
-#ifdef HAVE_EBUR128
-      if (song_ebur128_loudness_analysis_ && (!matching_song.ebur128_integrated_loudness_lufs() || !matching_song.ebur128_loudness_range_lu())) {
-        missing_loudness_characteristics = true;
-      }
+  if (song_tracking_) {
+    QFuture<FingerprintService::Result> future = fingerprint_futures_.take(file);
+    if (!future.isValid()) {
+      future = FingerprintService::Instance()->Fingerprint(QUrl::fromLocalFile(file), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+    }
+    future.waitForFinished();
+    if (!future.isCanceled() && future.resultCount() > 0) {
+      fingerprint = future.result().fingerprint;
+    }
+    if (fingerprint.isEmpty()) {
+      fingerprint = "NONE"_L1;
+    }
+  }
+#else
+  Q_UNUSED(file)
 #endif
 
-      if (changed) {
-        qLog(Debug) << file << "has changed.";
-      }
-      else if (missing_fingerprint) {
-        qLog(Debug) << file << "is missing fingerprint.";
-      }
-      else if (missing_loudness_characteristics) {
-        qLog(Debug) << file << "is missing EBU R 128 loudness characteristics.";
-      }
+  return fingerprint;
 
-      // If the song is unavailable and nothing has changed, just mark it as available without re-scanning
-      // For CUE files with multiple sections, all sections share the same file and would have the same availability status
-      if (matching_song.unavailable() && !changed && !missing_fingerprint && !missing_loudness_characteristics) {
-        qLog(Debug) << "Unavailable song" << file << "restored without re-scanning.";
-        t->readded_songs << matching_songs;
-      }
-      // The song's changed or missing fingerprint - create fingerprint and reread the metadata from file.
-      else if (t->ignores_mtime() || changed || missing_fingerprint || missing_loudness_characteristics) {
+}
 
-        QString fingerprint;
-#ifdef HAVE_SONGTRACKING
-        if (song_tracking_) {
-          Chromaprinter chromaprinter(file);
-          fingerprint = chromaprinter.CreateFingerprint();
-          if (fingerprint.isEmpty()) {
-            fingerprint = "NONE"_L1;
-          }
-        }
-#endif
+bool CollectionWatcher::ScanFile(const QString &file, const QString &path, const SongList &songs_in_db, QMap<QString, QStringList> &album_art, QSet<QString> *cues_processed, ScanTransaction *t) {
 
-        if (new_cue.isEmpty() || new_cue_mtime == 0) {  // If no CUE or it's about to lose it.
-          if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, cue_deleted, t)) {
-            files_on_disk.removeAll(file);
-          }
-        }
-        else {  // If CUE associated.
-          UpdateCueAssociatedSongs(file, path, fingerprint, new_cue, art_automatic, matching_songs, t);
-        }
-      }
+  TRACE_SCOPE("collection", "Scan file");
+
+  bool on_disk = true;
+
+  // Associated CUE
+  const QString new_cue = CueParser::FindCueFilename(file);
+
+  SongList matching_songs;
+  if (FindSongsByPath(songs_in_db, file, &matching_songs)) {  // Found matching song in DB by path.
+
+    const Song matching_song = matching_songs.first();
+
+    // The song is in the database and still on disk.
+    // Check the mtime to see if it's been changed since it was added.
+    const QFileInfo fileinfo(file);
+
+    if (!fileinfo.exists()) {
+      // Partially fixes race condition - if file was removed between being added to the list and now.
+      t->AddToProgress(1);
+      return false;
+    }
 
+    // CUE sheet's path from collection (if any).
+    qint64 matching_song_cue_mtime = static_cast<qint64>(GetMtimeForCue(matching_song.cue_path()));
+
+    // CUE sheet's path from this file (if any).
+    qint64 new_cue_mtime = 0;
+    if (!new_cue.isEmpty()) {
+      new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue));
+    }
+
+    const bool cue_added = new_cue_mtime != 0 && !matching_song.has_cue();
+    const bool cue_changed = new_cue_mtime != 0 && matching_song.has_cue() && new_cue != matching_song.cue_path();
+    const bool cue_deleted = matching_song.has_cue() && new_cue_mtime == 0;
+
+    // Watch out for CUE songs which have their mtime equal to qMax(media_file_mtime, cue_sheet_mtime)
+    bool changed = (matching_song.mtime() != qMax(fileinfo.lastModified().toSecsSinceEpoch(), matching_song_cue_mtime)) || cue_deleted || cue_added || cue_changed;
+
+    // Also want to look to see whether the album art has changed
+    const QUrl art_automatic = ArtForSong(file, album_art);
+    if (matching_song.art_automatic() != art_automatic || (!matching_song.art_automatic().isEmpty() && !matching_song.art_automatic_is_valid())) {
+      changed = true;
     }
-    else {  // Search the DB by fingerprint.
-      QString fingerprint;
+
+    bool missing_fingerprint = false;
+    bool missing_loudness_characteristics = false;
 #ifdef HAVE_SONGTRACKING
-      if (song_tracking_) {
-        Chromaprinter chromaprinter(file);
-        fingerprint = chromaprinter.CreateFingerprint();
-        if (fingerprint.isEmpty()) {
-          fingerprint = "NONE"_L1;
-        }
-      }
+    if (song_tracking_ && matching_song.fingerprint().isEmpty()) {
+      missing_fingerprint = true;
+    }
+#endif
+#ifdef HAVE_EBUR128
+    if (song_ebur128_loudness_analysis_ && (!matching_song.ebur128_integrated_loudness_lufs() || !matching_song.ebur128_loudness_range_lu())) {
+      missing_loudness_characteristics = true;
+    }
 #endif
-      if (song_tracking_ && !fingerprint.isEmpty() && fingerprint != "NONE"_L1 && FindSongsByFingerprint(file, fingerprint, &matching_songs)) {
-
-        // The song is in the database and still on disk.
-        // Check the mtime to see if it's been changed since it was added.
-        const QFileInfo fileinfo(file);
-        if (!fileinfo.exists()) {
-          // Partially fixes race condition - if file was removed between being added to the list and now.
-          files_on_disk.removeAll(file);
-          t->AddToProgress(1);
-          continue;
-        }
 
-        // Make sure the songs aren't deleted, as they still exist elsewhere with a different file path.
-        bool matching_songs_has_cue = false;
-        for (const Song &matching_song : std::as_const(matching_songs)) {
-          const QString matching_filename = matching_song.url().toLocalFile();
-          if (!t->files_changed_path_.contains(matching_filename)) {
-            t->files_changed_path_ << matching_filename;
-            qLog(Debug) << matching_filename << "has changed path to" << file;
-          }
-          if (t->deleted_songs.contains(matching_song)) {
-            t->deleted_songs.removeAll(matching_song);
-          }
-          if (matching_song.has_cue()) {
-            matching_songs_has_cue = true;
-          }
-        }
+    if (changed) {
+      qLog(Debug) << file << "has changed.";
+    }
+    else if (missing_fingerprint) {
+      qLog(Debug) << file << "is missing fingerprint.";
+    }
+    else if (missing_loudness_characteristics) {
+      qLog(Debug) << file << "is missing EBU R 128 loudness characteristics.";
+    }
 
-        // CUE sheet's path from this file (if any).
-        qint64 new_cue_mtime = 0;
-        if (!new_cue.isEmpty()) {
-          new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue));
-        }
+    // If the song is unavailable and nothing has changed, just mark it as available without re-scanning
+    // For CUE files with multiple sections, all sections share the same file and would have the same availability status
+    if (matching_song.unavailable() && !changed && !missing_fingerprint && !missing_loudness_characteristics) {
+      qLog(Debug) << "Unavailable song" << file << "restored without re-scanning.";
+      t->readded_songs << matching_songs;
+    }
+    // The song's changed or missing fingerprint - create fingerprint and reread the metadata from file.
+    else if (t->ignores_mtime() || changed || missing_fingerprint || missing_loudness_characteristics) {
 
-        // Get new album art
-        const QUrl art_automatic = ArtForSong(file, album_art);
+      const QString fingerprint = GetFingerprint(file);
 
-        if (new_cue.isEmpty() || new_cue_mtime == 0) {  // If no CUE or it's about to lose it.
-          if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, matching_songs_has_cue && new_cue_mtime == 0, t)) {
-            files_on_disk.removeAll(file);
-          }
-        }
-        else {  // If CUE associated.
-          UpdateCueAssociatedSongs(file, path, fingerprint, new_cue, art_automatic, matching_songs, t);
+      if (new_cue.isEmpty() || new_cue_mtime == 0) {  // If no CUE or it's about to lose it.
+        if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, cue_deleted, t)) {
+          on_disk = false;
         }
+      }
+      else {  // If CUE associated.
+        UpdateCueAssociatedSongs(file, path, fingerprint, new_cue, art_automatic, matching_songs, t);
+      }
+    }
 
+  }
+  else {  // Search the DB by fingerprint.
+    const QString fingerprint = GetFingerprint(file);
+    if (song_tracking_ && !fingerprint.isEmpty() && fingerprint != "NONE"_L1 && FindSongsByFingerprint(file, fingerprint, &matching_songs)) {
+
+      // The song is in the database and still on disk.
+      // Check the mtime to see if it's been changed since it was added.
+      const QFileInfo fileinfo(file);
+      if (!fileinfo.exists()) {
+        // Partially fixes race condition - if file was removed between being added to the list and now.
+        t->AddToProgress(1);
+        return false;
       }
-      else {  // The song is on disk but not in the DB
 
-        const SongList songs = ScanNewFile(file, path, fingerprint, new_cue, &cues_processed);
-        if (songs.isEmpty()) {
-          files_on_disk.removeAll(file);
-          t->AddToProgress(1);
-          continue;
+      // Make sure the songs aren't deleted, as they still exist elsewhere with a different file path.
+      bool matching_songs_has_cue = false;
+      for (const Song &matching_song : std::as_const(matching_songs)) {
+        const QString matching_filename = matching_song.url().toLocalFile();
+        if (!t->files_changed_path_.contains(matching_filename)) {
+          t->files_changed_path_ << matching_filename;
+          qLog(Debug) << matching_filename << "has changed path to" << file;
+        }
+        if (t->deleted_songs.contains(matching_song)) {
+          t->deleted_songs.removeAll(matching_song);
         }
+        if (matching_song.has_cue()) {
+          matching_songs_has_cue = true;
+        }
+      }
 
-        qLog(Debug) << file << "is new.";
+      // CUE sheet's path from this file (if any).
+      qint64 new_cue_mtime = 0;
+      if (!new_cue.isEmpty()) {
+        new_cue_mtime = static_cast<qint64>(GetMtimeForCue(new_cue));
+      }
 
-        // Choose art for the song(s)
-        const QUrl art_automatic = ArtForSong(file, album_art);
+      // Get new album art
+      const QUrl art_automatic = ArtForSong(file, album_art);
 
-        for (Song song : songs) {
-          song.set_directory_id(t->dir_id());
-          if (song.art_automatic().isEmpty()) song.set_art_automatic(art_automatic);
-          t->new_songs << song;
+      if (new_cue.isEmpty() || new_cue_mtime == 0) {  // If no CUE or it's about to lose it.
+        if (!UpdateNonCueAssociatedSong(file, fingerprint, matching_songs, art_automatic, matching_songs_has_cue && new_cue_mtime == 0, t)) {
+          on_disk = false;
         }
       }
-    }
-    t->AddToProgress(1);
-  }
+      else {  // If CUE associated.
+        UpdateCueAssociatedSongs(file, path, fingerprint, new_cue, art_automatic, matching_songs, t);
+      }
 
-  // Look for deleted songs.
-  // files_on_disk holds the on-disk path spelling while the database stores its own; the two can differ purely by Unicode normalization form (NFC vs NFD).
-  // Compare in NFC so a song that was just matched (FindSongsByPath normalizes too) is not also treated as deleted within the same scan.
-  QSet<QString> files_on_disk_nfc;
-  files_on_disk_nfc.reserve(files_on_disk.count());
-  for (const QString &file : std::as_const(files_on_disk)) {
-    files_on_disk_nfc.insert(file.normalized(QString::NormalizationForm_C));
-  }
-  for (const Song &song : std::as_const(songs_in_db)) {
-    const QString file = song.url().toLocalFile();
-    if (!song.unavailable() && !files_on_disk_nfc.contains(file.normalized(QString::NormalizationForm_C)) && !t->files_changed_path_.contains(file)) {
-      qLog(Debug) << "Song deleted from disk:" << file;
-      t->deleted_songs << song;
     }
-  }
+    else {  // The song is on disk but not in the DB
 
-  // Add, update or delete subdir
-  CollectionSubdirectory updated_subdir;
-  updated_subdir.directory_id = t->dir_id();
-  updated_subdir.mtime = path_mtime;
-  updated_subdir.path = path;
+      const SongList songs = ScanNewFile(file, path, fingerprint, new_cue, cues_processed);
+      if (songs.isEmpty()) {
+        t->AddToProgress(1);
+        return false;
+      }
 
-  if (!path_info.exists() && updated_subdir.path != dir.path) {
-    t->deleted_subdirs << updated_subdir;
-  }
-  else if (subdir.directory_id == -1) {
-    t->new_subdirs << updated_subdir;
-  }
-  else if (subdir.mtime != updated_subdir.mtime) {
-    t->touched_subdirs << updated_subdir;
-  }
+      qLog(Debug) << file << "is new.";
 
-  // Recurse into the new subdirs that we found
-  for (const CollectionSubdirectory &my_new_subdir : std::as_const(my_new_subdirs)) {
-    if (stop_or_abort_requested()) return;
-    ScanSubdirectory(dir, my_new_subdir.path, my_new_subdir, 0, t, true);
+      // Choose art for the song(s)
+      const QUrl art_automatic = ArtForSong(file, album_art);
+
+      for (Song song : songs) {
+        song.set_directory_id(t->dir_id());
+        if (song.art_automatic().isEmpty()) song.set_art_automatic(art_automatic);
+        t->new_songs << song;
+      }
+    }
   }
 
+  t->AddToProgress(1);
+
+  return on_disk;
+
 }
 
 void CollectionWatcher::UpdateCueAssociatedSongs(const QString &file,
@@ -1249,6 +1331,313 @@ void CollectionWatcher::DirectoryChanged(const QString &subdir) {
 
 }
 
+void CollectionWatcher::FileChanged(const QString &filename) {
+
+  QueueFileEvent(filename, FileEvent::Changed);
+
+}
+
+void CollectionWatcher::FileRemoved(const QString &filename) {
+
+  // If the file was moved here before, it's the original file that is gone.
+  if (pending_file_moves_.contains(filename)) {
+    QueueFileEvent(pending_file_moves_.take(filename), FileEvent::Removed);
+    return;
+  }
+
+  QueueFileEvent(filename, FileEvent::Removed);
+
+}
+
+void CollectionWatcher::FileMoved(const QString &old_filename, const QString &new_filename) {
+
+  if (!subdir_mapping_.contains(DirectoryPart(new_filename))) {
+    FileRemoved(old_filename);
+    return;
+  }
+  if (!subdir_mapping_.contains(DirectoryPart(old_filename))) {
+    FileChanged(new_filename);
+    return;
+  }
+
+  // Follow a file that is moved several times back to where it was first.
+  const QString original_filename = pending_file_moves_.contains(old_filename) ? pending_file_moves_.take(old_filename) : old_filename;
+
+  // The file is replacing whatever was at the new filename, that is handled together with the move.
+  pending_file_events_.remove(new_filename);
+
+  // Changes to the file before it was moved have to be picked up from the new filename.
+  if (pending_file_events_.contains(old_filename)) {
+    pending_file_events_.remove(old_filename);
+    pending_file_events_[new_filename] = FileEvent::Changed;
+  }
+
+  if (original_filename != new_filename) {
+    pending_file_moves_[new_filename] = original_filename;
+  }
+
+  StartFileEventsTimer();
+
+}
+
+void CollectionWatcher::WatcherOverflow() {
+
+  qLog(Warning) << "Filesystem events were lost, rescanning all watched subdirectories.";
+
+  file_events_timer_->stop();
+  file_events_started_ = 0;
+  pending_file_events_.clear();
+  pending_file_moves_.clear();
+
+  rescan_queue_.clear();
+  for (QHash<QString, CollectionDirectory>::const_iterator it = subdir_mapping_.constBegin(); it != subdir_mapping_.constEnd(); ++it) {
+    rescan_queue_[it.value().id] << it.key();
+  }
+
+  if (!rescan_paused_) rescan_timer_->start();
+
+}
+
+void CollectionWatcher::QueueFileEvent(const QString &filename, const FileEvent event) {
+
+  if (!subdir_mapping_.contains(DirectoryPart(filename))) return;
+
+  pending_file_events_[filename] = event;
+
+  StartFileEventsTimer();
+
+}
+
+void CollectionWatcher::StartFileEventsTimer() {
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if (file_events_started_ == 0) {
+    file_events_started_ = now;
+  }
+
+  if (rescan_paused_) return;
+
+  // Wait for the events to settle down, but don't let a file that keeps changing hold back the others forever.
+  if (!file_events_timer_->isActive() || now - file_events_started_ < kFileEventsMaxDelayMsec) {
+    file_events_timer_->start();
+  }
+
+}
+
+void CollectionWatcher::ProcessFileEvents() {
+
+  if (rescan_paused_) return;
+
+  file_events_timer_->stop();
+  file_events_started_ = 0;
+
+  QMap<int, QMap<QString, FileEvent>> dir_file_events;
+  QMap<int, QMap<QString, QString>> dir_file_moves;
+
+  for (QHash<QString, QString>::const_iterator it = pending_file_moves_.constBegin(); it != pending_file_moves_.constEnd(); ++it) {
+    const QString &new_filename = it.key();
+    const QString &old_filename = it.value();
+    const QHash<QString, CollectionDirectory>::const_iterator old_dir = subdir_mapping_.constFind(DirectoryPart(old_filename));
+    const QHash<QString, CollectionDirectory>::const_iterator new_dir = subdir_mapping_.constFind(DirectoryPart(new_filename));
+    if (old_dir != subdir_mapping_.constEnd() && new_dir != subdir_mapping_.constEnd() && old_dir.value().id == new_dir.value().id) {
+      dir_file_moves[new_dir.value().id][new_filename] = old_filename;
+      continue;
+    }
+    // Moved between collection directories, so it's removed from one and added to the other.
+    if (old_dir != subdir_mapping_.constEnd()) {
+      dir_file_events[old_dir.value().id][old_filename] = FileEvent::Removed;
+    }
+    if (new_dir != subdir_mapping_.constEnd()) {
+      dir_file_events[new_dir.value().id][new_filename] = FileEvent::Changed;
+    }
+  }
+
+  for (QHash<QString, FileEvent>::const_iterator it = pending_file_events_.constBegin(); it != pending_file_events_.constEnd(); ++it) {
+    const QString &filename = it.key();
+    const QString path = DirectoryPart(filename);
+    const QHash<QString, CollectionDirectory>::const_iterator dir = subdir_mapping_.constFind(path);
+    if (dir == subdir_mapping_.constEnd()) continue;
+    // Album art and CUE sheets affect the other songs in the directory, so rescan the whole subdirectory for those.
+    const QString ext_part = ExtensionPart(filename);
+    if (sValidImages.contains(ext_part) || ext_part == "cue"_L1) {
+      DirectoryChanged(path);
+      continue;
+    }
+    dir_file_events[dir.value().id][filename] = it.value();
+  }
+
+  pending_file_events_.clear();
+  pending_file_moves_.clear();
+
+  QList<int> dir_ids = dir_file_events.keys();
+  const QList<int> move_dir_ids = dir_file_moves.keys();
+  for (const int dir_id : move_dir_ids) {
+    if (!dir_ids.contains(dir_id)) dir_ids << dir_id;
+  }
+
+  if (dir_ids.isEmpty()) return;
+
+  CancelStop();
+
+  for (const int dir_id : std::as_const(dir_ids)) {
+    if (stop_or_abort_requested()) break;
+    ProcessDirectoryFileEvents(dir_id, dir_file_events.value(dir_id), dir_file_moves.value(dir_id));
+  }
+
+  Q_EMIT CompilationsNeedUpdating();
+
+}
+
+void CollectionWatcher::ProcessDirectoryFileEvents(const int dir_id, const QMap<QString, FileEvent> &file_events, const QMap<QString, QString> &file_moves) {
+
+  if (!watched_dirs_.contains(dir_id)) return;
+
+  ScanTransaction t(this, dir_id, false, false);
+  t.AddToProgressMax(static_cast<quint64>(file_events.count() + file_moves.count()));
+
+  QSet<QString> touched_paths;
+  QMap<QString, QStringList> album_art;
+  const auto load_album_art = [&album_art](const QString &path) {
+    if (album_art.contains(path)) return;
+    QStringList &images = album_art[path];
+    const QFileInfoList entries = QDir(path).entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+    for (const QFileInfo &entry : entries) {
+      if (sValidImages.contains(ExtensionPart(entry.filePath()))) {
+        images << entry.filePath();
+      }
+    }
+    if (images.isEmpty()) album_art.remove(path);
+  };
+
+  // Songs which were moved and also changed, these have to be matched against the song at its new filename.
+  QHash<QString, SongList> moved_songs;
+  QStringList changed_files;
+
+  const QStringList moved_away_files = file_moves.values();
+  for (QMap<QString, QString>::const_iterator it = file_moves.constBegin(); it != file_moves.constEnd(); ++it) {
+
+    if (stop_or_abort_requested()) return;
+
+    const QString &new_filename = it.key();
+    const QString &old_filename = it.value();
+    const QString old_path = DirectoryPart(old_filename);
+    const QString new_path = DirectoryPart(new_filename);
+    touched_paths << old_path << new_path;
+
+    SongList matching_songs;
+    FindSongsByPath(t.FindSongsInSubdirectory(old_path), old_filename, &matching_songs);
+    SongList old_songs;
+    bool has_cue = false;
+    for (const Song &song : std::as_const(matching_songs)) {
+      if (song.unavailable()) continue;
+      if (song.has_cue()) has_cue = true;
+      old_songs << song;
+    }
+
+    if (old_songs.isEmpty() || has_cue || !QFileInfo::exists(new_filename)) {
+      // Not a plain song, handle it as a removed and a new file.
+      t.deleted_songs << old_songs;
+      changed_files << new_filename;
+      continue;
+    }
+
+    // The moved file replaces the songs which were at the new filename, unless those were moved away too.
+    if (!moved_away_files.contains(new_filename)) {
+      SongList replaced_songs;
+      FindSongsByPath(t.FindSongsInSubdirectory(new_path), new_filename, &replaced_songs);
+      for (const Song &song : std::as_const(replaced_songs)) {
+        if (!song.unavailable()) t.deleted_songs << song;
+      }
+    }
+
+    qLog(Debug) << old_filename << "moved to" << new_filename;
+
+    const QUrl new_url = QUrl::fromLocalFile(new_filename);
+    const QString new_basefilename = QFileInfo(new_filename).fileName();
+    SongList new_songs;
+    for (Song song : std::as_const(old_songs)) {
+      song.set_url(new_url);
+      song.set_basefilename(new_basefilename);
+      // Album art picked up from the old directory doesn't belong to the song anymore.
+      if (new_path != old_path && song.art_automatic().isLocalFile() && DirectoryPart(song.art_automatic().toLocalFile()) == old_path) {
+        load_album_art(new_path);
+        song.set_art_automatic(ArtForSong(new_filename, album_art));
+      }
+      new_songs << song;
+    }
+    t.new_songs << new_songs;
+
+    if (file_events.value(new_filename, FileEvent::Removed) == FileEvent::Changed) {
+      moved_songs[new_filename] = new_songs;
+      changed_files << new_filename;
+    }
+    else {
+      t.AddToProgress(1);
+    }
+
+  }
+
+  for (QMap<QString, FileEvent>::const_iterator it = file_events.constBegin(); it != file_events.constEnd(); ++it) {
+
+    const QString &filename = it.key();
+    if (moved_songs.contains(filename)) {
+      t.AddToProgress(1);
+      continue;
+    }
+
+    if (it.value() == FileEvent::Changed && QFileInfo::exists(filename)) {
+      changed_files << filename;
+      continue;
+    }
+
+    const QString path = DirectoryPart(filename);
+    touched_paths << path;
+
+    SongList matching_songs;
+    FindSongsByPath(t.FindSongsInSubdirectory(path), filename, &matching_songs);
+    for (const Song &song : std::as_const(matching_songs)) {
+      if (!song.unavailable() && !t.deleted_songs.contains(song)) {
+        qLog(Debug) << "Song deleted from disk:" << filename;
+        t.deleted_songs << song;
+      }
+    }
+    t.AddToProgress(1);
+
+  }
+
+  QSet<QString> cues_processed;
+  for (const QString &file : std::as_const(changed_files)) {
+
+    if (stop_or_abort_requested()) return;
+
+    const QFileInfo fileinfo(file);
+    if (!fileinfo.isFile() || fileinfo.isHidden() || Song::kRejectedExtensions.contains(fileinfo.suffix(), Qt::CaseInsensitive) || fileinfo.baseName() == "qt_temp"_L1) {
+      t.AddToProgress(1);
+      continue;
+    }
+
+    const QString path = DirectoryPart(file);
+    touched_paths << path;
+    load_album_art(path);
+
+    const SongList songs_in_db = moved_songs.contains(file) ? moved_songs.value(file) : t.FindSongsInSubdirectory(path);
+    ScanFile(file, path, songs_in_db, album_art, &cues_processed, &t);
+
+  }
+
+  for (const QString &path : std::as_const(touched_paths)) {
+    if (!t.HasSeenSubdir(path)) continue;
+    const QFileInfo path_info(path);
+    if (!path_info.exists()) continue;
+    CollectionSubdirectory subdir;
+    subdir.directory_id = dir_id;
+    subdir.path = path;
+    subdir.mtime = path_info.lastModified().isValid() ? path_info.lastModified().toSecsSinceEpoch() : 0;
+    t.touched_subdirs << subdir;
+  }
+
+}
+
 void CollectionWatcher::RescanPathsNow() {
 
   const QList<int> dir_ids = rescan_queue_.keys();
@@ -1360,6 +1749,7 @@ void CollectionWatcher::SetRescanPaused(bool pause) {
 
   rescan_paused_ = pause;
   if (!rescan_paused_ && !rescan_queue_.isEmpty()) RescanPathsNow();
+  if (!rescan_paused_ && (!pending_file_events_.isEmpty() || !pending_file_moves_.isEmpty())) ProcessFileEvents();
 
 }
 
@@ -1379,18 +1769,44 @@ void CollectionWatcher::IncrementalScanCheck() {
 
   qint64 duration = QDateTime::currentSecsSinceEpoch() - last_scan_time_;
   if (duration >= 86400) {
+    if (WatchedDirsSupportFileEvents()) {
+      // Every change is already picked up from the filesystem events, so only expire the unavailable songs.
+      qLog(Debug) << "Skipping periodic incremental scan, updating last seen.";
+      for (const CollectionDirectory &dir : std::as_const(watched_dirs_)) {
+        Q_EMIT UpdateLastSeen(dir.id, expire_unavailable_songs_days_);
+      }
+      last_scan_time_ = QDateTime::currentSecsSinceEpoch();
+      return;
+    }
     qLog(Debug) << "Performing periodic incremental scan.";
     IncrementalScanNow();
   }
 
 }
 
+bool CollectionWatcher::WatchedDirsSupportFileEvents() const {
+
+  if (!monitor_ || !fs_watcher_->SupportsFileEvents()) return false;
+
+  for (const CollectionDirectory &dir : std::as_const(watched_dirs_)) {
+    const QStorageInfo storage_info(dir.path);
+    if (!storage_info.isValid() || kNetworkFileSystems.contains(storage_info.fileSystemType())) {
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
 void CollectionWatcher::IncrementalScanNow() { PerformScan(true, false); }
 
 void CollectionWatcher::FullScanNow() { PerformScan(false, true); }
 
 void CollectionWatcher::PerformScan(const bool incremental, const bool ignore_mtimes) {
 
+  TRACE_SCOPE("collection", "Collection scan");
+
   CancelStop();
 
   for (const CollectionDirectory &dir : std::as_const(watched_dirs_)) {
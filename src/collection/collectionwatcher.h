@@ -39,6 +39,11 @@
 #include "includes/shared_ptr.h"
 #include "core/song.h"
 
+#ifdef HAVE_SONGTRACKING
+#  include <QFuture>
+#  include "engine/fingerprintservice.h"
+#endif
+
 class QThread;
 class QTimer;
 
@@ -182,6 +187,11 @@ class CollectionWatcher : public QObject {
   void ReloadSettings();
   void Exit();
   void DirectoryChanged(const QString &subdir);
+  void FileChanged(const QString &filename);
+  void FileRemoved(const QString &filename);
+  void FileMoved(const QString &old_filename, const QString &new_filename);
+  void WatcherOverflow();
+  void ProcessFileEvents();
   void IncrementalScanCheck();
   void IncrementalScanNow();
   void FullScanNow();
@@ -190,9 +200,19 @@ class CollectionWatcher : public QObject {
   void RescanSongs(const SongList &songs);
 
  private:
+  enum class FileEvent {
+    Changed,
+    Removed
+  };
+
   bool stop_requested() const;
   bool abort_requested() const;
   bool stop_or_abort_requested() const;
+  bool ScanFile(const QString &file, const QString &path, const SongList &songs_in_db, QMap<QString, QStringList> &album_art, QSet<QString> *cues_processed, ScanTransaction *t);
+  void QueueFileEvent(const QString &filename, const FileEvent event);
+  void StartFileEventsTimer();
+  void ProcessDirectoryFileEvents(const int dir_id, const QMap<QString, FileEvent> &file_events, const QMap<QString, QString> &file_moves);
+  bool WatchedDirsSupportFileEvents() const;
   static bool FindSongsByPath(const SongList &songs, const QString &path, SongList *out);
   bool FindSongsByFingerprint(const QString &file, const QString &fingerprint, SongList *out);
   static bool FindSongsByFingerprint(const QString &file, const SongList &songs, const QString &fingerprint, SongList *out);
@@ -218,6 +238,13 @@ class CollectionWatcher : public QObject {
 
   void PerformEBUR128Analysis(Song &song) const;
 
+#ifdef HAVE_SONGTRACKING
+  // Starts creating the fingerprints the scan of a subdirectory is likely to need, so they are created in parallel.
+  void QueueFingerprints(const QStringList &files, const SongList &songs_in_db, ScanTransaction *t);
+  void CancelFingerprints();
+#endif
+  QString GetFingerprint(const QString &file);
+
   quint64 FilesCountForPath(ScanTransaction *t, const QString &path);
   quint64 FilesCountForSubdirs(ScanTransaction *t, const CollectionSubdirectoryList &subdirs, QMap<QString, quint64> &subdir_files_count);
 
@@ -261,10 +288,20 @@ class CollectionWatcher : public QObject {
   QMap<int, QStringList> rescan_queue_;  // dir id -> list of subdirs to be scanned
   bool rescan_paused_;
 
+  // Single file events from the filesystem watcher, collected until it has been quiet for a while.
+  QTimer *file_events_timer_;
+  qint64 file_events_started_;
+  QHash<QString, FileEvent> pending_file_events_;
+  QHash<QString, QString> pending_file_moves_;  // new filename -> old filename
+
   int total_watches_;
 
   CueParser *cue_parser_;
 
+#ifdef HAVE_SONGTRACKING
+  QHash<QString, QFuture<FingerprintService::Result>> fingerprint_futures_;
+#endif
+
   static QStringList sValidImages;
 
   qint64 last_scan_time_;
@@ -46,6 +46,7 @@ constexpr char kBufferDuration[] = "bufferduration";
 constexpr char kBufferLowWatermark[] = "bufferlowwatermark";
 constexpr char kBufferHighWatermark[] = "bufferhighwatermark";
 constexpr char kDeviceWarmupDuration[] = "devicewarmupduration";
+constexpr char kPreloadDuration[] = "preloadduration";
 constexpr char kRgEnabled[] = "rgenabled";
 constexpr char kRgMode[] = "rgmode";
 constexpr char kRgPreamp[] = "rgpreamp";
@@ -74,6 +75,7 @@ constexpr qint64 kDefaultBufferDuration = 4000LL;
 constexpr double kDefaultBufferLowWatermark = 0.33;
 constexpr double kDefaultBufferHighWatermark = 0.99;
 constexpr int kDefaultDeviceWarmupDuration = 500;
+constexpr int kDefaultPreloadDuration = 8;
 constexpr bool kDefaultRgEnabled = false;
 constexpr int kDefaultRgMode = 0;
 constexpr double kDefaultRgPreamp = 0.0;
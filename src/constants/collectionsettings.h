@@ -45,6 +45,7 @@ constexpr char kVariousArtists[] = "various_artists";
 constexpr char kSkipArticlesForArtists[] = "skip_articles_for_artists";
 constexpr char kSkipArticlesForAlbums[] = "skip_articles_for_albums";
 constexpr char kUseSortTags[] = "use_sort_tags";
+constexpr char kLazyLoading[] = "lazy_loading";
 constexpr char kSettingsCacheSize[] = "cache_size";
 constexpr char kSettingsCacheSizeUnit[] = "cache_size_unit";
 constexpr char kSettingsDiskCacheEnable[] = "disk_cache_enable";
@@ -72,6 +73,7 @@ constexpr bool kDefaultVariousArtists = true;
 constexpr bool kDefaultSkipArticlesForArtists = true;
 constexpr bool kDefaultSkipArticlesForAlbums = false;
 constexpr bool kDefaultUseSortTags = true;
+constexpr bool kDefaultLazyLoading = false;
 constexpr CacheSizeUnit kDefaultSettingsCacheSizeUnit = CacheSizeUnit::MB;
 constexpr bool kDefaultSettingsDiskCacheEnable = false;
 constexpr CacheSizeUnit kDefaultSettingsDiskCacheSizeUnit = CacheSizeUnit::MB;
@@ -27,5 +27,19 @@ const QByteArrayList kRejectedFileSystems = QByteArrayList() << "proc"
                                                              << "tmpfs"
                                                              << "devtmpfs";
 
+// Changes made on other hosts are not reported by the filesystem watcher for these.
+const QByteArrayList kNetworkFileSystems = QByteArrayList() << "nfs"
+                                                            << "nfs4"
+                                                            << "cifs"
+                                                            << "smb3"
+                                                            << "smbfs"
+                                                            << "9p"
+                                                            << "afs"
+                                                            << "ceph"
+                                                            << "glusterfs"
+                                                            << "fuse.sshfs"
+                                                            << "fuse.rclone"
+                                                            << "fuse.gvfsd-fuse";
+
 
 #endif  // FILESYSTEMCONSTANTS_H
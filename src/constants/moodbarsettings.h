@@ -35,9 +35,12 @@ enum class Style {
 
 constexpr char kStyle[] = "style";
 constexpr char kSave[] = "save";
+constexpr char kAnalysisRate[] = "analysis_rate";
 
 constexpr Style kDefaultStyle = Style::Normal;
 constexpr bool kDefaultSave = false;
+// Enough for the highest bark band at 15500 Hz, 0 analyzes the audio at the rate of the file.
+constexpr int kDefaultAnalysisRate = 32000;
 
 }  // namespace MoodbarSettings
 
@@ -40,6 +40,7 @@ constexpr char kDownloadAlbumCovers[] = "downloadalbumcovers";
 constexpr char kUseAlbumIdForAlbumCovers[] = "usealbumidforalbumcovers";
 constexpr char kServerSideScrobbling[] = "serversidescrobbling";
 constexpr char kAuthMethod[] = "authmethod";
+constexpr char kLastModified[] = "lastmodified";
 
 constexpr bool kDefaultEnabled = false;
 constexpr bool kDefaultHTTP2 = false;
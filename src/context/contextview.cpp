@@ -359,6 +359,17 @@ void ContextView::SearchLyrics() {
 
 }
 
+void ContextView::PrefetchLyrics(const SongList &songs) {
+
+  if (!lyrics_fetcher_ || !action_show_lyrics_->isChecked() || !action_search_lyrics_->isChecked()) return;
+
+  for (const Song &song : songs) {
+    if (!song.lyrics().isEmpty() || song.artist().isEmpty() || song.title().isEmpty()) continue;
+    lyrics_fetcher_->Prefetch(song.effective_albumartist(), song.artist(), song.album(), song.title(), song.length_nanosec() / kNsecPerSec);
+  }
+
+}
+
 void ContextView::FadeStopFinished() {
 
   widget_stacked_->setCurrentWidget(widget_stop_);
@@ -57,6 +57,9 @@ class ContextView : public QWidget {
  public:
   explicit ContextView(QWidget *parent = nullptr);
 
+  // Number of upcoming songs to prefetch lyrics for.
+  static constexpr int kLyricsPrefetchSongs = 3;
+
   void Init(CollectionView *collectionview, AlbumCoverChoiceController *album_cover_choice_controller, SharedPtr<LyricsProviders> lyrics_providers);
 
   ContextAlbum *album_widget() const { return widget_album_; }
@@ -98,6 +101,7 @@ class ContextView : public QWidget {
   void Stopped();
   void Error();
   void SongChanged(const Song &song);
+  void PrefetchLyrics(const SongList &songs);
   void AlbumCoverLoaded(const Song &song, const QImage &image);
 
  private:
@@ -92,7 +92,8 @@ constexpr char kHelpText[] =
     "      --verbose              %32\n"
     "      --log-levels <levels>  %33\n"
     "      --version              %34\n"
-    "      --create-fingerprint <filename>  %35\n";
+    "      --create-fingerprint <filename>  %35\n"
+    "      --trace <filename>     %36\n";
 
 constexpr char kVersionText[] = "Strawberry %1";
 
@@ -179,6 +180,7 @@ bool CommandlineOptions::Parse() {
       {L"log-levels", required_argument, nullptr, LongOptions::LogLevels},
       {L"version", no_argument, nullptr, LongOptions::Version},
       {L"create-fingerprint", required_argument, nullptr, LongOptions::CreateFingerPrint},
+      {L"trace", required_argument, nullptr, LongOptions::Trace},
       {nullptr, 0, nullptr, 0}
 #else
     { "help", no_argument, nullptr, 'h' },
@@ -211,6 +213,7 @@ bool CommandlineOptions::Parse() {
     { "log-levels", required_argument, nullptr, LongOptions::LogLevels },
     { "version", no_argument, nullptr, LongOptions::Version },
     { "create-fingerprint", required_argument, nullptr, LongOptions::CreateFingerPrint },
+    { "trace", required_argument, nullptr, LongOptions::Trace },
     { nullptr, 0, nullptr, 0 }
 #endif
   };
@@ -264,7 +267,8 @@ bool CommandlineOptions::Parse() {
                      QObject::tr("Equivalent to --log-levels *:3"),
                      QObject::tr("Comma separated list of class:level, level is 0-3"),
                      QObject::tr("Print out version information"),
-                     QObject::tr("Create fingerprint")
+                     QObject::tr("Create fingerprint"),
+                     QObject::tr("Record a trace and save it in Chrome trace format on exit")
                      );
 
         std::cout << translated_help_text.toLocal8Bit().constData();
@@ -330,6 +334,9 @@ bool CommandlineOptions::Parse() {
       case LongOptions::LogLevels:
         log_levels_ = OptArgToString(optarg);
         break;
+      case LongOptions::Trace:
+        trace_filename_ = OptArgToString(optarg);
+        break;
       case LongOptions::Version:{
         QString version_text = QString::fromUtf8(kVersionText).arg(QLatin1String(STRAWBERRY_VERSION_DISPLAY));
         std::cout << version_text.toLocal8Bit().constData() << std::endl;
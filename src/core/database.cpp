@@ -21,6 +21,7 @@
 
 #include "config.h"
 
+#include <memory>
 #include <utility>
 
 #include <sqlite3.h>
@@ -28,6 +29,7 @@
 #include <QObject>
 #include <QThread>
 #include <QMutex>
+#include <QCache>
 #include <QIODevice>
 #include <QDir>
 #include <QFile>
@@ -49,13 +51,15 @@
 #include "scopedtransaction.h"
 
 using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
 
-const int Database::kSchemaVersion = 23;
+const int Database::kSchemaVersion = 24;
 
 namespace {
 constexpr char kDatabaseFilename[] = "strawberry.db";
 constexpr int kMinSupportedSchemaVersion = 10;
 constexpr char kMagicAllSongsTables[] = "%allsongstables";
+constexpr int kMaxPreparedQueries = 32;
 }  // namespace
 
 int Database::sNextConnectionId = 1;
@@ -87,6 +91,8 @@ Database::Database(SharedPtr<TaskManager> task_manager, QObject *parent, const Q
 
 Database::~Database() {
 
+  ClearAllPreparedQueries();
+
   QMutexLocker l(&connect_mutex_);
 
   const QStringList connection_names = QSqlDatabase::connectionNames();
@@ -207,6 +213,7 @@ void Database::Close() {
 
   // Try to find an existing connection for this thread
   if (QSqlDatabase::connectionNames().contains(connection_id)) {
+    ClearPreparedQueries(connection_id);
     {
       QSqlDatabase db = QSqlDatabase::database(connection_id);
       if (db.isOpen()) {
@@ -219,6 +226,51 @@ void Database::Close() {
 
 }
 
+ScopedPtr<QSqlQuery> Database::TakePreparedQuery(const QSqlDatabase &db, const QString &query) {
+
+  QMutexLocker l(&prepared_queries_mutex_);
+
+  SharedPtr<QCache<QString, QSqlQuery>> prepared_queries = prepared_queries_.value(db.connectionName());
+  if (!prepared_queries) return nullptr;
+
+  // Taken out of the cache while it's in use, so nested queries preparing the same statement get their own.
+  ScopedPtr<QSqlQuery> prepared_query(prepared_queries->take(query));
+  if (!prepared_query || !prepared_query->driver() || prepared_query->driver() != db.driver()) return nullptr;
+
+  return prepared_query;
+
+}
+
+void Database::ReturnPreparedQuery(const QSqlDatabase &db, const QString &query, const QSqlQuery &prepared_query) {
+
+  // The connection might have been removed while the statement was in use.
+  const QString connection_name = db.connectionName();
+  if (!prepared_query.driver() || !QSqlDatabase::contains(connection_name)) return;
+
+  QMutexLocker l(&prepared_queries_mutex_);
+
+  SharedPtr<QCache<QString, QSqlQuery>> &prepared_queries = prepared_queries_[connection_name];
+  if (!prepared_queries) {
+    prepared_queries = make_shared<QCache<QString, QSqlQuery>>(kMaxPreparedQueries);
+  }
+  prepared_queries->insert(query, new QSqlQuery(prepared_query));
+
+}
+
+void Database::ClearPreparedQueries(const QString &connection_name) {
+
+  QMutexLocker l(&prepared_queries_mutex_);
+  prepared_queries_.remove(connection_name);
+
+}
+
+void Database::ClearAllPreparedQueries() {
+
+  QMutexLocker l(&prepared_queries_mutex_);
+  prepared_queries_.clear();
+
+}
+
 int Database::SchemaVersion(QSqlDatabase *db) {
 
   // Get the database's schema version
@@ -262,6 +314,11 @@ void Database::RecreateAttachedDb(const QString &database_name) {
   const QString filename = attached_databases_.value(database_name).filename_;
 
   QMutexLocker l(&mutex_);
+
+  // All the connections are removed below, and statements still using the attached database would keep it from being detached.
+  // The connections are only used while holding the database mutex, so the statements of the other threads can be removed here too.
+  ClearAllPreparedQueries();
+
   {
     QSqlDatabase db(Connect());
 
@@ -312,6 +369,8 @@ void Database::DetachDatabase(const QString &database_name) {
   {
     QSqlDatabase db(Connect());
 
+    ClearPreparedQueries(db.connectionName());
+
     SqlQuery q(db);
     q.prepare(u"DETACH DATABASE :alias"_s);
     q.BindValue(u":alias"_s, database_name);
@@ -30,13 +30,15 @@
 #include <QObject>
 #include <QMutex>
 #include <QMap>
+#include <QCache>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QString>
 #include <QStringList>
-#include <QRecursiveMutex>
 
 #include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
+#include "databasemutex.h"
 #include "sqlquery.h"
 
 class QThread;
@@ -66,7 +68,11 @@ class Database : public QObject {
   void Close();
   void ReportErrors(const SqlQuery &query);
 
-  QRecursiveMutex *Mutex() { return &mutex_; }
+  DatabaseMutex *Mutex() { return &mutex_; }
+
+  // Statements prepared by SqlQuery::PrepareCached(), kept per connection until the connection is closed.
+  ScopedPtr<QSqlQuery> TakePreparedQuery(const QSqlDatabase &db, const QString &query);
+  void ReturnPreparedQuery(const QSqlDatabase &db, const QString &query, const QSqlQuery &prepared_query);
 
   void RecreateAttachedDb(const QString &database_name);
   void ExecSchemaCommands(QSqlDatabase &db, const QString &schema, const int schema_version, const bool in_transaction = false);
@@ -102,6 +108,8 @@ class Database : public QObject {
   bool IntegrityCheck(const QSqlDatabase &db);
   void BackupFile(const QString &filename);
   static bool OpenDatabase(const QString &filename, sqlite3 **connection);
+  void ClearPreparedQueries(const QString &connection_name);
+  void ClearAllPreparedQueries();
 
   SharedPtr<TaskManager> task_manager_;
 
@@ -110,7 +118,11 @@ class Database : public QObject {
 
   QString directory_;
   QMutex connect_mutex_;
-  QRecursiveMutex mutex_;
+  DatabaseMutex mutex_;
+
+  // Connection name -> statements prepared on the connection
+  QMutex prepared_queries_mutex_;
+  QMap<QString, SharedPtr<QCache<QString, QSqlQuery>>> prepared_queries_;
 
   // This ID makes the QSqlDatabase name unique to the object as well as the thread
   int connection_id_;
@@ -0,0 +1,104 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QString>
+#include <QMutexLocker>
+
+#include "core/tracing.h"
+#include "core/databasestatistics.h"
+#include "databasemutex.h"
+
+void DatabaseMutex::lock() {
+
+  if (mutex_.tryLock()) {
+    if (depth_++ == 0 && DatabaseStatistics::IsEnabled()) {
+      LockAcquired(0, QString());
+    }
+    return;
+  }
+
+  const bool statistics_enabled = DatabaseStatistics::IsEnabled();
+  QString owner_thread_name;
+  if (statistics_enabled) {
+    QMutexLocker l(&owner_mutex_);
+    owner_thread_name = owner_thread_name_;
+  }
+
+  const qint64 start_usec = statistics_enabled ? tracing::NowMicroseconds() : 0;
+  {
+    TRACE_SCOPE("database", "Database mutex wait");
+    mutex_.lock();
+  }
+
+  if (depth_++ == 0 && statistics_enabled) {
+    LockAcquired(qMax<qint64>(1, tracing::NowMicroseconds() - start_usec), owner_thread_name);
+  }
+
+}
+
+bool DatabaseMutex::tryLock() {
+
+  if (!mutex_.tryLock()) return false;
+
+  if (depth_++ == 0 && DatabaseStatistics::IsEnabled()) {
+    LockAcquired(0, QString());
+  }
+
+  return true;
+
+}
+
+void DatabaseMutex::unlock() {
+
+  if (--depth_ == 0 && tracked_) {
+    LockReleased();
+  }
+
+  mutex_.unlock();
+
+}
+
+void DatabaseMutex::LockAcquired(const qint64 wait_usec, const QString &owner_thread_name) {
+
+  tracked_ = true;
+
+  DatabaseStatistics::Instance()->AddMutexLock(wait_usec, owner_thread_name);
+  DatabaseStatistics::BeginMutexHold();
+  hold_start_usec_ = tracing::NowMicroseconds();
+
+  QMutexLocker l(&owner_mutex_);
+  owner_thread_name_ = tracing::CurrentThreadName();
+
+}
+
+void DatabaseMutex::LockReleased() {
+
+  tracked_ = false;
+
+  {
+    QMutexLocker l(&owner_mutex_);
+    owner_thread_name_.clear();
+  }
+
+  DatabaseStatistics::Instance()->AddMutexHold(tracing::NowMicroseconds() - hold_start_usec_);
+
+}
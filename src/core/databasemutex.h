@@ -0,0 +1,57 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DATABASEMUTEX_H
+#define DATABASEMUTEX_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QString>
+#include <QMutex>
+#include <QRecursiveMutex>
+
+// The recursive mutex serializing access to the database, used with QMutexLocker.
+// Waiting for it is traced, and when the database statistics are enabled the wait and hold times are added to them.
+class DatabaseMutex {
+ public:
+  DatabaseMutex() : depth_(0), tracked_(false), hold_start_usec_(0) {}
+
+  void lock();
+  bool tryLock();
+  void unlock();
+
+ private:
+  Q_DISABLE_COPY_MOVE(DatabaseMutex)
+
+  void LockAcquired(const qint64 wait_usec, const QString &owner_thread_name);
+  void LockReleased();
+
+  QRecursiveMutex mutex_;
+  // Only used by the thread holding the mutex.
+  int depth_;
+  // Whether the statistics were enabled when the mutex was locked.
+  bool tracked_;
+  qint64 hold_start_usec_;
+  // The thread holding the mutex while the statistics are enabled, read by the threads waiting for it.
+  QMutex owner_mutex_;
+  QString owner_thread_name_;
+};
+
+#endif  // DATABASEMUTEX_H
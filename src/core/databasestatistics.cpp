@@ -0,0 +1,284 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "config.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QtGlobal>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "core/tracing.h"
+#include "databasestatistics.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+constexpr qint64 kDefaultSlowThresholdUsec = 100000;
+constexpr int kMaxReportStatements = 20;
+
+// The last statement executed by the thread, to tell what a long hold of the mutex was doing.
+thread_local QString sLastStatement;
+
+QString FormatMsec(const qint64 usec) {
+  return QString::number(static_cast<double>(usec) / 1000.0, 'f', 1);
+}
+
+}  // namespace
+
+std::atomic<bool> DatabaseStatistics::sEnabled(false);
+
+DatabaseStatistics *DatabaseStatistics::Instance() {
+
+  static DatabaseStatistics statistics;
+  return &statistics;
+
+}
+
+DatabaseStatistics::DatabaseStatistics() : slow_threshold_usec_(kDefaultSlowThresholdUsec) {}
+
+int DatabaseStatistics::HistogramBucket(const qint64 duration_usec) {
+
+  int bucket = 0;
+  for (qint64 bound = 100; bucket < kHistogramBuckets - 1 && duration_usec >= bound; bound *= 10) {
+    ++bucket;
+  }
+
+  return bucket;
+
+}
+
+QString DatabaseStatistics::NormalizeStatement(const QString &statement) {
+
+  static const QRegularExpression regex_string(u"'(?:[^']|'')*'"_s);
+  static const QRegularExpression regex_number(u"(?<![\\w.])-?\\d+(?:\\.\\d+)?\\b"_s);
+  static const QRegularExpression regex_list(u"\\bIN\\s*\\(\\s*\\?(?:\\s*,\\s*\\?)*\\s*\\)"_s, QRegularExpression::CaseInsensitiveOption);
+
+  QString normalized_statement = statement.simplified();
+  normalized_statement.replace(regex_string, u"?"_s);
+  normalized_statement.replace(regex_number, u"?"_s);
+  normalized_statement.replace(regex_list, u"IN (?)"_s);
+
+  return normalized_statement;
+
+}
+
+QString DatabaseStatistics::OtherStatements() {
+
+  return u"(other statements)"_s;
+
+}
+
+void DatabaseStatistics::AddStatement(const QString &statement, const qint64 duration_usec) {
+
+  sLastStatement = statement;
+
+  const QString normalized_statement = NormalizeStatement(statement);
+
+  QMutexLocker l(&mutex_);
+  StatementStats &stats = statement_stats_.count() < kMaxStatements || statement_stats_.contains(normalized_statement) ? statement_stats_[normalized_statement] : statement_stats_[OtherStatements()];
+  ++stats.count;
+  stats.total_usec += duration_usec;
+  stats.max_usec = std::max(stats.max_usec, duration_usec);
+  ++stats.histogram[HistogramBucket(duration_usec)];
+
+}
+
+void DatabaseStatistics::AddSlowQuery(const QString &statement, const qint64 duration_usec, const QString &query_plan) {
+
+  SlowEvent slow_event;
+  slow_event.type = SlowEvent::Type::Query;
+  slow_event.time = QDateTime::currentDateTime();
+  slow_event.duration_usec = duration_usec;
+  slow_event.thread_name = tracing::CurrentThreadName();
+  slow_event.statement = statement;
+  slow_event.query_plan = query_plan;
+
+  AddSlowEvent(slow_event);
+
+}
+
+void DatabaseStatistics::AddMutexLock(const qint64 wait_usec, const QString &owner_thread_name) {
+
+  {
+    QMutexLocker l(&mutex_);
+    ++mutex_stats_.locks;
+    if (wait_usec > 0) {
+      ++mutex_stats_.contended_locks;
+      mutex_stats_.total_wait_usec += wait_usec;
+      mutex_stats_.max_wait_usec = std::max(mutex_stats_.max_wait_usec, wait_usec);
+    }
+  }
+
+  if (wait_usec >= slow_threshold_usec()) {
+    SlowEvent slow_event;
+    slow_event.type = SlowEvent::Type::MutexWait;
+    slow_event.time = QDateTime::currentDateTime();
+    slow_event.duration_usec = wait_usec;
+    slow_event.thread_name = tracing::CurrentThreadName();
+    slow_event.owner_thread_name = owner_thread_name;
+    AddSlowEvent(slow_event);
+  }
+
+}
+
+void DatabaseStatistics::BeginMutexHold() {
+
+  sLastStatement.clear();
+
+}
+
+void DatabaseStatistics::AddMutexHold(const qint64 hold_usec) {
+
+  {
+    QMutexLocker l(&mutex_);
+    mutex_stats_.total_hold_usec += hold_usec;
+    mutex_stats_.max_hold_usec = std::max(mutex_stats_.max_hold_usec, hold_usec);
+  }
+
+  if (hold_usec >= slow_threshold_usec()) {
+    SlowEvent slow_event;
+    slow_event.type = SlowEvent::Type::MutexHold;
+    slow_event.time = QDateTime::currentDateTime();
+    slow_event.duration_usec = hold_usec;
+    slow_event.thread_name = tracing::CurrentThreadName();
+    slow_event.statement = sLastStatement;
+    AddSlowEvent(slow_event);
+  }
+
+}
+
+void DatabaseStatistics::AddSlowEvent(const SlowEvent &slow_event) {
+
+  QMutexLocker l(&mutex_);
+  slow_events_ << slow_event;
+  while (slow_events_.count() > kMaxSlowEvents) {
+    slow_events_.removeFirst();
+  }
+
+}
+
+QHash<QString, DatabaseStatistics::StatementStats> DatabaseStatistics::statement_stats() const {
+
+  QMutexLocker l(&mutex_);
+  return statement_stats_;
+
+}
+
+DatabaseStatistics::MutexStats DatabaseStatistics::mutex_stats() const {
+
+  QMutexLocker l(&mutex_);
+  return mutex_stats_;
+
+}
+
+QList<DatabaseStatistics::SlowEvent> DatabaseStatistics::slow_events() const {
+
+  QMutexLocker l(&mutex_);
+  return slow_events_;
+
+}
+
+QString DatabaseStatistics::Report() const {
+
+  const MutexStats mutex_stats = DatabaseStatistics::mutex_stats();
+  const QHash<QString, StatementStats> statement_stats = DatabaseStatistics::statement_stats();
+  const QList<SlowEvent> slow_events = DatabaseStatistics::slow_events();
+
+  QStringList lines;
+
+  lines << u"Database mutex: %1 locks, %2 contended, waited %3 ms (max %4 ms), held %5 ms (max %6 ms)"_s
+             .arg(mutex_stats.locks)
+             .arg(mutex_stats.contended_locks)
+             .arg(FormatMsec(mutex_stats.total_wait_usec), FormatMsec(mutex_stats.max_wait_usec), FormatMsec(mutex_stats.total_hold_usec), FormatMsec(mutex_stats.max_hold_usec));
+
+  QList<std::pair<QString, StatementStats>> statements;
+  statements.reserve(statement_stats.count());
+  for (QHash<QString, StatementStats>::const_iterator it = statement_stats.constBegin(); it != statement_stats.constEnd(); ++it) {
+    statements << std::make_pair(it.key(), it.value());
+  }
+  std::sort(statements.begin(), statements.end(), [](const std::pair<QString, StatementStats> &a, const std::pair<QString, StatementStats> &b) { return a.second.total_usec > b.second.total_usec; });
+
+  lines << QString();
+  lines << u"Statements by total time (%1 statements):"_s.arg(statements.count());
+  lines << u"%1 %2 %3 %4 %5 %6 %7 %8 %9  Statement"_s
+             .arg(u"Count"_s, 8)
+             .arg(u"Total ms"_s, 10)
+             .arg(u"Max ms"_s, 8)
+             .arg(u"<0.1ms"_s, 7)
+             .arg(u"<1ms"_s, 7)
+             .arg(u"<10ms"_s, 7)
+             .arg(u"<100ms"_s, 7)
+             .arg(u"<1s"_s, 7)
+             .arg(u">=1s"_s, 7);
+  for (qsizetype i = 0; i < std::min(statements.count(), static_cast<qsizetype>(kMaxReportStatements)); ++i) {
+    const StatementStats &stats = statements[i].second;
+    QString line = u"%1 %2 %3"_s.arg(stats.count, 8).arg(FormatMsec(stats.total_usec), 10).arg(FormatMsec(stats.max_usec), 8);
+    for (const qint64 bucket_count : stats.histogram) {
+      line += u" %1"_s.arg(bucket_count, 7);
+    }
+    lines << line + u"  "_s + statements[i].first.simplified();
+  }
+
+  lines << QString();
+  lines << u"Slow events over %1 ms (%2 events):"_s.arg(FormatMsec(slow_threshold_usec())).arg(slow_events.count());
+  for (const SlowEvent &slow_event : slow_events) {
+    QString line = slow_event.time.toString(u"hh:mm:ss.zzz"_s) + u" "_s + FormatMsec(slow_event.duration_usec) + u" ms "_s;
+    switch (slow_event.type) {
+      case SlowEvent::Type::Query:
+        line += u"query on %1: %2"_s.arg(slow_event.thread_name, slow_event.statement.simplified());
+        break;
+      case SlowEvent::Type::MutexWait:
+        line += u"mutex wait on %1, held by %2"_s.arg(slow_event.thread_name, slow_event.owner_thread_name);
+        break;
+      case SlowEvent::Type::MutexHold:
+        line += u"mutex hold on %1, last statement: %2"_s.arg(slow_event.thread_name, slow_event.statement.isEmpty() ? u"none"_s : slow_event.statement.simplified());
+        break;
+    }
+    lines << line;
+    if (!slow_event.query_plan.isEmpty()) {
+      const QStringList query_plan_lines = slow_event.query_plan.split(u'\n');
+      for (const QString &query_plan_line : query_plan_lines) {
+        lines << u"    "_s + query_plan_line;
+      }
+    }
+  }
+
+  return lines.join(u'\n');
+
+}
+
+void DatabaseStatistics::Reset() {
+
+  QMutexLocker l(&mutex_);
+  statement_stats_.clear();
+  mutex_stats_ = MutexStats();
+  slow_events_.clear();
+
+}
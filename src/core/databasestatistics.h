@@ -0,0 +1,130 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef DATABASESTATISTICS_H
+#define DATABASESTATISTICS_H
+
+#include "config.h"
+
+#include <array>
+#include <atomic>
+
+#include <QtGlobal>
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QDateTime>
+#include <QMutex>
+
+// Statistics for finding out why the database is slow: the latency of each prepared statement,
+// how long the database mutex is waited for and held, and a log of everything slower than a threshold.
+// Nothing is collected until it is enabled from the console.
+class DatabaseStatistics {
+ public:
+  static DatabaseStatistics *Instance();
+
+  // Checked on every query and lock of the database mutex, so disabled statistics cost a relaxed atomic load.
+  static bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+  static void SetEnabled(const bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+
+  // Statement latency buckets: < 0.1 ms, < 1 ms, < 10 ms, < 100 ms, < 1 s and the rest.
+  static constexpr int kHistogramBuckets = 6;
+  static constexpr int kMaxSlowEvents = 100;
+  // Statements after this are counted together, so the statistics can't grow without bound.
+  static constexpr int kMaxStatements = 500;
+
+  struct StatementStats {
+    StatementStats() : count(0), total_usec(0), max_usec(0), histogram{} {}
+    qint64 count;
+    qint64 total_usec;
+    qint64 max_usec;
+    std::array<qint64, kHistogramBuckets> histogram;
+  };
+
+  struct MutexStats {
+    MutexStats() : locks(0), contended_locks(0), total_wait_usec(0), max_wait_usec(0), total_hold_usec(0), max_hold_usec(0) {}
+    qint64 locks;
+    qint64 contended_locks;
+    qint64 total_wait_usec;
+    qint64 max_wait_usec;
+    qint64 total_hold_usec;
+    qint64 max_hold_usec;
+  };
+
+  struct SlowEvent {
+    enum class Type {
+      Query,
+      MutexWait,
+      MutexHold
+    };
+    Type type;
+    QDateTime time;
+    qint64 duration_usec;
+    QString thread_name;
+    // The thread holding the mutex when waiting for it.
+    QString owner_thread_name;
+    // The statement, for a hold the last statement executed while holding the mutex.
+    QString statement;
+    QString query_plan;
+  };
+
+  static int HistogramBucket(const qint64 duration_usec);
+  // Replaces literals and lists of values with ?, so statements built with inlined values are counted together.
+  static QString NormalizeStatement(const QString &statement);
+  static QString OtherStatements();
+
+  qint64 slow_threshold_usec() const { return slow_threshold_usec_.load(std::memory_order_relaxed); }
+  void set_slow_threshold_msec(const int msec) { slow_threshold_usec_.store(static_cast<qint64>(msec) * 1000, std::memory_order_relaxed); }
+
+  // Called by SqlQuery after executing a prepared statement.
+  void AddStatement(const QString &statement, const qint64 duration_usec);
+  void AddSlowQuery(const QString &statement, const qint64 duration_usec, const QString &query_plan);
+
+  // Called by DatabaseMutex.
+  void AddMutexLock(const qint64 wait_usec, const QString &owner_thread_name);
+  void AddMutexHold(const qint64 hold_usec);
+  // Starts a new hold of the mutex by the current thread, forgetting its last statement.
+  static void BeginMutexHold();
+
+  QHash<QString, StatementStats> statement_stats() const;
+  MutexStats mutex_stats() const;
+  QList<SlowEvent> slow_events() const;
+
+  // A plain text summary for the console.
+  QString Report() const;
+  void Reset();
+
+ private:
+  DatabaseStatistics();
+  Q_DISABLE_COPY_MOVE(DatabaseStatistics)
+
+  static std::atomic<bool> sEnabled;
+
+  void AddSlowEvent(const SlowEvent &slow_event);
+
+  std::atomic<qint64> slow_threshold_usec_;
+
+  mutable QMutex mutex_;
+  QHash<QString, StatementStats> statement_stats_;
+  MutexStats mutex_stats_;
+  QList<SlowEvent> slow_events_;
+};
+
+#endif  // DATABASESTATISTICS_H
@@ -73,9 +73,17 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_te
       error_text = QObject::tr("Destination file %1 exists, but not allowed to overwrite.").arg(dest.absoluteFilePath());
       qLog(Error) << error_text;
     }
-    else {
+    else if (Utilities::OnSameFilesystem(src.absoluteFilePath(), dest.absolutePath())) {
       result = QFile::rename(src.absoluteFilePath(), dest.absoluteFilePath());
     }
+    else {
+      // Moving to another filesystem, copy the file and remove the original.
+      result = Utilities::CloneOrCopyFile(src.absoluteFilePath(), dest.absoluteFilePath()) && QFile::remove(src.absoluteFilePath());
+    }
+    if (!result && error_text.isEmpty()) {
+      error_text = QObject::tr("Could not move file %1 to %2.").arg(src.absoluteFilePath(), dest.absoluteFilePath());
+      qLog(Error) << error_text;
+    }
     if ((!cover_dest.exists() || job.overwrite_) && !cover_src.filePath().isEmpty() && !cover_dest.filePath().isEmpty()) {
       QFile::rename(cover_src.absoluteFilePath(), cover_dest.absoluteFilePath());
     }
@@ -93,7 +101,7 @@ bool FilesystemMusicStorage::CopyToStorage(const CopyJob &job, QString &error_te
       qLog(Error) << error_text;
     }
     else {
-      result = QFile::copy(src.absoluteFilePath(), dest.absoluteFilePath());
+      result = Utilities::CloneOrCopyFile(src.absoluteFilePath(), dest.absoluteFilePath());
       if (!result) {
         error_text = QObject::tr("Could not copy file %1 to %2.").arg(src.absoluteFilePath(), dest.absoluteFilePath());
         qLog(Error) << error_text;
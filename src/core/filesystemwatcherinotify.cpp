@@ -25,17 +25,35 @@
 #include <cerrno>
 #include <cstring>
 #include <vector>
+#include <utility>
+#include <chrono>
 
 #include <QFile>
 #include <QFileInfo>
+#include <QList>
+#include <QSet>
+#include <QTimer>
 
 #include "logging.h"
 #include "filesystemwatcherinotify.h"
 
+using namespace std::chrono_literals;
+
+namespace {
+// How long an IN_MOVED_FROM waits for its IN_MOVED_TO, after that the file was moved out of the watched directories.
+constexpr auto kMovesTimeout = 500ms;
+}  // namespace
+
 FileSystemWatcherInotify::FileSystemWatcherInotify(QObject *parent)
     : FileSystemWatcherInterface(parent),
       inotify_fd_(-1),
-      socket_notifier_(nullptr) {
+      socket_notifier_(nullptr),
+      overflows_(0),
+      moves_timer_(new QTimer(this)) {
+
+  moves_timer_->setSingleShot(true);
+  moves_timer_->setInterval(kMovesTimeout);
+  QObject::connect(moves_timer_, &QTimer::timeout, this, &FileSystemWatcherInotify::MovesTimeout);
 
   inotify_fd_ = ::inotify_init1(IN_CLOEXEC);
   if (inotify_fd_ == -1) {
@@ -69,6 +87,7 @@ void FileSystemWatcherInotify::AddPaths(const QStringList &paths) {
     return;
   }
 
+  const qsizetype failed_paths_before = failed_paths_.count();
   for (const QString &path : paths) {
     if (wd_from_path_.contains(path)) {
       qLog(Warning) << "Already watching path" << path;
@@ -77,13 +96,26 @@ void FileSystemWatcherInotify::AddPaths(const QStringList &paths) {
     const QByteArray encoded_path = QFile::encodeName(path);
     const int result = ::inotify_add_watch(inotify_fd_, encoded_path.constData(), (IN_CREATE | IN_ATTRIB | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVE | IN_MOVE_SELF | IN_DELETE | IN_DELETE_SELF));
     if (result == -1) {
-      qLog(Error) << "Failed to add inotify watch for path" << path << strerror(errno);
+      const int error = errno;
+      // Only log the first failure, with a large collection every following path fails the same way.
+      if (failed_paths_.count() == failed_paths_before) {
+        qLog(Error) << "Failed to add inotify watch for path" << path << strerror(error);
+        if (error == ENOSPC) {
+          qLog(Error) << "The inotify watch limit was reached, increase fs.inotify.max_user_watches to watch the whole collection.";
+        }
+      }
+      failed_paths_.insert(path);
       continue;
     }
+    failed_paths_.remove(path);
     path_from_wd_.insert(result, path);
     wd_from_path_.insert(path, result);
   }
 
+  if (failed_paths_.count() > failed_paths_before) {
+    qLog(Warning) << failed_paths_.count() << "paths are not watched, changes in them are only found by scanning.";
+  }
+
 }
 
 void FileSystemWatcherInotify::AddPath(const QString &path) {
@@ -100,6 +132,7 @@ void FileSystemWatcherInotify::RemovePaths(const QStringList &paths) {
   }
 
   for (const QString &path : paths) {
+    failed_paths_.remove(path);
     if (!wd_from_path_.contains(path)) {
       continue;
     }
@@ -125,6 +158,8 @@ void FileSystemWatcherInotify::RemovePath(const QString &path) {
 void FileSystemWatcherInotify::Clear() {
 
   RemovePaths(path_from_wd_.values());
+  failed_paths_.clear();
+  overflows_ = 0;
 
 }
 
@@ -153,20 +188,18 @@ void FileSystemWatcherInotify::InotifyRead() {
   char *pos = buffer.data();
   char *const end = pos + read_buffer_size;
 
-  QMap<int, inotify_event*> events;
+  bool overflow = false;
+  QList<QString> changed_paths;
+  QSet<QString> changed_files;
   while (pos < end) {
-    inotify_event *event = reinterpret_cast<inotify_event*>(pos);
-    if (events.contains(event->wd)) {
-      events[event->wd]->mask |= event->mask;
-    }
-    else {
-      events.insert(event->wd, event);
+    const inotify_event &event = *reinterpret_cast<inotify_event*>(pos);
+    pos += sizeof(inotify_event) + event.len;
+
+    if ((event.mask & IN_Q_OVERFLOW) != 0) {
+      overflow = true;
+      continue;
     }
-    pos += sizeof(inotify_event) + event->len;
-  }
 
-  for (QMap<int, inotify_event*>::const_iterator it = events.constBegin(); it != events.constEnd(); ++it) {
-    const inotify_event &event = **it;
     const int wd = event.wd;
     if (!path_from_wd_.contains(wd)) {
       // No path is associated with this descriptor.
@@ -191,10 +224,66 @@ void FileSystemWatcherInotify::InotifyRead() {
       wd_from_path_.remove(path);
     }
 
+    // Events without a name are about the directory itself, and changes to subdirectories need the directory scanned to pick up new or removed subdirectories.
     // Report the change, except for a bare IN_IGNORED which only signals that the watch went away.
-    if (!ignored || self_gone) {
-      Q_EMIT PathChanged(path);
+    if (event.len == 0 || (event.mask & IN_ISDIR) != 0) {
+      if ((!ignored || self_gone) && !changed_paths.contains(path)) {
+        changed_paths << path;
+      }
+      continue;
     }
+
+    const QString filename = path + u'/' + QFile::decodeName(QByteArray(event.name));
+
+    if ((event.mask & IN_MOVED_FROM) != 0) {
+      changed_files.remove(filename);
+      pending_moves_.insert(event.cookie, filename);
+    }
+    else if ((event.mask & IN_MOVED_TO) != 0) {
+      changed_files.remove(filename);
+      if (pending_moves_.contains(event.cookie)) {
+        Q_EMIT FileMoved(pending_moves_.take(event.cookie), filename);
+      }
+      else {
+        // Moved in from outside the watched directories.
+        Q_EMIT FileChanged(filename);
+      }
+    }
+    else if ((event.mask & IN_DELETE) != 0) {
+      changed_files.remove(filename);
+      Q_EMIT FileRemoved(filename);
+    }
+    else if ((event.mask & (IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB)) != 0) {
+      // A file being written causes many IN_MODIFY events, only report it once for each read.
+      if (!changed_files.contains(filename)) {
+        changed_files.insert(filename);
+        Q_EMIT FileChanged(filename);
+      }
+    }
+  }
+
+  if (!pending_moves_.isEmpty() && !moves_timer_->isActive()) {
+    moves_timer_->start();
+  }
+
+  for (const QString &path : std::as_const(changed_paths)) {
+    Q_EMIT PathChanged(path);
+  }
+
+  if (overflow) {
+    ++overflows_;
+    qLog(Warning) << "inotify event queue overflowed, events were lost";
+    Q_EMIT Overflow();
+  }
+
+}
+
+void FileSystemWatcherInotify::MovesTimeout() {
+
+  const QList<QString> filenames = pending_moves_.values();
+  pending_moves_.clear();
+  for (const QString &filename : filenames) {
+    Q_EMIT FileRemoved(filename);
   }
 
 }
@@ -20,11 +20,16 @@
 #ifndef FILESYSTEMWATCHERINOTIFY_H
 #define FILESYSTEMWATCHERINOTIFY_H
 
+#include <QtGlobal>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QSocketNotifier>
 
+class QTimer;
+
 #include "filesystemwatcherinterface.h"
 
 class FileSystemWatcherInotify : public FileSystemWatcherInterface {
@@ -40,14 +45,27 @@ class FileSystemWatcherInotify : public FileSystemWatcherInterface {
   void RemovePath(const QString &path) override;
   void Clear() override;
 
+  // Only while every path is watched and no events were lost, otherwise changes can be missed.
+  bool SupportsFileEvents() const override { return inotify_fd_ != -1 && failed_paths_.isEmpty() && overflows_ == 0; }
+
+  int failed_watches() const { return static_cast<int>(failed_paths_.count()); }
+  int overflows() const { return overflows_; }
+
  private Q_SLOTS:
   void InotifyRead();
+  void MovesTimeout();
 
  private:
   int inotify_fd_;
   QSocketNotifier *socket_notifier_;
   QMap<QString, int> wd_from_path_;
   QMap<int, QString> path_from_wd_;
+  // Paths that could not be watched, usually because fs.inotify.max_user_watches was reached.
+  QSet<QString> failed_paths_;
+  int overflows_;
+  // IN_MOVED_FROM events waiting for the IN_MOVED_TO with the same cookie.
+  QHash<quint32, QString> pending_moves_;
+  QTimer *moves_timer_;
 };
 
 #endif  // FILESYSTEMWATCHERINOTIFY_H
@@ -36,8 +36,18 @@ class FileSystemWatcherInterface : public QObject {
   virtual void RemovePath(const QString &path) = 0;
   virtual void Clear() = 0;
 
+  // Watchers that support it report changes to single files in the watched directories with FileChanged(), FileRemoved() and FileMoved().
+  // PathChanged() is then only emitted for changes to the directories themselves.
+  // This is false when some paths could not be watched or events were lost, then changes have to be found by scanning.
+  virtual bool SupportsFileEvents() const { return false; }
+
  Q_SIGNALS:
   void PathChanged(const QString &path);
+  void FileChanged(const QString &filename);
+  void FileRemoved(const QString &filename);
+  void FileMoved(const QString &old_filename, const QString &new_filename);
+  // Events were lost, everything watched has to be checked again.
+  void Overflow();
 };
 
 #endif  // FILESYSTEMWATCHERINTERFACE_H
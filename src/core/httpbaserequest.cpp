@@ -95,6 +95,9 @@ QNetworkReply *HttpBaseRequest::CreateGetRequest(const QUrl &url, const QUrlQuer
   if (fake_user_agent_header) {
     network_request.setHeader(QNetworkRequest::UserAgentHeader, u"Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/148.0.0.0 Safari/537.36"_s);
   }
+  if (metadata_cache_ttl() > 0) {
+    network_request.setAttribute(NetworkAccessManager::kMetadataCacheTtlAttribute, metadata_cache_ttl());
+  }
   QNetworkReply *reply = network_->get(network_request);
   QObject::connect(reply, &QNetworkReply::sslErrors, this, &HttpBaseRequest::HandleSSLErrors);
   replies_ << reply;
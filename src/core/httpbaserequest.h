@@ -85,6 +85,8 @@ class HttpBaseRequest : public QObject {
   virtual bool authenticated() const = 0;
   virtual bool use_authorization_header() const = 0;
   virtual QByteArray authorization_header() const = 0;
+  // Seconds GET responses are served from the metadata response cache, see NetworkAccessManager::kMetadataCacheTtlAttribute. 0 disables it.
+  virtual qint64 metadata_cache_ttl() const { return 0; }
 
   virtual QNetworkReply *CreateGetRequest(const QUrl &url, const bool fake_user_agent_header);
   virtual QNetworkReply *CreateGetRequest(const QUrl &url, const ParamList &params = ParamList(), const bool fake_user_agent_header = false);
@@ -317,7 +317,7 @@ MainWindow::MainWindow(Application *app,
       discord_rich_presence_(discord_rich_presence),
 #endif
       console_([app, this]() {
-        Console *console = new Console(app->database());
+        Console *console = new Console(app->database(), app->player());
         QObject::connect(console, &Console::Error, this, &MainWindow::ShowErrorDialog);
         return console;
       }),
@@ -348,8 +348,8 @@ MainWindow::MainWindow(Application *app,
         dialog->SetDestinationModel(app->collection()->model()->directory_model());
         return dialog;
       }),
-      transcode_dialog_([this]() {
-        TranscodeDialog *dialog = new TranscodeDialog(this);
+      transcode_dialog_([this, app]() {
+        TranscodeDialog *dialog = new TranscodeDialog(app->task_manager(), this);
         return dialog;
       }),
       add_stream_dialog_([this]() {
@@ -1617,6 +1617,10 @@ void MainWindow::SongChanged(const Song &song) {
 
   SendNowPlaying();
 
+  if (Playlist *playlist = app_->playlist_manager()->active()) {
+    context_view_->PrefetchLyrics(playlist->UpcomingSongs(ContextView::kLyricsPrefetchSongs));
+  }
+
   const bool enable_change_art = song.is_local_collection_song() && !song.effective_albumartist().isEmpty() && !song.album().isEmpty();
   album_cover_choice_controller_->show_cover_action()->setEnabled(song.has_valid_art() && !song.art_unset());
   album_cover_choice_controller_->cover_to_file_action()->setEnabled(song.has_valid_art() && !song.art_unset());
@@ -88,10 +88,23 @@ class MusicStorage {
   virtual Song::FileType GetTranscodeFormat() const { return Song::FileType::Unknown; }
   virtual bool GetSupportedFiletypes(QList<Song::FileType> *ret) { Q_UNUSED(ret); return true; }
 
+  // Whether CopyToStorage() can be called for several jobs at once from different threads.
+  virtual bool SupportsParallelCopy() const { return false; }
+
   virtual bool StartCopy(QList<Song::FileType> *supported_types) { Q_UNUSED(supported_types); return true; }
   virtual bool CopyToStorage(const CopyJob &job, QString &error_text) = 0;
   virtual bool FinishCopy(bool success, QString &error_text) { Q_UNUSED(error_text); return success; }
 
+  // Storages with a batch size above 0 get their files in batches, CommitCopyBatch() is called after each batch to write the metadata of the copied files.
+  // Originals of moved files should only be removed once their batch is committed.
+  virtual int CopyBatchSize() const { return 0; }
+  virtual bool CommitCopyBatch(QString &error_text) { Q_UNUSED(error_text); return true; }
+
+  // Identifies the storage in the journal used to resume interrupted batched transfers.
+  virtual QString TransferJournalId() const { return QString(); }
+  // Whether a song with this metadata is on the storage, storages that can't tell return false.
+  virtual bool ContainsSong(const Song &metadata) { Q_UNUSED(metadata); return false; }
+
   virtual void StartDelete() {}
   virtual bool DeleteFromStorage(const DeleteJob &job) = 0;
   virtual bool FinishDelete(bool success, QString &error_text) { Q_UNUSED(error_text); return success; }
@@ -21,6 +21,8 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QtGlobal>
 #include <QCoreApplication>
 #include <QIODevice>
@@ -30,12 +32,22 @@
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QNetworkInformation>
+#include <QAbstractNetworkCache>
+#include <QNetworkCacheMetaData>
+#include <QDateTime>
+#include <QUrl>
 
 #include "networkaccessmanager.h"
 #include "threadsafenetworkdiskcache.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+std::atomic<quint64> metadata_cache_hits = 0;
+std::atomic<quint64> metadata_cache_revalidated = 0;
+std::atomic<quint64> metadata_cache_misses = 0;
+}  // namespace
+
 NetworkAccessManager::NetworkAccessManager(QObject *parent)
     : QNetworkAccessManager(parent) {
 
@@ -87,6 +99,61 @@ QNetworkReply *NetworkAccessManager::createRequest(Operation op, const QNetworkR
     new_network_request.setTransferTimeout(QNetworkRequest::DefaultTransferTimeoutConstant);
   }
 
-  return QNetworkAccessManager::createRequest(op, new_network_request, outgoing_data);
+  const qint64 metadata_cache_ttl = op == QNetworkAccessManager::GetOperation && cache() ? network_request.attribute(kMetadataCacheTtlAttribute).toLongLong() : 0;
+  bool metadata_cache_expired = false;
+  bool metadata_cache_store = false;
+  if (metadata_cache_ttl > 0) {
+    const QNetworkCacheMetaData cache_metadata = cache()->metaData(new_network_request.url());
+    if (cache_metadata.isValid() && cache_metadata.expirationDate().isValid() && cache_metadata.expirationDate() > QDateTime::currentDateTimeUtc()) {
+      new_network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysCache);
+    }
+    else {
+      // Qt sends the ETag and Last-Modified of an expired entry along, and loads it from the cache if the server answers 304 Not Modified.
+      metadata_cache_expired = cache_metadata.isValid();
+      new_network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
+      ThreadSafeNetworkDiskCache::SetTimeToLive(new_network_request.url(), metadata_cache_ttl);
+      metadata_cache_store = true;
+    }
+  }
+
+  QNetworkReply *reply = QNetworkAccessManager::createRequest(op, new_network_request, outgoing_data);
+
+  if (metadata_cache_ttl > 0) {
+    const QUrl url = new_network_request.url();
+    QObject::connect(reply, &QNetworkReply::finished, this, [reply, url, metadata_cache_expired, metadata_cache_store]() {
+      if (metadata_cache_store) {
+        ThreadSafeNetworkDiskCache::ClearTimeToLive(url);
+      }
+      if (!reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+        ++metadata_cache_misses;
+      }
+      else if (metadata_cache_expired) {
+        ++metadata_cache_revalidated;
+      }
+      else {
+        ++metadata_cache_hits;
+      }
+    });
+  }
+
+  return reply;
+
+}
+
+void NetworkAccessManager::RemoveFromMetadataCache(QNetworkReply *reply) {
+
+  if (!cache() || reply->operation() != QNetworkAccessManager::GetOperation || reply->request().attribute(kMetadataCacheTtlAttribute).toLongLong() <= 0) return;
+
+  cache()->remove(reply->request().url());
+
+}
+
+NetworkAccessManager::MetadataCacheStats NetworkAccessManager::metadata_cache_stats() {
+
+  MetadataCacheStats stats;
+  stats.hits = metadata_cache_hits;
+  stats.revalidated = metadata_cache_revalidated;
+  stats.misses = metadata_cache_misses;
+  return stats;
 
 }
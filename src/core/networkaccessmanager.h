@@ -24,6 +24,7 @@
 
 #include "config.h"
 
+#include <QtGlobal>
 #include <QObject>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
@@ -37,6 +38,24 @@ class NetworkAccessManager : public QNetworkAccessManager {
  public:
   explicit NetworkAccessManager(QObject *parent = nullptr);
 
+  // Opts a GET request in to the metadata response cache: the value is the number of seconds a response is used without asking the server again, regardless of the servers caching headers.
+  // After that, the cached response is revalidated with If-None-Match or If-Modified-Since and reused if the server answers 304 Not Modified.
+  static constexpr QNetworkRequest::Attribute kMetadataCacheTtlAttribute = static_cast<QNetworkRequest::Attribute>(QNetworkRequest::User + 1);
+
+  class MetadataCacheStats {
+   public:
+    MetadataCacheStats() : hits(0), revalidated(0), misses(0) {}
+    quint64 hits;
+    quint64 revalidated;
+    quint64 misses;
+  };
+
+  // Counters for all opted in requests since startup.
+  static MetadataCacheStats metadata_cache_stats();
+
+  // Removes the cached response of an opted in request, for replies that turned out to hold an error instead of a result.
+  void RemoveFromMetadataCache(QNetworkReply *reply);
+
  protected:
   QNetworkReply *createRequest(Operation op, const QNetworkRequest &network_request, QIODevice *outgoing_data) override;
 };
@@ -44,6 +44,7 @@
 #include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/settings.h"
 #include "core/song.h"
 #include "core/urlhandlers.h"
@@ -265,6 +266,8 @@ void Player::ResumePlayback() {
 
 void Player::HandleLoadResult(const UrlHandler::LoadResult &result) {
 
+  TRACE_SCOPE("player", "Handle load result");
+
   if (loading_async_.contains(result.media_url_)) {
     loading_async_.removeAll(result.media_url_);
   }
@@ -398,6 +401,8 @@ void Player::Next() { NextInternal(EngineBase::TrackChangeType::Manual, Playlist
 
 void Player::NextInternal(const EngineBase::TrackChangeFlags change, const Playlist::AutoScroll autoscroll) {
 
+  TRACE_SCOPE("player", "Next");
+
   pause_time_ = QDateTime();
   play_offset_nanosec_ = 0;
 
@@ -516,6 +521,8 @@ void Player::TrackEnded() {
 
 void Player::PlayPause(const quint64 offset_nanosec, const Playlist::AutoScroll autoscroll) {
 
+  TRACE_SCOPE("player", "Play/pause");
+
   switch (engine_->state()) {
     case EngineBase::State::Paused:
       UnPause();
@@ -737,6 +744,8 @@ void Player::VolumeDown() {
 
 void Player::PlayAt(const int index, const bool pause, const quint64 offset_nanosec, EngineBase::TrackChangeFlags change, const Playlist::AutoScroll autoscroll, const bool reshuffle, const bool force_inform) {
 
+  TRACE_SCOPE("player", "Play at");
+
   pause_time_ = pause ? QDateTime::currentDateTime() : QDateTime();
   play_offset_nanosec_ = offset_nanosec;
 
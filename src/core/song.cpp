@@ -50,6 +50,7 @@
 #include <taglib/tstring.h>
 
 #include "core/standardpaths.h"
+#include "core/stringpool.h"
 #include "core/iconloader.h"
 #include "core/enginemetadata.h"
 #include "utilities/strutils.h"
@@ -1552,23 +1553,23 @@ void Song::InitFromQuery(const QSqlRecord &r, const bool reliable_metadata, cons
 
   set_title(SqlHelper::ValueToString(r, ColumnIndex(u"title"_s) + col));
   set_titlesort(SqlHelper::ValueToString(r, ColumnIndex(u"titlesort"_s) + col));
-  set_album(SqlHelper::ValueToString(r, ColumnIndex(u"album"_s) + col));
-  set_albumsort(SqlHelper::ValueToString(r, ColumnIndex(u"albumsort"_s) + col));
-  set_artist(SqlHelper::ValueToString(r, ColumnIndex(u"artist"_s) + col));
-  set_artistsort(SqlHelper::ValueToString(r, ColumnIndex(u"artistsort"_s) + col));
-  set_albumartist(SqlHelper::ValueToString(r, ColumnIndex(u"albumartist"_s) + col));
-  set_albumartistsort(SqlHelper::ValueToString(r, ColumnIndex(u"albumartistsort"_s) + col));
+  d->album_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"album"_s) + col));
+  d->albumsort_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"albumsort"_s) + col));
+  d->artist_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"artist"_s) + col));
+  d->artistsort_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"artistsort"_s) + col));
+  d->albumartist_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"albumartist"_s) + col));
+  d->albumartistsort_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"albumartistsort"_s) + col));
   d->track_ = SqlHelper::ValueToInt(r, ColumnIndex(u"track"_s) + col);
   d->disc_ = SqlHelper::ValueToInt(r, ColumnIndex(u"disc"_s) + col);
   d->year_ = SqlHelper::ValueToInt(r, ColumnIndex(u"year"_s) + col);
   d->originalyear_ = SqlHelper::ValueToInt(r, ColumnIndex(u"originalyear"_s) + col);
-  d->genre_ = SqlHelper::ValueToString(r, ColumnIndex(u"genre"_s) + col);
+  d->genre_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"genre"_s) + col));
   d->compilation_ = r.value(ColumnIndex(u"compilation"_s) + col).toBool();
-  d->composer_ = SqlHelper::ValueToString(r, ColumnIndex(u"composer"_s) + col);
-  d->composersort_ = SqlHelper::ValueToString(r, ColumnIndex(u"composersort"_s) + col);
-  d->performer_ = SqlHelper::ValueToString(r, ColumnIndex(u"performer"_s) + col);
-  d->performersort_ = SqlHelper::ValueToString(r, ColumnIndex(u"performersort"_s) + col);
-  d->grouping_ = SqlHelper::ValueToString(r, ColumnIndex(u"grouping"_s) + col);
+  d->composer_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"composer"_s) + col));
+  d->composersort_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"composersort"_s) + col));
+  d->performer_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"performer"_s) + col));
+  d->performersort_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"performersort"_s) + col));
+  d->grouping_ = StringPool::Intern(SqlHelper::ValueToString(r, ColumnIndex(u"grouping"_s) + col));
   d->comment_ = SqlHelper::ValueToString(r, ColumnIndex(u"comment"_s) + col);
   d->lyrics_ = SqlHelper::ValueToString(r, ColumnIndex(u"lyrics"_s) + col);
   d->artist_id_ = SqlHelper::ValueToString(r, ColumnIndex(u"artist_id"_s) + col);
@@ -22,6 +22,7 @@
 #include "config.h"
 
 #include <algorithm>
+#include <utility>
 
 #include <gst/gst.h>
 
@@ -34,6 +35,8 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QSet>
+#include <QHash>
+#include <QList>
 #include <QTimer>
 #include <QString>
 #include <QUrl>
@@ -236,15 +239,18 @@ SongLoader::Result SongLoader::LoadLocal(const QString &filename) {
   // Search in the database.
   const QUrl url = QUrl::fromLocalFile(filename);
 
-  SongList songs = collection_backend_->GetSongsByUrl(url);
-  if (!songs.isEmpty()) {
-    songs_ = songs;
-    return Result::Success;
+  SongList songs;
+  if (collection_backend_->MayContainUrl(url)) {
+    songs = collection_backend_->GetSongsByUrl(url);
+    if (!songs.isEmpty()) {
+      songs_ = songs;
+      return Result::Success;
+    }
   }
 
   const QString canonical_filepath = QFileInfo(filename).canonicalFilePath();
-  if (!canonical_filepath.isEmpty() && canonical_filepath != filename) {
-    const QUrl canonical_filepath_url = QUrl::fromLocalFile(canonical_filepath);
+  const QUrl canonical_filepath_url = QUrl::fromLocalFile(canonical_filepath);
+  if (!canonical_filepath.isEmpty() && canonical_filepath != filename && collection_backend_->MayContainUrl(canonical_filepath_url)) {
     songs = collection_backend_->GetSongsByUrl(canonical_filepath_url);
     if (!songs.isEmpty()) {
       songs_ = songs;
@@ -332,23 +338,49 @@ SongLoader::Result SongLoader::LoadLocalAsync(const QString &filename) {
 
 void SongLoader::LoadMetadataBlocking() {
 
+  // Look up the songs that can be in the collection with one query, instead of a query for each song.
+  QList<QUrl> urls;
+  for (const Song &song : std::as_const(songs_)) {
+    if (NeedsEffectiveSongLoad(song) && collection_backend_->MayContainUrl(song.url())) {
+      urls << song.url();
+    }
+  }
+
+  QHash<QString, Song> collection_songs;
+  if (!urls.isEmpty()) {
+    const SongList songs = collection_backend_->GetSongsByUrls(urls);
+    for (const Song &song : songs) {
+      if (song.beginning_nanosec() == 0) {
+        collection_songs.insert(CollectionBackendInterface::UrlKey(song.url()), song);
+      }
+    }
+  }
+
   for (int i = 0; i < songs_.size(); i++) {
-    EffectiveSongLoad(&songs_[i]);
+    EffectiveSongLoad(&songs_[i], &collection_songs);
   }
 
 }
 
-void SongLoader::EffectiveSongLoad(Song *song) {
+bool SongLoader::NeedsEffectiveSongLoad(const Song &song) {
 
-  if (!song || !song->url().isLocalFile()) return;
+  // Maybe we loaded the metadata already, for example from a cuesheet.
+  return song.url().isLocalFile() && !(song.init_from_file() && song.filetype() != Song::FileType::Unknown);
 
-  if (song->init_from_file() && song->filetype() != Song::FileType::Unknown) {
-    // Maybe we loaded the metadata already, for example from a cuesheet.
-    return;
-  }
+}
+
+void SongLoader::EffectiveSongLoad(Song *song, const QHash<QString, Song> *collection_songs) {
+
+  if (!song || !NeedsEffectiveSongLoad(*song)) return;
 
   // First, try to get the song from the collection
-  Song collection_song = collection_backend_->GetSongByUrl(song->url());
+  Song collection_song;
+  if (collection_songs) {
+    collection_song = collection_songs->value(CollectionBackendInterface::UrlKey(song->url()));
+  }
+  else if (collection_backend_->MayContainUrl(song->url())) {
+    collection_song = collection_backend_->GetSongByUrl(song->url());
+  }
   if (collection_song.is_valid()) {
     *song = collection_song;
   }
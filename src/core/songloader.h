@@ -34,6 +34,7 @@
 #include <QThreadPool>
 #include <QByteArray>
 #include <QSet>
+#include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
@@ -118,7 +119,8 @@ class SongLoader : public QObject {
 
   Result LoadLocal(const QString &filename);
   SongLoader::Result LoadLocalAsync(const QString &filename);
-  void EffectiveSongLoad(Song *song);
+  static bool NeedsEffectiveSongLoad(const Song &song);
+  void EffectiveSongLoad(Song *song, const QHash<QString, Song> *collection_songs = nullptr);
   Result LoadLocalPartial(const QString &filename);
   void LoadLocalDirectory(const QString &filename);
   void LoadPlaylist(ParserBase *parser, const QString &filename);
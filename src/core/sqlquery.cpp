@@ -22,12 +22,57 @@
 #include <QMap>
 #include <QVariant>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
-
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include "includes/scoped_ptr.h"
+#include "core/databasestatistics.h"
+#include "database.h"
 #include "sqlquery.h"
 
 using namespace Qt::Literals::StringLiterals;
 
+SqlQuery::~SqlQuery() {
+
+  if (!database_ || lastQuery() != prepared_query_) return;
+
+  // Reset the statement, so it doesn't keep the database locked while it's waiting to be reused.
+  finish();
+  database_->ReturnPreparedQuery(db_, prepared_query_, *this);
+
+}
+
+bool SqlQuery::PrepareCached(Database *database, const QString &query) {
+
+  database_ = nullptr;
+  prepared_query_.clear();
+
+  ScopedPtr<QSqlQuery> prepared_query = database->TakePreparedQuery(db_, query);
+  if (prepared_query) {
+    const bool forward_only = isForwardOnly();
+    QSqlQuery::operator=(*prepared_query);
+    setForwardOnly(forward_only);
+    // Clear the values bound by the last user of the statement.
+    const qsizetype bound_values_count = boundValues().count();
+    for (qsizetype i = 0; i < bound_values_count; ++i) {
+      bindValue(static_cast<int>(i), QVariant());
+    }
+  }
+  else if (!prepare(query)) {
+    return false;
+  }
+
+  database_ = database;
+  prepared_query_ = query;
+
+  return true;
+
+}
+
 void SqlQuery::BindValue(const QString &placeholder, const QVariant &value) {
 
   bound_values_.insert(placeholder, value);
@@ -92,20 +137,60 @@ void SqlQuery::BindNotNullIntValue(const QString &placeholder, const int value)
 
 bool SqlQuery::Exec() {
 
-  bool success = exec();
-  last_query_ = executedQuery();
+  const bool statistics_enabled = DatabaseStatistics::IsEnabled();
+  QElapsedTimer timer;
+  if (statistics_enabled) timer.start();
 
-  for (QMap<QString, QVariant>::const_iterator it = bound_values_.constBegin(); it != bound_values_.constEnd(); ++it) {
-    last_query_.replace(it.key(), it.value().toString());
-  }
+  const bool success = exec();
+  const qint64 duration_usec = statistics_enabled ? timer.nsecsElapsed() / 1000 : 0;
+
+  last_bound_values_ = bound_values_;
   bound_values_.clear();
 
+  if (!statistics_enabled) return success;
+
+  // Statements are counted by the prepared query, so the same statement with different values is counted together.
+  DatabaseStatistics *statistics = DatabaseStatistics::Instance();
+  statistics->AddStatement(lastQuery(), duration_usec);
+  if (success && duration_usec >= statistics->slow_threshold_usec()) {
+    statistics->AddSlowQuery(LastQuery(), duration_usec, LastQueryPlan());
+  }
+
   return success;
 
 }
 
 QString SqlQuery::LastQuery() const {
 
-  return last_query_;
+  QString last_query = executedQuery();
+  for (QMap<QString, QVariant>::const_iterator it = last_bound_values_.constBegin(); it != last_bound_values_.constEnd(); ++it) {
+    last_query.replace(it.key(), it.value().toString());
+  }
+
+  return last_query;
+
+}
+
+QString SqlQuery::LastQueryPlan() const {
+
+  const QString last_query = lastQuery();
+  if (last_query.startsWith("EXPLAIN"_L1, Qt::CaseInsensitive)) return QString();
+
+  QSqlQuery query(db_);
+  if (!query.prepare("EXPLAIN QUERY PLAN "_L1 + last_query)) return QString();
+  for (QMap<QString, QVariant>::const_iterator it = last_bound_values_.constBegin(); it != last_bound_values_.constEnd(); ++it) {
+    query.bindValue(it.key(), it.value());
+  }
+  if (!query.exec()) return QString();
+
+  const int detail_column = query.record().indexOf("detail"_L1);
+  if (detail_column == -1) return QString();
+
+  QStringList query_plan;
+  while (query.next()) {
+    query_plan << query.value(detail_column).toString();
+  }
+
+  return query_plan.join(u'\n');
 
 }
@@ -31,10 +31,17 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 
+class Database;
+
 class SqlQuery : public QSqlQuery {
 
  public:
-  explicit SqlQuery(const QSqlDatabase &db) : QSqlQuery(db) {}
+  explicit SqlQuery(const QSqlDatabase &db) : QSqlQuery(db), db_(db), database_(nullptr) {}
+  ~SqlQuery();
+
+  // Prepares a statement executed repeatedly by batch writes.
+  // The statement is kept by the database for the connection when the query is destroyed, and reused by the next query preparing it.
+  bool PrepareCached(Database *database, const QString &query);
 
   int columns() const { return QSqlQuery::record().count(); }
 
@@ -53,8 +60,18 @@ class SqlQuery : public QSqlQuery {
   QString LastQuery() const;
 
  private:
+  // The query plan of the last query, for the slow query log.
+  QString LastQueryPlan() const;
+
+  Q_DISABLE_COPY_MOVE(SqlQuery)
+
+  QSqlDatabase db_;
+  // The database and statement of PrepareCached(), the statement is returned to the database when the query is destroyed.
+  Database *database_;
+  QString prepared_query_;
   QMap<QString, QVariant> bound_values_;
-  QString last_query_;
+  // The last query with its bound values is only needed for error reporting, so it's built lazily by LastQuery().
+  QMap<QString, QVariant> last_bound_values_;
 };
 
 #endif  // SQLQUERY_H
@@ -0,0 +1,109 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+#include <QSet>
+#include <QString>
+#include <QReadWriteLock>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include "stringpool.h"
+
+namespace {
+
+// Longer strings are rarely repeated, so they are not worth the lookup.
+constexpr qsizetype kMaxInternLength = 256;
+constexpr qsizetype kMinPruneCount = 1024;
+
+QReadWriteLock *PoolLock() {
+  static QReadWriteLock lock;
+  return &lock;
+}
+
+QSet<QString> *Pool() {
+  static QSet<QString> pool;
+  return &pool;
+}
+
+// The pool is pruned when it reaches this size.
+qsizetype sPruneCount = kMinPruneCount;
+
+// Must be called with the write lock held.
+qsizetype PruneLocked() {
+
+  QSet<QString> *pool = Pool();
+  const qsizetype count = pool->count();
+  for (QSet<QString>::iterator it = pool->begin(); it != pool->end();) {
+    // The pool holds the only reference when no song uses the string anymore.
+    if (it->isDetached()) {
+      it = pool->erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  sPruneCount = std::max(kMinPruneCount, pool->count() * 2);
+
+  return count - pool->count();
+
+}
+
+}  // namespace
+
+QString StringPool::Intern(const QString &str) {
+
+  if (str.isEmpty() || str.length() > kMaxInternLength) return str;
+
+  {
+    QReadLocker l(PoolLock());
+    QSet<QString>::const_iterator it = Pool()->constFind(str);
+    if (it != Pool()->constEnd()) return *it;
+  }
+
+  QWriteLocker l(PoolLock());
+  // Another thread might have added it since the read lock was released.
+  QSet<QString>::const_iterator it = Pool()->constFind(str);
+  if (it != Pool()->constEnd()) return *it;
+
+  if (Pool()->count() >= sPruneCount) {
+    PruneLocked();
+  }
+
+  return *Pool()->insert(str);
+
+}
+
+qsizetype StringPool::Prune() {
+
+  QWriteLocker l(PoolLock());
+  return PruneLocked();
+
+}
+
+qsizetype StringPool::Count() {
+
+  QReadLocker l(PoolLock());
+  return Pool()->count();
+
+}
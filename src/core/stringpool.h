@@ -0,0 +1,45 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QString>
+
+// Process-wide pool of shared strings.
+// Songs loaded from the database use this for text fields that repeat across many songs (artist, album, genre, etc.),
+// so all songs with the same value share one copy of the string data instead of each holding their own.
+// Strings no longer used outside the pool are pruned whenever the pool has doubled in size since it was last pruned.
+class StringPool {
+ public:
+  // Returns a copy of str sharing its data with the pooled string, adding str to the pool if it's not there yet.
+  static QString Intern(const QString &str);
+
+  // Removes the strings only referenced by the pool, returns the number of strings removed.
+  static qsizetype Prune();
+  static qsizetype Count();
+
+ private:
+  StringPool() = default;
+};
+
+#endif  // STRINGPOOL_H
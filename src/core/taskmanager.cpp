@@ -84,6 +84,19 @@ void TaskManager::SetTaskBlocksCollectionScans(const int id) {
 
 }
 
+void TaskManager::SetTaskName(const int id, const QString &name) {
+
+  {
+    QMutexLocker l(&mutex_);
+    if (!tasks_.contains(id)) return;
+
+    tasks_[id].name = name;
+  }
+
+  Q_EMIT TasksChanged();
+
+}
+
 void TaskManager::SetTaskProgress(const int id, const quint64 progress, const quint64 max) {
 
   {
@@ -64,6 +64,7 @@ class TaskManager : public QObject {
 
   int StartTask(const QString &name);
   void SetTaskBlocksCollectionScans(const int id);
+  void SetTaskName(const int id, const QString &name);
   void SetTaskProgress(const int id, const quint64 progress, const quint64 max = 0);
   void IncreaseTaskProgress(const int id, const quint64 progress, const quint64 max = 0);
   void SetTaskFinished(const int id);
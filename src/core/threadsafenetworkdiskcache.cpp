@@ -21,6 +21,8 @@
 
 #include "config.h"
 
+#include <algorithm>
+
 #include <QtGlobal>
 #include <QObject>
 #include <QCoreApplication>
@@ -29,7 +31,12 @@
 #include <QNetworkDiskCache>
 #include <QNetworkCacheMetaData>
 #include <QAbstractNetworkCache>
+#include <QDateTime>
+#include <QByteArray>
+#include <QHash>
 #include <QUrl>
+#include <QVariant>
+#include <QNetworkRequest>
 
 #include "standardpaths.h"
 #include "threadsafenetworkdiskcache.h"
@@ -39,6 +46,7 @@ using namespace Qt::Literals::StringLiterals;
 QMutex ThreadSafeNetworkDiskCache::sMutex;
 int ThreadSafeNetworkDiskCache::sInstances = 0;
 QNetworkDiskCache *ThreadSafeNetworkDiskCache::sCache = nullptr;
+QHash<QUrl, ThreadSafeNetworkDiskCache::TimeToLive> ThreadSafeNetworkDiskCache::sTimeToLive;
 
 ThreadSafeNetworkDiskCache::ThreadSafeNetworkDiskCache(QObject *parent) : QAbstractNetworkCache(parent) {
 
@@ -90,7 +98,7 @@ QNetworkCacheMetaData ThreadSafeNetworkDiskCache::metaData(const QUrl &url) {
 
 QIODevice *ThreadSafeNetworkDiskCache::prepare(const QNetworkCacheMetaData &metaData) {
   QMutexLocker l(&sMutex);
-  return sCache->prepare(metaData);
+  return sCache->prepare(ApplyTimeToLive(metaData));
 }
 
 bool ThreadSafeNetworkDiskCache::remove(const QUrl &url) {
@@ -100,7 +108,55 @@ bool ThreadSafeNetworkDiskCache::remove(const QUrl &url) {
 
 void ThreadSafeNetworkDiskCache::updateMetaData(const QNetworkCacheMetaData &metaData) {
   QMutexLocker l(&sMutex);
-  sCache->updateMetaData(metaData);
+  sCache->updateMetaData(ApplyTimeToLive(metaData));
+}
+
+void ThreadSafeNetworkDiskCache::SetTimeToLive(const QUrl &url, const qint64 seconds) {
+
+  QMutexLocker l(&sMutex);
+  TimeToLive &time_to_live = sTimeToLive[url];
+  time_to_live.seconds = std::max(time_to_live.seconds, seconds);
+  ++time_to_live.requests;
+
+}
+
+void ThreadSafeNetworkDiskCache::ClearTimeToLive(const QUrl &url) {
+
+  QMutexLocker l(&sMutex);
+  QHash<QUrl, TimeToLive>::iterator it = sTimeToLive.find(url);
+  if (it != sTimeToLive.end() && --it->requests <= 0) {
+    sTimeToLive.erase(it);
+  }
+
+}
+
+QNetworkCacheMetaData ThreadSafeNetworkDiskCache::ApplyTimeToLive(const QNetworkCacheMetaData &metadata) {
+
+  if (sTimeToLive.isEmpty()) return metadata;
+
+  QHash<QUrl, TimeToLive>::const_iterator it = sTimeToLive.constFind(metadata.url());
+  if (it == sTimeToLive.constEnd()) return metadata;
+
+  // Only pin successful responses, anything else follows the servers caching headers.
+  const QVariant http_status_code = metadata.attributes().value(QNetworkRequest::HttpStatusCodeAttribute);
+  if (http_status_code.isValid() && http_status_code.toInt() != 200) return metadata;
+
+  QNetworkCacheMetaData new_metadata(metadata);
+  new_metadata.setSaveToDisk(true);
+  new_metadata.setExpirationDate(QDateTime::currentDateTimeUtc().addSecs(it->seconds));
+
+  // Drop the caching directives of the server so they don't stop the response from being stored or reused, keep ETag and Last-Modified for revalidation.
+  QNetworkCacheMetaData::RawHeaderList raw_headers;
+  const QNetworkCacheMetaData::RawHeaderList old_raw_headers = metadata.rawHeaders();
+  for (const QNetworkCacheMetaData::RawHeader &raw_header : old_raw_headers) {
+    const QByteArray name = raw_header.first.toLower();
+    if (name == "cache-control" || name == "pragma" || name == "expires" || name == "vary") continue;
+    raw_headers << raw_header;
+  }
+  new_metadata.setRawHeaders(raw_headers);
+
+  return new_metadata;
+
 }
 
 void ThreadSafeNetworkDiskCache::clear() {
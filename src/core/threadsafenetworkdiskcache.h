@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QAbstractNetworkCache>
 #include <QMutex>
+#include <QHash>
 #include <QUrl>
 #include <QNetworkCacheMetaData>
 
@@ -49,6 +50,20 @@ class ThreadSafeNetworkDiskCache : public QAbstractNetworkCache {
   bool remove(const QUrl &url) override;
   void updateMetaData(const QNetworkCacheMetaData &metaData) override;
 
+  // Successful responses for the URL are stored with this lifetime instead of following the servers caching headers.
+  // Each call to SetTimeToLive() needs a matching ClearTimeToLive(), so concurrent requests for the same URL don't clear each others lifetime.
+  static void SetTimeToLive(const QUrl &url, const qint64 seconds);
+  static void ClearTimeToLive(const QUrl &url);
+
+ private:
+  struct TimeToLive {
+    TimeToLive() : seconds(0), requests(0) {}
+    qint64 seconds;
+    int requests;
+  };
+
+  static QNetworkCacheMetaData ApplyTimeToLive(const QNetworkCacheMetaData &metadata);
+
  public Q_SLOTS:
   void clear() override;
 
@@ -56,6 +71,7 @@ class ThreadSafeNetworkDiskCache : public QAbstractNetworkCache {
   static QMutex sMutex;
   static int sInstances;
   static QNetworkDiskCache *sCache;
+  static QHash<QUrl, TimeToLive> sTimeToLive;
 };
 
 #endif  // THREADSAFENETWORKDISKCACHE_H
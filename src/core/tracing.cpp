@@ -0,0 +1,233 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QThread>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+#include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "tracing.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+namespace tracing {
+
+std::atomic<bool> sEnabled(false);
+
+namespace {
+
+// The oldest events of a thread are overwritten after this many, so a long trace keeps the most recent part.
+constexpr std::size_t kMaxEventsPerThread = 100000;
+
+struct Event {
+  const char *category;
+  const char *name;
+  qint64 start_usec;
+  qint64 duration_usec;
+};
+
+// The events of one thread, only locked by the thread itself and when exporting.
+struct ThreadBuffer {
+  ThreadBuffer() : thread_id(0), next(0) {}
+  QMutex mutex;
+  quint64 thread_id;
+  QString thread_name;
+  std::vector<Event> events;
+  std::size_t next;
+};
+
+using ThreadBufferPtr = SharedPtr<ThreadBuffer>;
+
+QMutex sBuffersMutex;
+QList<ThreadBufferPtr> sBuffers;
+const std::chrono::steady_clock::time_point sEpoch = std::chrono::steady_clock::now();
+
+ThreadBuffer *CurrentThreadBuffer() {
+
+  thread_local ThreadBufferPtr thread_buffer;
+  if (!thread_buffer) {
+    thread_buffer = make_shared<ThreadBuffer>();
+    thread_buffer->thread_id = reinterpret_cast<quintptr>(QThread::currentThread());
+    thread_buffer->thread_name = CurrentThreadName();
+    QMutexLocker l(&sBuffersMutex);
+    sBuffers << thread_buffer;
+  }
+
+  return &*thread_buffer;
+
+}
+
+}  // namespace
+
+void Start() {
+
+  {
+    QMutexLocker l(&sBuffersMutex);
+    for (const ThreadBufferPtr &thread_buffer : std::as_const(sBuffers)) {
+      QMutexLocker buffer_locker(&thread_buffer->mutex);
+      thread_buffer->events.clear();
+      thread_buffer->next = 0;
+    }
+  }
+
+  sEnabled.store(true, std::memory_order_relaxed);
+
+  qLog(Info) << "Tracing started";
+
+}
+
+void Stop() {
+
+  sEnabled.store(false, std::memory_order_relaxed);
+
+  qLog(Info) << "Tracing stopped," << EventCount() << "events";
+
+}
+
+qint64 NowMicroseconds() {
+
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sEpoch).count();
+
+}
+
+QString CurrentThreadName() {
+
+  QThread *thread = QThread::currentThread();
+  if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+    return u"Main"_s;
+  }
+  if (thread && !thread->objectName().isEmpty()) {
+    return thread->objectName();
+  }
+
+  return u"Thread "_s + QString::number(reinterpret_cast<quintptr>(thread), 16);
+
+}
+
+void AddCompleteEvent(const char *category, const char *name, const qint64 start_usec, const qint64 duration_usec) {
+
+  ThreadBuffer *thread_buffer = CurrentThreadBuffer();
+  QMutexLocker l(&thread_buffer->mutex);
+
+  const Event event { category, name, start_usec, duration_usec };
+  if (thread_buffer->events.size() < kMaxEventsPerThread) {
+    thread_buffer->events.push_back(event);
+  }
+  else {
+    thread_buffer->events[thread_buffer->next] = event;
+    thread_buffer->next = (thread_buffer->next + 1) % kMaxEventsPerThread;
+  }
+
+}
+
+int EventCount() {
+
+  std::size_t count = 0;
+  QMutexLocker l(&sBuffersMutex);
+  for (const ThreadBufferPtr &thread_buffer : std::as_const(sBuffers)) {
+    QMutexLocker buffer_locker(&thread_buffer->mutex);
+    count += thread_buffer->events.size();
+  }
+
+  return static_cast<int>(count);
+
+}
+
+QByteArray ExportChromeTrace() {
+
+  const qint64 pid = QCoreApplication::applicationPid();
+
+  QJsonArray trace_events;
+
+  QMutexLocker l(&sBuffersMutex);
+  for (const ThreadBufferPtr &thread_buffer : std::as_const(sBuffers)) {
+    QMutexLocker buffer_locker(&thread_buffer->mutex);
+    if (thread_buffer->events.empty()) continue;
+
+    const qint64 tid = static_cast<qint64>(thread_buffer->thread_id & 0xFFFFFFFF);
+
+    QJsonObject thread_name_event;
+    thread_name_event["name"_L1] = u"thread_name"_s;
+    thread_name_event["ph"_L1] = u"M"_s;
+    thread_name_event["pid"_L1] = pid;
+    thread_name_event["tid"_L1] = tid;
+    thread_name_event["args"_L1] = QJsonObject { { u"name"_s, thread_buffer->thread_name } };
+    trace_events << thread_name_event;
+
+    for (const Event &event : thread_buffer->events) {
+      QJsonObject trace_event;
+      trace_event["name"_L1] = QString::fromLatin1(event.name);
+      trace_event["cat"_L1] = QString::fromLatin1(event.category);
+      trace_event["ph"_L1] = u"X"_s;
+      trace_event["ts"_L1] = event.start_usec;
+      trace_event["dur"_L1] = event.duration_usec;
+      trace_event["pid"_L1] = pid;
+      trace_event["tid"_L1] = tid;
+      trace_events << trace_event;
+    }
+  }
+
+  QJsonObject trace;
+  trace["traceEvents"_L1] = trace_events;
+  trace["displayTimeUnit"_L1] = u"ms"_s;
+
+  return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+
+}
+
+bool SaveChromeTrace(const QString &filename) {
+
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qLog(Error) << "Could not open" << filename << "for writing:" << file.errorString();
+    return false;
+  }
+
+  const QByteArray data = ExportChromeTrace();
+  if (file.write(data) != data.size()) {
+    qLog(Error) << "Could not write trace to" << filename << ":" << file.errorString();
+    return false;
+  }
+  file.close();
+
+  qLog(Info) << "Wrote trace to" << filename;
+
+  return true;
+
+}
+
+}  // namespace tracing
@@ -0,0 +1,76 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <atomic>
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+// Records the time spent in a scope when tracing is enabled, for viewing in chrome://tracing or Perfetto.
+// The category and name must be string literals, only the pointers are stored.
+#define TRACE_SCOPE_CONCAT2(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT2(a, b)
+#define TRACE_SCOPE(category, name) const tracing::ScopedSpan TRACE_SCOPE_CONCAT(trace_span_, __LINE__)(category, name)
+
+namespace tracing {
+
+extern std::atomic<bool> sEnabled;
+
+// Checked by every span, so a disabled span costs a relaxed atomic load.
+inline bool IsEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+// Starting clears the events recorded before.
+void Start();
+void Stop();
+
+qint64 NowMicroseconds();
+// The name of the current thread, as shown in the trace.
+QString CurrentThreadName();
+void AddCompleteEvent(const char *category, const char *name, const qint64 start_usec, const qint64 duration_usec);
+
+int EventCount();
+
+// The events recorded by all threads in the Chrome trace event format.
+QByteArray ExportChromeTrace();
+bool SaveChromeTrace(const QString &filename);
+
+class ScopedSpan {
+ public:
+  explicit ScopedSpan(const char *category, const char *name) : category_(category), name_(name), start_usec_(IsEnabled() ? NowMicroseconds() : -1) {}
+  ~ScopedSpan() {
+    if (start_usec_ >= 0) {
+      AddCompleteEvent(category_, name_, start_usec_, NowMicroseconds() - start_usec_);
+    }
+  }
+
+ private:
+  Q_DISABLE_COPY_MOVE(ScopedSpan)
+
+  const char *category_;
+  const char *name_;
+  const qint64 start_usec_;
+};
+
+}  // namespace tracing
+
+#endif  // TRACING_H
@@ -38,6 +38,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/networkaccessmanager.h"
 #include "core/song.h"
 #include "utilities/mimeutils.h"
@@ -210,6 +211,8 @@ void AlbumCoverLoader::ProcessTasks() {
 
 void AlbumCoverLoader::ProcessTask(TaskPtr task) {
 
+  TRACE_SCOPE("covers", "Album cover task");
+
   // If we have album cover already, only do scale and pad.
   if (task->album_cover.is_valid()) {
     task->success = true;
@@ -23,7 +23,6 @@
 
 #include <algorithm>
 #include <utility>
-#include <chrono>
 #include <memory>
 
 #include <QObject>
@@ -52,6 +51,7 @@
 #include <QStatusBar>
 #include <QLabel>
 #include <QListWidget>
+#include <QListView>
 #include <QMessageBox>
 #include <QProgressBar>
 #include <QPushButton>
@@ -67,7 +67,6 @@
 #include "core/logging.h"
 #include "core/iconloader.h"
 #include "core/settings.h"
-#include "core/database.h"
 #include "core/networkaccessmanager.h"
 #include "core/songmimedata.h"
 #include "utilities/strutils.h"
@@ -79,8 +78,9 @@
 #include "widgets/searchfield.h"
 #include "tagreader/tagreaderclient.h"
 #include "collection/collectionbackend.h"
-#include "collection/collectionquery.h"
 #include "albumcovermanager.h"
+#include "albumcovermanagerlist.h"
+#include "albumcovermanagermodel.h"
 #include "albumcoversearcher.h"
 #include "albumcoverchoicecontroller.h"
 #include "albumcoverexport.h"
@@ -95,7 +95,6 @@
 
 #include "ui_albumcovermanager.h"
 
-using namespace std::literals::chrono_literals;
 using namespace Qt::Literals::StringLiterals;
 using std::make_shared;
 
@@ -105,6 +104,9 @@ constexpr char kGeometry[] = "geometry";
 constexpr char kSplitterState[] = "splitter_state";
 constexpr char kSaveCoverType[] = "save_cover_type";
 constexpr int kThumbnailSize = 120;
+// Wait for scrolling to settle before loading the covers in view.
+constexpr int kAlbumCoverLoadDelay = 50;
+constexpr int kUpdateFilterDelay = 250;
 }  // namespace
 
 AlbumCoverManager::AlbumCoverManager(const SharedPtr<NetworkAccessManager> network,
@@ -125,6 +127,7 @@ AlbumCoverManager::AlbumCoverManager(const SharedPtr<NetworkAccessManager> netwo
       cover_providers_(cover_providers),
       album_cover_choice_controller_(new AlbumCoverChoiceController(this)),
       timer_album_cover_load_(new QTimer(this)),
+      timer_update_filter_(new QTimer(this)),
       filter_all_(nullptr),
       filter_with_covers_(nullptr),
       filter_without_covers_(nullptr),
@@ -136,6 +139,7 @@ AlbumCoverManager::AlbumCoverManager(const SharedPtr<NetworkAccessManager> netwo
       all_artists_icon_(IconLoader::Load(u"library-music"_s)),
       image_nocover_thumbnail_(ImageUtils::GenerateNoCoverImage(QSize(120, 120), devicePixelRatio())),
       icon_nocover_item_(QPixmap::fromImage(image_nocover_thumbnail_)),
+      albums_model_(new AlbumCoverManagerModel(collection_backend, icon_nocover_item_, this)),
       context_menu_(new QMenu(this)),
       progress_bar_(new QProgressBar(this)),
       abort_progress_(new QPushButton(this)),
@@ -143,11 +147,16 @@ AlbumCoverManager::AlbumCoverManager(const SharedPtr<NetworkAccessManager> netwo
       all_artists_(nullptr) {
 
   ui_->setupUi(this);
-  ui_->albums->set_cover_manager(this);
+  ui_->albums->setModel(albums_model_);
 
-  timer_album_cover_load_->setSingleShot(false);
-  timer_album_cover_load_->setInterval(10ms);
+  timer_album_cover_load_->setSingleShot(true);
+  timer_album_cover_load_->setInterval(kAlbumCoverLoadDelay);
   QObject::connect(timer_album_cover_load_, &QTimer::timeout, this, &AlbumCoverManager::LoadAlbumCovers);
+  QObject::connect(ui_->albums, &AlbumCoverManagerList::ViewChanged, timer_album_cover_load_, qOverload<>(&QTimer::start));
+
+  timer_update_filter_->setSingleShot(true);
+  timer_update_filter_->setInterval(kUpdateFilterDelay);
+  QObject::connect(timer_update_filter_, &QTimer::timeout, this, &AlbumCoverManager::UpdateFilter);
 
   // Icons
   ui_->action_fetch->setIcon(IconLoader::Load(u"download"_s));
@@ -237,7 +246,7 @@ void AlbumCoverManager::Init() {
   QObject::connect(ui_->export_covers, &QPushButton::clicked, this, &AlbumCoverManager::ExportCovers);
   QObject::connect(cover_fetcher_, &AlbumCoverFetcher::AlbumCoverFetched, this, &AlbumCoverManager::AlbumCoverFetched);
   QObject::connect(ui_->action_fetch, &QAction::triggered, this, &AlbumCoverManager::FetchSingleCover);
-  QObject::connect(ui_->albums, &QListWidget::doubleClicked, this, &AlbumCoverManager::AlbumDoubleClicked);
+  QObject::connect(ui_->albums, &QListView::doubleClicked, this, &AlbumCoverManager::AlbumDoubleClicked);
   QObject::connect(ui_->action_add_to_playlist, &QAction::triggered, this, &AlbumCoverManager::AddSelectedToPlaylist);
   QObject::connect(ui_->action_load, &QAction::triggered, this, &AlbumCoverManager::LoadSelectedToPlaylist);
 
@@ -295,7 +304,7 @@ void AlbumCoverManager::closeEvent(QCloseEvent *e) {
   CancelRequests();
 
   ui_->artists->clear();
-  ui_->albums->clear();
+  albums_model_->Clear();
 
   QMainWindow::closeEvent(e);
 
@@ -336,8 +345,9 @@ void AlbumCoverManager::SaveSettings() {
 void AlbumCoverManager::CancelRequests() {
 
   albumcover_loader_->CancelTasks(QSet<quint64>(cover_loading_tasks_.keyBegin(), cover_loading_tasks_.keyEnd()));
-  cover_loading_pending_.clear();
+  timer_album_cover_load_->stop();
   cover_loading_tasks_.clear();
+  cover_loading_rows_.clear();
   cover_save_tasks_.clear();
 
   cover_exporter_->Cancel();
@@ -365,7 +375,7 @@ void AlbumCoverManager::Reset() {
 
   ui_->artists->clear();
   all_artists_ = new QListWidgetItem(all_artists_icon_, tr("All artists"), ui_->artists, All_Artists);
-  new AlbumItem(artist_icon_, tr("Various artists"), ui_->artists, Various_Artists);
+  new QListWidgetItem(artist_icon_, tr("Various artists"), ui_->artists, Various_Artists);
 
   QStringList artists = collection_backend_->GetAllArtistsWithAlbums();
   std::stable_sort(artists.begin(), artists.end(), CompareNocase);
@@ -391,8 +401,7 @@ void AlbumCoverManager::ArtistChanged(QListWidgetItem *current) {
 
   if (!current) return;
 
-  ui_->albums->clear();
-  context_menu_items_.clear();
+  context_menu_rows_.clear();
   CancelRequests();
 
   // Get the list of albums.  How we do it depends on what thing we have selected in the artist list.
@@ -404,85 +413,74 @@ void AlbumCoverManager::ArtistChanged(QListWidgetItem *current) {
     default:              albums = collection_backend_->GetAllAlbums(); break;
   }
 
+  // Don't show songs without an album, obviously
+  albums.erase(std::remove_if(albums.begin(), albums.end(), [](const CollectionBackend::Album &album_info) { return album_info.album.isEmpty(); }), albums.end());
+
   // Sort by album name.  The list is already sorted by sqlite but it was done case sensitively.
   std::stable_sort(albums.begin(), albums.end(), CompareAlbumNameNocase);
 
-  for (const CollectionBackend::Album &album_info : std::as_const(albums)) {
+  // Only the albums are added here, the covers are loaded when the albums are scrolled into view.
+  albums_model_->SetAlbums(albums, current->type() != Specific_Artist);
 
-    // Don't show songs without an album, obviously
-    if (album_info.album.isEmpty()) continue;
+  UpdateFilter();
 
-    QString display_text;
+  timer_album_cover_load_->start();
 
-    if (current->type() == Specific_Artist) {
-      display_text = album_info.album;
-    }
-    else {
-      display_text = album_info.album_artist + " - "_L1 + album_info.album;
-    }
+}
 
-    AlbumItem *album_item = new AlbumItem(icon_nocover_item_, display_text, ui_->albums);
-    album_item->setData(Role_AlbumArtist, album_info.album_artist);
-    album_item->setData(Role_Album, album_info.album);
-    album_item->setData(Role_Filetype, QVariant::fromValue(album_info.filetype));
-    album_item->setData(Role_CuePath, album_info.cue_path);
-    album_item->setData(Qt::TextAlignmentRole, QVariant(Qt::AlignTop | Qt::AlignHCenter));
-    album_item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsDragEnabled);
-    album_item->urls = album_info.urls;
-
-    if (album_info.album_artist.isEmpty()) {
-      album_item->setToolTip(album_info.album);
-    }
-    else {
-      album_item->setToolTip(album_info.album_artist + " - "_L1 + album_info.album);
-    }
+void AlbumCoverManager::LoadAlbumCovers() {
 
-    album_item->setData(Role_ArtEmbedded, album_info.art_embedded);
-    album_item->setData(Role_ArtAutomatic, album_info.art_automatic);
-    album_item->setData(Role_ArtManual, album_info.art_manual);
-    album_item->setData(Role_ArtUnset, album_info.art_unset);
+  // Load the covers of the albums in view and one page above and below, and stop loading the covers of albums scrolled out of view.
+  const QList<int> rows = ui_->albums->RowsInView(ui_->albums->viewport()->height());
+  const QSet<int> rows_in_view(rows.begin(), rows.end());
 
-    if (album_info.art_embedded || !album_info.art_automatic.isEmpty() || !album_info.art_manual.isEmpty()) {
-      QueueAlbumCoverLoad(album_item);
+  QSet<quint64> cancel_ids;
+  for (QMap<quint64, int>::iterator it = cover_loading_tasks_.begin(); it != cover_loading_tasks_.end();) {
+    if (rows_in_view.contains(it.value())) {
+      ++it;
+    }
+    else {
+      cancel_ids << it.key();
+      cover_loading_rows_.remove(it.value());
+      it = cover_loading_tasks_.erase(it);
     }
-
   }
-
-  UpdateFilter();
-
-}
-
-void AlbumCoverManager::QueueAlbumCoverLoad(AlbumItem *album_item) {
-
-  cover_loading_pending_.enqueue(album_item);
-
-  if (!timer_album_cover_load_->isActive()) {
-    timer_album_cover_load_->start();
+  if (!cancel_ids.isEmpty()) {
+    albumcover_loader_->CancelTasks(cancel_ids);
   }
 
-}
-
-void AlbumCoverManager::LoadAlbumCovers() {
-
-  if (cover_loading_pending_.isEmpty()) {
-    if (timer_album_cover_load_->isActive()) {
-      timer_album_cover_load_->stop();
+  for (const int row : rows) {
+    if (!cover_loading_rows_.contains(row) && albums_model_->NeedsCover(row)) {
+      LoadAlbumCoverAsync(row);
     }
-    return;
   }
 
-  LoadAlbumCoverAsync(cover_loading_pending_.dequeue());
-
 }
 
-void AlbumCoverManager::LoadAlbumCoverAsync(AlbumItem *album_item) {
+void AlbumCoverManager::LoadAlbumCoverAsync(const int row) {
+
+  const CollectionBackend::Album &album_info = albums_model_->album(row);
+  if (album_info.urls.isEmpty()) return;
+
+  CancelAlbumCoverLoad(row);
 
   AlbumCoverLoaderOptions cover_options(AlbumCoverLoaderOptions::Option::ScaledImage | AlbumCoverLoaderOptions::Option::PadScaledImage);
   cover_options.types = cover_types_;
   cover_options.desired_scaled_size = QSize(kThumbnailSize, kThumbnailSize);
   cover_options.device_pixel_ratio = devicePixelRatioF();
-  quint64 cover_load_id = albumcover_loader_->LoadImageAsync(cover_options, album_item->data(Role_ArtEmbedded).toBool(), album_item->data(Role_ArtAutomatic).toUrl(), album_item->data(Role_ArtManual).toUrl(), album_item->data(Role_ArtUnset).toBool(), album_item->urls.constFirst());
-  cover_loading_tasks_.insert(cover_load_id, album_item);
+  quint64 cover_load_id = albumcover_loader_->LoadImageAsync(cover_options, album_info.art_embedded, album_info.art_automatic, album_info.art_manual, album_info.art_unset, album_info.urls.constFirst());
+  cover_loading_tasks_.insert(cover_load_id, row);
+  cover_loading_rows_.insert(row, cover_load_id);
+
+}
+
+void AlbumCoverManager::CancelAlbumCoverLoad(const int row) {
+
+  if (!cover_loading_rows_.contains(row)) return;
+
+  const quint64 cover_load_id = cover_loading_rows_.take(row);
+  cover_loading_tasks_.remove(cover_load_id);
+  albumcover_loader_->CancelTasks(QSet<quint64>() << cover_load_id);
 
 }
 
@@ -490,17 +488,18 @@ void AlbumCoverManager::AlbumCoverLoaded(const quint64 id, const AlbumCoverLoade
 
   if (!cover_loading_tasks_.contains(id)) return;
 
-  AlbumItem *album_item = cover_loading_tasks_.take(id);
+  const int row = cover_loading_tasks_.take(id);
+  cover_loading_rows_.remove(row);
 
   if (!result.success || result.image_scaled.isNull() || result.type == AlbumCoverLoaderResult::Type::Unset) {
-    album_item->setIcon(icon_nocover_item_);
+    albums_model_->SetNoCover(row);
+    // The album turned out to have no cover, so the counts and the cover filter may change.
+    timer_update_filter_->start();
   }
   else {
-    album_item->setIcon(QPixmap::fromImage(result.image_scaled));
+    albums_model_->SetCover(row, result.image_scaled);
   }
 
-  UpdateFilter();
-
 }
 
 void AlbumCoverManager::UpdateFilter() {
@@ -520,14 +519,16 @@ void AlbumCoverManager::UpdateFilter() {
   qint32 total_count = 0;
   qint32 without_cover = 0;
 
-  for (int i = 0; i < ui_->albums->count(); ++i) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(ui_->albums->item(i));
-    bool should_hide = ShouldHide(*album_item, filter, hide_covers);
-    album_item->setHidden(should_hide);
+  const int row_count = albums_model_->rowCount();
+  for (int row = 0; row < row_count; ++row) {
+    const bool should_hide = ShouldHide(row, filter, hide_covers);
+    if (ui_->albums->isRowHidden(row) != should_hide) {
+      ui_->albums->setRowHidden(row, should_hide);
+    }
 
     if (!should_hide) {
       ++total_count;
-      if (!ItemHasCover(*album_item)) {
+      if (!albums_model_->HasCover(row)) {
         ++without_cover;
       }
     }
@@ -536,11 +537,14 @@ void AlbumCoverManager::UpdateFilter() {
   ui_->total_albums->setText(QString::number(total_count));
   ui_->without_cover->setText(QString::number(without_cover));
 
+  // Other albums may have come into view.
+  timer_album_cover_load_->start();
+
 }
 
-bool AlbumCoverManager::ShouldHide(const AlbumItem &album_item, const QString &filter, const HideCovers hide_covers) const {
+bool AlbumCoverManager::ShouldHide(const int row, const QString &filter, const HideCovers hide_covers) const {
 
-  bool has_cover = ItemHasCover(album_item);
+  bool has_cover = albums_model_->HasCover(row);
   if (hide_covers == HideCovers::WithCovers && has_cover) {
     return true;
   }
@@ -552,10 +556,12 @@ bool AlbumCoverManager::ShouldHide(const AlbumItem &album_item, const QString &f
     return false;
   }
 
+  const QString text = albums_model_->index(row).data(Qt::DisplayRole).toString();
+  const QString albumartist = albums_model_->album(row).album_artist;
   const QStringList query = filter.split(u' ');
   for (const QString &s : query) {
-    bool in_text = album_item.text().contains(s, Qt::CaseInsensitive);
-    bool in_albumartist = album_item.data(Role_AlbumArtist).toString().contains(s, Qt::CaseInsensitive);
+    bool in_text = text.contains(s, Qt::CaseInsensitive);
+    bool in_albumartist = albumartist.contains(s, Qt::CaseInsensitive);
     if (!in_text && !in_albumartist) {
       return true;
     }
@@ -567,13 +573,14 @@ bool AlbumCoverManager::ShouldHide(const AlbumItem &album_item, const QString &f
 
 void AlbumCoverManager::FetchAlbumCovers() {
 
-  for (int i = 0; i < ui_->albums->count(); ++i) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(ui_->albums->item(i));
-    if (album_item->isHidden()) continue;
-    if (ItemHasCover(*album_item)) continue;
+  const int row_count = albums_model_->rowCount();
+  for (int row = 0; row < row_count; ++row) {
+    if (ui_->albums->isRowHidden(row)) continue;
+    if (albums_model_->HasCover(row)) continue;
 
-    quint64 id = cover_fetcher_->FetchAlbumCover(album_item->data(Role_AlbumArtist).toString(), album_item->data(Role_Album).toString(), QString(), true);
-    cover_fetching_tasks_[id] = album_item;
+    const CollectionBackend::Album &album_info = albums_model_->album(row);
+    quint64 id = cover_fetcher_->FetchAlbumCover(album_info.album_artist, album_info.album, QString(), true);
+    cover_fetching_tasks_[id] = row;
     jobs_++;
   }
 
@@ -583,6 +590,7 @@ void AlbumCoverManager::FetchAlbumCovers() {
   progress_bar_->show();
   abort_progress_->show();
   fetch_statistics_ = CoverSearchStatistics();
+  fetch_cache_stats_ = NetworkAccessManager::metadata_cache_stats();
   UpdateStatusText();
 
 }
@@ -591,9 +599,9 @@ void AlbumCoverManager::AlbumCoverFetched(const quint64 id, const AlbumCoverImag
 
   if (!cover_fetching_tasks_.contains(id)) return;
 
-  AlbumItem *album_item = cover_fetching_tasks_.take(id);
+  const int row = cover_fetching_tasks_.take(id);
   if (!result.image.isNull()) {
-    SaveAndSetCover(album_item, result);
+    SaveAndSetCover(row, result);
   }
 
   if (cover_fetching_tasks_.isEmpty()) {
@@ -625,6 +633,9 @@ void AlbumCoverManager::UpdateStatusText() {
     dialog->setAttribute(Qt::WA_DeleteOnClose);
     dialog->Show(fetch_statistics_);
 
+    const NetworkAccessManager::MetadataCacheStats cache_stats = NetworkAccessManager::metadata_cache_stats();
+    qLog(Debug) << "Cover searches answered from the cache:" << cache_stats.hits - fetch_cache_stats_.hits << "revalidated:" << cache_stats.revalidated - fetch_cache_stats_.revalidated << "sent to the network:" << cache_stats.misses - fetch_cache_stats_.misses;
+
     jobs_ = 0;
   }
 
@@ -633,28 +644,32 @@ void AlbumCoverManager::UpdateStatusText() {
 bool AlbumCoverManager::eventFilter(QObject *obj, QEvent *e) {
 
   if (obj == ui_->albums && e->type() == QEvent::ContextMenu) {
-    context_menu_items_ = ui_->albums->selectedItems();
-    if (context_menu_items_.isEmpty()) return QMainWindow::eventFilter(obj, e);
+    context_menu_rows_.clear();
+    const QModelIndexList selected_indexes = ui_->albums->selectionModel()->selectedIndexes();
+    for (const QModelIndex &idx : selected_indexes) {
+      context_menu_rows_ << idx.row();
+    }
+    if (context_menu_rows_.isEmpty()) return QMainWindow::eventFilter(obj, e);
 
     bool some_with_covers = false;
     bool some_unset = false;
     bool some_clear = false;
 
-    for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
-      AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
-      if (ItemHasCover(*album_item)) some_with_covers = true;
-      if (album_item->data(Role_ArtUnset).toBool()) {
+    for (const int row : std::as_const(context_menu_rows_)) {
+      const CollectionBackend::Album &album_info = albums_model_->album(row);
+      if (albums_model_->HasCover(row)) some_with_covers = true;
+      if (album_info.art_unset) {
         some_unset = true;
       }
-      else if (!album_item->data(Role_ArtEmbedded).toBool() && album_item->data(Role_ArtAutomatic).toUrl().isEmpty() && album_item->data(Role_ArtManual).toUrl().isEmpty()) {
+      else if (!album_info.art_embedded && album_info.art_automatic.isEmpty() && album_info.art_manual.isEmpty()) {
         some_clear = true;
       }
     }
 
-    album_cover_choice_controller_->show_cover_action()->setEnabled(some_with_covers && context_menu_items_.size() == 1);
+    album_cover_choice_controller_->show_cover_action()->setEnabled(some_with_covers && context_menu_rows_.size() == 1);
     album_cover_choice_controller_->cover_to_file_action()->setEnabled(some_with_covers);
-    album_cover_choice_controller_->cover_from_file_action()->setEnabled(context_menu_items_.size() == 1);
-    album_cover_choice_controller_->cover_from_url_action()->setEnabled(context_menu_items_.size() == 1);
+    album_cover_choice_controller_->cover_from_file_action()->setEnabled(context_menu_rows_.size() == 1);
+    album_cover_choice_controller_->cover_from_url_action()->setEnabled(context_menu_rows_.size() == 1);
     album_cover_choice_controller_->search_for_cover_action()->setEnabled(cover_providers_->HasAnyProviders());
     album_cover_choice_controller_->unset_cover_action()->setEnabled(some_with_covers || some_clear);
     album_cover_choice_controller_->clear_cover_action()->setEnabled(some_with_covers || some_unset);
@@ -670,38 +685,38 @@ bool AlbumCoverManager::eventFilter(QObject *obj, QEvent *e) {
 }
 
 Song AlbumCoverManager::GetSingleSelectionAsSong() {
-  return context_menu_items_.size() != 1 ? Song() : AlbumItemAsSong(context_menu_items_.value(0));
+  return context_menu_rows_.size() != 1 ? Song() : AlbumItemAsSong(context_menu_rows_.value(0));
 }
 
 Song AlbumCoverManager::GetFirstSelectedAsSong() {
-  return context_menu_items_.isEmpty() ? Song() : AlbumItemAsSong(context_menu_items_.value(0));
+  return context_menu_rows_.isEmpty() ? Song() : AlbumItemAsSong(context_menu_rows_.value(0));
 }
 
-Song AlbumCoverManager::AlbumItemAsSong(AlbumItem *album_item) {
+Song AlbumCoverManager::AlbumItemAsSong(const int row) const {
+
+  const CollectionBackend::Album &album_info = albums_model_->album(row);
 
   Song result(Song::Source::Collection);
 
-  QString title = album_item->data(Role_Album).toString();
-  QString artist_name = album_item->data(Role_AlbumArtist).toString();
-  if (!artist_name.isEmpty()) {
-    result.set_title(artist_name + " - "_L1 + title);
+  if (!album_info.album_artist.isEmpty()) {
+    result.set_title(album_info.album_artist + " - "_L1 + album_info.album);
   }
   else {
-    result.set_title(title);
+    result.set_title(album_info.album);
   }
 
-  result.set_artist(album_item->data(Role_AlbumArtist).toString());
-  result.set_albumartist(album_item->data(Role_AlbumArtist).toString());
-  result.set_album(album_item->data(Role_Album).toString());
+  result.set_artist(album_info.album_artist);
+  result.set_albumartist(album_info.album_artist);
+  result.set_album(album_info.album);
 
-  result.set_filetype(static_cast<Song::FileType>(album_item->data(Role_Filetype).toInt()));
-  result.set_url(album_item->urls.constFirst());
-  result.set_cue_path(album_item->data(Role_CuePath).toString());
+  result.set_filetype(album_info.filetype);
+  result.set_url(album_info.urls.value(0));
+  result.set_cue_path(album_info.cue_path);
 
-  result.set_art_embedded(album_item->data(Role_ArtEmbedded).toBool());
-  result.set_art_automatic(album_item->data(Role_ArtAutomatic).toUrl());
-  result.set_art_manual(album_item->data(Role_ArtManual).toUrl());
-  result.set_art_unset(album_item->data(Role_ArtUnset).toBool());
+  result.set_art_embedded(album_info.art_embedded);
+  result.set_art_automatic(album_info.art_automatic);
+  result.set_art_manual(album_info.art_manual);
+  result.set_art_unset(album_info.art_unset);
 
   // force validity
   result.set_valid(true);
@@ -722,10 +737,10 @@ void AlbumCoverManager::ShowCover() {
 
 void AlbumCoverManager::FetchSingleCover() {
 
-  for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
-    quint64 id = cover_fetcher_->FetchAlbumCover(album_item->data(Role_AlbumArtist).toString(), album_item->data(Role_Album).toString(), QString(), false);
-    cover_fetching_tasks_[id] = album_item;
+  for (const int row : std::as_const(context_menu_rows_)) {
+    const CollectionBackend::Album &album_info = albums_model_->album(row);
+    quint64 id = cover_fetcher_->FetchAlbumCover(album_info.album_artist, album_info.album, QString(), false);
+    cover_fetching_tasks_[id] = row;
     jobs_++;
   }
 
@@ -736,11 +751,12 @@ void AlbumCoverManager::FetchSingleCover() {
 
 }
 
-void AlbumCoverManager::UpdateCoverInList(AlbumItem *album_item, const QUrl &cover_url) {
+void AlbumCoverManager::UpdateCoverInList(const int row, const QUrl &cover_url) {
 
-  album_item->setData(Role_ArtManual, cover_url);
-  album_item->setData(Role_ArtUnset, false);
-  LoadAlbumCoverAsync(album_item);
+  const QModelIndex idx = albums_model_->index(row);
+  albums_model_->setData(idx, cover_url, AlbumCoverManagerModel::Role_ArtManual);
+  albums_model_->setData(idx, false, AlbumCoverManagerModel::Role_ArtUnset);
+  LoadAlbumCoverAsync(row);
 
 }
 
@@ -844,31 +860,27 @@ void AlbumCoverManager::SaveImageToAlbums(Song *song, const AlbumCoverImageResul
   }
 
   // Force the found cover on all of the selected items
-  QList<QUrl> urls;
-  QList<AlbumItem*> album_items;
-  for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
+  for (const int row : std::as_const(context_menu_rows_)) {
     switch (album_cover_choice_controller_->get_save_album_cover_type()) {
       case CoverOptions::CoverType::Cache:
       case CoverOptions::CoverType::Album:{
-        Song current_song = AlbumItemAsSong(album_item);
+        Song current_song = AlbumItemAsSong(row);
         album_cover_choice_controller_->SaveArtManualToSong(&current_song, cover_url);
-        UpdateCoverInList(album_item, cover_url);
+        UpdateCoverInList(row, cover_url);
         break;
       }
       case CoverOptions::CoverType::Embedded:{
-        for (const QUrl &url : std::as_const(album_item->urls)) {
+        const QList<QUrl> urls = albums_model_->album(row).urls;
+        for (const QUrl &url : urls) {
           const bool art_embedded = !result.image_data.isEmpty();
           TagReaderReplyPtr reply = tagreader_client_->SaveCoverAsync(url.toLocalFile(), SaveTagCoverData(result.image_data, result.mime_type));
           SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
-          *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, album_item, url, art_embedded, connection]() {
-            SaveEmbeddedCoverFinished(reply, album_item, url, art_embedded);
+          *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, row, url, art_embedded, connection]() {
+            SaveEmbeddedCoverFinished(reply, row, url, art_embedded);
             QObject::disconnect(*connection);
           });
-          cover_save_tasks_.insert(album_item, url);
+          cover_save_tasks_.insert(row, url);
         }
-        urls << album_item->urls;
-        album_items << album_item;
         break;
       }
     }
@@ -878,18 +890,19 @@ void AlbumCoverManager::SaveImageToAlbums(Song *song, const AlbumCoverImageResul
 
 void AlbumCoverManager::UnsetCover() {
 
-  if (context_menu_items_.isEmpty()) return;
+  if (context_menu_rows_.isEmpty()) return;
 
   // Force the 'none' cover on all of the selected items
-  for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
-    album_item->setIcon(icon_nocover_item_);
-    album_item->setData(Role_ArtEmbedded, false);
-    album_item->setData(Role_ArtManual, QUrl());
-    album_item->setData(Role_ArtAutomatic, QUrl());
-    album_item->setData(Role_ArtUnset, true);
-
-    Song current_song = AlbumItemAsSong(album_item);
+  for (const int row : std::as_const(context_menu_rows_)) {
+    const QModelIndex idx = albums_model_->index(row);
+    CancelAlbumCoverLoad(row);
+    albums_model_->setData(idx, false, AlbumCoverManagerModel::Role_ArtEmbedded);
+    albums_model_->setData(idx, QUrl(), AlbumCoverManagerModel::Role_ArtManual);
+    albums_model_->setData(idx, QUrl(), AlbumCoverManagerModel::Role_ArtAutomatic);
+    albums_model_->setData(idx, true, AlbumCoverManagerModel::Role_ArtUnset);
+    albums_model_->SetNoCover(row);
+
+    Song current_song = AlbumItemAsSong(row);
     album_cover_choice_controller_->UnsetAlbumCoverForSong(&current_song);
   }
 
@@ -897,18 +910,19 @@ void AlbumCoverManager::UnsetCover() {
 
 void AlbumCoverManager::ClearCover() {
 
-  if (context_menu_items_.isEmpty()) return;
+  if (context_menu_rows_.isEmpty()) return;
 
   // Force the 'none' cover on all of the selected items
-  for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
-    album_item->setIcon(icon_nocover_item_);
-    album_item->setData(Role_ArtEmbedded, false);
-    album_item->setData(Role_ArtAutomatic, QUrl());
-    album_item->setData(Role_ArtManual, QUrl());
-    album_item->setData(Role_ArtUnset, false);
-
-    Song current_song = AlbumItemAsSong(album_item);
+  for (const int row : std::as_const(context_menu_rows_)) {
+    const QModelIndex idx = albums_model_->index(row);
+    CancelAlbumCoverLoad(row);
+    albums_model_->setData(idx, false, AlbumCoverManagerModel::Role_ArtEmbedded);
+    albums_model_->setData(idx, QUrl(), AlbumCoverManagerModel::Role_ArtAutomatic);
+    albums_model_->setData(idx, QUrl(), AlbumCoverManagerModel::Role_ArtManual);
+    albums_model_->setData(idx, false, AlbumCoverManagerModel::Role_ArtUnset);
+    albums_model_->SetNoCover(row);
+
+    Song current_song = AlbumItemAsSong(row);
     album_cover_choice_controller_->ClearAlbumCoverForSong(&current_song);
   }
 
@@ -916,53 +930,24 @@ void AlbumCoverManager::ClearCover() {
 
 void AlbumCoverManager::DeleteCover() {
 
-  for (QListWidgetItem *list_widget_item : std::as_const(context_menu_items_)) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(list_widget_item);
-    Song song = AlbumItemAsSong(album_item);
+  for (const int row : std::as_const(context_menu_rows_)) {
+    Song song = AlbumItemAsSong(row);
     album_cover_choice_controller_->DeleteCover(&song);
-    album_item->setIcon(icon_nocover_item_);
-    album_item->setData(Role_ArtEmbedded, false);
-    album_item->setData(Role_ArtManual, QUrl());
-    album_item->setData(Role_ArtAutomatic, QUrl());
+    const QModelIndex idx = albums_model_->index(row);
+    CancelAlbumCoverLoad(row);
+    albums_model_->setData(idx, false, AlbumCoverManagerModel::Role_ArtEmbedded);
+    albums_model_->setData(idx, QUrl(), AlbumCoverManagerModel::Role_ArtManual);
+    albums_model_->setData(idx, QUrl(), AlbumCoverManagerModel::Role_ArtAutomatic);
+    albums_model_->SetNoCover(row);
   }
 
 }
 
-SongList AlbumCoverManager::GetSongsInAlbum(const QModelIndex &idx) const {
-
-  SongList ret;
-
-  QMutexLocker l(collection_backend_->db()->Mutex());
-  QSqlDatabase db(collection_backend_->db()->Connect());
-
-  CollectionQuery q(db, collection_backend_->songs_table());
-  q.SetColumnSpec(Song::kRowIdColumnSpec);
-  q.AddWhere(u"album"_s, idx.data(Role_Album).toString());
-  q.SetOrderBy(u"disc, track, title"_s);
-
-  QString albumartist = idx.data(Role_AlbumArtist).toString();
-  if (!albumartist.isEmpty()) {
-    q.AddWhere(u"effective_albumartist"_s, albumartist);
-  }
-
-  q.AddCompilationRequirement(albumartist.isEmpty());
-
-  if (!q.Exec()) return ret;
-
-  while (q.Next()) {
-    Song song;
-    song.InitFromQuery(q, true);
-    ret << song;
-  }
-  return ret;
-
-}
-
 SongList AlbumCoverManager::GetSongsInAlbums(const QModelIndexList &indexes) const {
 
   SongList ret;
   for (const QModelIndex &idx : indexes) {
-    ret << GetSongsInAlbum(idx);
+    ret << albums_model_->GetSongsInAlbum(idx.row());
   }
   return ret;
 
@@ -982,9 +967,8 @@ SongMimeData *AlbumCoverManager::GetMimeDataForAlbums(const QModelIndexList &ind
 
 void AlbumCoverManager::AlbumDoubleClicked(const QModelIndex &idx) {
 
-  AlbumItem *album_item = static_cast<AlbumItem*>(idx.internalPointer());
-  if (!album_item) return;
-  album_cover_choice_controller_->ShowCover(AlbumItemAsSong(album_item));
+  if (!idx.isValid()) return;
+  album_cover_choice_controller_->ShowCover(AlbumItemAsSong(idx.row()));
 
 }
 
@@ -1002,27 +986,28 @@ void AlbumCoverManager::LoadSelectedToPlaylist() {
 
 }
 
-void AlbumCoverManager::SaveAndSetCover(AlbumItem *album_item, const AlbumCoverImageResult &result) {
+void AlbumCoverManager::SaveAndSetCover(const int row, const AlbumCoverImageResult &result) {
 
-  const QList<QUrl> &urls = album_item->urls;
-  const Song::FileType filetype = static_cast<Song::FileType>(album_item->data(Role_Filetype).toInt());
-  const bool has_cue = !album_item->data(Role_CuePath).toString().isEmpty();
+  const CollectionBackend::Album album_info = albums_model_->album(row);
+  const QList<QUrl> &urls = album_info.urls;
+  const Song::FileType filetype = album_info.filetype;
+  const bool has_cue = !album_info.cue_path.isEmpty();
 
   if (album_cover_choice_controller_->get_save_album_cover_type() == CoverOptions::CoverType::Embedded && Song::save_embedded_cover_supported(filetype) && !has_cue) {
     for (const QUrl &url : urls) {
       const bool art_embedded = !result.image_data.isEmpty();
       TagReaderReplyPtr reply = tagreader_client_->SaveCoverAsync(url.toLocalFile(), SaveTagCoverData(result.cover_url.isValid() ? result.cover_url.toLocalFile() : QString(), result.image_data, result.mime_type));
       SharedPtr<QMetaObject::Connection> connection = std::make_shared<QMetaObject::Connection>();
-      *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, album_item, url, art_embedded, connection]() {
-        SaveEmbeddedCoverFinished(reply, album_item, url, art_embedded);
+      *connection = QObject::connect(&*reply, &TagReaderReply::Finished, this, [this, reply, row, url, art_embedded, connection]() {
+        SaveEmbeddedCoverFinished(reply, row, url, art_embedded);
         QObject::disconnect(*connection);
       });
-      cover_save_tasks_.insert(album_item, url);
+      cover_save_tasks_.insert(row, url);
     }
   }
   else {
-    const QString albumartist = album_item->data(Role_AlbumArtist).toString();
-    const QString album = album_item->data(Role_Album).toString();
+    const QString albumartist = album_info.album_artist;
+    const QString album = album_info.album;
     QUrl cover_url;
     if (!result.cover_url.isEmpty() && result.cover_url.isValid() && result.cover_url.isLocalFile()) {
       cover_url = result.cover_url;
@@ -1037,7 +1022,7 @@ void AlbumCoverManager::SaveAndSetCover(AlbumItem *album_item, const AlbumCoverI
     collection_backend_->UpdateManualAlbumArtAsync(albumartist, album, cover_url);
 
     // Update the icon in our list
-    UpdateCoverInList(album_item, cover_url);
+    UpdateCoverInList(row, cover_url);
   }
 
 }
@@ -1055,15 +1040,14 @@ void AlbumCoverManager::ExportCovers() {
   cover_exporter_->SetDialogResult(result);
   cover_exporter_->SetCoverTypes(cover_types_);
 
-  for (int i = 0; i < ui_->albums->count(); ++i) {
-    AlbumItem *album_item = static_cast<AlbumItem*>(ui_->albums->item(i));
-
+  const int row_count = albums_model_->rowCount();
+  for (int row = 0; row < row_count; ++row) {
     // skip hidden and coverless albums
-    if (album_item->isHidden() || !ItemHasCover(*album_item)) {
+    if (ui_->albums->isRowHidden(row) || !albums_model_->HasCover(row)) {
       continue;
     }
 
-    cover_exporter_->AddExportRequest(AlbumItemAsSong(album_item));
+    cover_exporter_->AddExportRequest(AlbumItemAsSong(row));
   }
 
   if (cover_exporter_->request_count() > 0) {
@@ -1105,30 +1089,27 @@ void AlbumCoverManager::UpdateExportStatus(const int exported, const int skipped
 
 }
 
-bool AlbumCoverManager::ItemHasCover(const AlbumItem &album_item) const {
-  return album_item.icon().cacheKey() != icon_nocover_item_.cacheKey();
-}
-
-void AlbumCoverManager::SaveEmbeddedCoverFinished(TagReaderReplyPtr reply, AlbumItem *album_item, const QUrl &url, const bool art_embedded) {
+void AlbumCoverManager::SaveEmbeddedCoverFinished(TagReaderReplyPtr reply, const int row, const QUrl &url, const bool art_embedded) {
 
-  if (!cover_save_tasks_.contains(album_item, url)) {
+  if (!cover_save_tasks_.contains(row, url)) {
     return;
   }
-  cover_save_tasks_.remove(album_item, url);
+  cover_save_tasks_.remove(row, url);
 
   if (!reply->success()) {
     Q_EMIT Error(tr("Could not save cover to file %1.").arg(url.toLocalFile()));
     return;
   }
 
-  if (cover_save_tasks_.contains(album_item)) {
+  if (cover_save_tasks_.contains(row)) {
     return;
   }
 
-  album_item->setData(Role_ArtEmbedded, true);
-  album_item->setData(Role_ArtUnset, false);
-  Song song = AlbumItemAsSong(album_item);
+  const QModelIndex idx = albums_model_->index(row);
+  albums_model_->setData(idx, true, AlbumCoverManagerModel::Role_ArtEmbedded);
+  albums_model_->setData(idx, false, AlbumCoverManagerModel::Role_ArtUnset);
+  Song song = AlbumItemAsSong(row);
   album_cover_choice_controller_->SaveArtEmbeddedToSong(&song, art_embedded);
-  LoadAlbumCoverAsync(album_item);
+  LoadAlbumCoverAsync(row);
 
 }
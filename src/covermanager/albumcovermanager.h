@@ -32,13 +32,14 @@
 #include <QListWidgetItem>
 #include <QMap>
 #include <QMultiMap>
-#include <QQueue>
+#include <QHash>
 #include <QString>
 #include <QImage>
 #include <QIcon>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/networkaccessmanager.h"
 #include "tagreader/tagreaderclient.h"
 #include "albumcoverloaderoptions.h"
 #include "albumcoverloaderresult.h"
@@ -55,7 +56,6 @@ class QEvent;
 class QCloseEvent;
 class QShowEvent;
 
-class NetworkAccessManager;
 class CollectionBackend;
 class AlbumCoverLoader;
 class CurrentAlbumCoverLoader;
@@ -65,18 +65,10 @@ class AlbumCoverExport;
 class AlbumCoverExporter;
 class AlbumCoverFetcher;
 class AlbumCoverSearcher;
+class AlbumCoverManagerModel;
 
 class Ui_CoverManager;
 
-class AlbumItem : public QListWidgetItem {
- public:
-  AlbumItem(const QIcon &icon, const QString &text, QListWidget *parent = nullptr, int type = Type) : QListWidgetItem(icon, text, parent, type) {};
-  QList<QUrl> urls;
-
- private:
-  Q_DISABLE_COPY(AlbumItem)
-};
-
 class AlbumCoverManager : public QMainWindow {
   Q_OBJECT
 
@@ -98,8 +90,6 @@ class AlbumCoverManager : public QMainWindow {
   void EnableCoversButtons();
   void DisableCoversButtons();
 
-  SongList GetSongsInAlbum(const QModelIndex &idx) const;
-
   SharedPtr<CollectionBackend> collection_backend() const { return collection_backend_; }
 
  protected:
@@ -116,19 +106,6 @@ class AlbumCoverManager : public QMainWindow {
     Specific_Artist
   };
 
-  enum Role {
-    Role_AlbumArtist = Qt::UserRole + 1,
-    Role_Album,
-    Role_ArtEmbedded,
-    Role_ArtAutomatic,
-    Role_ArtManual,
-    Role_ArtUnset,
-    Role_Filetype,
-    Role_CuePath,
-    Role_ImageData,
-    Role_Image
-  };
-
   enum class HideCovers {
     None,
     WithCovers,
@@ -145,23 +122,20 @@ class AlbumCoverManager : public QMainWindow {
   // Returns the first of the selected elements in form of a Song ready to be used by AlbumCoverChoiceController or invalid song if there's nothing selected.
   Song GetFirstSelectedAsSong();
 
-  Song AlbumItemAsSong(QListWidgetItem *list_widget_item) { return AlbumItemAsSong(static_cast<AlbumItem*>(list_widget_item)); }
-  static Song AlbumItemAsSong(AlbumItem *album_item);
+  Song AlbumItemAsSong(const int row) const;
 
-  void QueueAlbumCoverLoad(AlbumItem *album_item);
-  void LoadAlbumCoverAsync(AlbumItem *album_item);
+  void LoadAlbumCoverAsync(const int row);
+  void CancelAlbumCoverLoad(const int row);
 
   void UpdateStatusText();
-  bool ShouldHide(const AlbumItem &album_item, const QString &filter, const HideCovers hide_covers) const;
-  void SaveAndSetCover(AlbumItem *album_item, const AlbumCoverImageResult &result);
+  bool ShouldHide(const int row, const QString &filter, const HideCovers hide_covers) const;
+  void SaveAndSetCover(const int row, const AlbumCoverImageResult &result);
 
   void SaveImageToAlbums(Song *song, const AlbumCoverImageResult &result);
 
   SongList GetSongsInAlbums(const QModelIndexList &indexes) const;
   SongMimeData *GetMimeDataForAlbums(const QModelIndexList &indexes) const;
 
-  bool ItemHasCover(const AlbumItem &album_item) const;
-
  Q_SIGNALS:
   void Error(const QString &error);
   void AddToPlaylist(QMimeData *data);
@@ -193,10 +167,10 @@ class AlbumCoverManager : public QMainWindow {
   void AddSelectedToPlaylist();
   void LoadSelectedToPlaylist();
 
-  void UpdateCoverInList(AlbumItem *album_item, const QUrl &cover);
+  void UpdateCoverInList(const int row, const QUrl &cover);
   void UpdateExportStatus(const int exported, const int skipped, const int max);
 
-  void SaveEmbeddedCoverFinished(TagReaderReplyPtr reply, AlbumItem *album_item, const QUrl &url, const bool art_embedded);
+  void SaveEmbeddedCoverFinished(TagReaderReplyPtr reply, const int row, const QUrl &url, const bool art_embedded);
 
  private:
   Ui_CoverManager *ui_;
@@ -210,17 +184,20 @@ class AlbumCoverManager : public QMainWindow {
 
   AlbumCoverChoiceController *album_cover_choice_controller_;
   QTimer *timer_album_cover_load_;
+  QTimer *timer_update_filter_;
 
   QAction *filter_all_;
   QAction *filter_with_covers_;
   QAction *filter_without_covers_;
 
-  QQueue<AlbumItem*> cover_loading_pending_;
-  QMap<quint64, AlbumItem*> cover_loading_tasks_;
+  // Covers being loaded for the albums in view, by task ID and by row.
+  QMap<quint64, int> cover_loading_tasks_;
+  QHash<int, quint64> cover_loading_rows_;
 
   AlbumCoverFetcher *cover_fetcher_;
-  QMap<quint64, AlbumItem*> cover_fetching_tasks_;
+  QMap<quint64, int> cover_fetching_tasks_;
   CoverSearchStatistics fetch_statistics_;
+  NetworkAccessManager::MetadataCacheStats fetch_cache_stats_;
 
   AlbumCoverSearcher *cover_searcher_;
   AlbumCoverExport *cover_export_;
@@ -231,14 +208,16 @@ class AlbumCoverManager : public QMainWindow {
   const QImage image_nocover_thumbnail_;
   const QIcon icon_nocover_item_;
 
+  AlbumCoverManagerModel *albums_model_;
+
   QMenu *context_menu_;
-  QList<QListWidgetItem*> context_menu_items_;
+  QList<int> context_menu_rows_;
 
   QProgressBar *progress_bar_;
   QPushButton *abort_progress_;
   int jobs_;
 
-  QMultiMap<AlbumItem*, QUrl> cover_save_tasks_;
+  QMultiMap<int, QUrl> cover_save_tasks_;
 
   QListWidgetItem *all_artists_;
 
@@ -21,56 +21,52 @@
 
 #include "config.h"
 
-#include <utility>
-
 #include <QWidget>
-#include <QStringList>
-#include <QUrl>
 #include <QList>
 #include <QListView>
-#include <QListWidget>
-#include <QListWidgetItem>
-#include <QMimeData>
-#include <QDropEvent>
-
-#include "includes/scoped_ptr.h"
-#include "core/song.h"
-#include "core/songmimedata.h"
-#include "collection/collectionbackend.h"
-#include "albumcovermanager.h"
+#include <QAbstractItemModel>
+#include <QRect>
+#include <QResizeEvent>
+
 #include "albumcovermanagerlist.h"
 
-AlbumCoverManagerList::AlbumCoverManagerList(QWidget *parent) : QListWidget(parent), manager_(nullptr) {}
+AlbumCoverManagerList::AlbumCoverManagerList(QWidget *parent) : QListView(parent) {}
 
-QMimeData *AlbumCoverManagerList::mimeData(const QList<QListWidgetItem*> &items) const {
+QList<int> AlbumCoverManagerList::RowsInView(const int margin) const {
 
-  // Get songs
-  SongList songs;
-  for (QListWidgetItem *item : items) {
-    songs << manager_->GetSongsInAlbum(indexFromItem(item));
-  }
+  QList<int> rows;
 
-  if (songs.isEmpty()) return nullptr;
+  const QAbstractItemModel *item_model = model();
+  if (!item_model) return rows;
 
-  // Get URLs from the songs
-  QList<QUrl> urls;
-  urls.reserve(songs.count());
-  for (const Song &song : std::as_const(songs)) {
-    urls << song.url();
+  const QRect view_rect = viewport()->rect().adjusted(0, -margin, 0, margin);
+  const int row_count = item_model->rowCount();
+  for (int row = 0; row < row_count; ++row) {
+    if (isRowHidden(row)) continue;
+    const QRect item_rect = visualRect(item_model->index(row, 0));
+    if (item_rect.intersects(view_rect)) {
+      rows << row;
+    }
+    // The rows are laid out in order, so none of the remaining rows are in view.
+    else if (!rows.isEmpty() && item_rect.top() > view_rect.bottom()) {
+      break;
+    }
   }
 
-  // Get the QAbstractItemModel data so the picture works
-  ScopedPtr<QMimeData> orig_data(QListWidget::mimeData(items));
+  return rows;
 
-  SongMimeData *mime_data = new SongMimeData;
-  mime_data->backend = manager_->collection_backend();
-  mime_data->songs = songs;
-  mime_data->setUrls(urls);
-  const QStringList orig_formats = orig_data->formats();
-  if (!orig_formats.isEmpty()) {
-    mime_data->setData(orig_formats.constFirst(), orig_data->data(orig_formats.constFirst()));
-  }
+}
+
+void AlbumCoverManagerList::scrollContentsBy(int dx, int dy) {
+
+  QListView::scrollContentsBy(dx, dy);
+  Q_EMIT ViewChanged();
+
+}
+
+void AlbumCoverManagerList::resizeEvent(QResizeEvent *e) {
 
-  return mime_data;
+  QListView::resizeEvent(e);
+  Q_EMIT ViewChanged();
 
 }
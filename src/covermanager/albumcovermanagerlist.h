@@ -25,31 +25,29 @@
 #include "config.h"
 
 #include <QObject>
-#include <QString>
 #include <QList>
-#include <QListWidget>
+#include <QListView>
 
 class QWidget;
-class QMimeData;
-class QListWidgetItem;
 class QDropEvent;
-class AlbumCoverManager;
+class QResizeEvent;
 
-class AlbumCoverManagerList : public QListWidget {
+class AlbumCoverManagerList : public QListView {
   Q_OBJECT
 
  public:
   explicit AlbumCoverManagerList(QWidget *parent = nullptr);
 
-  void set_cover_manager(AlbumCoverManager *manager) { manager_ = manager; }
+  // The rows shown in the viewport, or within margin pixels above or below it.
+  QList<int> RowsInView(const int margin) const;
 
- protected:
-  QMimeData *mimeData(const QList<QListWidgetItem*> &items) const override;
+ Q_SIGNALS:
+  void ViewChanged();
 
+ protected:
   void dropEvent(QDropEvent *e) override { Q_UNUSED(e) }
-
- private:
-  AlbumCoverManager *manager_;
+  void scrollContentsBy(int dx, int dy) override;
+  void resizeEvent(QResizeEvent *e) override;
 };
 
 #endif  // ALBUMCOVERMANAGERLIST_H
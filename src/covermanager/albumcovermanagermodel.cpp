@@ -0,0 +1,298 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QObject>
+#include <QAbstractListModel>
+#include <QList>
+#include <QVariant>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QImage>
+#include <QIcon>
+#include <QPixmap>
+#include <QMimeData>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+
+#include "includes/scoped_ptr.h"
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/songmimedata.h"
+#include "core/database.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectionquery.h"
+#include "albumcovermanagermodel.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+// Enough for a few screens of thumbnails, even with a high device pixel ratio.
+constexpr int kMaxIconCacheKilobytes = 64 * 1024;
+}  // namespace
+
+AlbumCoverManagerModel::AlbumCoverManagerModel(const SharedPtr<CollectionBackend> collection_backend, const QIcon &icon_nocover_item, QObject *parent)
+    : QAbstractListModel(parent),
+      collection_backend_(collection_backend),
+      icon_nocover_item_(icon_nocover_item),
+      icons_(kMaxIconCacheKilobytes) {}
+
+int AlbumCoverManagerModel::rowCount(const QModelIndex &parent) const {
+
+  if (parent.isValid()) return 0;
+
+  return static_cast<int>(albums_.count());
+
+}
+
+QVariant AlbumCoverManagerModel::data(const QModelIndex &idx, const int role) const {
+
+  if (!idx.isValid() || idx.row() < 0 || idx.row() >= albums_.count()) return QVariant();
+
+  const AlbumItem &album_item = albums_[idx.row()];
+  const CollectionBackend::Album &album_info = album_item.album;
+
+  switch (role) {
+    case Qt::DisplayRole:
+      return album_item.display_text;
+    case Qt::DecorationRole:{
+      const QIcon *icon = icons_.object(idx.row());
+      return icon ? *icon : icon_nocover_item_;
+    }
+    case Qt::ToolTipRole:
+      if (album_info.album_artist.isEmpty()) {
+        return album_info.album;
+      }
+      return album_info.album_artist + " - "_L1 + album_info.album;
+    case Qt::TextAlignmentRole:
+      return QVariant(Qt::AlignTop | Qt::AlignHCenter);
+    case Role_AlbumArtist:
+      return album_info.album_artist;
+    case Role_Album:
+      return album_info.album;
+    case Role_ArtEmbedded:
+      return album_info.art_embedded;
+    case Role_ArtAutomatic:
+      return album_info.art_automatic;
+    case Role_ArtManual:
+      return album_info.art_manual;
+    case Role_ArtUnset:
+      return album_info.art_unset;
+    case Role_Filetype:
+      return QVariant::fromValue(album_info.filetype);
+    case Role_CuePath:
+      return album_info.cue_path;
+    default:
+      return QVariant();
+  }
+
+}
+
+bool AlbumCoverManagerModel::setData(const QModelIndex &idx, const QVariant &value, const int role) {
+
+  if (!idx.isValid() || idx.row() < 0 || idx.row() >= albums_.count()) return false;
+
+  CollectionBackend::Album &album_info = albums_[idx.row()].album;
+
+  switch (role) {
+    case Role_ArtEmbedded:
+      album_info.art_embedded = value.toBool();
+      break;
+    case Role_ArtAutomatic:
+      album_info.art_automatic = value.toUrl();
+      break;
+    case Role_ArtManual:
+      album_info.art_manual = value.toUrl();
+      break;
+    case Role_ArtUnset:
+      album_info.art_unset = value.toBool();
+      break;
+    default:
+      return false;
+  }
+
+  // The icon is for the old cover, it's loaded again the next time the album is in view.
+  ClearCover(idx.row());
+
+  Q_EMIT dataChanged(idx, idx, QList<int>() << role << Qt::DecorationRole);
+
+  return true;
+
+}
+
+Qt::ItemFlags AlbumCoverManagerModel::flags(const QModelIndex &idx) const {
+
+  if (!idx.isValid()) return Qt::NoItemFlags;
+
+  return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsDragEnabled;
+
+}
+
+QMimeData *AlbumCoverManagerModel::mimeData(const QModelIndexList &indexes) const {
+
+  // Get songs
+  SongList songs;
+  for (const QModelIndex &idx : indexes) {
+    songs << GetSongsInAlbum(idx.row());
+  }
+
+  if (songs.isEmpty()) return nullptr;
+
+  // Get URLs from the songs
+  QList<QUrl> urls;
+  urls.reserve(songs.count());
+  for (const Song &song : std::as_const(songs)) {
+    urls << song.url();
+  }
+
+  // Get the QAbstractItemModel data so the picture works
+  ScopedPtr<QMimeData> orig_data(QAbstractListModel::mimeData(indexes));
+
+  SongMimeData *mime_data = new SongMimeData;
+  mime_data->backend = collection_backend_;
+  mime_data->songs = songs;
+  mime_data->setUrls(urls);
+  if (orig_data) {
+    const QStringList orig_formats = orig_data->formats();
+    if (!orig_formats.isEmpty()) {
+      mime_data->setData(orig_formats.constFirst(), orig_data->data(orig_formats.constFirst()));
+    }
+  }
+
+  return mime_data;
+
+}
+
+void AlbumCoverManagerModel::SetAlbums(const CollectionBackend::AlbumList &albums, const bool show_album_artist) {
+
+  beginResetModel();
+
+  icons_.clear();
+  albums_.clear();
+  albums_.reserve(albums.count());
+  for (const CollectionBackend::Album &album_info : albums) {
+    AlbumItem album_item;
+    album_item.album = album_info;
+    album_item.display_text = show_album_artist ? album_info.album_artist + " - "_L1 + album_info.album : album_info.album;
+    albums_ << album_item;
+  }
+
+  endResetModel();
+
+}
+
+void AlbumCoverManagerModel::Clear() {
+
+  beginResetModel();
+  icons_.clear();
+  albums_.clear();
+  endResetModel();
+
+}
+
+bool AlbumCoverManagerModel::HasCover(const int row) const {
+
+  if (icons_.contains(row)) return true;
+
+  const AlbumItem &album_item = albums_[row];
+  if (album_item.cover_missing || album_item.album.art_unset) return false;
+
+  return album_item.album.art_embedded || !album_item.album.art_automatic.isEmpty() || !album_item.album.art_manual.isEmpty();
+
+}
+
+bool AlbumCoverManagerModel::NeedsCover(const int row) const {
+
+  if (icons_.contains(row)) return false;
+
+  const AlbumItem &album_item = albums_[row];
+  if (album_item.cover_missing || album_item.album.urls.isEmpty()) return false;
+
+  return album_item.album.art_embedded || !album_item.album.art_automatic.isEmpty() || !album_item.album.art_manual.isEmpty();
+
+}
+
+void AlbumCoverManagerModel::SetCover(const int row, const QImage &image) {
+
+  if (row < 0 || row >= albums_.count()) return;
+
+  albums_[row].cover_missing = false;
+  icons_.insert(row, new QIcon(QPixmap::fromImage(image)), std::max(1, static_cast<int>(image.sizeInBytes() / 1024)));
+
+  const QModelIndex idx = index(row);
+  Q_EMIT dataChanged(idx, idx, QList<int>() << Qt::DecorationRole);
+
+}
+
+void AlbumCoverManagerModel::SetNoCover(const int row) {
+
+  if (row < 0 || row >= albums_.count()) return;
+
+  albums_[row].cover_missing = true;
+  icons_.remove(row);
+
+  const QModelIndex idx = index(row);
+  Q_EMIT dataChanged(idx, idx, QList<int>() << Qt::DecorationRole);
+
+}
+
+void AlbumCoverManagerModel::ClearCover(const int row) {
+
+  albums_[row].cover_missing = false;
+  icons_.remove(row);
+
+}
+
+SongList AlbumCoverManagerModel::GetSongsInAlbum(const int row) const {
+
+  SongList ret;
+
+  if (row < 0 || row >= albums_.count()) return ret;
+
+  const CollectionBackend::Album &album_info = albums_[row].album;
+
+  QMutexLocker l(collection_backend_->db()->Mutex());
+  QSqlDatabase db(collection_backend_->db()->Connect());
+
+  CollectionQuery q(db, collection_backend_->songs_table());
+  q.SetColumnSpec(Song::kRowIdColumnSpec);
+  q.AddWhere(u"album"_s, album_info.album);
+  q.SetOrderBy(u"disc, track, title"_s);
+
+  if (!album_info.album_artist.isEmpty()) {
+    q.AddWhere(u"effective_albumartist"_s, album_info.album_artist);
+  }
+
+  q.AddCompilationRequirement(album_info.album_artist.isEmpty());
+
+  if (!q.Exec()) return ret;
+
+  while (q.Next()) {
+    Song song;
+    song.InitFromQuery(q, true);
+    ret << song;
+  }
+  return ret;
+
+}
@@ -0,0 +1,101 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ALBUMCOVERMANAGERMODEL_H
+#define ALBUMCOVERMANAGERMODEL_H
+
+#include "config.h"
+
+#include <QObject>
+#include <QAbstractListModel>
+#include <QList>
+#include <QVariant>
+#include <QString>
+#include <QStringList>
+#include <QImage>
+#include <QIcon>
+#include <QCache>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "collection/collectionbackend.h"
+
+class QMimeData;
+
+// The albums shown in the cover manager.
+// The album metadata is kept for every album, but cover icons only for a bounded number of albums, the least recently used icons are dropped first.
+// The cover manager loads the covers of the albums in view, and again when an album with a dropped icon comes back into view.
+class AlbumCoverManagerModel : public QAbstractListModel {
+  Q_OBJECT
+
+ public:
+  explicit AlbumCoverManagerModel(const SharedPtr<CollectionBackend> collection_backend, const QIcon &icon_nocover_item, QObject *parent = nullptr);
+
+  enum Role {
+    Role_AlbumArtist = Qt::UserRole + 1,
+    Role_Album,
+    Role_ArtEmbedded,
+    Role_ArtAutomatic,
+    Role_ArtManual,
+    Role_ArtUnset,
+    Role_Filetype,
+    Role_CuePath
+  };
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &idx, const int role) const override;
+  bool setData(const QModelIndex &idx, const QVariant &value, const int role) override;
+  Qt::ItemFlags flags(const QModelIndex &idx) const override;
+  QMimeData *mimeData(const QModelIndexList &indexes) const override;
+
+  void SetAlbums(const CollectionBackend::AlbumList &albums, const bool show_album_artist);
+  void Clear();
+
+  const CollectionBackend::Album &album(const int row) const { return albums_[row].album; }
+
+  // Whether the album has a cover, known for sure once the cover was loaded.
+  bool HasCover(const int row) const;
+  // Whether the cover should be loaded to show the album.
+  bool NeedsCover(const int row) const;
+
+  void SetCover(const int row, const QImage &image);
+  void SetNoCover(const int row);
+
+  SongList GetSongsInAlbum(const int row) const;
+
+ private:
+  struct AlbumItem {
+    AlbumItem() : cover_missing(false) {}
+    CollectionBackend::Album album;
+    QString display_text;
+    // The cover was loaded, but there was no image.
+    bool cover_missing;
+  };
+
+  void ClearCover(const int row);
+
+ private:
+  const SharedPtr<CollectionBackend> collection_backend_;
+  const QIcon icon_nocover_item_;
+  QList<AlbumItem> albums_;
+  // Icons by row, the cost is the size of the icon in kilobytes.
+  QCache<int, QIcon> icons_;
+};
+
+#endif  // ALBUMCOVERMANAGERMODEL_H
@@ -38,6 +38,8 @@ class CoverProvider : public JsonBaseRequest {
   Q_OBJECT
 
  public:
+  static constexpr qint64 kSearchCacheTtl = 7LL * 24LL * 60LL * 60LL;
+
   explicit CoverProvider(const QString &name, const bool enabled, const bool authentication_required, const float quality, const bool batch, const bool allow_missing_album, const SharedPtr<NetworkAccessManager> network, QObject *parent);
 
   QString name() const { return name_; }
@@ -55,6 +57,8 @@ class CoverProvider : public JsonBaseRequest {
   virtual bool authenticated() const override { return true; }
   virtual bool use_authorization_header() const override { return false; }
   virtual QByteArray authorization_header() const override { return QByteArray(); }
+  // Search results of providers that need no account are the same for everyone and change rarely.
+  virtual qint64 metadata_cache_ttl() const override { return authentication_required_ ? 0 : kSearchCacheTtl; }
 
   virtual void Authenticate() {}
   virtual void ClearSession() {}
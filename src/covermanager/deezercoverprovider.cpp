@@ -137,6 +137,8 @@ JsonBaseRequest::JsonObjectResult DeezerCoverProvider::ParseJsonObject(QNetworkR
     }
   }
 
+  if (!result.success()) network_->RemoveFromMetadataCache(reply);
+
   return result;
 
 }
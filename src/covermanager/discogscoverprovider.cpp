@@ -174,6 +174,7 @@ QNetworkReply *DiscogsCoverProvider::CreateRequest(const QUrl &url, const ParamL
 
   QNetworkRequest network_request(request_url);
   network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+  network_request.setAttribute(NetworkAccessManager::kMetadataCacheTtlAttribute, metadata_cache_ttl());
   QNetworkReply *reply = network_->get(network_request);
   replies_ << reply;
 
@@ -226,6 +227,8 @@ JsonBaseRequest::JsonObjectResult DiscogsCoverProvider::ParseJsonObject(QNetwork
     }
   }
 
+  if (!result.success()) network_->RemoveFromMetadataCache(reply);
+
   return result;
 
 }
@@ -150,6 +150,8 @@ JsonBaseRequest::JsonObjectResult LastFmCoverProvider::ParseJsonObject(QNetworkR
     }
   }
 
+  if (!result.success()) network_->RemoveFromMetadataCache(reply);
+
   return result;
 
 }
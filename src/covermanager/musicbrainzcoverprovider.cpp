@@ -143,6 +143,8 @@ JsonBaseRequest::JsonObjectResult MusicbrainzCoverProvider::ParseJsonObject(QNet
     }
   }
 
+  if (!result.success()) network_->RemoveFromMetadataCache(reply);
+
   return result;
 
 }
@@ -40,6 +40,7 @@ class MusicbrainzCoverProvider : public JsonCoverProvider {
   explicit MusicbrainzCoverProvider(const SharedPtr<NetworkAccessManager> network, QObject *parent = nullptr);
 
   bool StartSearch(const QString &artist, const QString &album, const QString &title, const int id) override;
+  qint64 metadata_cache_ttl() const override { return 4LL * kSearchCacheTtl; }
 
  private Q_SLOTS:
   void FlushRequests();
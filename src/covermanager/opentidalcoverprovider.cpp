@@ -228,6 +228,8 @@ JsonBaseRequest::JsonObjectResult OpenTidalCoverProvider::ParseJsonObject(QNetwo
     oauth_->ClearSession();
   }
 
+  if (!result.success()) network_->RemoveFromMetadataCache(reply);
+
   return result;
 
 }
@@ -159,6 +159,15 @@ bool ConnectedDevice::FinishDelete(bool success, QString &error_text) {
   return success;
 }
 
+bool ConnectedDevice::ContainsSong(const Song &metadata) {
+
+  if (!collection_backend_->GetSongsBy(metadata.artist(), metadata.album(), metadata.title()).isEmpty()) return true;
+
+  // Some devices store the album artist as the artist.
+  return metadata.effective_albumartist() != metadata.artist() && !collection_backend_->GetSongsBy(metadata.effective_albumartist(), metadata.album(), metadata.title()).isEmpty();
+
+}
+
 MusicStorage::TranscodeMode ConnectedDevice::GetTranscodeMode() const {
 
   DeviceInfo *info = device_manager_->FindDeviceById(unique_id_);
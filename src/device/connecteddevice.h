@@ -70,6 +70,8 @@ class ConnectedDevice : public QObject, public virtual MusicStorage, public enab
 
   TranscodeMode GetTranscodeMode() const override;
   Song::FileType GetTranscodeFormat() const override;
+  QString TransferJournalId() const override { return unique_id_; }
+  bool ContainsSong(const Song &metadata) override;
 
   DeviceLister *lister() const { return lister_; }
   QString unique_id() const { return unique_id_; }
@@ -22,6 +22,7 @@
 #include "config.h"
 
 #include <memory>
+#include <utility>
 
 #include <glib.h>
 #include <gpod/itdb.h>
@@ -56,6 +57,10 @@ class DeviceManager;
 using std::make_shared;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kCopyBatchSize = 50;
+}
+
 GPodDevice::GPodDevice(const QUrl &url,
                        DeviceLister *lister,
                        const QString &unique_id,
@@ -282,16 +287,70 @@ bool GPodDevice::CopyToStorage(const CopyJob &job, QString &error_text) {
   }
 
   AddTrackToModel(track, url_.path());
+  tracks_to_commit_ << track;
 
-  // Remove the original if it was requested
+  // Remove the original when the batch is committed
   if (job.remove_original_) {
-    QFile::remove(job.source_);
+    files_to_remove_ << job.source_;
   }
 
   return true;
 
 }
 
+int GPodDevice::CopyBatchSize() const { return kCopyBatchSize; }
+
+bool GPodDevice::CommitCopyBatch(QString &error_text) {
+
+  if (tracks_to_commit_.isEmpty()) return true;
+
+  // Write the iTunesDB once for the whole batch, so a transfer interrupted later keeps the tracks of the batches already committed.
+  if (!WriteDatabase(error_text)) {
+    RollbackCopyBatch();
+    return false;
+  }
+
+  if (!songs_to_add_.isEmpty()) {
+    collection_backend_->AddOrUpdateSongs(songs_to_add_);
+    songs_to_add_.clear();
+  }
+  tracks_to_commit_.clear();
+
+  for (const QString &filename : std::as_const(files_to_remove_)) {
+    if (!QFile::remove(filename)) {
+      qLog(Error) << "Failed to remove" << filename;
+    }
+  }
+  files_to_remove_.clear();
+
+  return true;
+
+}
+
+void GPodDevice::RollbackCopyBatch() {
+
+  // Remove the tracks of the failed batch from the database and the iPod again.
+  for (Itdb_Track *track : std::as_const(tracks_to_commit_)) {
+    gchar *filename = itdb_filename_on_ipod(track);
+    if (filename) {
+      QFile::remove(QString::fromUtf8(filename));
+      g_free(filename);
+    }
+    for (GList *playlists = db_->playlists; playlists != nullptr; playlists = playlists->next) {
+      Itdb_Playlist *playlist = static_cast<Itdb_Playlist*>(playlists->data);
+      if (itdb_playlist_contains_track(playlist, track)) {
+        itdb_playlist_remove_track(playlist, track);
+      }
+    }
+    itdb_track_remove(track);
+  }
+
+  tracks_to_commit_.clear();
+  songs_to_add_.clear();
+  files_to_remove_.clear();
+
+}
+
 bool GPodDevice::WriteDatabase(QString &error_text) {
 
   // Write the itunes database
@@ -326,6 +385,8 @@ void GPodDevice::Finish(const bool success) {
 
   songs_to_add_.clear();
   songs_to_remove_.clear();
+  tracks_to_commit_.clear();
+  files_to_remove_.clear();
   cover_files_.clear();
 
   db_busy_.unlock();
@@ -334,7 +395,8 @@ void GPodDevice::Finish(const bool success) {
 
 bool GPodDevice::FinishCopy(bool success, QString &error_text) {
 
-  if (success) success = WriteDatabase(error_text);
+  // Committed batches are already written, only the remaining tracks need another database write.
+  if (success) success = CommitCopyBatch(error_text);
   Finish(success);
   return ConnectedDevice::FinishCopy(success, error_text);
 
@@ -80,6 +80,8 @@ class GPodDevice : public ConnectedDevice, public virtual MusicStorage {
   bool StartCopy(QList<Song::FileType> *supported_filetypes) override;
   bool CopyToStorage(const CopyJob &job, QString &error_text) override;
   bool FinishCopy(bool success, QString &error_text) override;
+  int CopyBatchSize() const override;
+  bool CommitCopyBatch(QString &error_text) override;
 
   void StartDelete() override;
   bool DeleteFromStorage(const DeleteJob &job) override;
@@ -98,6 +100,7 @@ class GPodDevice : public ConnectedDevice, public virtual MusicStorage {
   void Start();
   void Finish(const bool success);
   bool WriteDatabase(QString &error_text);
+  void RollbackCopyBatch();
 
  protected:
   const SharedPtr<TaskManager> task_manager_;
@@ -112,6 +115,8 @@ class GPodDevice : public ConnectedDevice, public virtual MusicStorage {
   QMutex db_busy_;
   SongList songs_to_add_;
   SongList songs_to_remove_;
+  QList<Itdb_Track*> tracks_to_commit_;
+  QStringList files_to_remove_;
   QList<SharedPtr<TemporaryFile>> cover_files_;
 };
 
@@ -24,6 +24,7 @@
 #include <libmtp.h>
 #include <cstdint>
 #include <cstdlib>
+#include <utility>
 
 #include <QThread>
 #include <QMutex>
@@ -51,6 +52,10 @@ class AlbumCoverLoader;
 class DeviceLister;
 class DeviceManager;
 
+namespace {
+constexpr int kCopyBatchSize = 25;
+}
+
 bool MtpDevice::sInitializedLibMTP = false;
 
 MtpDevice::MtpDevice(const QUrl &url,
@@ -215,10 +220,33 @@ bool MtpDevice::CopyToStorage(const CopyJob &job, QString &error_text) {
   metadata_on_device.set_albumartist(""_L1);
   songs_to_add_ << metadata_on_device;
 
-  // Remove the original if requested
+  // Remove the original when the batch is committed
   if (job.remove_original_) {
-    if (!QFile::remove(job.source_)) return false;
+    files_to_remove_ << job.source_;
+  }
+
+  return true;
+
+}
+
+int MtpDevice::CopyBatchSize() const { return kCopyBatchSize; }
+
+bool MtpDevice::CommitCopyBatch(QString &error_text) {
+
+  Q_UNUSED(error_text)
+
+  // The files are already on the device, add them to the collection now so they are kept if the transfer is interrupted later.
+  if (!songs_to_add_.isEmpty()) {
+    collection_backend_->AddOrUpdateSongs(songs_to_add_);
+    songs_to_add_.clear();
+  }
+
+  for (const QString &filename : std::as_const(files_to_remove_)) {
+    if (!QFile::remove(filename)) {
+      qLog(Error) << "Failed to remove" << filename;
+    }
   }
+  files_to_remove_.clear();
 
   return true;
 
@@ -227,12 +255,13 @@ bool MtpDevice::CopyToStorage(const CopyJob &job, QString &error_text) {
 bool MtpDevice::FinishCopy(const bool success, QString &error_text) {
 
   if (success) {
-    if (!songs_to_add_.isEmpty()) collection_backend_->AddOrUpdateSongs(songs_to_add_);
+    CommitCopyBatch(error_text);
     if (!songs_to_remove_.isEmpty()) collection_backend_->DeleteSongs(songs_to_remove_);
   }
 
   songs_to_add_.clear();
   songs_to_remove_.clear();
+  files_to_remove_.clear();
 
   // This is done in the organize thread so close the unique DB connection.
   collection_backend_->Close();
@@ -79,6 +79,8 @@ class MtpDevice : public ConnectedDevice {
   bool StartCopy(QList<Song::FileType> *supported_types) override;
   bool CopyToStorage(const CopyJob &job, QString &error_text) override;
   bool FinishCopy(const bool success, QString &error_text) override;
+  int CopyBatchSize() const override;
+  bool CommitCopyBatch(QString &error_text) override;
 
   void StartDelete() override;
   bool DeleteFromStorage(const DeleteJob &job) override;
@@ -106,6 +108,7 @@ class MtpDevice : public ConnectedDevice {
   bool db_busy_locked_;
   SongList songs_to_add_;
   SongList songs_to_remove_;
+  QStringList files_to_remove_;
 
   ScopedPtr<MtpConnection> connection_;
 };
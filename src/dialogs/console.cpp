@@ -26,12 +26,19 @@
 #include <QString>
 #include <QStringList>
 #include <QFont>
+#include <QDir>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QMessageBox>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QSqlError>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QLabel>
 #include <QScrollBar>
 #include <QTextBrowser>
 
@@ -40,16 +47,25 @@
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
 #include "core/database.h"
+#include "core/databasestatistics.h"
+#include "core/tracing.h"
+#include "core/player.h"
+#include "engine/enginebase.h"
 
 using namespace Qt::Literals::StringLiterals;
 
-Console::Console(const SharedPtr<Database> database, QWidget *parent) : QDialog(parent), ui_{}, database_(database) {
+Console::Console(const SharedPtr<Database> database, const SharedPtr<Player> player, QWidget *parent) : QDialog(parent), ui_{}, database_(database), player_(player) {
 
   ui_.setupUi(this);
 
   setWindowFlags(windowFlags() | Qt::WindowMaximizeButtonHint);
 
   QObject::connect(ui_.run, &QPushButton::clicked, this, &Console::RunQuery);
+  QObject::connect(ui_.trace, &QPushButton::clicked, this, &Console::ToggleTracing);
+  QObject::connect(ui_.save_trace, &QPushButton::clicked, this, &Console::SaveTrace);
+  QObject::connect(ui_.show_statistics, &QPushButton::clicked, this, &Console::ShowStatistics);
+  QObject::connect(ui_.reset_statistics, &QPushButton::clicked, this, &Console::ResetStatistics);
+  QObject::connect(ui_.show_transition_statistics, &QPushButton::clicked, this, &Console::ShowTransitionStatistics);
 
   QFont font(u"Monospace"_s);
   font.setStyleHint(QFont::TypeWriter);
@@ -57,6 +73,14 @@ Console::Console(const SharedPtr<Database> database, QWidget *parent) : QDialog(
   ui_.output->setFont(font);
   ui_.query->setFont(font);
 
+  ui_.collect_statistics->setChecked(DatabaseStatistics::IsEnabled());
+  QObject::connect(ui_.collect_statistics, &QCheckBox::toggled, this, &Console::CollectStatisticsToggled);
+
+  ui_.slow_query_threshold->setValue(static_cast<int>(DatabaseStatistics::Instance()->slow_threshold_usec() / 1000));
+  QObject::connect(ui_.slow_query_threshold, &QSpinBox::valueChanged, this, &Console::SlowQueryThresholdChanged);
+
+  UpdateTracing();
+
 }
 
 void Console::RunQuery() {
@@ -91,3 +115,87 @@ void Console::RunQuery() {
   ui_.output->verticalScrollBar()->setValue(ui_.output->verticalScrollBar()->maximum());
 
 }
+
+void Console::UpdateTracing() {
+
+  if (tracing::IsEnabled()) {
+    ui_.label_trace->setText(tr("Tracing is running"));
+    ui_.trace->setText(tr("Stop tracing"));
+  }
+  else {
+    ui_.label_trace->setText(tr("Tracing is stopped, %1 events recorded").arg(tracing::EventCount()));
+    ui_.trace->setText(tr("Start tracing"));
+  }
+
+}
+
+void Console::ToggleTracing() {
+
+  if (tracing::IsEnabled()) {
+    tracing::Stop();
+  }
+  else {
+    tracing::Start();
+  }
+
+  UpdateTracing();
+
+}
+
+void Console::SaveTrace() {
+
+  const QString default_filename = QDir::home().filePath(u"strawberry-trace-"_s + QDateTime::currentDateTime().toString(u"yyyyMMdd-hhmmss"_s) + u".json"_s);
+  const QString filename = QFileDialog::getSaveFileName(this, tr("Save trace"), default_filename, tr("Chrome trace (*.json)"));
+  if (filename.isEmpty()) return;
+
+  if (!tracing::SaveChromeTrace(filename)) {
+    QMessageBox::critical(this, tr("Save trace"), tr("Could not save the trace to %1.").arg(filename));
+    return;
+  }
+
+  UpdateTracing();
+
+}
+
+void Console::CollectStatisticsToggled(const bool enabled) {
+
+  DatabaseStatistics::SetEnabled(enabled);
+
+}
+
+void Console::SlowQueryThresholdChanged(const int msec) {
+
+  DatabaseStatistics::Instance()->set_slow_threshold_msec(msec);
+
+}
+
+void Console::ShowStatistics() {
+
+  ui_.output->append(u"<pre>"_s + DatabaseStatistics::Instance()->Report().toHtmlEscaped() + u"</pre>"_s);
+  ui_.output->verticalScrollBar()->setValue(ui_.output->verticalScrollBar()->maximum());
+
+}
+
+void Console::ResetStatistics() {
+
+  DatabaseStatistics::Instance()->Reset();
+
+}
+
+void Console::ShowTransitionStatistics() {
+
+  const SharedPtr<EngineBase> engine = player_->engine();
+  if (!engine) return;
+
+  const EngineBase::TransitionStats &stats = engine->transition_stats();
+  const qint64 average_gap_msec = stats.transitions > stats.gapless_transitions ? stats.total_gap_msec / (stats.transitions - stats.gapless_transitions) : 0;
+
+  QStringList lines;
+  lines << u"Transitions: %1, gapless: %2, late preloads: %3"_s.arg(stats.transitions).arg(stats.gapless_transitions).arg(stats.late_preloads)
+        << u"Last preload lead: %1 ms"_s.arg(stats.last_preload_lead_msec)
+        << u"Gap: last %1 ms, average %2 ms, maximum %3 ms"_s.arg(stats.last_gap_msec).arg(average_gap_msec).arg(stats.max_gap_msec);
+
+  ui_.output->append(u"<pre>"_s + lines.join(u'\n').toHtmlEscaped() + u"</pre>"_s);
+  ui_.output->verticalScrollBar()->setValue(ui_.output->verticalScrollBar()->maximum());
+
+}
@@ -34,22 +34,34 @@
 #include "includes/shared_ptr.h"
 
 class Database;
+class Player;
 
 class Console : public QDialog {
   Q_OBJECT
 
  public:
-  explicit Console(const SharedPtr<Database> database, QWidget *parent = nullptr);
+  explicit Console(const SharedPtr<Database> database, const SharedPtr<Player> player, QWidget *parent = nullptr);
 
  private Q_SLOTS:
   void RunQuery();
+  void ToggleTracing();
+  void SaveTrace();
+  void CollectStatisticsToggled(const bool enabled);
+  void SlowQueryThresholdChanged(const int msec);
+  void ShowStatistics();
+  void ResetStatistics();
+  void ShowTransitionStatistics();
 
  Q_SIGNALS:
   void Error(const QString &error);
 
+ private:
+  void UpdateTracing();
+
  private:
   Ui::Console ui_;
   const SharedPtr<Database> database_;
+  const SharedPtr<Player> player_;
 };
 
 #endif  // CONSOLE_H
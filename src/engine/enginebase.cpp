@@ -24,10 +24,12 @@
 #include "config.h"
 
 #include <cmath>
+#include <algorithm>
 
 #include <QtGlobal>
 #include <QVariant>
 #include <QUrl>
+#include <QElapsedTimer>
 #include <QSettings>
 #include <QNetworkProxy>
 
@@ -69,6 +71,7 @@ EngineBase::EngineBase(QObject *parent)
       buffer_low_watermark_(BackendSettings::kDefaultBufferLowWatermark),
       buffer_high_watermark_(BackendSettings::kDefaultBufferHighWatermark),
       device_warmup_duration_ms_(BackendSettings::kDefaultDeviceWarmupDuration),
+      preload_duration_nanosec_(BackendSettings::kDefaultPreloadDuration * kNsecPerSec),
       fadeout_enabled_(true),
       crossfade_enabled_(true),
       autocrossfade_enabled_(false),
@@ -100,9 +103,16 @@ void EngineBase::StartPreloading(const QUrl &media_url, const QUrl &stream_url,
 
 bool EngineBase::Load(const QUrl &media_url, const QUrl &stream_url, const TrackChangeFlags track_change_flags, const bool force_stop_at_end, const quint64 beginning_offset_nanosec, const qint64 end_offset_nanosec, const std::optional<double> ebur128_integrated_loudness_lufs) {
 
-  Q_UNUSED(track_change_flags)
   Q_UNUSED(force_stop_at_end);
 
+  // Only automatic track changes continue a transition.
+  if (track_change_flags & TrackChangeType::Auto) {
+    TransitionNextTrackLoaded();
+  }
+  else {
+    TransitionCancelled();
+  }
+
   media_url_ = media_url;
   stream_url_ = stream_url;
   beginning_offset_nanosec_ = beginning_offset_nanosec;
@@ -186,6 +196,8 @@ void EngineBase::ReloadSettings() {
 
   device_warmup_duration_ms_ = s.value(BackendSettings::kDeviceWarmupDuration, BackendSettings::kDefaultDeviceWarmupDuration).toInt();
 
+  preload_duration_nanosec_ = s.value(BackendSettings::kPreloadDuration, BackendSettings::kDefaultPreloadDuration).toLongLong() * kNsecPerSec;
+
   rg_enabled_ = s.value(BackendSettings::kRgEnabled, BackendSettings::kDefaultRgEnabled).toBool();
   rg_mode_ = s.value(BackendSettings::kRgMode, BackendSettings::kDefaultRgMode).toInt();
   rg_preamp_ = s.value(BackendSettings::kRgPreamp, BackendSettings::kDefaultRgPreamp).toDouble();
@@ -267,6 +279,90 @@ void EngineBase::EmitAboutToFinish() {
 
 }
 
+void EngineBase::TransitionNextUrlPreloaded() {
+
+  if (transition_needed_timer_.isValid()) {
+    ++transition_stats_.late_preloads;
+    transition_stats_.last_preload_lead_msec = -transition_needed_timer_.elapsed();
+    transition_needed_timer_.invalidate();
+    qLog(Debug) << "Next track was preloaded" << -transition_stats_.last_preload_lead_msec << "ms after it was needed";
+  }
+  else {
+    transition_preloaded_timer_.start();
+  }
+
+}
+
+void EngineBase::TransitionNextUrlNeeded() {
+
+  // There might not be a next track, so this is only counted as a late preload once the next track is preloaded or loaded.
+  if (transition_preloaded_timer_.isValid()) {
+    transition_stats_.last_preload_lead_msec = transition_preloaded_timer_.elapsed();
+    transition_preloaded_timer_.invalidate();
+  }
+  else if (!transition_needed_timer_.isValid()) {
+    transition_needed_timer_.start();
+  }
+
+}
+
+void EngineBase::TransitionTrackEnded(const bool gapless) {
+
+  if (gapless) {
+    ++transition_stats_.transitions;
+    ++transition_stats_.gapless_transitions;
+    transition_stats_.last_gap_msec = 0;
+    transition_needed_timer_.invalidate();
+    qLog(Debug) << "Gapless transition, next track was preloaded" << transition_stats_.last_preload_lead_msec << "ms before it was needed." << transition_stats_.gapless_transitions << "of" << transition_stats_.transitions << "transitions were gapless," << transition_stats_.late_preloads << "late preloads";
+  }
+  else {
+    // Only a transition if the next track is loaded, the gap lasts until it is playing.
+    transition_ended_timer_.start();
+  }
+
+  transition_preloaded_timer_.invalidate();
+
+}
+
+void EngineBase::TransitionNextTrackLoaded() {
+
+  if (!transition_ended_timer_.isValid()) return;
+
+  ++transition_stats_.transitions;
+
+  if (transition_needed_timer_.isValid()) {
+    ++transition_stats_.late_preloads;
+    transition_stats_.last_preload_lead_msec = -transition_needed_timer_.elapsed();
+    transition_needed_timer_.invalidate();
+  }
+
+  transition_gap_timer_ = transition_ended_timer_;
+  transition_ended_timer_.invalidate();
+
+}
+
+void EngineBase::TransitionPlaybackStarted() {
+
+  if (!transition_gap_timer_.isValid()) return;
+
+  transition_stats_.last_gap_msec = transition_gap_timer_.elapsed();
+  transition_stats_.max_gap_msec = std::max(transition_stats_.max_gap_msec, transition_stats_.last_gap_msec);
+  transition_stats_.total_gap_msec += transition_stats_.last_gap_msec;
+  transition_gap_timer_.invalidate();
+
+  qLog(Debug) << "Transition gap of" << transition_stats_.last_gap_msec << "ms, maximum" << transition_stats_.max_gap_msec << "ms." << transition_stats_.gapless_transitions << "of" << transition_stats_.transitions << "transitions were gapless," << transition_stats_.late_preloads << "late preloads";
+
+}
+
+void EngineBase::TransitionCancelled() {
+
+  transition_preloaded_timer_.invalidate();
+  transition_needed_timer_.invalidate();
+  transition_ended_timer_.invalidate();
+  transition_gap_timer_.invalidate();
+
+}
+
 bool EngineBase::ValidOutput(const QString &output) {
 
   Q_UNUSED(output);
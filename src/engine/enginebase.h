@@ -37,6 +37,7 @@
 #include <QVariant>
 #include <QString>
 #include <QUrl>
+#include <QElapsedTimer>
 
 #include "core/enginemetadata.h"
 #include "core/song.h"
@@ -88,6 +89,22 @@ class EngineBase : public QObject {
 
   using Scope = std::vector<int16_t>;
 
+  // Timing of automatic transitions to the next track, to verify that the next track is preloaded in time.
+  struct TransitionStats {
+    TransitionStats() : transitions(0), gapless_transitions(0), late_preloads(0), last_preload_lead_msec(0), last_gap_msec(0), max_gap_msec(0), total_gap_msec(0) {}
+    // Automatic transitions, and those where the playing pipeline continued with the preloaded track.
+    int transitions;
+    int gapless_transitions;
+    // Times the pipeline needed the next track before it was preloaded.
+    int late_preloads;
+    // How long before the pipeline needed it the next track was preloaded, negative when it was late.
+    qint64 last_preload_lead_msec;
+    // Time between the end of a track and the start of the next track, when the next track wasn't preloaded and needed a new pipeline.
+    qint64 last_gap_msec;
+    qint64 max_gap_msec;
+    qint64 total_gap_msec;
+  };
+
   virtual bool Init() = 0;
   virtual State state() const = 0;
   virtual void StartPreloading(const QUrl &media_url, const QUrl &stream_url, const bool force_stop_at_end, const qint64 beginning_offset_nanosec, const qint64 end_offset_nanosec);
@@ -141,6 +158,8 @@ class EngineBase : public QObject {
   bool crossfade_same_album() const { return crossfade_same_album_; }
   bool IsEqualizerEnabled() const { return equalizer_enabled_; }
 
+  const TransitionStats &transition_stats() const { return transition_stats_; }
+
   static const int kScopeSize = 1024;
 
   QVariant device() { return device_; }
@@ -182,6 +201,15 @@ class EngineBase : public QObject {
   virtual void SetSpotifyAccessToken() {}
 #endif
 
+ protected:
+  // Called by the engine to measure the transitions to the next track.
+  void TransitionNextUrlPreloaded();
+  void TransitionNextUrlNeeded();
+  void TransitionTrackEnded(const bool gapless);
+  void TransitionNextTrackLoaded();
+  void TransitionPlaybackStarted();
+  void TransitionCancelled();
+
  protected:
   bool playbin3_enabled_;
   bool exclusive_mode_;
@@ -220,6 +248,9 @@ class EngineBase : public QObject {
   // Audio device (DAC) warm-up delay in milliseconds inserted between preroll (PAUSED) and playback (PLAYING) to give the device time to become ready, avoiding the start of the track being cut off.
   int device_warmup_duration_ms_;
 
+  // How long before the end of the track TrackAboutToEnd is emitted, so the next track is resolved and preloaded in time.
+  qint64 preload_duration_nanosec_;
+
   // Fadeout
   bool fadeout_enabled_;
   bool crossfade_enabled_;
@@ -253,6 +284,13 @@ class EngineBase : public QObject {
 
   bool about_to_end_emitted_;
 
+ private:
+  TransitionStats transition_stats_;
+  QElapsedTimer transition_preloaded_timer_;
+  QElapsedTimer transition_needed_timer_;
+  QElapsedTimer transition_ended_timer_;
+  QElapsedTimer transition_gap_timer_;
+
   Q_DISABLE_COPY(EngineBase)
 };
 
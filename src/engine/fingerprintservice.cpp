@@ -0,0 +1,240 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <QtGlobal>
+#include <QThread>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QFileInfo>
+#include <QStorageInfo>
+#include <QFuture>
+#include <QPromise>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "chromaprinter.h"
+#include "fingerprintservice.h"
+
+using std::make_shared;
+
+namespace {
+// Each worker runs a GStreamer decode pipeline, more than this mostly competes for the disk.
+constexpr int kMaxWorkers = 4;
+// The device of a directory is looked up with a statfs call, remember it for the files in the same directory.
+constexpr int kMaxCachedDirectories = 1000;
+}  // namespace
+
+FingerprintService::FingerprintService(const int max_workers, const int max_readers_per_device)
+    : max_workers_(std::max(1, max_workers)),
+      max_readers_per_device_(std::max(1, max_readers_per_device)),
+      fingerprint_function_(&FingerprintService::ChromaprintFingerprint),
+      workers_(0),
+      running_(0) {
+
+  threadpool_.setMaxThreadCount(max_workers_);
+
+}
+
+FingerprintService::~FingerprintService() {
+
+  {
+    QMutexLocker l(&mutex_);
+    interactive_jobs_.clear();
+    background_jobs_.clear();
+  }
+
+  threadpool_.waitForDone();
+
+}
+
+int FingerprintService::DefaultMaxWorkers() {
+
+  return std::clamp(QThread::idealThreadCount() / 2, 1, kMaxWorkers);
+
+}
+
+FingerprintService *FingerprintService::Instance() {
+
+  // C++11 guarantees thread-safe initialization of static local variables
+  static FingerprintService fingerprint_service;
+  return &fingerprint_service;
+
+}
+
+int FingerprintService::queued() const {
+
+  QMutexLocker l(&mutex_);
+  return static_cast<int>(interactive_jobs_.count() + background_jobs_.count());
+
+}
+
+FingerprintService::Stats FingerprintService::stats() const {
+
+  QMutexLocker l(&mutex_);
+  Stats stats = stats_;
+  if (running_ > 0) {
+    stats.busy_msec += busy_timer_.elapsed();
+  }
+  return stats;
+
+}
+
+QByteArray FingerprintService::DeviceForUrl(const QUrl &url) {
+
+  if (!url.isLocalFile()) {
+    return url.host().toUtf8();
+  }
+
+  const QString directory = QFileInfo(url.toLocalFile()).absolutePath();
+
+  {
+    QMutexLocker l(&mutex_);
+    const QHash<QString, QByteArray>::const_iterator it = device_by_directory_.constFind(directory);
+    if (it != device_by_directory_.constEnd()) {
+      return it.value();
+    }
+  }
+
+  const QByteArray device = QStorageInfo(directory).device();
+
+  QMutexLocker l(&mutex_);
+  if (device_by_directory_.count() >= kMaxCachedDirectories) {
+    device_by_directory_.clear();
+  }
+  device_by_directory_.insert(directory, device);
+
+  return device;
+
+}
+
+QFuture<FingerprintService::Result> FingerprintService::Fingerprint(const QUrl &url, const Algorithm algorithm, const Priority priority) {
+
+  JobPtr job = make_shared<Job>();
+  job->url = url;
+  job->algorithm = algorithm;
+  job->device = DeviceForUrl(url);
+
+  QFuture<Result> future = job->promise.future();
+
+  QMutexLocker l(&mutex_);
+
+  if (priority == Priority::Interactive) {
+    interactive_jobs_ << job;
+  }
+  else {
+    background_jobs_ << job;
+  }
+
+  if (workers_ < max_workers_) {
+    ++workers_;
+    threadpool_.start([this]() { Run(); });
+  }
+
+  return future;
+
+}
+
+FingerprintService::JobPtr FingerprintService::TakeNextJob() {
+
+  // Called with mutex_ locked.
+
+  for (QList<JobPtr> *jobs : { &interactive_jobs_, &background_jobs_ }) {
+    for (QList<JobPtr>::iterator it = jobs->begin(); it != jobs->end();) {
+      const JobPtr job = *it;
+      if (job->promise.isCanceled()) {
+        // Destroying the promise finishes the cancelled future.
+        it = jobs->erase(it);
+        continue;
+      }
+      if (device_readers_.value(job->device, 0) < max_readers_per_device_) {
+        jobs->erase(it);
+        ++device_readers_[job->device];
+        return job;
+      }
+      ++it;
+    }
+  }
+
+  return JobPtr();
+
+}
+
+void FingerprintService::Run() {
+
+  while (true) {
+
+    JobPtr job;
+    {
+      QMutexLocker l(&mutex_);
+      job = TakeNextJob();
+      if (!job) {
+        // The remaining jobs wait for a device, and are taken by the workers reading from it.
+        --workers_;
+        return;
+      }
+      if (running_++ == 0) {
+        busy_timer_.start();
+      }
+    }
+
+    job->promise.start();
+    const Result result = fingerprint_function_(job->url, job->algorithm);
+    job->promise.addResult(result);
+    job->promise.finish();
+
+    QMutexLocker l(&mutex_);
+    if (--device_readers_[job->device] <= 0) {
+      device_readers_.remove(job->device);
+    }
+    if (result.fingerprint.isEmpty()) {
+      ++stats_.failures;
+    }
+    else {
+      ++stats_.fingerprints;
+    }
+    if (--running_ == 0) {
+      stats_.busy_msec += busy_timer_.elapsed();
+      if (interactive_jobs_.isEmpty() && background_jobs_.isEmpty()) {
+        qLog(Debug) << "Created" << stats_.fingerprints << "fingerprints," << stats_.failures << "failed," << stats_.fingerprints_per_second() << "per second";
+      }
+    }
+
+  }
+
+}
+
+FingerprintService::Result FingerprintService::ChromaprintFingerprint(const QUrl &url, const Algorithm algorithm) {
+
+  Chromaprinter chromaprinter(url);
+  Result result;
+  result.fingerprint = algorithm == Algorithm::Legacy ? chromaprinter.CreateFingerprint() : chromaprinter.CreateFullFingerprint();
+  result.error = chromaprinter.LastError();
+  return result;
+
+}
@@ -0,0 +1,125 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FINGERPRINTSERVICE_H
+#define FINGERPRINTSERVICE_H
+
+#include "config.h"
+
+#include <functional>
+
+#include <QtGlobal>
+#include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QFuture>
+#include <QPromise>
+#include <QMutex>
+#include <QThreadPool>
+#include <QElapsedTimer>
+
+#include "includes/shared_ptr.h"
+
+// Creates Chromaprint fingerprints on a fixed number of worker threads shared by the whole application.
+// Every fingerprint decodes the file, so the number of files read at the same time from one device is limited too, to keep a collection scan from seeking a disk to death.
+// Interactive requests, like the tag fetcher, are started before background requests, like the collection scan.
+class FingerprintService {
+ public:
+  explicit FingerprintService(const int max_workers = DefaultMaxWorkers(), const int max_readers_per_device = kDefaultMaxReadersPerDevice);
+  ~FingerprintService();
+
+  static constexpr int kDefaultMaxReadersPerDevice = 2;
+  static int DefaultMaxWorkers();
+
+  static FingerprintService *Instance();
+
+  enum class Priority {
+    Background,
+    Interactive
+  };
+
+  enum class Algorithm {
+    // Chromaprinter::CreateFingerprint(), used for song tracking.
+    Legacy,
+    // Chromaprinter::CreateFullFingerprint(), used for AcoustID lookups.
+    Full
+  };
+
+  struct Result {
+    QString fingerprint;
+    QString error;
+  };
+
+  struct Stats {
+    Stats() : fingerprints(0), failures(0), busy_msec(0) {}
+    int fingerprints;
+    int failures;
+    // Time with at least one fingerprint being created.
+    qint64 busy_msec;
+    double fingerprints_per_second() const { return busy_msec > 0 ? static_cast<double>(fingerprints + failures) * 1000.0 / static_cast<double>(busy_msec) : 0.0; }
+  };
+
+  // Cancelling the future drops the request if it hasn't started yet.
+  QFuture<Result> Fingerprint(const QUrl &url, const Algorithm algorithm, const Priority priority);
+
+  int max_workers() const { return max_workers_; }
+  int max_readers_per_device() const { return max_readers_per_device_; }
+  int queued() const;
+  Stats stats() const;
+
+  // Replaces Chromaprinter, for testing the scheduling.
+  using FingerprintFunction = std::function<Result(const QUrl &url, const Algorithm algorithm)>;
+  void set_fingerprint_function(const FingerprintFunction &fingerprint_function) { fingerprint_function_ = fingerprint_function; }
+
+ private:
+  struct Job {
+    QUrl url;
+    Algorithm algorithm;
+    QByteArray device;
+    QPromise<Result> promise;
+  };
+  using JobPtr = SharedPtr<Job>;
+
+  QByteArray DeviceForUrl(const QUrl &url);
+  JobPtr TakeNextJob();
+  void Run();
+
+  static Result ChromaprintFingerprint(const QUrl &url, const Algorithm algorithm);
+
+ private:
+  const int max_workers_;
+  const int max_readers_per_device_;
+  FingerprintFunction fingerprint_function_;
+
+  mutable QMutex mutex_;
+  QList<JobPtr> interactive_jobs_;
+  QList<JobPtr> background_jobs_;
+  QHash<QByteArray, int> device_readers_;
+  QHash<QString, QByteArray> device_by_directory_;
+  int workers_;
+  int running_;
+  Stats stats_;
+  QElapsedTimer busy_timer_;
+
+  QThreadPool threadpool_;
+};
+
+#endif  // FINGERPRINTSERVICE_H
@@ -49,6 +49,8 @@
 #include <QEasingCurve>
 #include <QMetaObject>
 #include <QTimerEvent>
+#include <QFile>
+#include <QtConcurrentRun>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -87,8 +89,11 @@ constexpr char kWASAPISink[] = "wasapisink";
 constexpr char kWASAPI2Sink[] = "wasapi2sink";
 constexpr int kDiscoveryTimeoutS = 10;
 constexpr qint64 kTimerIntervalNanosec = 1000 * kNsecPerMsec;  // 1s
-constexpr qint64 kPreloadGapNanosec = 8000 * kNsecPerMsec;     // 8s
 constexpr qint64 kSeekDelayNanosec = 100 * kNsecPerMsec;       // 100msec
+// The beginning and the end of the next file are read before it's needed, that's where the headers and tags are.
+constexpr qint64 kPrereadHeadBytes = 4LL * 1024LL * 1024LL;  // 4 MB
+constexpr qint64 kPrereadTailBytes = 256LL * 1024LL;         // 256 KB
+constexpr qint64 kPrereadChunkBytes = 64LL * 1024LL;         // 64 KB
 }  // namespace
 
 #ifdef __clang__
@@ -188,6 +193,8 @@ void GstEngine::StartPreloading(const QUrl &media_url, const QUrl &stream_url, c
       current_pipeline_->SetSourceDevice(gst_url.source_device);
     }
     current_pipeline_->PrepareNextUrl(media_url, stream_url, gst_url.url, beginning_offset_nanosec, force_stop_at_end ? end_offset_nanosec : 0);
+    TransitionNextUrlPreloaded();
+    PrereadNextUrl(stream_url);
     // Add request to discover the stream
     if (discoverer_ && media_url.scheme() != u"spotify"_s) {
       if (!gst_discoverer_discover_uri_async(discoverer_, gst_url.url.constData())) {
@@ -323,6 +330,8 @@ void GstEngine::Stop(const bool stop_after) {
   delayed_state_pause_ = false;
   delayed_state_offset_nanosec_ = 0;
 
+  TransitionCancelled();
+
   media_url_.clear();
   stream_url_.clear();  // To ensure we return Empty from state()
   beginning_offset_nanosec_ = 0;
@@ -608,7 +617,7 @@ void GstEngine::timerEvent(QTimerEvent *e) {
       const qint64 current_position = position_nanosec();
       const qint64 remaining = current_length - current_position;
       const qint64 fudge = kTimerIntervalNanosec + 100 * kNsecPerMsec;  // Mmm fudge
-      const qint64 gap = static_cast<qint64>(buffer_duration_nanosec_) + (autocrossfade_enabled_ ? fadeout_duration_nanosec_ : kPreloadGapNanosec);
+      const qint64 gap = static_cast<qint64>(buffer_duration_nanosec_) + (autocrossfade_enabled_ ? fadeout_duration_nanosec_ : preload_duration_nanosec_);
       // Emit TrackAboutToEnd when we're a few seconds away from finishing
       if (remaining < gap + fudge) {
         qLog(Debug) << "Stream from URL" << media_url_.toString() << "about to end in" << remaining / kNsecPerSec << "seconds. Fudge:" << fudge / kNsecPerMsec << "+" << "Gap:" << gap / kNsecPerMsec;
@@ -625,6 +634,8 @@ void GstEngine::EndOfStreamReached(const int pipeline_id, const bool has_next_tr
     return;
   }
 
+  TransitionTrackEnded(has_next_track);
+
   if (!has_next_track) {
     GstEnginePipelinePtr old_pipeline = current_pipeline_;
     FinishPipeline(old_pipeline);
@@ -757,6 +768,7 @@ void GstEngine::PlayDone(const GstStateChangeReturn state_change_return, const b
 
   if (!pause) {
     StartTimers();
+    TransitionPlaybackStarted();
   }
 
   Q_EMIT StateChanged(pause ? State::Paused : State::Playing);
@@ -766,6 +778,14 @@ void GstEngine::PlayDone(const GstStateChangeReturn state_change_return, const b
 
 }
 
+void GstEngine::PipelineAboutToFinish() {
+
+  // The pipeline needs the next track now, it's gapless if it was already preloaded.
+  TransitionNextUrlNeeded();
+  EmitAboutToFinish();
+
+}
+
 void GstEngine::BufferingStarted() {
 
   if (buffering_task_id_ != -1) {
@@ -838,7 +858,7 @@ void GstEngine::StartFadeout(GstEnginePipelinePtr pipeline) {
   QObject::disconnect(&*pipeline, &GstEnginePipeline::BufferingProgress, this, &GstEngine::BufferingProgress);
   QObject::disconnect(&*pipeline, &GstEnginePipeline::BufferingFinished, this, &GstEngine::BufferingFinished);
   QObject::disconnect(&*pipeline, &GstEnginePipeline::VolumeChanged, this, &EngineBase::UpdateVolume);
-  QObject::disconnect(&*pipeline, &GstEnginePipeline::AboutToFinish, this, &EngineBase::EmitAboutToFinish);
+  QObject::disconnect(&*pipeline, &GstEnginePipeline::AboutToFinish, this, &GstEngine::PipelineAboutToFinish);
 
   fadeout_pipelines_.insert(pipeline->id(), pipeline);
   pipeline->RemoveAllBufferConsumers();
@@ -922,7 +942,7 @@ GstEnginePipelinePtr GstEngine::CreatePipeline() {
   QObject::connect(&*pipeline, &GstEnginePipeline::BufferingProgress, this, &GstEngine::BufferingProgress);
   QObject::connect(&*pipeline, &GstEnginePipeline::BufferingFinished, this, &GstEngine::BufferingFinished);
   QObject::connect(&*pipeline, &GstEnginePipeline::VolumeChanged, this, &EngineBase::UpdateVolume);
-  QObject::connect(&*pipeline, &GstEnginePipeline::AboutToFinish, this, &EngineBase::EmitAboutToFinish);
+  QObject::connect(&*pipeline, &GstEnginePipeline::AboutToFinish, this, &GstEngine::PipelineAboutToFinish);
 
   return pipeline;
 
@@ -1174,6 +1194,39 @@ QString GstEngine::GSTdiscovererErrorMessage(GstDiscovererResult result) {
 
 }
 
+void GstEngine::PrereadNextUrl(const QUrl &stream_url) {
+
+  // Streams are opened by the discoverer, local files on slow disks and network shares are read into the cache here.
+  if (!stream_url.isLocalFile() || preread_future_.isRunning()) return;
+
+  preread_future_ = QtConcurrent::run(&GstEngine::PrereadFile, stream_url.toLocalFile());
+
+}
+
+void GstEngine::PrereadFile(const QString &filename) {
+
+  QFile file(filename);
+  if (!file.open(QIODevice::ReadOnly)) return;
+
+  QByteArray buffer(static_cast<qsizetype>(kPrereadChunkBytes), Qt::Uninitialized);
+  const auto read = [&file, &buffer](qint64 bytes) {
+    while (bytes > 0) {
+      const qint64 bytes_read = file.read(buffer.data(), std::min(bytes, kPrereadChunkBytes));
+      if (bytes_read <= 0) return;
+      bytes -= bytes_read;
+    }
+  };
+
+  const qint64 size = file.size();
+  read(std::min(size, kPrereadHeadBytes));
+  if (size > kPrereadHeadBytes + kPrereadTailBytes && file.seek(size - kPrereadTailBytes)) {
+    read(kPrereadTailBytes);
+  }
+
+  file.close();
+
+}
+
 bool GstEngine::OldExclusivePipelineActive() const {
 
   if (current_pipeline_ && current_pipeline_->exclusive_mode() && (!fadeout_pipelines_.isEmpty() || !old_pipelines_.isEmpty())) {
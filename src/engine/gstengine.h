@@ -116,6 +116,7 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   void FadeoutPauseFinished();
   void SeekNow();
   void PlayDone(const GstStateChangeReturn ret, const bool pause, const int pipeline_id);
+  void PipelineAboutToFinish();
 
   void BufferingStarted();
   void BufferingProgress(int percent);
@@ -140,6 +141,9 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
 
   void UpdateScope(int chunk_length);
 
+  void PrereadNextUrl(const QUrl &stream_url);
+  static void PrereadFile(const QString &filename);
+
   static void StreamDiscovered(GstDiscoverer *discoverer, GstDiscovererInfo *info, GError *error, gpointer self);
   static void StreamDiscoveryFinished(GstDiscoverer *discoverer, gpointer self);
   static QString GSTdiscovererErrorMessage(GstDiscovererResult result);
@@ -187,6 +191,8 @@ class GstEngine : public EngineBase, public GstBufferConsumer {
   int scope_chunks_;
   QString buffer_format_;
 
+  QFuture<void> preread_future_;
+
   int discovery_finished_cb_id_;
   int discovery_discovered_cb_id_;
 
@@ -65,6 +65,7 @@
 #include <QVersionNumber>
 
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/signalchecker.h"
 #include "constants/timeconstants.h"
 #include "constants/backendsettings.h"
@@ -2171,7 +2172,10 @@ QFuture<GstStateChangeReturn> GstEnginePipeline::SetState(const GstState state)
     watcher->deleteLater();
     SetStateFinishedSlot(state, state_change_return);
   });
-  QFuture<GstStateChangeReturn> future = QtConcurrent::run(shared_state_threadpool(), &gst_element_set_state, pipeline_, state);
+  QFuture<GstStateChangeReturn> future = QtConcurrent::run(shared_state_threadpool(), [pipeline = pipeline_, state]() {
+    TRACE_SCOPE("engine", "Pipeline state change");
+    return gst_element_set_state(pipeline, state);
+  });
   watcher->setFuture(future);
 
   // Track this future so the destructor can wait for it and so it counts as a state change in progress.
@@ -0,0 +1,128 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QIODevice>
+#include <QNetworkDiskCache>
+#include <QNetworkCacheMetaData>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+
+#include "includes/scoped_ptr.h"
+#include "core/logging.h"
+#include "core/standardpaths.h"
+#include "lyricscache.h"
+#include "lyricssearchrequest.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr qint64 kMaxCacheSizeBytes = 20LL * 1024LL * 1024LL;
+constexpr int kLyricsExpireDays = 180;
+constexpr int kNoLyricsExpireDays = 7;
+constexpr char kProviderHeader[] = "provider";
+}  // namespace
+
+LyricsCache::LyricsCache(const QString &cache_directory) : cache_(new QNetworkDiskCache) {
+
+  cache_->setCacheDirectory(cache_directory.isEmpty() ? StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u"/lyrics"_s : cache_directory);
+  cache_->setMaximumCacheSize(kMaxCacheSizeBytes);
+
+}
+
+LyricsCache::~LyricsCache() = default;
+
+QString LyricsCache::Key(const LyricsSearchRequest &request) {
+
+  // Providers match case insensitively, so the same song tagged slightly differently should share an entry.
+  const QString artist = (request.albumartist.isEmpty() ? request.artist : request.albumartist).toCaseFolded().simplified();
+  const QString album = request.album.toCaseFolded().simplified();
+  const QString title = request.title.toCaseFolded().simplified();
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(artist.toUtf8());
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(album.toUtf8());
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(title.toUtf8());
+  hash.addData(QByteArrayView("\n"));
+  hash.addData(QByteArray::number(request.duration));
+
+  return QString::fromLatin1(hash.result().toHex());
+
+}
+
+QUrl LyricsCache::CacheUrlEntry(const QString &key) {
+
+  return QUrl(u"lyrics:"_s + key);
+
+}
+
+bool LyricsCache::Lookup(const QString &key, Entry *entry) const {
+
+  const QNetworkCacheMetaData metadata = cache_->metaData(CacheUrlEntry(key));
+  if (!metadata.isValid()) return false;
+
+  if (metadata.expirationDate().isValid() && metadata.expirationDate() < QDateTime::currentDateTime()) {
+    cache_->remove(metadata.url());
+    return false;
+  }
+
+  ScopedPtr<QIODevice> device(cache_->data(metadata.url()));
+  if (!device) return false;
+
+  entry->lyrics = QString::fromUtf8(device->readAll());
+  entry->provider.clear();
+  const QNetworkCacheMetaData::RawHeaderList headers = metadata.rawHeaders();
+  for (const QNetworkCacheMetaData::RawHeader &header : headers) {
+    if (header.first == kProviderHeader) {
+      entry->provider = QString::fromUtf8(header.second);
+    }
+  }
+
+  return true;
+
+}
+
+void LyricsCache::Insert(const QString &key, const QString &provider, const QString &lyrics) {
+
+  QNetworkCacheMetaData metadata;
+  metadata.setSaveToDisk(true);
+  metadata.setUrl(CacheUrlEntry(key));
+  // Qt 6 ignores any entry without headers, the provider header is always set, empty for negative entries.
+  metadata.setRawHeaders(QNetworkCacheMetaData::RawHeaderList() << qMakePair(QByteArray(kProviderHeader), provider.toUtf8()));
+  metadata.setExpirationDate(QDateTime::currentDateTime().addDays(lyrics.isEmpty() ? kNoLyricsExpireDays : kLyricsExpireDays));
+
+  QIODevice *device = cache_->prepare(metadata);
+  if (!device) return;
+
+  const QByteArray data = lyrics.toUtf8();
+  if (device->write(data) == data.size()) {
+    cache_->insert(device);
+  }
+  else {
+    qLog(Warning) << "Short write to lyrics cache";
+    cache_->remove(metadata.url());
+  }
+
+}
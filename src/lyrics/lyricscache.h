@@ -0,0 +1,62 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LYRICSCACHE_H
+#define LYRICSCACHE_H
+
+#include "config.h"
+
+#include <QString>
+#include <QUrl>
+
+#include "includes/scoped_ptr.h"
+#include "lyricssearchrequest.h"
+
+class QNetworkDiskCache;
+
+// Persistent lyrics search results in a QNetworkDiskCache at CacheLocation/lyrics, keyed by the normalized artist, album, title and length of the request.
+// Found lyrics are stored with the provider they came from, searches that found nothing are stored as negative entries that expire sooner, so they are retried later.
+class LyricsCache {
+ public:
+  explicit LyricsCache(const QString &cache_directory = QString());
+  ~LyricsCache();
+
+  class Entry {
+   public:
+    Entry() {}
+    QString provider;
+    QString lyrics;
+    bool negative() const { return lyrics.isEmpty(); }
+  };
+
+  static QString Key(const LyricsSearchRequest &request);
+
+  bool Lookup(const QString &key, Entry *entry) const;
+  void Insert(const QString &key, const QString &provider, const QString &lyrics);
+
+ private:
+  static QUrl CacheUrlEntry(const QString &key);
+
+ private:
+  ScopedPtr<QNetworkDiskCache> cache_;
+
+  Q_DISABLE_COPY(LyricsCache)
+};
+
+#endif  // LYRICSCACHE_H
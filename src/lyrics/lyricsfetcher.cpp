@@ -22,6 +22,7 @@
 #include <chrono>
 
 #include <QtGlobal>
+#include <QMetaObject>
 #include <QTimer>
 #include <QString>
 
@@ -31,17 +32,20 @@
 #include "lyricsfetchersearch.h"
 #include "lyricssearchrequest.h"
 #include "lyricssearchresult.h"
+#include "lyricscache.h"
 
 using namespace std::chrono_literals;
 
 namespace {
 constexpr int kMaxConcurrentRequests = 5;
+constexpr int kMaxConcurrentPrefetchRequests = 1;
 }
 
 LyricsFetcher::LyricsFetcher(const SharedPtr<LyricsProviders> lyrics_providers, QObject *parent)
     : QObject(parent),
       lyrics_providers_(lyrics_providers),
       next_id_(0),
+      cache_(new LyricsCache),
       request_starter_(new QTimer(this)) {
 
   request_starter_->setInterval(500ms);
@@ -49,7 +53,9 @@ LyricsFetcher::LyricsFetcher(const SharedPtr<LyricsProviders> lyrics_providers,
 
 }
 
-quint64 LyricsFetcher::Search(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration) {
+LyricsFetcher::~LyricsFetcher() = default;
+
+LyricsSearchRequest LyricsFetcher::MakeSearchRequest(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration) {
 
   LyricsSearchRequest search_request;
   search_request.albumartist = effective_albumartist;
@@ -58,18 +64,100 @@ quint64 LyricsFetcher::Search(const QString &effective_albumartist, const QStrin
   search_request.title = Song::TitleRemoveMisc(title);
   search_request.duration = duration;
 
+  return search_request;
+
+}
+
+quint64 LyricsFetcher::Search(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration) {
+
   Request request;
   request.id = ++next_id_;
-  request.search_request = search_request;
+  request.search_request = MakeSearchRequest(effective_albumartist, artist, album, title, duration);
+  request.cache_key = LyricsCache::Key(request.search_request);
+
+  LyricsCache::Entry entry;
+  if (cache_->Lookup(request.cache_key, &entry)) {
+    // Callers only know the request ID once this returns, so the result is signalled from the event loop.
+    cached_requests_ << request.id;
+    QMetaObject::invokeMethod(this, [this, id = request.id, entry]() { CachedLyricsFetched(id, entry); }, Qt::QueuedConnection);
+    return request.id;
+  }
+
+  // Wait for a prefetch of the same song that is already running instead of searching again.
+  for (QHash<quint64, QString>::const_iterator it = active_request_keys_.constBegin(); it != active_request_keys_.constEnd(); ++it) {
+    if (it.value() == request.cache_key && prefetch_requests_.contains(it.key()) && !waiting_requests_.contains(it.key())) {
+      waiting_requests_.insert(it.key(), request.id);
+      return request.id;
+    }
+  }
+
+  // A queued prefetch of the same song is replaced by this request.
+  for (qsizetype i = queued_requests_.size() - 1; i >= 0; --i) {
+    if (queued_requests_.at(i).prefetch && queued_requests_.at(i).cache_key == request.cache_key) {
+      prefetch_requests_.remove(queued_requests_.takeAt(i).id);
+    }
+  }
+
   AddRequest(request);
 
   return request.id;
 
 }
 
+void LyricsFetcher::Prefetch(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration) {
+
+  Request request;
+  request.search_request = MakeSearchRequest(effective_albumartist, artist, album, title, duration);
+  request.cache_key = LyricsCache::Key(request.search_request);
+  request.prefetch = true;
+
+  if (HasRequestForKey(request.cache_key)) return;
+
+  LyricsCache::Entry entry;
+  if (cache_->Lookup(request.cache_key, &entry)) return;
+
+  request.id = ++next_id_;
+  prefetch_requests_ << request.id;
+  AddRequest(request);
+
+}
+
+bool LyricsFetcher::HasRequestForKey(const QString &cache_key) const {
+
+  for (const Request &request : queued_requests_) {
+    if (request.cache_key == cache_key) return true;
+  }
+
+  for (const QString &active_cache_key : active_request_keys_) {
+    if (active_cache_key == cache_key) return true;
+  }
+
+  return false;
+
+}
+
+int LyricsFetcher::ActivePrefetchRequests() const {
+
+  int count = 0;
+  for (const quint64 id : prefetch_requests_) {
+    if (active_requests_.contains(id)) ++count;
+  }
+
+  return count;
+
+}
+
 void LyricsFetcher::AddRequest(const Request &request) {
 
-  queued_requests_.enqueue(request);
+  // Prefetch requests are kept at the back of the queue, behind the songs that are needed now.
+  if (request.prefetch) {
+    queued_requests_.enqueue(request);
+  }
+  else {
+    qsizetype i = 0;
+    while (i < queued_requests_.size() && !queued_requests_.at(i).prefetch) ++i;
+    queued_requests_.insert(i, request);
+  }
 
   if (!request_starter_->isActive()) request_starter_->start();
 
@@ -79,14 +167,23 @@ void LyricsFetcher::AddRequest(const Request &request) {
 
 void LyricsFetcher::Clear() {
 
-  queued_requests_.clear();
+  for (qsizetype i = queued_requests_.size() - 1; i >= 0; --i) {
+    if (!queued_requests_.at(i).prefetch) {
+      queued_requests_.removeAt(i);
+    }
+  }
 
-  const QList<LyricsFetcherSearch*> searches = active_requests_.values();
-  for (LyricsFetcherSearch *search : searches) {
+  const QList<quint64> ids = active_requests_.keys();
+  for (const quint64 id : ids) {
+    if (prefetch_requests_.contains(id)) continue;
+    LyricsFetcherSearch *search = active_requests_.take(id);
+    active_request_keys_.remove(id);
     search->Cancel();
     search->deleteLater();
   }
-  active_requests_.clear();
+
+  waiting_requests_.clear();
+  cached_requests_.clear();
 
 }
 
@@ -99,10 +196,14 @@ void LyricsFetcher::StartRequests() {
 
   while (!queued_requests_.isEmpty() && active_requests_.size() < kMaxConcurrentRequests) {
 
+    // Everything behind a prefetch request is a prefetch request too.
+    if (queued_requests_.head().prefetch && ActivePrefetchRequests() >= kMaxConcurrentPrefetchRequests) break;
+
     Request request = queued_requests_.dequeue();
 
     LyricsFetcherSearch *search = new LyricsFetcherSearch(request.id, request.search_request, this);
     active_requests_.insert(request.id, search);
+    active_request_keys_.insert(request.id, request.cache_key);
 
     QObject::connect(search, &LyricsFetcherSearch::SearchFinished, this, &LyricsFetcher::SingleSearchFinished);
     QObject::connect(search, &LyricsFetcherSearch::LyricsFetched, this, &LyricsFetcher::SingleLyricsFetched);
@@ -112,12 +213,27 @@ void LyricsFetcher::StartRequests() {
 
 }
 
+void LyricsFetcher::CachedLyricsFetched(const quint64 request_id, const LyricsCache::Entry &entry) {
+
+  if (!cached_requests_.remove(request_id)) return;
+
+  Q_EMIT LyricsFetched(request_id, entry.provider, entry.lyrics);
+
+}
+
 void LyricsFetcher::SingleSearchFinished(const quint64 request_id, const LyricsSearchResults &results) {
 
   if (!active_requests_.contains(request_id)) return;
 
   LyricsFetcherSearch *search = active_requests_.take(request_id);
+  active_request_keys_.remove(request_id);
   search->deleteLater();
+
+  if (prefetch_requests_.remove(request_id)) {
+    waiting_requests_.remove(request_id);
+    return;
+  }
+
   Q_EMIT SearchFinished(request_id, results);
 
 }
@@ -127,7 +243,21 @@ void LyricsFetcher::SingleLyricsFetched(const quint64 request_id, const QString
   if (!active_requests_.contains(request_id)) return;
 
   LyricsFetcherSearch *search = active_requests_.take(request_id);
+  const QString cache_key = active_request_keys_.take(request_id);
   search->deleteLater();
+
+  // Only remember that there are no lyrics if a provider actually answered, not when none were enabled or all timed out.
+  if (!lyrics.isEmpty() || search->any_provider_responded()) {
+    cache_->Insert(cache_key, provider, lyrics);
+  }
+
+  if (prefetch_requests_.remove(request_id)) {
+    if (waiting_requests_.contains(request_id)) {
+      Q_EMIT LyricsFetched(waiting_requests_.take(request_id), provider, lyrics);
+    }
+    return;
+  }
+
   Q_EMIT LyricsFetched(request_id, provider, lyrics);
 
 }
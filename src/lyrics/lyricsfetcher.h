@@ -33,8 +33,10 @@
 #include <QUrl>
 
 #include "includes/shared_ptr.h"
+#include "includes/scoped_ptr.h"
 #include "lyricssearchrequest.h"
 #include "lyricssearchresult.h"
+#include "lyricscache.h"
 
 class QTimer;
 class LyricsProviders;
@@ -45,19 +47,30 @@ class LyricsFetcher : public QObject {
 
  public:
   explicit LyricsFetcher(const SharedPtr<LyricsProviders> lyrics_providers, QObject *parent = nullptr);
-  ~LyricsFetcher() override {}
+  ~LyricsFetcher() override;
 
   struct Request {
-    Request() : id(0) {}
+    Request() : id(0), prefetch(false) {}
     quint64 id;
+    QString cache_key;
+    bool prefetch;
     LyricsSearchRequest search_request;
   };
 
   quint64 Search(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration);
+
+  // Searches in the background and only stores the result in the cache, so a later Search() for the same song is answered without going to the providers.
+  void Prefetch(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration);
+
+  // Cancels the pending Search() requests, prefetches keep running.
   void Clear();
 
  private:
+  static LyricsSearchRequest MakeSearchRequest(const QString &effective_albumartist, const QString &artist, const QString &album, const QString &title, const qint64 duration);
   void AddRequest(const Request &request);
+  bool HasRequestForKey(const QString &cache_key) const;
+  int ActivePrefetchRequests() const;
+  void CachedLyricsFetched(const quint64 request_id, const LyricsCache::Entry &entry);
 
  Q_SIGNALS:
   void LyricsFetched(const quint64 request_id, const QString &provider, const QString &lyrics);
@@ -72,8 +85,18 @@ class LyricsFetcher : public QObject {
   const SharedPtr<LyricsProviders> lyrics_providers_;
   quint64 next_id_;
 
+  ScopedPtr<LyricsCache> cache_;
+
   QQueue<Request> queued_requests_;
   QHash<quint64, LyricsFetcherSearch*> active_requests_;
+  QHash<quint64, QString> active_request_keys_;
+
+  // Queued and active prefetch requests, and the Search() requests waiting for an active prefetch of the same song.
+  QSet<quint64> prefetch_requests_;
+  QHash<quint64, quint64> waiting_requests_;
+
+  // Search() requests answered from the cache that haven't been signalled yet.
+  QSet<quint64> cached_requests_;
 
   QTimer *request_starter_;
 };
@@ -49,6 +49,7 @@ LyricsFetcherSearch::LyricsFetcherSearch(const quint64 id, const LyricsSearchReq
       request_(request),
       timer_search_early_timeout_(new QTimer(this)),
       timer_search_timeout_(new QTimer(this)),
+      responses_(0),
       cancel_requested_(false),
       finished_(false) {
 
@@ -107,6 +108,7 @@ void LyricsFetcherSearch::ProviderSearchFinished(const int id, const LyricsSearc
 
   if (!pending_requests_.contains(id)) return;
   LyricsProvider *provider = pending_requests_.take(id);
+  ++responses_;
 
   LyricsSearchResults results_copy(results);
   float higest_score = 0.0;
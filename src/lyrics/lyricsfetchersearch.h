@@ -44,6 +44,9 @@ class LyricsFetcherSearch : public QObject {
   void Start(SharedPtr<LyricsProviders> lyrics_providers);
   void Cancel();
 
+  const LyricsSearchRequest &request() const { return request_; }
+  bool any_provider_responded() const { return responses_ > 0; }
+
  Q_SIGNALS:
   void SearchFinished(const quint64 id, const LyricsSearchResults &results);
   void LyricsFetched(const quint64 id, const QString &provider = QString(), const QString &lyrics = QString());
@@ -66,6 +69,7 @@ class LyricsFetcherSearch : public QObject {
   QTimer *timer_search_timeout_;
   LyricsSearchResults results_;
   QMap<int, LyricsProvider*> pending_requests_;
+  int responses_;
   bool cancel_requested_;
   bool finished_;
 };
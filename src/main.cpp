@@ -104,6 +104,7 @@
 
 #include "core/iconloader.h"
 #include "core/commandlineoptions.h"
+#include "core/tracing.h"
 #include "core/networkproxyfactory.h"
 
 #include "core/application.h"
@@ -171,6 +172,9 @@ int main(int argc, char *argv[]) {
     // Parse commandline options - need to do this before starting the full QApplication, so it works without an X server
     if (!options.Parse()) return 1;
     logging::SetLevels(options.log_levels());
+    if (!options.trace_filename().isEmpty()) {
+      tracing::Start();
+    }
     if (!single_app.isPrimaryInstance()) {
       if (options.is_empty()) {
         qLog(Info) << "Strawberry is already running - activating existing window (1)";
@@ -435,6 +439,11 @@ int main(int argc, char *argv[]) {
 
   int ret = QCoreApplication::exec();
 
+  if (!options.trace_filename().isEmpty()) {
+    tracing::Stop();
+    tracing::SaveChromeTrace(options.trace_filename());
+  }
+
 #if defined(__MINGW32__) && !defined(HAVE_WINPTHREADS)
   // Workaround crash on exit with the GCC win32 threading model (not needed with winpthreads).
   TerminateProcess(GetCurrentProcess(), 0);
@@ -63,8 +63,17 @@ void MoodbarBuilder::Init(const int bands, const int rate_hz) {
 
 void MoodbarBuilder::AddFrame(const double *magnitudes, const int size) {
 
+  Rgb rgb;
+  if (FrameRgb(magnitudes, size, &rgb)) {
+    frames_.append(rgb);
+  }
+
+}
+
+bool MoodbarBuilder::FrameRgb(const double *magnitudes, const int size, Rgb *rgb) const {
+
   if (size > barkband_table_.length()) {
-    return;
+    return false;
   }
 
   // Calculate total magnitudes for different bark bands.
@@ -74,12 +83,14 @@ void MoodbarBuilder::AddFrame(const double *magnitudes, const int size) {
   }
 
   // Now divide the bark bands into thirds and compute their total amplitudes.
-  double rgb[] = { 0, 0, 0 };
+  double thirds[] = { 0, 0, 0 };
   for (int i = 0; i < sBarkBandCount; ++i) {
-    rgb[(i * 3) / sBarkBandCount] += bands[i] * bands[i];
+    thirds[(i * 3) / sBarkBandCount] += bands[i] * bands[i];
   }
 
-  frames_.append(Rgb(sqrt(rgb[0]), sqrt(rgb[1]), sqrt(rgb[2])));
+  *rgb = Rgb(sqrt(thirds[0]), sqrt(thirds[1]), sqrt(thirds[2]));
+
+  return true;
 
 }
 
@@ -164,22 +175,28 @@ void MoodbarBuilder::Normalize(QList<Rgb> *vals, double Rgb::*member) {
 
 QByteArray MoodbarBuilder::Finish(const int width) {
 
+  return BuildData(&frames_, width);
+
+}
+
+QByteArray MoodbarBuilder::BuildData(QList<Rgb> *frames, const int width) {
+
   QByteArray ret;
   ret.resize(width * 3);
   char *data = ret.data();
-  if (frames_.count() == 0) return ret;
+  if (frames->count() == 0) return ret;
 
-  Normalize(&frames_, &Rgb::r);
-  Normalize(&frames_, &Rgb::g);
-  Normalize(&frames_, &Rgb::b);
+  Normalize(frames, &Rgb::r);
+  Normalize(frames, &Rgb::g);
+  Normalize(frames, &Rgb::b);
 
   for (int i = 0; i < width; ++i) {
     Rgb rgb;
-    const int start = static_cast<int>(i * frames_.count() / width);
-    const int end = std::max(static_cast<int>((i + 1) * frames_.count() / width), start + 1);
+    const int start = static_cast<int>(i * frames->count() / width);
+    const int end = std::max(static_cast<int>((i + 1) * frames->count() / width), start + 1);
 
     for (int j = start; j < end; j++) {
-      const Rgb frame = frames_.value(j);
+      const Rgb frame = frames->value(j);
       rgb.r += frame.r * 255;
       rgb.g += frame.g * 255;
       rgb.b += frame.b * 255;
@@ -26,15 +26,12 @@
 #include <QList>
 #include <QByteArray>
 
+// Keeps the color of every spectrum frame and normalizes them for the whole track in Finish().
+// MoodbarStreamingBuilder does the same with bounded memory.
 class MoodbarBuilder {
  public:
   explicit MoodbarBuilder();
 
-  void Init(const int bands, const int rate_hz);
-  void AddFrame(const double *magnitudes, const int size);
-  QByteArray Finish(const int width);
-
- private:
   struct Rgb {
     Rgb() : r(0), g(0), b(0) {}
     Rgb(const double r_, const double g_, const double b_) : r(r_), g(g_), b(b_) {}
@@ -42,6 +39,18 @@ class MoodbarBuilder {
     double r, g, b;
   };
 
+  void Init(const int bands, const int rate_hz);
+  void AddFrame(const double *magnitudes, const int size);
+  QByteArray Finish(const int width);
+
+  // Sums the magnitudes of a spectrum frame into the bark bands, and the bark bands into thirds for red, green and blue.
+  // Returns false if the frame has more bands than given to Init().
+  bool FrameRgb(const double *magnitudes, const int size, Rgb *rgb) const;
+
+  // Normalizes the frames and averages them down to width colors.
+  static QByteArray BuildData(QList<Rgb> *frames, const int width);
+
+ private:
   int BandFrequency(const int band) const;
   static void Normalize(QList<Rgb> *vals, double Rgb::*member);
 
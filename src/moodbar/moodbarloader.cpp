@@ -62,7 +62,8 @@ MoodbarLoader::MoodbarLoader(QObject *parent)
       cache_(new QNetworkDiskCache(this)),
       thread_(new QThread(this)),
       kMaxActiveRequests(qMax(1, QThread::idealThreadCount() / 2)),
-      save_(false) {
+      save_(false),
+      analysis_rate_(MoodbarSettings::kDefaultAnalysisRate) {
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
   thread_->setObjectName(objectName());
@@ -102,6 +103,7 @@ void MoodbarLoader::ReloadSettings() {
   Settings s;
   s.beginGroup(MoodbarSettings::kSettingsGroup);
   save_ = s.value(MoodbarSettings::kSave, MoodbarSettings::kDefaultSave).toBool();
+  analysis_rate_ = s.value(MoodbarSettings::kAnalysisRate, MoodbarSettings::kDefaultAnalysisRate).toInt();
   s.endGroup();
 
   MaybeTakeNextRequest();
@@ -175,7 +177,7 @@ MoodbarLoader::LoadResult MoodbarLoader::Load(const QUrl &url, const bool has_cu
   if (!thread_->isRunning()) thread_->start(QThread::IdlePriority);
 
   // There was no existing file, analyze the audio file and create one.
-  MoodbarPipelinePtr pipeline = MoodbarPipelinePtr(new MoodbarPipeline(url));
+  MoodbarPipelinePtr pipeline = MoodbarPipelinePtr(new MoodbarPipeline(url, analysis_rate_));
   pipeline->moveToThread(thread_);
   SharedPtr<QMetaObject::Connection> connection = make_shared<QMetaObject::Connection>();
   *connection = QObject::connect(&*pipeline, &MoodbarPipeline::Finished, this, [this, connection, pipeline, url]() {
@@ -92,6 +92,7 @@ class MoodbarLoader : public QObject {
   QSet<QUrl> active_requests_;
 
   bool save_;
+  int analysis_rate_;
 };
 
 #endif  // MOODBARLOADER_H
@@ -39,7 +39,7 @@
 #include "core/logging.h"
 #include "core/signalchecker.h"
 #include "utilities/threadutils.h"
-#include "moodbar/moodbarbuilder.h"
+#include "moodbar/moodbarstreamingbuilder.h"
 #ifdef HAVE_GSTFASTSPECTRUM
 #  include "engine/gstfastspectrum.h"
 #endif
@@ -51,9 +51,10 @@ namespace {
 constexpr int kBands = 128;
 }
 
-MoodbarPipeline::MoodbarPipeline(const QUrl &url, QObject *parent)
+MoodbarPipeline::MoodbarPipeline(const QUrl &url, const int analysis_rate, QObject *parent)
     : QObject(parent),
       url_(url),
+      analysis_rate_(analysis_rate),
       pipeline_(nullptr),
       convert_element_(nullptr),
       success_(false),
@@ -106,6 +107,7 @@ void MoodbarPipeline::Start() {
 
   GstElement *decodebin = CreateElement("uridecodebin");
   GstElement *convert_element = CreateElement("audioconvert");
+  GstElement *resample = CreateElement("audioresample");
 #ifdef HAVE_GSTFASTSPECTRUM
   GstElement *spectrum = CreateElement("strawberry-fastspectrum");
 #else
@@ -113,7 +115,7 @@ void MoodbarPipeline::Start() {
 #endif
   GstElement *fakesink = CreateElement("fakesink");
 
-  if (!decodebin || !convert_element || !spectrum || !fakesink) {
+  if (!decodebin || !convert_element || !resample || !spectrum || !fakesink) {
     gst_object_unref(GST_OBJECT(pipeline_));
     pipeline_ = nullptr;
     Q_EMIT Finished(false);
@@ -121,7 +123,7 @@ void MoodbarPipeline::Start() {
   }
 
   // Join them together
-  if (!gst_element_link_many(convert_element, spectrum, fakesink, nullptr)) {
+  if (!gst_element_link_many(convert_element, resample, nullptr) || !gst_element_link(spectrum, fakesink)) {
     qLog(Error) << "Failed to link elements";
     gst_object_unref(GST_OBJECT(pipeline_));
     pipeline_ = nullptr;
@@ -129,9 +131,27 @@ void MoodbarPipeline::Start() {
     return;
   }
 
+  // The moodbar only needs one channel, and nothing above the highest bark band, so downmix and never upsample, but downsample to the analysis rate.
+  GstCaps *caps = nullptr;
+  if (analysis_rate_ > 0) {
+    caps = gst_caps_new_simple("audio/x-raw", "channels", G_TYPE_INT, 1, "rate", GST_TYPE_INT_RANGE, 1, analysis_rate_, nullptr);
+  }
+  else {
+    caps = gst_caps_new_simple("audio/x-raw", "channels", G_TYPE_INT, 1, nullptr);
+  }
+  const bool resample_to_spectrum_linked = gst_element_link_filtered(resample, spectrum, caps);
+  gst_caps_unref(caps);
+  if (!resample_to_spectrum_linked) {
+    qLog(Error) << "Failed to link audioresample to spectrum with filter";
+    gst_object_unref(GST_OBJECT(pipeline_));
+    pipeline_ = nullptr;
+    Q_EMIT Finished(false);
+    return;
+  }
+
   convert_element_ = convert_element;
 
-  builder_ = make_unique<MoodbarBuilder>();
+  builder_ = make_unique<MoodbarStreamingBuilder>();
 
   // Set properties
 
@@ -219,6 +239,11 @@ void MoodbarPipeline::NewPadCallback(GstElement *element, GstPad *pad, gpointer
     gst_caps_unref(caps);
   }
 
+  // The spectrum gets the audio after it was downsampled to the analysis rate.
+  if (instance->analysis_rate_ > 0 && rate > instance->analysis_rate_) {
+    rate = instance->analysis_rate_;
+  }
+
   if (instance->builder_) {
     instance->builder_->Init(kBands, rate);
   }
@@ -36,14 +36,15 @@
 
 #include "includes/scoped_ptr.h"
 
-class MoodbarBuilder;
+class MoodbarStreamingBuilder;
 
 // Creates moodbar data for a single local music file.
 class MoodbarPipeline : public QObject {
   Q_OBJECT
 
  public:
-  explicit MoodbarPipeline(const QUrl &url, QObject *parent = nullptr);
+  // analysis_rate limits the sample rate of the audio given to the spectrum, 0 analyzes the audio at the rate of the file.
+  explicit MoodbarPipeline(const QUrl &url, const int analysis_rate = 0, QObject *parent = nullptr);
   ~MoodbarPipeline() override;
 
   bool success() const { return success_; }
@@ -69,10 +70,11 @@ class MoodbarPipeline : public QObject {
 
  private:
   QUrl url_;
+  int analysis_rate_;
   GstElement *pipeline_;
   GstElement *convert_element_;
 
-  ScopedPtr<MoodbarBuilder> builder_;
+  ScopedPtr<MoodbarStreamingBuilder> builder_;
 
   bool success_;
   std::atomic<bool> running_;
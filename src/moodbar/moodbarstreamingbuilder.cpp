@@ -0,0 +1,333 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QList>
+#include <QByteArray>
+
+#include "moodbarstreamingbuilder.h"
+
+namespace {
+
+// Below this many values, an estimate is treated as empty the same way as MoodbarBuilder::Normalize() treats no values.
+constexpr double kMinEstimatedCount = 0.5;
+
+constexpr double kSqrt2 = 1.41421356237309504880;
+constexpr double kSqrt2Pi = 2.50662827463100050242;
+
+double NormalCdf(const double z) {
+  return 0.5 * (1.0 + std::erf(z / kSqrt2));
+}
+
+double NormalPdf(const double z) {
+  return std::exp(-z * z / 2.0) / kSqrt2Pi;
+}
+
+double MemberOf(const MoodbarBuilder::Rgb &rgb, const int channel) {
+
+  switch (channel) {
+    case 0:
+      return rgb.r;
+    case 1:
+      return rgb.g;
+    default:
+      return rgb.b;
+  }
+
+}
+
+}  // namespace
+
+void MoodbarStreamingBuilder::ChannelStatistics::Add(const double value) {
+
+  // MoodbarBuilder::Normalize() maps these to zero, and they would make the sums useless.
+  if (!std::isfinite(value)) return;
+
+  sum += value;
+
+  if (count == 0 || value < min) {
+    min = value;
+    min_count = 1;
+  }
+  else if (value == min) {
+    ++min_count;
+  }
+
+  if (count == 0 || value > max) {
+    max = value;
+    max_count = 1;
+  }
+  else if (value == max) {
+    ++max_count;
+  }
+
+  ++count;
+
+}
+
+MoodbarStreamingBuilder::MoodbarStreamingBuilder() : frames_per_bucket_(1), frame_count_(0) {}
+
+void MoodbarStreamingBuilder::Init(const int bands, const int rate_hz) {
+
+  frame_builder_.Init(bands, rate_hz);
+
+  buckets_.clear();
+  buckets_.reserve(kMaxWorkingBuckets);
+  current_bucket_ = Bucket();
+  frames_per_bucket_ = 1;
+  frame_count_ = 0;
+  for (ChannelStatistics &statistics : statistics_) {
+    statistics = ChannelStatistics();
+  }
+
+}
+
+void MoodbarStreamingBuilder::AddFrame(const double *magnitudes, const int size) {
+
+  Rgb rgb;
+  if (!frame_builder_.FrameRgb(magnitudes, size, &rgb)) {
+    return;
+  }
+
+  statistics_[0].Add(rgb.r);
+  statistics_[1].Add(rgb.g);
+  statistics_[2].Add(rgb.b);
+
+  current_bucket_.sum.r += rgb.r;
+  current_bucket_.sum.g += rgb.g;
+  current_bucket_.sum.b += rgb.b;
+  current_bucket_.sum_squares.r += rgb.r * rgb.r;
+  current_bucket_.sum_squares.g += rgb.g * rgb.g;
+  current_bucket_.sum_squares.b += rgb.b * rgb.b;
+  ++current_bucket_.frames;
+  ++frame_count_;
+
+  if (current_bucket_.frames >= frames_per_bucket_) {
+    AddBucket(current_bucket_);
+    current_bucket_ = Bucket();
+  }
+
+}
+
+void MoodbarStreamingBuilder::AddBucket(const Bucket &bucket) {
+
+  buckets_.push_back(bucket);
+  if (static_cast<qint64>(buckets_.size()) >= kMaxWorkingBuckets) {
+    FoldBuckets();
+  }
+
+}
+
+void MoodbarStreamingBuilder::FoldBuckets() {
+
+  // Merge adjacent pairs of buckets, halving the number of buckets and doubling the frames per bucket.
+  const size_t folded_count = (buckets_.size() + 1) / 2;
+  for (size_t i = 0; i < folded_count; ++i) {
+    Bucket bucket = buckets_[i * 2];
+    if (i * 2 + 1 < buckets_.size()) {
+      const Bucket &next = buckets_[i * 2 + 1];
+      bucket.sum.r += next.sum.r;
+      bucket.sum.g += next.sum.g;
+      bucket.sum.b += next.sum.b;
+      bucket.sum_squares.r += next.sum_squares.r;
+      bucket.sum_squares.g += next.sum_squares.g;
+      bucket.sum_squares.b += next.sum_squares.b;
+      bucket.frames += next.frames;
+    }
+    buckets_[i] = bucket;
+  }
+  buckets_.resize(folded_count);
+  frames_per_bucket_ *= 2;
+
+}
+
+QByteArray MoodbarStreamingBuilder::FinishExact(const int width) const {
+
+  QList<Rgb> frames;
+  frames.reserve(static_cast<qsizetype>(buckets_.size()));
+  for (const Bucket &bucket : buckets_) {
+    frames.append(bucket.sum);
+  }
+
+  return MoodbarBuilder::BuildData(&frames, width);
+
+}
+
+void MoodbarStreamingBuilder::Above(const int channel, const double threshold, double *count, double *sum) const {
+
+  const ChannelStatistics &statistics = statistics_[channel];
+
+  *count = 0;
+  *sum = 0;
+  if (statistics.min == statistics.max) return;
+
+  // The buckets are a mixture of normal distributions, one for the frames in each bucket.
+  for (const Bucket &bucket : buckets_) {
+    const double frames = static_cast<double>(bucket.frames);
+    const double mean = MemberOf(bucket.sum, channel) / frames;
+    const double variance = std::max(0.0, MemberOf(bucket.sum_squares, channel) / frames - mean * mean);
+    if (!std::isfinite(mean) || !std::isfinite(variance)) continue;
+    const double stddev = std::sqrt(variance);
+    if (stddev <= 0.0) {
+      if (mean > threshold) {
+        *count += frames;
+        *sum += frames * mean;
+      }
+      continue;
+    }
+    const double z = (threshold - mean) / stddev;
+    const double fraction_above = 1.0 - NormalCdf(z);
+    *count += frames * fraction_above;
+    *sum += frames * (mean * fraction_above + stddev * NormalPdf(z));
+  }
+
+  if (statistics.max > threshold) {
+    *count -= static_cast<double>(statistics.max_count);
+    *sum -= static_cast<double>(statistics.max_count) * statistics.max;
+  }
+  if (statistics.min > threshold) {
+    *count -= static_cast<double>(statistics.min_count);
+    *sum -= static_cast<double>(statistics.min_count) * statistics.min;
+  }
+
+  if (*count < kMinEstimatedCount) {
+    *count = 0;
+    *sum = 0;
+  }
+
+}
+
+void MoodbarStreamingBuilder::Range(const int channel, double *low, double *delta) const {
+
+  const ChannelStatistics &statistics = statistics_[channel];
+
+  *low = 0;
+  *delta = 1;
+  if (statistics.count == 0) return;
+
+  // The values other than the minimum and maximum.
+  double rest_count = 0;
+  double rest_sum = 0;
+  if (statistics.min != statistics.max) {
+    rest_count = static_cast<double>(statistics.count - statistics.min_count - statistics.max_count);
+    rest_sum = statistics.sum - static_cast<double>(statistics.min_count) * statistics.min - static_cast<double>(statistics.max_count) * statistics.max;
+  }
+
+  const double avg = rest_sum / static_cast<double>(statistics.count);
+
+  double count_above = 0;
+  double sum_above = 0;
+  Above(channel, avg, &count_above, &sum_above);
+  const double avgu = count_above > kMinEstimatedCount ? sum_above / count_above : avg;
+  const double count_below = rest_count - count_above;
+  const double avgb = count_below > kMinEstimatedCount ? (rest_sum - sum_above) / count_below : avg;
+
+  Above(channel, avgu, &count_above, &sum_above);
+  const double avguu = count_above > kMinEstimatedCount ? sum_above / count_above : avg;
+
+  Above(channel, avgb, &count_above, &sum_above);
+  const double count_below_avgb = rest_count - count_above;
+  const double avgbb = count_below_avgb > kMinEstimatedCount ? (rest_sum - sum_above) / count_below_avgb : avg;
+
+  *low = std::max(avg + (avgb - avg) * 2, avgbb);
+  const double high = std::min(avg + (avgu - avg) * 2, avguu);
+  *delta = high - *low;
+  if (*delta == 0) {
+    *delta = 1;
+  }
+
+}
+
+double MoodbarStreamingBuilder::ClampedMean(const double mean, const double stddev, const qint64 frames) {
+
+  if (stddev <= 1e-12) {
+    return std::clamp(mean, 0.0, 1.0);
+  }
+
+  // Two frames are exactly one standard deviation below and above the mean.
+  if (frames == 2) {
+    return (std::clamp(mean - stddev, 0.0, 1.0) + std::clamp(mean + stddev, 0.0, 1.0)) / 2.0;
+  }
+
+  // E[max(X - t, 0)] for a normal X, the clamped mean is the difference of this at 0 and 1.
+  const auto relu_mean = [stddev](const double m) {
+    const double z = m / stddev;
+    return m * NormalCdf(z) + stddev * NormalPdf(z);
+  };
+
+  return std::clamp(relu_mean(mean) - relu_mean(mean - 1.0), 0.0, 1.0);
+
+}
+
+QByteArray MoodbarStreamingBuilder::Finish(const int width) {
+
+  if (current_bucket_.frames > 0) {
+    buckets_.push_back(current_bucket_);
+    current_bucket_ = Bucket();
+  }
+
+  if (frames_per_bucket_ == 1) {
+    return FinishExact(width);
+  }
+
+  QByteArray ret;
+  ret.resize(width * 3);
+  char *data = ret.data();
+
+  double low[3] = { 0, 0, 0 };
+  double delta[3] = { 1, 1, 1 };
+  for (int channel = 0; channel < 3; ++channel) {
+    Range(channel, &low[channel], &delta[channel]);
+  }
+
+  // Each bucket holds the mean and variance of its frames, every frame in it is assumed to be normally distributed around the mean when normalizing.
+  // The pixels use the same frame ranges as MoodbarBuilder::Finish(), weighting each bucket by how many of its frames are in the range.
+  for (int i = 0; i < width; ++i) {
+    const qint64 start = i * frame_count_ / width;
+    const qint64 end = std::max((i + 1) * frame_count_ / width, start + 1);
+
+    double values[3] = { 0, 0, 0 };
+    qint64 frames = 0;
+    for (qint64 j = start / frames_per_bucket_; j < static_cast<qint64>(buckets_.size()) && j * frames_per_bucket_ < end; ++j) {
+      const Bucket &bucket = buckets_[j];
+      const qint64 bucket_start = j * frames_per_bucket_;
+      const qint64 overlap = std::min(end, bucket_start + bucket.frames) - std::max(start, bucket_start);
+      if (overlap <= 0) continue;
+      for (int channel = 0; channel < 3; ++channel) {
+        const double mean = MemberOf(bucket.sum, channel) / static_cast<double>(bucket.frames);
+        const double variance = std::max(0.0, MemberOf(bucket.sum_squares, channel) / static_cast<double>(bucket.frames) - mean * mean);
+        const double value = ClampedMean((mean - low[channel]) / delta[channel], std::sqrt(variance) / delta[channel], bucket.frames);
+        values[channel] += std::isfinite(value) ? static_cast<double>(overlap) * value * 255 : 0;
+      }
+      frames += overlap;
+    }
+
+    for (int channel = 0; channel < 3; ++channel) {
+      *(data++) = static_cast<char>(frames > 0 ? values[channel] / static_cast<double>(frames) : 0);
+    }
+  }
+
+  return ret;
+
+}
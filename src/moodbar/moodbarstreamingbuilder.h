@@ -0,0 +1,95 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MOODBARSTREAMINGBUILDER_H
+#define MOODBARSTREAMINGBUILDER_H
+
+#include "config.h"
+
+#include <vector>
+
+#include <QtGlobal>
+#include <QByteArray>
+
+#include "moodbarbuilder.h"
+
+// Builds the same moodbar as MoodbarBuilder, without keeping every spectrum frame of the track.
+// The frames are summed into a fixed number of working buckets, and adjacent buckets are merged when they are full, so memory doesn't grow with the length of the track.
+// The normalization range of each channel is estimated from the mean and variance of the frames in each bucket.
+// As long as no buckets were merged, every bucket is one frame and the result is exactly the same as MoodbarBuilder.
+class MoodbarStreamingBuilder {
+ public:
+  explicit MoodbarStreamingBuilder();
+
+  static constexpr qint64 kMaxWorkingBuckets = 4096;
+
+  void Init(const int bands, const int rate_hz);
+  void AddFrame(const double *magnitudes, const int size);
+  QByteArray Finish(const int width);
+
+  qint64 frame_count() const { return frame_count_; }
+  qint64 frames_per_bucket() const { return frames_per_bucket_; }
+  qint64 working_bucket_count() const { return static_cast<qint64>(buckets_.size()); }
+
+ private:
+  using Rgb = MoodbarBuilder::Rgb;
+
+  struct Bucket {
+    Bucket() : frames(0) {}
+    Rgb sum;
+    Rgb sum_squares;
+    qint64 frames;
+  };
+
+  // Exact statistics of the values of one color channel over the whole track.
+  struct ChannelStatistics {
+    ChannelStatistics() : count(0), sum(0), min(0), max(0), min_count(0), max_count(0) {}
+    void Add(const double value);
+
+    qint64 count;
+    double sum;
+    double min;
+    double max;
+    qint64 min_count;
+    qint64 max_count;
+  };
+
+  void AddBucket(const Bucket &bucket);
+  void FoldBuckets();
+  QByteArray FinishExact(const int width) const;
+
+  // Estimated count and sum of the values of a channel above threshold, leaving out the minimum and maximum values like MoodbarBuilder::Normalize() does.
+  void Above(const int channel, const double threshold, double *count, double *sum) const;
+  // The same range as MoodbarBuilder::Normalize() computes from all frames.
+  void Range(const int channel, double *low, double *delta) const;
+
+  // Expected value of the frames of a bucket with the given mean and standard deviation after clamping to 0.0 - 1.0.
+  // More than two frames are assumed to be normally distributed.
+  static double ClampedMean(const double mean, const double stddev, const qint64 frames);
+
+ private:
+  MoodbarBuilder frame_builder_;
+  std::vector<Bucket> buckets_;
+  Bucket current_bucket_;
+  qint64 frames_per_bucket_;
+  qint64 frame_count_;
+  ChannelStatistics statistics_[3];
+};
+
+#endif  // MOODBARSTREAMINGBUILDER_H
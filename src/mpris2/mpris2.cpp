@@ -36,6 +36,7 @@
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <QTimer>
 #include <QDBusConnection>
 #include <QDBusMessage>
 #include <QDBusArgument>
@@ -111,6 +112,12 @@ constexpr char kTrackPrefix[] = "/org/strawberrymusicplayer/strawberry/Track/";
 constexpr char kNoTrack[] = "/org/mpris/MediaPlayer2/TrackList/NoTrack";
 constexpr int kTracksSubsetCount = 20;
 
+// Changes to the track list within one frame are sent together.
+constexpr int kTrackListChangesDelayMsec = 16;
+// With more changes than this, clients are better off getting the tracks around the current track again.
+constexpr int kMaxTrackListChanges = kTracksSubsetCount;
+constexpr int kMaxTrackMetadataCacheSize = 500;
+
 Mpris2::Mpris2(const SharedPtr<Player> player,
                const SharedPtr<PlaylistManager> playlist_manager,
                const SharedPtr<CurrentAlbumCoverLoader> current_albumcover_loader,
@@ -118,7 +125,14 @@ Mpris2::Mpris2(const SharedPtr<Player> player,
     : QObject(parent),
       player_(player),
       playlist_manager_(playlist_manager),
-      current_albumcover_loader_(current_albumcover_loader) {
+      current_albumcover_loader_(current_albumcover_loader),
+      timer_track_list_changes_(new QTimer(this)),
+      track_list_changes_playlist_id_(-1),
+      track_metadata_cache_(kMaxTrackMetadataCacheSize) {
+
+  timer_track_list_changes_->setSingleShot(true);
+  timer_track_list_changes_->setInterval(kTrackListChangesDelayMsec);
+  QObject::connect(timer_track_list_changes_, &QTimer::timeout, this, &Mpris2::FlushTrackListChanges);
 
   new Mpris2Root(this);
   new Mpris2TrackList(this);
@@ -149,6 +163,10 @@ Mpris2::Mpris2(const SharedPtr<Player> player,
   QObject::connect(&*playlist_manager_, &PlaylistManager::PlaylistItemsAdded, this, &Mpris2::PlaylistItemsAdded);
   QObject::connect(&*playlist_manager_, &PlaylistManager::PlaylistItemsRemoved, this, &Mpris2::PlaylistItemsRemoved);
   QObject::connect(&*playlist_manager_, &PlaylistManager::PlaylistItemMetadataChanged, this, &Mpris2::PlaylistItemMetadataChanged);
+  QObject::connect(&*playlist_manager_, &PlaylistManager::ActiveChanged, this, &Mpris2::ActivePlaylistChanged);
+  if (playlist_manager_->active()) {
+    ActivePlaylistChanged(playlist_manager_->active());
+  }
 
   QStringList data_dirs = QString::fromUtf8(qgetenv("XDG_DATA_DIRS")).split(u':');
 
@@ -476,48 +494,156 @@ void Mpris2::PlaylistItemsAdded(const int playlist_id, const QList<QUuid> &track
 
   // The items were inserted contiguously after after_track_id, so chain the AfterTrack:
   // the first track follows after_track_id, and each subsequent track follows the previous one.
-  QDBusObjectPath after_track_path = after_track_id.isNull() ? QDBusObjectPath(kNoTrack) : current_track_id(after_track_id);
+  QUuid previous_track_id = after_track_id;
   for (const QUuid &track_id : track_ids) {
-    const QDBusObjectPath track_path = current_track_id(track_id);
-    const TrackMetadata metadata = GetTracksMetadata(Track_Ids() << track_path);
-    if (!metadata.isEmpty() && !metadata.first().isEmpty()) {
-      Q_EMIT TrackAdded(metadata.first(), after_track_path);
-    }
-    after_track_path = track_path;
+    QueueTrackListChange(playlist_id, TrackListChange(TrackListChange::Type::Added, track_id, previous_track_id));
+    previous_track_id = track_id;
   }
 
 }
 
 void Mpris2::PlaylistItemsRemoved(const int playlist_id, const QList<QUuid> &track_ids) {
 
+  for (const QUuid &track_id : track_ids) {
+    track_metadata_cache_.remove(track_id);
+  }
+
   if (track_ids.isEmpty() || !playlist_manager_->active() || playlist_manager_->active_id() != playlist_id) {
     return;
   }
 
   for (const QUuid &track_id : track_ids) {
-    Q_EMIT TrackRemoved(current_track_id(track_id));
+    QueueTrackListChange(playlist_id, TrackListChange(TrackListChange::Type::Removed, track_id));
   }
 
 }
 
 void Mpris2::PlaylistItemMetadataChanged(const int playlist_id, const QUuid &track_id) {
 
+  track_metadata_cache_.remove(track_id);
+
   if (track_id.isNull() || !playlist_manager_->active() || playlist_manager_->active_id() != playlist_id) {
     return;
   }
 
-  const QDBusObjectPath track_path = current_track_id(track_id);
-  const TrackMetadata metadata = GetTracksMetadata(Track_Ids() << track_path);
-  if (metadata.isEmpty() || metadata.first().isEmpty()) {
+  QueueTrackListChange(playlist_id, TrackListChange(TrackListChange::Type::MetadataChanged, track_id));
+
+}
+
+void Mpris2::ActivePlaylistChanged(Playlist *playlist) {
+
+  ClearTrackListChanges();
+  track_metadata_cache_.clear();
+
+  QObject::disconnect(active_playlist_data_changed_);
+  if (playlist) {
+    // Stream metadata and edits of streams change the items without PlaylistItemMetadataChanged.
+    active_playlist_data_changed_ = QObject::connect(playlist, &Playlist::dataChanged, this, &Mpris2::ActivePlaylistDataChanged);
+  }
+
+}
+
+void Mpris2::ActivePlaylistDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right) {
+
+  if (track_metadata_cache_.isEmpty() || !playlist_manager_->active()) return;
+
+  if (bottom_right.row() - top_left.row() >= track_metadata_cache_.maxCost()) {
+    track_metadata_cache_.clear();
     return;
   }
 
-  Q_EMIT TrackMetadataChanged(track_path, metadata.first());
+  Playlist *playlist = playlist_manager_->active();
+  for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
+    if (playlist->has_item_at(row)) {
+      track_metadata_cache_.remove(playlist->item_at(row)->uuid());
+    }
+  }
+
+}
+
+void Mpris2::QueueTrackListChange(const int playlist_id, const TrackListChange &change) {
+
+  if (track_list_changes_playlist_id_ != playlist_id) {
+    track_list_changes_.clear();
+    track_list_changes_playlist_id_ = playlist_id;
+  }
+
+  // Past the limit the changes are replaced by TrackListReplaced anyway, so there's no need to keep them.
+  if (track_list_changes_.count() <= kMaxTrackListChanges) {
+    track_list_changes_ << change;
+  }
+
+  if (!timer_track_list_changes_->isActive()) {
+    timer_track_list_changes_->start();
+  }
+
+}
+
+void Mpris2::ClearTrackListChanges() {
+
+  timer_track_list_changes_->stop();
+  track_list_changes_.clear();
+  track_list_changes_playlist_id_ = -1;
+
+}
+
+void Mpris2::FlushTrackListChanges() {
+
+  const QList<TrackListChange> track_list_changes = track_list_changes_;
+  const int playlist_id = track_list_changes_playlist_id_;
+  ClearTrackListChanges();
+
+  if (track_list_changes.isEmpty() || !playlist_manager_->active() || playlist_manager_->active_id() != playlist_id) {
+    return;
+  }
+
+  if (track_list_changes.count() > kMaxTrackListChanges) {
+    EmitTrackListReplaced();
+    return;
+  }
+
+  // Metadata is read when the changes are sent, so an added track already has its latest metadata, and a track changed several times is only sent once.
+  QSet<QUuid> sent_track_ids;
+  QSet<QUuid> skipped_track_ids;
+  for (const TrackListChange &change : track_list_changes) {
+    const QDBusObjectPath track_path = current_track_id(change.track_id);
+    switch (change.type) {
+      case TrackListChange::Type::Added:{
+        const QDBusObjectPath after_track_path = change.after_track_id.isNull() ? QDBusObjectPath(kNoTrack) : current_track_id(change.after_track_id);
+        const TrackMetadata metadata = GetTracksMetadata(Track_Ids() << track_path);
+        if (metadata.isEmpty() || metadata.first().isEmpty()) {
+          skipped_track_ids << change.track_id;
+          break;
+        }
+        sent_track_ids << change.track_id;
+        Q_EMIT TrackAdded(metadata.first(), after_track_path);
+        break;
+      }
+      case TrackListChange::Type::Removed:
+        // Clients never saw a track which was added and removed before it was sent.
+        if (!skipped_track_ids.contains(change.track_id)) {
+          Q_EMIT TrackRemoved(track_path);
+        }
+        sent_track_ids.remove(change.track_id);
+        break;
+      case TrackListChange::Type::MetadataChanged:{
+        if (sent_track_ids.contains(change.track_id)) break;
+        const TrackMetadata metadata = GetTracksMetadata(Track_Ids() << track_path);
+        if (metadata.isEmpty() || metadata.first().isEmpty()) break;
+        sent_track_ids << change.track_id;
+        Q_EMIT TrackMetadataChanged(track_path, metadata.first());
+        break;
+      }
+    }
+  }
 
 }
 
 void Mpris2::EmitTrackListReplaced() {
 
+  // The replaced track list includes any changes not sent yet.
+  ClearTrackListChanges();
+
   const Track_Ids track_ids = Tracks();
   const QUuid playlist_item_uuid = current_playlist_item_uuid();
   QDBusObjectPath current_track_path(kNoTrack);
@@ -757,6 +883,10 @@ TrackMetadata Mpris2::GetTracksMetadata(const Track_Ids &tracks) const {
       track_metadata << QVariantMap();
       continue;
     }
+    if (const QVariantMap *cached_track_map = track_metadata_cache_.object(playlist_item_uuid)) {
+      track_metadata << *cached_track_map;
+      continue;
+    }
     PlaylistItemPtr playlist_item = playlist_manager_->active()->ItemByUuId(playlist_item_uuid);
     if (!playlist_item) {
       track_metadata << QVariantMap();
@@ -765,6 +895,7 @@ TrackMetadata Mpris2::GetTracksMetadata(const Track_Ids &tracks) const {
     QVariantMap track_map;
     playlist_item->EffectiveMetadata().ToXesam(&track_map);
     track_map.insert(u"mpris:trackid"_s, QVariant::fromValue(track_object_path));
+    track_metadata_cache_.insert(playlist_item_uuid, new QVariantMap(track_map));
     track_metadata << track_map;
   }
 
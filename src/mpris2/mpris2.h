@@ -29,6 +29,7 @@
 #include <QList>
 #include <QMap>
 #include <QSet>
+#include <QCache>
 #include <QMetaType>
 #include <QVariant>
 #include <QString>
@@ -37,6 +38,7 @@
 #include <QDBusObjectPath>
 #include <QDBusArgument>
 #include <QJsonObject>
+#include <QModelIndex>
 
 #include "includes/shared_ptr.h"
 #include "engine/enginebase.h"
@@ -48,6 +50,7 @@ class CurrentAlbumCoverLoader;
 class Song;
 class Playlist;
 class PlaylistItem;
+class QTimer;
 
 using TrackMetadata = QList<QVariantMap>;
 using Track_Ids = QList<QDBusObjectPath>;
@@ -243,8 +246,26 @@ class Mpris2 : public QObject {
   void PlaylistItemsAdded(const int playlist_id, const QList<QUuid> &track_ids, const QUuid &after_track_id);
   void PlaylistItemsRemoved(const int playlist_id, const QList<QUuid> &track_ids);
   void PlaylistItemMetadataChanged(const int playlist_id, const QUuid &track_id);
+  void ActivePlaylistChanged(Playlist *playlist);
+  void ActivePlaylistDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
+  void FlushTrackListChanges();
 
  private:
+  struct TrackListChange {
+    enum class Type {
+      Added,
+      Removed,
+      MetadataChanged
+    };
+    TrackListChange(const Type _type, const QUuid &_track_id, const QUuid &_after_track_id = QUuid()) : type(_type), track_id(_track_id), after_track_id(_after_track_id) {}
+    Type type;
+    QUuid track_id;
+    QUuid after_track_id;
+  };
+
+  void QueueTrackListChange(const int playlist_id, const TrackListChange &change);
+  void ClearTrackListChanges();
+
   void EmitNotification(const QString &name);
   void EmitNotification(const QString &name, const QVariant &value);
   void EmitNotification(const QString &name, const QVariant &value, const QString &mprisEntity);
@@ -268,6 +289,15 @@ class Mpris2 : public QObject {
 
   QString desktopfilepath_;
   QVariantMap last_metadata_;
+
+  // TrackList changes of the active playlist are collected for a frame and sent together, or replaced by TrackListReplaced when there are too many of them.
+  QTimer *timer_track_list_changes_;
+  int track_list_changes_playlist_id_;
+  QList<TrackListChange> track_list_changes_;
+
+  // Metadata maps for GetTracksMetadata by playlist item, until the item changes.
+  QMetaObject::Connection active_playlist_data_changed_;
+  mutable QCache<QUuid, QVariantMap> track_metadata_cache_;
 };
 
 }  // namespace mpris
@@ -26,12 +26,17 @@
 #include <chrono>
 
 #include <QThread>
+#include <QThreadPool>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 #include <QFile>
 #include <QFileInfo>
 #include <QTimer>
 #include <QDateTime>
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 #include <QImage>
 
@@ -41,8 +46,10 @@
 #include "core/musicstorage.h"
 #include "core/song.h"
 #include "utilities/strutils.h"
+#include "utilities/fileutils.h"
 #include "tagreader/tagreaderclient.h"
 #include "organize.h"
+#include "organizetransferbatch.h"
 #include "transcoder/transcoder.h"
 
 using namespace std::chrono_literals;
@@ -52,6 +59,7 @@ class OrganizeFormat;
 namespace {
 constexpr int kBatchSize = 10;
 constexpr int kTranscodeProgressInterval = 500;
+constexpr int kMaxConcurrentCopies = 4;
 }  // namespace
 
 Organize::Organize(const SharedPtr<TaskManager> task_manager,
@@ -71,6 +79,7 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
       task_manager_(task_manager),
       tagreader_client_(tagreader_client),
       transcoder_(new Transcoder(this)),
+      copy_thread_pool_(new QThreadPool(this)),
       process_files_timer_(new QTimer(this)),
       destination_(destination),
       format_(format),
@@ -81,6 +90,9 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
       task_count_(static_cast<quint64>(songs_info.count())),
       playlist_(playlist),
       tasks_complete_(0),
+      transcode_tasks_pending_(true),
+      copy_jobs_active_(0),
+      next_batched_copy_id_(0),
       started_(false),
       task_id_(0),
       current_copy_progress_(0),
@@ -88,8 +100,11 @@ Organize::Organize(const SharedPtr<TaskManager> task_manager,
 
   original_thread_ = thread();
 
+  copy_thread_pool_->setMaxThreadCount(kMaxConcurrentCopies);
+
+  // The next batch is started from the event loop, so the organizer can be cancelled part-way through.
   process_files_timer_->setSingleShot(true);
-  process_files_timer_->setInterval(100ms);
+  process_files_timer_->setInterval(0ms);
   QObject::connect(process_files_timer_, &QTimer::timeout, this, &Organize::ProcessSomeFiles);
 
   tasks_pending_.reserve(songs_info.count());
@@ -120,6 +135,7 @@ void Organize::Start() {
 
   QObject::connect(transcoder_, &Transcoder::JobComplete, this, &Organize::FileTranscoded);
   QObject::connect(transcoder_, &Transcoder::LogLine, this, &Organize::LogLine);
+  QObject::connect(transcoder_, &Transcoder::ThroughputChanged, this, &Organize::TranscodeThroughputChanged);
 
   moveToThread(thread_);
   thread_->start();
@@ -138,11 +154,24 @@ void Organize::ProcessSomeFiles() {
       }
       tasks_pending_.clear();
     }
+    else if (destination_->CopyBatchSize() > 0) {
+      QStringList journal_keys;
+      journal_keys.reserve(tasks_pending_.count());
+      for (const Task &task : std::as_const(tasks_pending_)) {
+        journal_keys << OrganizeTransferBatch::JournalKey(task.song_info_.song_, task.song_info_.new_filename_);
+      }
+      transfer_batch_.reset(new OrganizeTransferBatch(destination_, OrganizeTransferBatch::JournalFilename(destination_->TransferJournalId(), journal_keys)));
+    }
     started_ = true;
   }
 
   // None left?
   if (tasks_pending_.isEmpty()) {
+    // Commit the last batch, or what was collected before the transcoder is waited on.
+    if (transfer_batch_ && !transfer_batch_->IsEmpty()) {
+      CommitTransferBatch();
+    }
+
     if (!tasks_transcoding_.isEmpty()) {
       // Just wait - FileTranscoded will start us off again in a little while
       qLog(Debug) << "Waiting for transcoding jobs";
@@ -150,12 +179,19 @@ void Organize::ProcessSomeFiles() {
       return;
     }
 
+    if (copy_jobs_active_ > 0) {
+      // Wait for the remaining copies, each finished copy starts us off again.
+      return;
+    }
+
     UpdateProgress();
 
     QString error_text;
-    if (!destination_->FinishCopy(files_with_errors_.isEmpty(), error_text) && !error_text.isEmpty()) {
+    const bool success = destination_->FinishCopy(files_with_errors_.isEmpty(), error_text);
+    if (!success && !error_text.isEmpty()) {
       log_ << error_text;
     }
+    if (transfer_batch_) transfer_batch_->Finish(success);
     if (eject_after_) destination_->Eject();
 
     task_manager_->SetTaskFinished(task_id_);
@@ -172,13 +208,25 @@ void Organize::ProcessSomeFiles() {
     return;
   }
 
+  // Set when the next task waits for a copy to the same destination, the copy finishing starts the next batch.
+  bool waiting_for_copy = false;
+  // The transcoder is started once for all the jobs queued in this batch.
+  bool transcode_jobs_added = false;
+
   // We process files in batches so we can be cancelled part-way through.
   for (int i = 0; i < kBatchSize; ++i) {
     SetSongProgress(0);
 
     if (tasks_pending_.isEmpty()) break;
 
-    Task task = tasks_pending_.takeFirst();
+    qint64 index = 0;
+    if (copy_jobs_active_ >= kMaxConcurrentCopies) {
+      // All copy threads are busy, keep the transcoder going meanwhile.
+      index = NextTranscodeTaskIndex();
+      if (index < 0) break;
+    }
+
+    Task task = tasks_pending_.takeAt(index);
     qLog(Info) << "Processing" << task.song_info_.song_.url().toLocalFile();
 
     // Use a Song instead of a tag reader
@@ -188,6 +236,13 @@ void Organize::ProcessSomeFiles() {
       continue;
     }
 
+    // Skip files committed by an earlier run of this job that was interrupted, unless they should be overwritten or were removed from the storage since.
+    if (transfer_batch_ && !overwrite_ && task.transcoded_filename_.isEmpty() && transfer_batch_->IsTransferred(OrganizeTransferBatch::JournalKey(task.song_info_.song_, task.song_info_.new_filename_)) && destination_->ContainsSong(song)) {
+      qLog(Debug) << "Skipping" << task.song_info_.song_.url().toLocalFile() << ", already transferred";
+      tasks_complete_++;
+      continue;
+    }
+
     // Maybe this file is one that's been transcoded already?
     if (!task.transcoded_filename_.isEmpty()) {
       qLog(Debug) << "This file has already been transcoded";
@@ -226,10 +281,10 @@ void Organize::ProcessSomeFiles() {
         tasks_transcoding_[task.song_info_.song_.url().toLocalFile()] = task;
         qLog(Debug) << "Transcoding to" << task.transcoded_filename_;
 
-        // Start the transcoding - this will happen in the background and FileTranscoded() will get called when it's done.
+        // Queue the transcoding - this will happen in the background and FileTranscoded() will get called when it's done.
         // At that point the task will get re-added to the pending queue with the new filename.
         transcoder_->AddJob(task.song_info_.song_.url().toLocalFile(), preset, task.transcoded_filename_);
-        transcoder_->Start();
+        transcode_jobs_added = true;
         continue;
       }
     }
@@ -241,73 +296,201 @@ void Organize::ProcessSomeFiles() {
       continue;
     }
 
-    MusicStorage::CopyJob job;
-    job.source_ = task.transcoded_filename_.isEmpty() ? task.song_info_.song_.url().toLocalFile() : task.transcoded_filename_;
-    job.destination_ = task.song_info_.new_filename_;
-    job.metadata_ = song;
-    job.overwrite_ = overwrite_;
-    job.albumcover_ = albumcover_;
-    job.remove_original_ = !copy_;
-    job.playlist_ = playlist_;
-
-    if (task.song_info_.song_.art_manual_is_valid() && !task.song_info_.song_.art_unset()) {
-      if (task.song_info_.song_.art_manual().isLocalFile() && QFile::exists(task.song_info_.song_.art_manual().toLocalFile())) {
-        job.cover_source_ = task.song_info_.song_.art_manual().toLocalFile();
-      }
-      else if (task.song_info_.song_.art_manual().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_manual().path())) {
-        job.cover_source_ = task.song_info_.song_.art_manual().path();
-      }
+    MusicStorage::CopyJob job = CreateCopyJob(task, song);
+
+    if (transfer_batch_) {
+      AddToTransferBatch(task, song, job);
+      continue;
     }
-    else if (task.song_info_.song_.art_automatic_is_valid()) {
-      if (task.song_info_.song_.art_automatic().isLocalFile() && QFile::exists(task.song_info_.song_.art_automatic().toLocalFile())) {
-        job.cover_source_ = task.song_info_.song_.art_automatic().toLocalFile();
-      }
-      else if (task.song_info_.song_.art_automatic().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_automatic().path())) {
-        job.cover_source_ = task.song_info_.song_.art_automatic().path();
-      }
+
+    // The songs of an album share the album cover, leave it out if another copy is already copying it.
+    if (!job.cover_dest_.isEmpty() && copy_destinations_active_.contains(job.cover_dest_)) {
+      job.cover_source_.clear();
+      job.cover_dest_.clear();
     }
-    else if (destination_->source() == Song::Source::Device) {
-      const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(task.song_info_.song_.url().toLocalFile(), job.cover_image_);
-      if (!result.success()) {
-        qLog(Error) << "Could not load embedded art from" << task.song_info_.song_.url() << result.error_string();
+
+    // Copies are run in parallel when the storage allows it, moves within the same filesystem are just renames.
+    if (destination_->SupportsParallelCopy() && !(job.remove_original_ && Utilities::OnSameFilesystem(job.source_, destination_->LocalPath()))) {
+      if (copy_destinations_active_.contains(job.destination_)) {
+        // Another song is being copied to the same file, wait for it to finish first.
+        tasks_pending_.prepend(task);
+        waiting_for_copy = true;
+        break;
       }
+      StartParallelCopy(task, song, job);
+      continue;
     }
 
-    if (!job.cover_source_.isEmpty()) {
-      job.cover_dest_ = QFileInfo(job.destination_).path() + QLatin1Char('/') + QFileInfo(job.cover_source_).fileName();
+    QString error_text;
+    const bool success = destination_->CopyToStorage(job, error_text);
+    CopyFinished(task, song, job.remove_original_, success, error_text);
+  }
+  SetSongProgress(0);
+
+  if (transcode_jobs_added) {
+    transcoder_->Start();
+  }
+
+  if (!waiting_for_copy && !process_files_timer_->isActive() && copy_jobs_active_ < kMaxConcurrentCopies) {
+    process_files_timer_->start();
+  }
+
+}
+
+qint64 Organize::NextTranscodeTaskIndex() {
+
+  // Tasks are only added back to the queue after they were transcoded, so once none are left there is no need to look again.
+  if (!transcode_tasks_pending_) return -1;
+
+  for (qint64 i = 0; i < tasks_pending_.count(); ++i) {
+    const Task &task = tasks_pending_[i];
+    if (task.transcoded_filename_.isEmpty() && task.song_info_.song_.is_valid() && CheckTranscode(task.song_info_.song_.filetype()) != Song::FileType::Unknown) {
+      return i;
     }
+  }
 
-    job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
+  transcode_tasks_pending_ = false;
 
-    QString error_text;
-    if (destination_->CopyToStorage(job, error_text)) {
-      if (job.remove_original_ && song.is_local_collection_song() && destination_->source() == Song::Source::Collection) {
-        // Notify other aspects of system that song has been invalidated
-        QString root = destination_->LocalPath();
-        QFileInfo new_file = QFileInfo(root + QLatin1Char('/') + task.song_info_.new_filename_);
-        Q_EMIT SongPathChanged(song, new_file, destination_->collection_directory_id());
-      }
+  return -1;
+
+}
+
+MusicStorage::CopyJob Organize::CreateCopyJob(const Task &task, const Song &song) {
+
+  MusicStorage::CopyJob job;
+  job.source_ = task.transcoded_filename_.isEmpty() ? task.song_info_.song_.url().toLocalFile() : task.transcoded_filename_;
+  job.destination_ = task.song_info_.new_filename_;
+  job.metadata_ = song;
+  job.overwrite_ = overwrite_;
+  job.albumcover_ = albumcover_;
+  job.remove_original_ = !copy_;
+  job.playlist_ = playlist_;
+
+  if (task.song_info_.song_.art_manual_is_valid() && !task.song_info_.song_.art_unset()) {
+    if (task.song_info_.song_.art_manual().isLocalFile() && QFile::exists(task.song_info_.song_.art_manual().toLocalFile())) {
+      job.cover_source_ = task.song_info_.song_.art_manual().toLocalFile();
     }
-    else {
-      files_with_errors_ << task.song_info_.song_.basefilename();
-      if (!error_text.isEmpty()) {
-        log_ << error_text;
-      }
+    else if (task.song_info_.song_.art_manual().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_manual().path())) {
+      job.cover_source_ = task.song_info_.song_.art_manual().path();
+    }
+  }
+  else if (task.song_info_.song_.art_automatic_is_valid()) {
+    if (task.song_info_.song_.art_automatic().isLocalFile() && QFile::exists(task.song_info_.song_.art_automatic().toLocalFile())) {
+      job.cover_source_ = task.song_info_.song_.art_automatic().toLocalFile();
+    }
+    else if (task.song_info_.song_.art_automatic().scheme().isEmpty() && QFile::exists(task.song_info_.song_.art_automatic().path())) {
+      job.cover_source_ = task.song_info_.song_.art_automatic().path();
+    }
+  }
+  else if (destination_->source() == Song::Source::Device) {
+    const TagReaderResult result = tagreader_client_->LoadCoverImageBlocking(task.song_info_.song_.url().toLocalFile(), job.cover_image_);
+    if (!result.success()) {
+      qLog(Error) << "Could not load embedded art from" << task.song_info_.song_.url() << result.error_string();
     }
+  }
 
-    // Clean up the temporary transcoded file
-    if (!task.transcoded_filename_.isEmpty()) {
-      QFile::remove(task.transcoded_filename_);
+  if (!job.cover_source_.isEmpty()) {
+    job.cover_dest_ = QFileInfo(job.destination_).path() + QLatin1Char('/') + QFileInfo(job.cover_source_).fileName();
+  }
+
+  job.progress_ = std::bind(&Organize::SetSongProgress, this, std::placeholders::_1, !task.transcoded_filename_.isEmpty());
+
+  return job;
+
+}
+
+void Organize::StartParallelCopy(const Task &task, const Song &song, const MusicStorage::CopyJob &job) {
+
+  ++copy_jobs_active_;
+  copy_destinations_active_ << job.destination_;
+  if (job.albumcover_ && !job.cover_dest_.isEmpty()) {
+    copy_destinations_active_ << job.cover_dest_;
+  }
+
+  // Progress is reported per finished file, the callback is not safe to call from the copy threads.
+  MusicStorage::CopyJob parallel_job = job;
+  parallel_job.progress_ = nullptr;
+
+  const SharedPtr<MusicStorage> destination = destination_;
+  QFuture<CopyResult> future = QtConcurrent::run(copy_thread_pool_, [destination, parallel_job]() {
+    CopyResult result;
+    result.success = destination->CopyToStorage(parallel_job, result.error_text);
+    return result;
+  });
+  QFutureWatcher<CopyResult> *watcher = new QFutureWatcher<CopyResult>(this);
+  QObject::connect(watcher, &QFutureWatcher<CopyResult>::finished, this, [this, watcher, task, song, job]() {
+    const CopyResult result = watcher->result();
+    watcher->deleteLater();
+    --copy_jobs_active_;
+    copy_destinations_active_.remove(job.destination_);
+    if (job.albumcover_ && !job.cover_dest_.isEmpty()) {
+      copy_destinations_active_.remove(job.cover_dest_);
+    }
+    CopyFinished(task, song, job.remove_original_, result.success, result.error_text);
+    UpdateProgress();
+    if (!process_files_timer_->isActive()) {
+      process_files_timer_->start();
     }
+  });
+  watcher->setFuture(future);
+
+}
 
-    tasks_complete_++;
+void Organize::CopyFinished(const Task &task, const Song &song, const bool remove_original, const bool success, const QString &error_text) {
+
+  if (success) {
+    if (remove_original && song.is_local_collection_song() && destination_->source() == Song::Source::Collection) {
+      // Notify other aspects of system that song has been invalidated
+      QString root = destination_->LocalPath();
+      QFileInfo new_file = QFileInfo(root + QLatin1Char('/') + task.song_info_.new_filename_);
+      Q_EMIT SongPathChanged(song, new_file, destination_->collection_directory_id());
+    }
+  }
+  else {
+    files_with_errors_ << task.song_info_.song_.basefilename();
+    if (!error_text.isEmpty()) {
+      log_ << error_text;
+    }
   }
-  SetSongProgress(0);
 
-  if (!process_files_timer_->isActive()) {
-    process_files_timer_->start();
+  // Clean up the temporary transcoded file
+  if (!task.transcoded_filename_.isEmpty()) {
+    QFile::remove(task.transcoded_filename_);
+  }
+
+  tasks_complete_++;
+
+}
+
+void Organize::AddToTransferBatch(const Task &task, const Song &song, const MusicStorage::CopyJob &job) {
+
+  const int id = ++next_batched_copy_id_;
+  BatchedCopy copy;
+  copy.task = task;
+  copy.song = song;
+  copy.remove_original = job.remove_original_;
+  copies_batched_.insert(id, copy);
+
+  // The key is made from the original file, so a transcoded file is found before it is transcoded again.
+  transfer_batch_->Add(id, OrganizeTransferBatch::JournalKey(task.song_info_.song_, task.song_info_.new_filename_), job);
+
+  if (transfer_batch_->IsFull()) {
+    CommitTransferBatch();
+  }
+
+}
+
+void Organize::CommitTransferBatch() {
+
+  qLog(Debug) << "Committing batch of" << transfer_batch_->count() << "files";
+
+  const OrganizeTransferBatch::ResultList results = transfer_batch_->Commit();
+  for (const OrganizeTransferBatch::Result &result : results) {
+    const BatchedCopy copy = copies_batched_.take(result.id);
+    CopyFinished(copy.task, copy.song, copy.remove_original, result.success, result.error_text);
   }
 
+  SetSongProgress(0);
 
 }
 
@@ -381,6 +564,11 @@ void Organize::UpdateProgress() {
     progress += qBound(0, static_cast<int>(task.transcode_progress_ * 50), 50);
   }
 
+  // Files waiting in the transfer batch have finished transcoding, but are not copied yet.
+  for (const BatchedCopy &copy : std::as_const(copies_batched_)) {
+    if (!copy.task.transcoded_filename_.isEmpty()) progress += 50;
+  }
+
   // Add the progress of the track that's currently copying
   progress += current_copy_progress_;
 
@@ -409,6 +597,12 @@ void Organize::FileTranscoded(const QString &input, const QString &output, const
 
 }
 
+void Organize::TranscodeThroughputChanged(const double realtime_factor, const double bytes_per_second) {
+
+  task_manager_->SetTaskName(task_id_, tr("Organizing files (transcoding %1)").arg(Transcoder::ThroughputText(realtime_factor, bytes_per_second)));
+
+}
+
 void Organize::timerEvent(QTimerEvent *e) {
 
   QObject::timerEvent(e);
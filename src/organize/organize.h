@@ -35,18 +35,21 @@
 #include <QString>
 #include <QStringList>
 
+#include "includes/scoped_ptr.h"
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "core/musicstorage.h"
 #include "organizeformat.h"
 
 class QThread;
+class QThreadPool;
 class QTimer;
 class QTimerEvent;
 
 class TaskManager;
 class TagReaderClient;
-class MusicStorage;
 class Transcoder;
+class OrganizeTransferBatch;
 
 class Organize : public QObject {
   Q_OBJECT
@@ -88,6 +91,7 @@ class Organize : public QObject {
  private Q_SLOTS:
   void ProcessSomeFiles();
   void FileTranscoded(const QString &input, const QString &output, const bool success);
+  void TranscodeThroughputChanged(const double realtime_factor, const double bytes_per_second);
   void LogLine(const QString &message);
 
  private:
@@ -95,6 +99,7 @@ class Organize : public QObject {
   void UpdateProgress();
   Song::FileType CheckTranscode(const Song::FileType original_type) const;
   bool ShouldSkipFile(const QString &filename) const;
+  qint64 NextTranscodeTaskIndex();
 
  private:
   struct Task {
@@ -110,11 +115,30 @@ class Organize : public QObject {
     Song::FileType new_filetype_;
   };
 
+  struct BatchedCopy {
+    Task task;
+    Song song;
+    bool remove_original;
+  };
+
+  struct CopyResult {
+    CopyResult() : success(false) {}
+    bool success;
+    QString error_text;
+  };
+
+  MusicStorage::CopyJob CreateCopyJob(const Task &task, const Song &song);
+  void StartParallelCopy(const Task &task, const Song &song, const MusicStorage::CopyJob &job);
+  void CopyFinished(const Task &task, const Song &song, const bool remove_original, const bool success, const QString &error_text);
+  void AddToTransferBatch(const Task &task, const Song &song, const MusicStorage::CopyJob &job);
+  void CommitTransferBatch();
+
   QThread *thread_;
   QThread *original_thread_;
   const SharedPtr<TaskManager> task_manager_;
   const SharedPtr<TagReaderClient> tagreader_client_;
   Transcoder *transcoder_;
+  QThreadPool *copy_thread_pool_;
   QTimer *process_files_timer_;
   const SharedPtr<MusicStorage> destination_;
   QList<Song::FileType> supported_filetypes_;
@@ -131,6 +155,14 @@ class Organize : public QObject {
   QList<Task> tasks_pending_;
   QMap<QString, Task> tasks_transcoding_;
   int tasks_complete_;
+  bool transcode_tasks_pending_;
+
+  int copy_jobs_active_;
+  QSet<QString> copy_destinations_active_;
+
+  ScopedPtr<OrganizeTransferBatch> transfer_batch_;
+  QMap<int, BatchedCopy> copies_batched_;
+  int next_batched_copy_id_;
 
   bool started_;
 
@@ -71,11 +71,58 @@ OrganizeFormat::OrganizeFormat(const QString &format)
       remove_non_fat_(false),
       remove_non_ascii_(false),
       allow_ascii_ext_(false),
-      replace_spaces_(true) {}
+      replace_spaces_(true) {
+
+  Compile();
+
+}
 
 void OrganizeFormat::set_format(const QString &v) {
+
   format_ = v;
   format_.replace(u'\\', u'/');
+  Compile();
+
+}
+
+void OrganizeFormat::Compile() {
+
+  tokens_.clear();
+
+  // Blocks can't be nested, so only the innermost braces form a block, any other braces are kept as text.
+  static const QRegularExpression block_regexp(QString::fromLatin1(kBlockPattern));
+  qint64 pos = 0;
+  QRegularExpressionMatchIterator it = block_regexp.globalMatch(format_);
+  while (it.hasNext()) {
+    const QRegularExpressionMatch re_match = it.next();
+    CompileText(format_.mid(pos, re_match.capturedStart() - pos));
+    tokens_ << Token(Token::Type::BlockBegin);
+    CompileText(re_match.captured(1));
+    tokens_ << Token(Token::Type::BlockEnd);
+    pos = re_match.capturedEnd();
+  }
+  CompileText(format_.mid(pos));
+
+}
+
+void OrganizeFormat::CompileText(const QString &text) {
+
+  static const QRegularExpression tag_regexp(QString::fromLatin1(kTagPattern));
+  qint64 pos = 0;
+  QRegularExpressionMatchIterator it = tag_regexp.globalMatch(text);
+  while (it.hasNext()) {
+    const QRegularExpressionMatch re_match = it.next();
+    if (re_match.capturedStart() > pos) {
+      tokens_ << Token(Token::Type::Text, text.mid(pos, re_match.capturedStart() - pos));
+    }
+    const QString tag_name = re_match.captured(1);
+    tokens_ << Token(Token::Type::Tag, QString(), TagFromName(tag_name), kUniqueTags.contains(tag_name));
+    pos = re_match.capturedEnd();
+  }
+  if (pos < text.length()) {
+    tokens_ << Token(Token::Type::Text, text.mid(pos));
+  }
+
 }
 
 bool OrganizeFormat::IsValid() const {
@@ -91,7 +138,7 @@ bool OrganizeFormat::IsValid() const {
 OrganizeFormat::GetFilenameForSongResult OrganizeFormat::GetFilenameForSong(const Song &song, QString extension) const {
 
   bool unique_filename = false;
-  QString filepath = ParseBlock(format_, song, &unique_filename);
+  QString filepath = Evaluate(song, &unique_filename);
 
   if (filepath.isEmpty()) {
     filepath = song.basefilename();
@@ -196,125 +243,132 @@ OrganizeFormat::GetFilenameForSongResult OrganizeFormat::GetFilenameForSong(cons
 
 }
 
-QString OrganizeFormat::ParseBlock(QString block, const Song &song, bool *have_tagdata, bool *any_empty) const {
+QString OrganizeFormat::Evaluate(const Song &song, bool *have_tagdata) const {
 
-  // Find any blocks first
-  qint64 pos = 0;
-  static const QRegularExpression block_regexp(QString::fromLatin1(kBlockPattern));
-  QRegularExpressionMatch re_match;
-  for (re_match = block_regexp.match(block, pos); re_match.hasMatch(); re_match = block_regexp.match(block, pos)) {
-    pos = re_match.capturedStart();
-    // Recursively parse the block
-    bool empty = false;
-    QString value = ParseBlock(re_match.captured(1), song, have_tagdata, &empty);
-    if (empty) value = ""_L1;
-
-    // Replace the block's value
-    block.replace(pos, re_match.capturedLength(), value);
-    pos += value.length();
-  }
+  QString filepath;
+  QString block;
+  bool in_block = false;
+  bool block_empty = false;
 
-  // Now look for tags
-  bool empty = false;
-  pos = 0;
-  static const QRegularExpression tag_regexp(QString::fromLatin1(kTagPattern));
-  for (re_match = tag_regexp.match(block, pos); re_match.hasMatch(); re_match = tag_regexp.match(block, pos)) {
-    pos = re_match.capturedStart();
-    const QString tag = re_match.captured(1);
-    const QString value = TagValue(tag, song);
-    if (value.isEmpty()) {
-      empty = true;
-    }
-    else if (have_tagdata && kUniqueTags.contains(tag)) {
-      *have_tagdata = true;
+  for (const Token &token : tokens_) {
+    switch (token.type) {
+      case Token::Type::Text:
+        (in_block ? block : filepath).append(token.text);
+        break;
+      case Token::Type::Tag:{
+        const QString value = TagValue(token.tag, song);
+        if (value.isEmpty()) {
+          // A block is left out if any of its tags are empty.
+          block_empty = true;
+        }
+        else if (have_tagdata && token.unique) {
+          *have_tagdata = true;
+        }
+        (in_block ? block : filepath).append(value);
+        break;
+      }
+      case Token::Type::BlockBegin:
+        in_block = true;
+        block_empty = false;
+        block.clear();
+        break;
+      case Token::Type::BlockEnd:
+        if (!block_empty) filepath.append(block);
+        in_block = false;
+        break;
     }
-
-    block.replace(pos, re_match.capturedLength(), value);
-    pos += value.length();
   }
 
-  if (any_empty) {
-    *any_empty = empty;
-  }
+  return filepath;
+
+}
 
-  return block;
+OrganizeFormat::Tag OrganizeFormat::TagFromName(const QString &name) {
+
+  // The tags follow Tag::Unknown in the same order as in kKnownTags.
+  const qsizetype index = kKnownTags.indexOf(name);
+  return index == -1 ? Tag::Unknown : static_cast<Tag>(index + 1);
 
 }
 
-QString OrganizeFormat::TagValue(const QString &tag, const Song &song) const {
+QString OrganizeFormat::TagValue(const Tag tag, const Song &song) const {
 
   QString value;
 
-  if (tag == "title"_L1) {
-    value = song.title();
-  }
-  else if (tag == "album"_L1) {
-    value = song.album();
-  }
-  else if (tag == "artist"_L1) {
-    value = song.artist();
-  }
-  else if (tag == "composer"_L1) {
-    value = song.composer();
-  }
-  else if (tag == "performer"_L1) {
-    value = song.performer();
-  }
-  else if (tag == "grouping"_L1) {
-    value = song.grouping();
-  }
-  else if (tag == "lyrics"_L1) {
-    value = song.lyrics();
-  }
-  else if (tag == "genre"_L1) {
-    value = song.genre();
-  }
-  else if (tag == "comment"_L1) {
-    value = song.comment();
-  }
-  else if (tag == "year"_L1) {
-    value = QString::number(song.year());
-  }
-  else if (tag == "originalyear"_L1) {
-    value = QString::number(song.effective_originalyear());
-  }
-  else if (tag == "track"_L1) {
-    value = QString::number(song.track());
-  }
-  else if (tag == "disc"_L1) {
-    value = QString::number(song.disc());
-  }
-  else if (tag == "length"_L1) {
-    value = QString::number(song.length_nanosec() / kNsecPerSec);
-  }
-  else if (tag == "bitrate"_L1) {
-    value = QString::number(song.bitrate());
-  }
-  else if (tag == "samplerate"_L1) {
-    value = QString::number(song.samplerate());
-  }
-  else if (tag == "bitdepth"_L1) {
-    value = QString::number(song.bitdepth());
-  }
-  else if (tag == "extension"_L1) {
-    value = QFileInfo(song.url().toLocalFile()).suffix();
-  }
-  else if (tag == "artistinitial"_L1) {
-    value = song.effective_albumartist().trimmed();
-    if (!value.isEmpty()) {
-      static const QRegularExpression regex_the(u"^the\\s+"_s, QRegularExpression::CaseInsensitiveOption);
-      value = value.remove(regex_the);
-      value = value[0].toUpper();
-    }
-  }
-  else if (tag == "albumartist"_L1) {
-    value = song.is_compilation() ? u"Various Artists"_s : song.effective_albumartist();
+  switch (tag) {
+    case Tag::Title:
+      value = song.title();
+      break;
+    case Tag::Album:
+      value = song.album();
+      break;
+    case Tag::Artist:
+      value = song.artist();
+      break;
+    case Tag::Composer:
+      value = song.composer();
+      break;
+    case Tag::Performer:
+      value = song.performer();
+      break;
+    case Tag::Grouping:
+      value = song.grouping();
+      break;
+    case Tag::Lyrics:
+      value = song.lyrics();
+      break;
+    case Tag::Genre:
+      value = song.genre();
+      break;
+    case Tag::Comment:
+      value = song.comment();
+      break;
+    case Tag::Year:
+      value = QString::number(song.year());
+      break;
+    case Tag::OriginalYear:
+      value = QString::number(song.effective_originalyear());
+      break;
+    case Tag::Track:
+      value = QString::number(song.track());
+      break;
+    case Tag::Disc:
+      value = QString::number(song.disc());
+      break;
+    case Tag::Length:
+      value = QString::number(song.length_nanosec() / kNsecPerSec);
+      break;
+    case Tag::Bitrate:
+      value = QString::number(song.bitrate());
+      break;
+    case Tag::Samplerate:
+      value = QString::number(song.samplerate());
+      break;
+    case Tag::Bitdepth:
+      value = QString::number(song.bitdepth());
+      break;
+    case Tag::Extension:
+      value = QFileInfo(song.url().toLocalFile()).suffix();
+      break;
+    case Tag::ArtistInitial:
+      value = song.effective_albumartist().trimmed();
+      if (!value.isEmpty()) {
+        static const QRegularExpression regex_the(u"^the\\s+"_s, QRegularExpression::CaseInsensitiveOption);
+        value = value.remove(regex_the);
+        value = value[0].toUpper();
+      }
+      break;
+    case Tag::AlbumArtist:
+      value = song.is_compilation() ? u"Various Artists"_s : song.effective_albumartist();
+      break;
+    case Tag::Unknown:
+      break;
   }
 
   if (value == u'0' || value == "-1"_L1) value = ""_L1;
 
   // Prepend a 0 to single-digit track numbers
-  if (tag == "track"_L1 && value.length() == 1) value.prepend(u'0');
+  if (tag == Tag::Track && value.length() == 1) value.prepend(u'0');
 
   // Replace characters that really shouldn't be in paths
   static const QRegularExpression regex_invalid_dir_characters(QString::fromLatin1(kInvalidDirCharactersRegex), QRegularExpression::PatternOption::CaseInsensitiveOption);
@@ -22,6 +22,7 @@
 #ifndef ORGANISEFORMAT_H
 #define ORGANISEFORMAT_H
 
+#include <QList>
 #include <QString>
 #include <QStringList>
 
@@ -61,10 +62,55 @@ class OrganizeFormat {
   GetFilenameForSongResult GetFilenameForSong(const Song &song, QString extension = QString()) const;
 
  private:
-  QString ParseBlock(QString block, const Song &song, bool *have_tagdata = nullptr, bool *any_empty = nullptr) const;
-  QString TagValue(const QString &tag, const Song &song) const;
+  // In the same order as kKnownTags.
+  enum class Tag {
+    Unknown,
+    Title,
+    Album,
+    Artist,
+    ArtistInitial,
+    AlbumArtist,
+    Composer,
+    Track,
+    Disc,
+    Year,
+    OriginalYear,
+    Genre,
+    Comment,
+    Length,
+    Bitrate,
+    Samplerate,
+    Bitdepth,
+    Extension,
+    Performer,
+    Grouping,
+    Lyrics
+  };
+
+  // The format is compiled once into a flat list of tokens, blocks are delimited by BlockBegin and BlockEnd tokens.
+  struct Token {
+    enum class Type {
+      Text,
+      Tag,
+      BlockBegin,
+      BlockEnd
+    };
+    explicit Token(const Type _type = Type::Text, const QString &_text = QString(), const Tag _tag = Tag::Unknown, const bool _unique = false) : type(_type), text(_text), tag(_tag), unique(_unique) {}
+    Type type;
+    QString text;
+    Tag tag;
+    // The tag is in kUniqueTags, so it makes the filename unique.
+    bool unique;
+  };
+
+  void Compile();
+  void CompileText(const QString &text);
+  QString Evaluate(const Song &song, bool *have_tagdata) const;
+  QString TagValue(const Tag tag, const Song &song) const;
+  static Tag TagFromName(const QString &name);
 
   QString format_;
+  QList<Token> tokens_;
   bool remove_problematic_;
   bool remove_non_fat_;
   bool remove_non_ascii_;
@@ -0,0 +1,215 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+#include "core/logging.h"
+#include "core/standardpaths.h"
+#include "core/song.h"
+#include "core/musicstorage.h"
+#include "utilities/fileutils.h"
+#include "organizetransferbatch.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+constexpr qint64 kReadAheadFiles = 2;
+constexpr qint64 kJournalMaxAgeDays = 7;
+}
+
+OrganizeTransferBatch::OrganizeTransferBatch(const SharedPtr<MusicStorage> storage, const QString &journal_filename)
+    : storage_(storage),
+      journal_filename_(journal_filename),
+      batch_size_(std::max(1, storage->CopyBatchSize())) {
+
+  if (!journal_filename_.isEmpty()) {
+    RemoveExpiredJournals(QFileInfo(journal_filename_).path());
+  }
+
+  LoadJournal();
+
+}
+
+QString OrganizeTransferBatch::JournalFilename(const QString &journal_id, const QStringList &keys) {
+
+  if (journal_id.isEmpty()) return QString();
+
+  // Only a restart of the same job, with the same files and destinations, resumes from the journal.
+  QStringList sorted_keys = keys;
+  std::sort(sorted_keys.begin(), sorted_keys.end());
+
+  QCryptographicHash hasher(QCryptographicHash::Sha1);
+  hasher.addData(journal_id.toUtf8());
+  for (const QString &key : std::as_const(sorted_keys)) {
+    hasher.addData(QByteArrayView("\n"));
+    hasher.addData(key.toUtf8());
+  }
+  const QByteArray hash = hasher.result().toHex();
+  return StandardPaths::WritableLocation(StandardPaths::StandardLocation::CacheLocation) + u"/organize/transfer-"_s + QString::fromLatin1(hash) + u".journal"_s;
+
+}
+
+QString OrganizeTransferBatch::JournalKey(const Song &song, const QString &destination) {
+
+  return song.url().toLocalFile() + QLatin1Char('\t') + QString::number(song.filesize()) + QLatin1Char('\t') + QString::number(song.mtime()) + QLatin1Char('\t') + destination;
+
+}
+
+void OrganizeTransferBatch::RemoveExpiredJournals(const QString &path) {
+
+  const QDateTime expiry = QDateTime::currentDateTime().addDays(-kJournalMaxAgeDays);
+  const QFileInfoList journals = QDir(path).entryInfoList(QStringList() << u"transfer-*.journal"_s, QDir::Files);
+  for (const QFileInfo &fileinfo : journals) {
+    if (fileinfo.lastModified() < expiry) {
+      qLog(Debug) << "Removing expired transfer journal" << fileinfo.filePath();
+      QFile::remove(fileinfo.filePath());
+    }
+  }
+
+}
+
+void OrganizeTransferBatch::LoadJournal() {
+
+  if (journal_filename_.isEmpty()) return;
+
+  QFile file(journal_filename_);
+  if (!file.exists()) return;
+  if (!file.open(QIODevice::ReadOnly)) {
+    qLog(Error) << "Failed to open transfer journal" << journal_filename_ << file.errorString();
+    return;
+  }
+
+  while (!file.atEnd()) {
+    QByteArray line = file.readLine();
+    if (line.endsWith('\n')) line.chop(1);
+    if (!line.isEmpty()) journal_.insert(QString::fromUtf8(line));
+  }
+  file.close();
+
+  if (!journal_.isEmpty()) {
+    qLog(Info) << "Resuming transfer," << journal_.count() << "files were already transferred";
+  }
+
+}
+
+bool OrganizeTransferBatch::WriteJournal(const QStringList &keys) {
+
+  for (const QString &key : keys) {
+    journal_.insert(key);
+  }
+
+  if (journal_filename_.isEmpty() || keys.isEmpty()) return true;
+
+  const QString path = QFileInfo(journal_filename_).path();
+  if (!QDir(path).exists()) QDir().mkpath(path);
+
+  QFile file(journal_filename_);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qLog(Error) << "Failed to open transfer journal" << journal_filename_ << file.errorString();
+    return false;
+  }
+
+  QByteArray data;
+  for (const QString &key : keys) {
+    data.append(key.toUtf8());
+    data.append('\n');
+  }
+  const bool success = file.write(data) == data.size() && file.flush();
+  file.close();
+
+  return success;
+
+}
+
+void OrganizeTransferBatch::Add(const int id, const QString &key, const MusicStorage::CopyJob &job) {
+
+  jobs_ << Entry { id, key, job };
+
+}
+
+OrganizeTransferBatch::ResultList OrganizeTransferBatch::Commit() {
+
+  ResultList results;
+  if (jobs_.isEmpty()) return results;
+
+  // Read the next files from disk while the current one is written to the storage.
+  for (qint64 i = 0; i < std::min(jobs_.count(), kReadAheadFiles); ++i) {
+    Utilities::PrefetchFile(jobs_[i].job.source_);
+  }
+
+  QStringList keys;
+  results.reserve(jobs_.count());
+  for (qint64 i = 0; i < jobs_.count(); ++i) {
+    if (i + kReadAheadFiles < jobs_.count()) {
+      Utilities::PrefetchFile(jobs_[i + kReadAheadFiles].job.source_);
+    }
+    const Entry &entry = jobs_[i];
+    Result result;
+    result.id = entry.id;
+    result.success = storage_->CopyToStorage(entry.job, result.error_text);
+    if (result.success) keys << entry.key;
+    results << result;
+  }
+
+  QString error_text;
+  if (storage_->CommitCopyBatch(error_text)) {
+    if (!WriteJournal(keys)) {
+      qLog(Error) << "Failed to write transfer journal, the transfer can not be resumed";
+    }
+  }
+  else {
+    // The storage discarded the whole batch.
+    qLog(Error) << "Failed to commit batch of" << jobs_.count() << "files" << error_text;
+    for (Result &result : results) {
+      if (!result.success) continue;
+      result.success = false;
+      result.error_text = error_text;
+    }
+  }
+
+  jobs_.clear();
+
+  return results;
+
+}
+
+void OrganizeTransferBatch::Finish(const bool success) {
+
+  jobs_.clear();
+
+  if (success) {
+    journal_.clear();
+    if (!journal_filename_.isEmpty() && QFile::exists(journal_filename_)) {
+      QFile::remove(journal_filename_);
+    }
+  }
+
+}
@@ -0,0 +1,85 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ORGANIZETRANSFERBATCH_H
+#define ORGANIZETRANSFERBATCH_H
+
+#include "config.h"
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/musicstorage.h"
+
+// Collects copy jobs for storages that want their files in batches (see MusicStorage::CopyBatchSize()).
+// Each batch is copied with the next files read ahead from disk, then committed to the storage in one go.
+// Committed files are recorded in a journal, so an interrupted transfer can skip them when the same job is started again.
+// The journal is named after the storage and the files of the job, journals older than a week are removed.
+class OrganizeTransferBatch {
+ public:
+  explicit OrganizeTransferBatch(const SharedPtr<MusicStorage> storage, const QString &journal_filename = QString());
+
+  struct Result {
+    Result() : id(0), success(false) {}
+    int id;
+    bool success;
+    QString error_text;
+  };
+  using ResultList = QList<Result>;
+
+  static QString JournalFilename(const QString &journal_id, const QStringList &keys);
+  static QString JournalKey(const Song &song, const QString &destination);
+
+  int batch_size() const { return batch_size_; }
+  qint64 count() const { return jobs_.count(); }
+  bool IsEmpty() const { return jobs_.isEmpty(); }
+  bool IsFull() const { return jobs_.count() >= batch_size_; }
+
+  // Whether the file was committed by an earlier run of this job that did not finish.
+  bool IsTransferred(const QString &key) const { return journal_.contains(key); }
+
+  void Add(const int id, const QString &key, const MusicStorage::CopyJob &job);
+  ResultList Commit();
+
+  // Removes the journal after a successful transfer.
+  void Finish(const bool success);
+
+ private:
+  struct Entry {
+    int id;
+    QString key;
+    MusicStorage::CopyJob job;
+  };
+
+  static void RemoveExpiredJournals(const QString &path);
+  void LoadJournal();
+  bool WriteJournal(const QStringList &keys);
+
+  const SharedPtr<MusicStorage> storage_;
+  const QString journal_filename_;
+  const int batch_size_;
+  QList<Entry> jobs_;
+  QSet<QString> journal_;
+};
+
+#endif  // ORGANIZETRANSFERBATCH_H
@@ -35,6 +35,7 @@
 #include <QtConcurrentRun>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QPromise>
 #include <QIODevice>
 #include <QDataStream>
 #include <QBuffer>
@@ -123,6 +124,9 @@ constexpr qint64 kMaxScrobblePointNsecs = 240LL * kNsecPerSec;
 
 constexpr int kMaxPlayedIndexes = 100;
 
+// Number of rows whose display values are kept, a few screens worth of rows for every column.
+constexpr int kDisplayCacheRows = 2000;
+
 }  // namespace
 
 Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
@@ -139,6 +143,8 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       filter_(new PlaylistFilter(this)),
       queue_(new Queue(this, this)),
       timer_save_(new QTimer(this)),
+      queue_positions_changed_begin_(-1),
+      queue_tracks_dequeued_(false),
       task_manager_(task_manager),
       url_handlers_(url_handlers),
       playlist_backend_(playlist_backend),
@@ -155,6 +161,10 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
       undo_stack_(new QUndoStack(this)),
       special_type_(special_type),
       cancel_restore_(false),
+      restore_watcher_(nullptr),
+      restore_row_(0),
+      timer_cue_restore_(new QTimer(this)),
+      display_cache_(kDisplayCacheRows),
       scrobbled_(false),
       scrobble_point_(-1),
       auto_sort_(false),
@@ -165,6 +175,8 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
 
   QObject::connect(this, &Playlist::rowsInserted, this, &Playlist::PlaylistChanged);
   QObject::connect(this, &Playlist::rowsRemoved, this, &Playlist::PlaylistChanged);
+  QObject::connect(this, &Playlist::dataChanged, this, &Playlist::InvalidateDisplayCache);
+  QObject::connect(this, &Playlist::modelReset, this, &Playlist::ClearDisplayCache);
 
   Restore();
 
@@ -177,6 +189,7 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
   QObject::connect(queue_, &Queue::rowsInserted, this, &Playlist::TracksEnqueued);
 
   QObject::connect(queue_, &Queue::layoutChanged, this, &Playlist::QueueLayoutChanged);
+  QObject::connect(queue_, &Queue::UpdateFinished, this, &Playlist::QueueUpdateFinished);
 
   QObject::connect(timer_save_, &QTimer::timeout, this, &Playlist::Save);
 
@@ -185,9 +198,14 @@ Playlist::Playlist(const SharedPtr<TaskManager> task_manager,
   timer_save_->setSingleShot(true);
   timer_save_->setInterval(900ms);
 
+  timer_cue_restore_->setSingleShot(true);
+  timer_cue_restore_->setInterval(0ms);
+  QObject::connect(timer_cue_restore_, &QTimer::timeout, this, &Playlist::RestoreRequestedCueData);
+
 }
 
 Playlist::~Playlist() {
+  if (restore_watcher_) restore_watcher_->cancel();
   items_.clear();
   ClearCollectionItems();
 }
@@ -315,6 +333,87 @@ bool Playlist::set_column_value(Song &song, const Playlist::Column column, const
 
 }
 
+QVariant Playlist::ColumnData(const Song &song, const Column column, const int role) {
+
+  // Don't forget to change Playlist::CompareItems when adding new columns
+  switch (column) {
+    case Column::Title:              return song.PrettyTitle();
+    case Column::TitleSort:          return song.titlesort();
+    case Column::Artist:             return song.artist();
+    case Column::ArtistSort:         return song.artistsort();
+    case Column::Album:              return song.album();
+    case Column::AlbumSort:          return song.albumsort();
+    case Column::Length:             return song.length_nanosec();
+    case Column::Track:              return song.track();
+    case Column::Disc:               return song.disc();
+    case Column::Year:               return song.year();
+    case Column::OriginalYear:       return song.effective_originalyear();
+    case Column::Genre:              return song.genre();
+    case Column::AlbumArtist:        return song.playlist_effective_albumartist();
+    case Column::AlbumArtistSort:    return song.albumartistsort();
+    case Column::Composer:           return song.composer();
+    case Column::ComposerSort:       return song.composersort();
+    case Column::Performer:          return song.performer();
+    case Column::PerformerSort:      return song.performersort();
+    case Column::Grouping:           return song.grouping();
+
+    case Column::PlayCount:          return song.playcount();
+    case Column::SkipCount:          return song.skipcount();
+    case Column::LastPlayed:         return song.lastplayed();
+
+    case Column::Samplerate:         return song.samplerate();
+    case Column::Bitdepth:           return song.bitdepth();
+    case Column::Bitrate:            return song.bitrate();
+
+    case Column::URL:                return song.effective_url();
+    case Column::BaseFilename:       return song.basefilename();
+    case Column::Filesize:           return song.filesize();
+    case Column::Filetype:           return QVariant::fromValue(song.filetype());
+    case Column::DateModified:       return song.mtime();
+    case Column::DateCreated:        return song.ctime();
+
+    case Column::Comment:
+      if (role == Qt::DisplayRole)   return song.comment().simplified();
+      return song.comment();
+
+    case Column::EBUR128IntegratedLoudness: return song.ebur128_integrated_loudness_lufs().has_value() ? song.ebur128_integrated_loudness_lufs().value() : QVariant();
+
+    case Column::EBUR128LoudnessRange:      return song.ebur128_loudness_range_lu().has_value() ? song.ebur128_loudness_range_lu().value() : QVariant();
+
+    case Column::Source:             return QVariant::fromValue(song.source());
+
+    case Column::Rating:             return song.rating();
+
+    case Column::HasCUE:             return song.has_cue();
+
+    case Column::BPM:                return song.bpm();
+    case Column::Mood:               return song.mood();
+    case Column::InitialKey:         return song.initial_key();
+
+    case Column::Moodbar:
+    case Column::ColumnCount:
+      break;
+
+  }
+
+  return QVariant();
+
+}
+
+void Playlist::InvalidateDisplayCache(const QModelIndex &top_left, const QModelIndex &bottom_right) {
+
+  if (display_cache_.isEmpty() || !top_left.isValid() || !bottom_right.isValid()) return;
+
+  for (int row = top_left.row(); row <= bottom_right.row() && row < items_.count(); ++row) {
+    display_cache_.remove(items_[row]->uuid());
+  }
+
+}
+
+void Playlist::ClearDisplayCache() {
+  display_cache_.clear();
+}
+
 QVariant Playlist::data(const QModelIndex &idx, const int role) const {
 
   if (!idx.isValid()) {
@@ -341,70 +440,29 @@ QVariant Playlist::data(const QModelIndex &idx, const int role) const {
     case Qt::ToolTipRole:
     case Qt::DisplayRole:{
       const PlaylistItemPtr item = items_[idx.row()];
-      const Song song = item->EffectiveMetadata();
-
-      // Don't forget to change Playlist::CompareItems when adding new columns
-      switch (static_cast<Column>(idx.column())) {
-        case Column::Title:              return song.PrettyTitle();
-        case Column::TitleSort:          return song.titlesort();
-        case Column::Artist:             return song.artist();
-        case Column::ArtistSort:         return song.artistsort();
-        case Column::Album:              return song.album();
-        case Column::AlbumSort:          return song.albumsort();
-        case Column::Length:             return song.length_nanosec();
-        case Column::Track:              return song.track();
-        case Column::Disc:               return song.disc();
-        case Column::Year:               return song.year();
-        case Column::OriginalYear:       return song.effective_originalyear();
-        case Column::Genre:              return song.genre();
-        case Column::AlbumArtist:        return song.playlist_effective_albumartist();
-        case Column::AlbumArtistSort:    return song.albumartistsort();
-        case Column::Composer:           return song.composer();
-        case Column::ComposerSort:       return song.composersort();
-        case Column::Performer:          return song.performer();
-        case Column::PerformerSort:      return song.performersort();
-        case Column::Grouping:           return song.grouping();
-
-        case Column::PlayCount:          return song.playcount();
-        case Column::SkipCount:          return song.skipcount();
-        case Column::LastPlayed:         return song.lastplayed();
-
-        case Column::Samplerate:         return song.samplerate();
-        case Column::Bitdepth:           return song.bitdepth();
-        case Column::Bitrate:            return song.bitrate();
-
-        case Column::URL:                return song.effective_url();
-        case Column::BaseFilename:       return song.basefilename();
-        case Column::Filesize:           return song.filesize();
-        case Column::Filetype:           return QVariant::fromValue(song.filetype());
-        case Column::DateModified:       return song.mtime();
-        case Column::DateCreated:        return song.ctime();
-
-        case Column::Comment:
-          if (role == Qt::DisplayRole)   return song.comment().simplified();
-          return song.comment();
-
-        case Column::EBUR128IntegratedLoudness: return song.ebur128_integrated_loudness_lufs().has_value() ? song.ebur128_integrated_loudness_lufs().value() : QVariant();
-
-        case Column::EBUR128LoudnessRange:      return song.ebur128_loudness_range_lu().has_value() ? song.ebur128_loudness_range_lu().value() : QVariant();
-
-        case Column::Source:             return QVariant::fromValue(song.source());
-
-        case Column::Rating:             return song.rating();
-
-        case Column::HasCUE:             return song.has_cue();
-
-        case Column::BPM:                return song.bpm();
-        case Column::Mood:               return song.mood();
-        case Column::InitialKey:         return song.initial_key();
-
-        case Column::Moodbar:
-        case Column::ColumnCount:
-          break;
+      if (!cue_restore_pending_.isEmpty() && cue_restore_pending_.contains(item->uuid())) {
+        RequestCueRestore(idx);
+      }
+      if (role != Qt::DisplayRole) {
+        return ColumnData(item->EffectiveMetadata(), static_cast<Column>(idx.column()), role);
+      }
 
+      // The stream URL is set by the player without a dataChanged signal, so the URL column is never cached.
+      if (static_cast<Column>(idx.column()) == Column::URL) {
+        return item->EffectiveMetadata().effective_url();
       }
 
-      return QVariant();
+      QVariantList *display_values = display_cache_.object(item->uuid());
+      if (!display_values) {
+        display_values = new QVariantList(ColumnCount);
+        display_cache_.insert(item->uuid(), display_values);
+      }
+      QVariant &value = (*display_values)[idx.column()];
+      if (!value.isValid()) {
+        value = ColumnData(item->EffectiveMetadata(), static_cast<Column>(idx.column()), role);
+      }
+
+      return value;
     }
 
     case Qt::TextAlignmentRole:
@@ -763,6 +821,11 @@ int Playlist::take_previous_row(const bool ignore_repeat_track) {
 
 void Playlist::set_current_row(const int i, const AutoScroll autoscroll, const bool is_stopping, const bool force_inform) {
 
+  // Playback starts with the stored metadata, the item is updated when its CUE sheet was read in the background.
+  if (has_item_at(i) && !cue_restore_pending_.isEmpty() && cue_restore_pending_.contains(items_[i]->uuid())) {
+    RequestCueRestore(index(i, 0));
+  }
+
   const QPersistentModelIndex old_current_item_index = current_item_index_;
   QPersistentModelIndex new_current_item_index;
   if (i != -1) new_current_item_index = QPersistentModelIndex(index(i, 0, QModelIndex()));
@@ -1380,6 +1443,7 @@ void Playlist::UpdateItems(SongList songs) {
           }
         }
         items_by_uuid_.remove(item->uuid());
+        display_cache_.remove(item->uuid());
         items_by_uuid_.insert(new_item->uuid(), new_item);
         items_[i] = new_item;
         Q_EMIT dataChanged(index(i, 0), index(i, ColumnCount - 1));
@@ -1731,7 +1795,8 @@ void Playlist::ScheduleSaveItem(const PlaylistItemPtr &item) {
 
 void Playlist::Save() {
 
-  if (!playlist_backend_ || is_loading_) return;
+  // Saving while the items are still being restored would write a partial playlist, ItemsLoaded() reschedules the save when done.
+  if (!playlist_backend_ || is_loading_ || restore_watcher_) return;
 
   // The items are snapshotted here, on the playlist's own thread, rather than handing the items themselves to the database thread:
   // saving is asynchronous and the model keeps mutating the items (inline tag edits, collection updates, stream metadata) while it runs.
@@ -1773,16 +1838,28 @@ void Playlist::Restore() {
 
   if (!playlist_backend_) return;
 
+  if (restore_watcher_) {
+    restore_watcher_->cancel();
+    restore_watcher_->deleteLater();
+    restore_watcher_ = nullptr;
+  }
+
   items_.clear();
   items_by_uuid_.clear();
   virtual_items_.clear();
+  cue_restore_pending_.clear();
+  cue_restore_requested_.clear();
   ClearCollectionItems();
 
   cancel_restore_ = false;
-  QFuture<PlaylistItemPtrList> future = QtConcurrent::run(&PlaylistBackend::GetPlaylistItems, playlist_backend_, id_);
-  QFutureWatcher<PlaylistItemPtrList> *watcher = new QFutureWatcher<PlaylistItemPtrList>(this);
-  QObject::connect(watcher, &QFutureWatcher<PlaylistItemPtrList>::finished, this, &Playlist::ItemsLoaded);
-  watcher->setFuture(future);
+  restore_row_ = 0;
+  const SharedPtr<PlaylistBackend> playlist_backend = playlist_backend_;
+  const int playlist_id = id_;
+  QFuture<PlaylistItemPtrList> future = QtConcurrent::run([playlist_backend, playlist_id](QPromise<PlaylistItemPtrList> &promise) { playlist_backend->LoadPlaylistItems(promise, playlist_id); });
+  restore_watcher_ = new QFutureWatcher<PlaylistItemPtrList>(this);
+  QObject::connect(restore_watcher_, &QFutureWatcher<PlaylistItemPtrList>::resultsReadyAt, this, &Playlist::ItemsLoadedAt);
+  QObject::connect(restore_watcher_, &QFutureWatcher<PlaylistItemPtrList>::finished, this, &Playlist::ItemsLoaded);
+  restore_watcher_->setFuture(future);
 
 }
 
@@ -1795,27 +1872,52 @@ void Playlist::ClearCollectionItems() {
 
 }
 
-void Playlist::ItemsLoaded() {
+void Playlist::ItemsLoadedAt(const int begin, const int end) {
 
   QFutureWatcher<PlaylistItemPtrList> *watcher = static_cast<QFutureWatcher<PlaylistItemPtrList>*>(sender());
-  PlaylistItemPtrList items = watcher->result();
-  watcher->deleteLater();
+  if (watcher != restore_watcher_ || cancel_restore_) return;
 
-  if (cancel_restore_) return;
+  for (int i = begin; i < end; ++i) {
+    PlaylistItemPtrList items = watcher->resultAt(i);
 
-  // Backend returns empty elements for collection items which it couldn't match (because they got deleted); we don't need those
-  QMutableListIterator<PlaylistItemPtr> it(items);
-  while (it.hasNext()) {
-    PlaylistItemPtr item = it.next();
+    // Backend returns empty elements for collection items which it couldn't match (because they got deleted); we don't need those
+    QMutableListIterator<PlaylistItemPtr> it(items);
+    while (it.hasNext()) {
+      PlaylistItemPtr item = it.next();
 
-    if (item->IsLocalCollectionItem() && item->EffectiveMetadata().url().isEmpty()) {
-      it.remove();
+      if (item->IsLocalCollectionItem() && item->EffectiveMetadata().url().isEmpty()) {
+        it.remove();
+      }
+      else if (item->source() == Song::Source::LocalFile && item->EffectiveMetadata().has_cue()) {
+        cue_restore_pending_.insert(item->uuid());
+      }
     }
+
+    // Items added while the playlist is being restored go after the restored ones.
+    const int pos = std::min(restore_row_, static_cast<int>(items_.count()));
+    restore_row_ = pos + static_cast<int>(items.count());
+
+    is_loading_ = true;
+    InsertItemsWithoutUndo(items, pos);
+    is_loading_ = false;
+  }
+
+}
+
+void Playlist::ItemsLoaded() {
+
+  QFutureWatcher<PlaylistItemPtrList> *watcher = static_cast<QFutureWatcher<PlaylistItemPtrList>*>(sender());
+  watcher->deleteLater();
+
+  if (watcher != restore_watcher_) return;
+  restore_watcher_ = nullptr;
+
+  // Changes made while the items were being restored were held back by Save().
+  if (save_all_ || save_last_played_ || !save_item_uuids_.isEmpty()) {
+    timer_save_->start();
   }
 
-  is_loading_ = true;
-  InsertItems(items, 0);
-  is_loading_ = false;
+  if (cancel_restore_) return;
 
   const PlaylistBackend::Playlist playlist = playlist_backend_->GetPlaylist(id_);
 
@@ -1854,6 +1956,59 @@ void Playlist::ItemsLoaded() {
 
 }
 
+void Playlist::RequestCueRestore(const QModelIndex &idx) const {
+
+  const QUuid uuid = items_[idx.row()]->uuid();
+  if (!cue_restore_requested_.contains(uuid)) {
+    cue_restore_requested_.insert(uuid, QPersistentModelIndex(idx));
+  }
+  if (!timer_cue_restore_->isActive()) {
+    timer_cue_restore_->start();
+  }
+
+}
+
+void Playlist::RestoreRequestedCueData() {
+
+  if (!playlist_backend_ || cue_restore_requested_.isEmpty()) return;
+
+  // The rows are kept with the songs, so the restored metadata is applied without searching the items.
+  QMap<QUuid, Song> songs;
+  QHash<QUuid, QPersistentModelIndex> rows;
+  for (QHash<QUuid, QPersistentModelIndex>::const_iterator it = cue_restore_requested_.constBegin(); it != cue_restore_requested_.constEnd(); ++it) {
+    if (!cue_restore_pending_.remove(it.key())) continue;
+    const QPersistentModelIndex &idx = it.value();
+    if (!idx.isValid() || items_[idx.row()]->uuid() != it.key()) continue;
+    songs.insert(it.key(), items_[idx.row()]->OriginalMetadata());
+    rows.insert(it.key(), idx);
+  }
+  cue_restore_requested_.clear();
+
+  if (songs.isEmpty()) return;
+
+  QFuture<QMap<QUuid, Song>> future = QtConcurrent::run(&PlaylistBackend::RestoreCueData, playlist_backend_, songs);
+  QFutureWatcher<QMap<QUuid, Song>> *watcher = new QFutureWatcher<QMap<QUuid, Song>>(this);
+  QObject::connect(watcher, &QFutureWatcher<QMap<QUuid, Song>>::finished, this, [this, watcher, rows]() {
+    watcher->deleteLater();
+    ApplyCueData(watcher->result(), rows);
+  });
+  watcher->setFuture(future);
+
+}
+
+void Playlist::ApplyCueData(const QMap<QUuid, Song> &songs, const QHash<QUuid, QPersistentModelIndex> &rows) {
+
+  for (QMap<QUuid, Song>::const_iterator it = songs.constBegin(); it != songs.constEnd(); ++it) {
+    const QPersistentModelIndex idx = rows.value(it.key());
+    if (!idx.isValid()) continue;
+    const PlaylistItemPtr item = items_[idx.row()];
+    if (item->uuid() == it.key()) {
+      UpdateItemMetadata(idx.row(), item, it.value(), false);
+    }
+  }
+
+}
+
 static bool DescendingIntLessThan(const int a, const int b) { return a > b; }
 
 void Playlist::RemoveItemsWithoutUndo(const QList<int> &indicesIn) {
@@ -2099,6 +2254,7 @@ void Playlist::Clear() {
 
   // If loading songs from session restore async, don't insert them
   cancel_restore_ = true;
+  if (restore_watcher_) restore_watcher_->cancel();
 
   const int count = static_cast<int>(items_.count());
 
@@ -2358,6 +2514,28 @@ SongList Playlist::GetAllSongs() const {
 
 }
 
+SongList Playlist::UpcomingSongs(const int count) const {
+
+  SongList songs;
+
+  for (int i = 0; i < queue_->rowCount() && songs.count() < count; ++i) {
+    const int row = queue_->mapToSource(queue_->index(i, 0)).row();
+    if (row >= 0 && row < items_.count()) {
+      songs << items_.at(row)->EffectiveMetadata();
+    }
+  }
+
+  int virtual_index = current_virtual_index_;
+  while (songs.count() < count) {
+    virtual_index = NextVirtualIndex(virtual_index, true);
+    if (virtual_index < 0 || virtual_index >= virtual_items_.count()) break;
+    songs << items_.at(virtual_items_.at(virtual_index))->EffectiveMetadata();
+  }
+
+  return songs;
+
+}
+
 PlaylistItemPtrList Playlist::GetAllItems() const { return items_; }
 
 quint64 Playlist::GetTotalLength() const {
@@ -2387,33 +2565,78 @@ void Playlist::TracksAboutToBeDequeued(const QModelIndex &idx, const int begin,
 
 }
 
-void Playlist::TracksDequeued() {
+void Playlist::TracksDequeued(const QModelIndex &idx, const int begin, const int end) {
 
-  for (const QModelIndex &idx : std::as_const(temp_dequeue_change_indexes_)) {
-    Q_EMIT dataChanged(idx, idx);
-  }
-  temp_dequeue_change_indexes_.clear();
-  Q_EMIT QueueChanged();
+  Q_UNUSED(idx)
+  Q_UNUSED(end)
+
+  queue_tracks_dequeued_ = true;
+
+  // The tracks after the removed ones moved up in the queue.
+  QueuePositionsChanged(begin);
 
 }
 
 void Playlist::TracksEnqueued(const QModelIndex &parent_idx, const int begin, const int end) {
 
   Q_UNUSED(parent_idx)
+  Q_UNUSED(end)
 
-  const QModelIndex &b = queue_->mapToSource(queue_->index(begin, static_cast<int>(Column::Title)));
-  const QModelIndex &e = queue_->mapToSource(queue_->index(end, static_cast<int>(Column::Title)));
-  Q_EMIT dataChanged(b, e);
+  // The inserted tracks and the ones after them got a new queue position.
+  QueuePositionsChanged(begin);
 
 }
 
-void Playlist::QueueLayoutChanged() {
+void Playlist::QueuePositionsChanged(const int begin) {
+
+  if (queue_positions_changed_begin_ == -1 || begin < queue_positions_changed_begin_) {
+    queue_positions_changed_begin_ = begin;
+  }
+
+  // A bulk change of the queue is made of several model operations, the rows are updated once when it's finished.
+  if (!queue_->is_updating()) {
+    QueueUpdateFinished();
+  }
+
+}
 
-  for (int i = 0; i < queue_->rowCount(); ++i) {
-    const QModelIndex idx = queue_->mapToSource(queue_->index(i, static_cast<int>(Column::Title)));
-    Q_EMIT dataChanged(idx, idx);
+void Playlist::QueueUpdateFinished() {
+
+  int first_row = -1;
+  int last_row = -1;
+  const auto add_row = [&first_row, &last_row](const int row) {
+    if (first_row == -1 || row < first_row) first_row = row;
+    if (row > last_row) last_row = row;
+  };
+
+  for (const QModelIndex &dequeued_idx : std::as_const(temp_dequeue_change_indexes_)) {
+    if (dequeued_idx.isValid()) add_row(dequeued_idx.row());
+  }
+  temp_dequeue_change_indexes_.clear();
+
+  if (queue_positions_changed_begin_ != -1) {
+    for (int i = queue_positions_changed_begin_; i < queue_->rowCount(); ++i) {
+      const QModelIndex idx = queue_->mapToSource(queue_->index(i, static_cast<int>(Column::Title)));
+      if (idx.isValid()) add_row(idx.row());
+    }
+    queue_positions_changed_begin_ = -1;
+  }
+
+  if (first_row != -1) {
+    Q_EMIT dataChanged(index(first_row, static_cast<int>(Column::Title)), index(last_row, static_cast<int>(Column::Title)));
   }
 
+  if (queue_tracks_dequeued_) {
+    queue_tracks_dequeued_ = false;
+    Q_EMIT QueueChanged();
+  }
+
+}
+
+void Playlist::QueueLayoutChanged() {
+
+  QueuePositionsChanged(0);
+
 }
 
 Playlist::Columns Playlist::ChangedColumns(const Song &metadata1, const Song &metadata2) {
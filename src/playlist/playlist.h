@@ -30,9 +30,12 @@
 #include <QAbstractListModel>
 #include <QPersistentModelIndex>
 #include <QFuture>
+#include <QFutureWatcher>
 #include <QList>
 #include <QMap>
+#include <QCache>
 #include <QSet>
+#include <QHash>
 #include <QMultiMap>
 #include <QMetaType>
 #include <QVariant>
@@ -226,6 +229,8 @@ class Playlist : public QAbstractListModel {
   int IndexByUuId(const QUuid &uuid) const;
 
   SongList GetAllSongs() const;
+  // The songs that will most likely be played after the current one, queued songs first. Doesn't reshuffle or wrap around.
+  SongList UpcomingSongs(const int count) const;
   PlaylistItemPtrList GetAllItems() const;
   quint64 GetTotalLength() const;  // in seconds
 
@@ -384,16 +389,28 @@ class Playlist : public QAbstractListModel {
 
   void ClearCollectionItems();
 
+  // CUE data of restored items is re-read lazily, when the row is displayed or played.
+  void RequestCueRestore(const QModelIndex &idx) const;
+  void ApplyCueData(const QMap<QUuid, Song> &songs, const QHash<QUuid, QPersistentModelIndex> &rows);
+
   void SaveItem(const QModelIndex &idx, PlaylistItemPtr item, const Song &song, const Song &pre_edit_metadata);
 
+  static QVariant ColumnData(const Song &song, const Column column, const int role);
+
  private Q_SLOTS:
   void TracksAboutToBeDequeued(const QModelIndex &idx, const int begin, const int end);
-  void TracksDequeued();
+  void TracksDequeued(const QModelIndex &idx, const int begin, const int end);
   void TracksEnqueued(const QModelIndex &parent_idx, const int begin, const int end);
   void QueueLayoutChanged();
+  void QueuePositionsChanged(const int begin);
+  void QueueUpdateFinished();
+  void InvalidateDisplayCache(const QModelIndex &top_left, const QModelIndex &bottom_right);
+  void ClearDisplayCache();
   void SaveItemComplete(TagReaderReplyPtr reply, const QPersistentModelIndex &idx, PlaylistItemPtr item, const quint64 save_generation, const Song &pre_edit_metadata);
   void ReloadItemComplete(const QPersistentModelIndex &idx, PlaylistItemPtr item, const Song &new_metadata, const bool saved, const quint64 save_generation, const Song &fallback_metadata);
+  void ItemsLoadedAt(const int begin, const int end);
   void ItemsLoaded();
+  void RestoreRequestedCueData();
   void ForceScheduleSave();
   void ScheduleSaveItem(const PlaylistItemPtr &item);
   void ScheduleSaveLastPlayed();
@@ -406,6 +423,9 @@ class Playlist : public QAbstractListModel {
   QTimer *timer_save_;
 
   QList<QModelIndex> temp_dequeue_change_indexes_;
+  // The first queue row with a changed position, -1 if none changed since the last queue update.
+  int queue_positions_changed_begin_;
+  bool queue_tracks_dequeued_;
 
   const SharedPtr<TaskManager> task_manager_;
   const SharedPtr<UrlHandlers> url_handlers_;
@@ -455,6 +475,16 @@ class Playlist : public QAbstractListModel {
 
   // Cancel async restore if songs are already replaced
   bool cancel_restore_;
+  QFutureWatcher<PlaylistItemPtrList> *restore_watcher_;
+  int restore_row_;
+
+  // Restored items with a CUE sheet that hasn't been re-read yet, and the rows of those displayed or played since the last timer_cue_restore_ timeout.
+  QSet<QUuid> cue_restore_pending_;
+  mutable QHash<QUuid, QPersistentModelIndex> cue_restore_requested_;
+  QTimer *timer_cue_restore_;
+
+  // DisplayRole values of recently displayed rows by item UUID, one entry per column. Dropped for the rows in dataChanged.
+  mutable QCache<QUuid, QVariantList> display_cache_;
 
   bool scrobbled_;
   qint64 scrobble_point_;
@@ -38,6 +38,7 @@
 #include <QUrl>
 #include <QUuid>
 #include <QSqlDatabase>
+#include <QPromise>
 
 #include "includes/shared_ptr.h"
 #include "core/database.h"
@@ -50,7 +51,6 @@
 #include "tagreader/tagreaderclient.h"
 #include "playlistitem.h"
 #include "playlistitemsavedata.h"
-#include "songplaylistitem.h"
 #include "playlistbackend.h"
 #include "playlistparsers/cueparser.h"
 #include "smartplaylists/playlistgenerator.h"
@@ -62,6 +62,8 @@ namespace {
 constexpr int kSongTableJoins = 2;
 }
 
+const int PlaylistBackend::kPlaylistItemsChunkSize = 2000;
+
 PlaylistBackend::PlaylistBackend(const SharedPtr<Database> database,
                                  const SharedPtr<TagReaderClient> tagreader_client,
                                  const SharedPtr<CollectionBackend> collection_backend,
@@ -189,7 +191,7 @@ PlaylistBackend::Playlist PlaylistBackend::GetPlaylist(const int id) {
 
 QString PlaylistBackend::PlaylistItemsQuery() {
 
-  return QStringLiteral("SELECT %1, %2, p.type, p.uuid FROM playlist_items AS p "
+  return QStringLiteral("SELECT %1, %2, p.type, p.uuid, p.ROWID FROM playlist_items AS p "
                         "LEFT JOIN songs ON p.type = songs.source AND p.collection_id = songs.ROWID "
                         "WHERE p.playlist = :playlist"
                         ).arg(Song::JoinSpec(u"songs"_s),
@@ -197,29 +199,44 @@ QString PlaylistBackend::PlaylistItemsQuery() {
 
 }
 
-PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist_id) {
-
-  PlaylistItemPtrList playlist_items;
-
-  {
-
-    QMutexLocker l(database_->Mutex());
-    QSqlDatabase db(database_->Connect());
-    SqlQuery q(db);
-    // Forward iterations only may be faster
-    q.setForwardOnly(true);
-    q.prepare(PlaylistItemsQuery());
-    q.BindValue(u":playlist"_s, playlist_id);
-    if (!q.Exec()) {
-      database_->ReportErrors(q);
-      return PlaylistItemPtrList();
+void PlaylistBackend::LoadPlaylistItems(QPromise<PlaylistItemPtrList> &promise, const int playlist_id) {
+
+  // The row order of a playlist is its ROWID order, so the last ROWID read is used as a cursor for the next chunk.
+  const int rowid_column = static_cast<int>(Song::kRowIdColumns.count()) * kSongTableJoins + 2;
+  qint64 last_rowid = -1;
+
+  while (!promise.isCanceled()) {
+
+    PlaylistItemPtrList playlist_items;
+    playlist_items.reserve(kPlaylistItemsChunkSize);
+
+    {
+      QMutexLocker l(database_->Mutex());
+      QSqlDatabase db(database_->Connect());
+      SqlQuery q(db);
+      // Forward iterations only may be faster
+      q.setForwardOnly(true);
+      q.prepare(PlaylistItemsQuery() + u" AND p.ROWID > :last_rowid ORDER BY p.ROWID LIMIT :limit"_s);
+      q.BindValue(u":playlist"_s, playlist_id);
+      q.BindValue(u":last_rowid"_s, last_rowid);
+      q.BindValue(u":limit"_s, kPlaylistItemsChunkSize);
+      if (!q.Exec()) {
+        database_->ReportErrors(q);
+        break;
+      }
+
+      while (q.next()) {
+        const SqlRow row(q);
+        last_rowid = row.value(rowid_column).toLongLong();
+        playlist_items << NewPlaylistItemFromQuery(row);
+      }
     }
 
-    // It's probable that we'll have a few songs associated with the same CUE, so we're caching results of parsing CUEs
-    SharedPtr<NewSongFromQueryState> state_ptr = make_shared<NewSongFromQueryState>();
-    while (q.next()) {
-      playlist_items << NewPlaylistItemFromQuery(SqlRow(q), state_ptr);
-    }
+    if (playlist_items.isEmpty()) break;
+
+    const bool last_chunk = playlist_items.count() < kPlaylistItemsChunkSize;
+    promise.addResult(playlist_items);
+    if (last_chunk) break;
 
   }
 
@@ -227,8 +244,6 @@ PlaylistItemPtrList PlaylistBackend::GetPlaylistItems(const int playlist_id) {
     Close();
   }
 
-  return playlist_items;
-
 }
 
 SongList PlaylistBackend::GetPlaylistSongs(const int playlist_id) {
@@ -264,7 +279,27 @@ SongList PlaylistBackend::GetPlaylistSongs(const int playlist_id) {
 
 }
 
-PlaylistItemPtr PlaylistBackend::NewPlaylistItemFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state) {
+QMap<QUuid, Song> PlaylistBackend::RestoreCueData(const QMap<QUuid, Song> &songs) {
+
+  QMap<QUuid, Song> restored_songs;
+
+  SharedPtr<NewSongFromQueryState> state_ptr = make_shared<NewSongFromQueryState>();
+  for (QMap<QUuid, Song>::const_iterator it = songs.constBegin(); it != songs.constEnd(); ++it) {
+    const Song restored_song = RestoreCueSong(it.value(), state_ptr);
+    if (restored_song.is_valid()) {
+      restored_songs.insert(it.key(), restored_song);
+    }
+  }
+
+  if (QThread::currentThread() != thread() && QThread::currentThread() != qApp->thread()) {
+    Close();
+  }
+
+  return restored_songs;
+
+}
+
+PlaylistItemPtr PlaylistBackend::NewPlaylistItemFromQuery(const SqlRow &row) {
 
   // The song tables get joined first
   const int playlist_row = static_cast<int>(Song::kRowIdColumns.count()) * kSongTableJoins;
@@ -273,19 +308,21 @@ PlaylistItemPtr PlaylistBackend::NewPlaylistItemFromQuery(const SqlRow &row, Sha
   PlaylistItemPtr item = PlaylistItem::NewFromSource(source, uuid);
   item->InitFromQuery(row);
 
-  return RestoreCueData(item, state);
+  return item;
 
 }
 
 Song PlaylistBackend::NewSongFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state) {
 
-  return NewPlaylistItemFromQuery(row, state)->EffectiveMetadata();
+  const Song song = NewPlaylistItemFromQuery(row)->EffectiveMetadata();
+  const Song restored_song = RestoreCueSong(song, state);
+
+  return restored_song.is_valid() ? restored_song : song;
 
 }
 
-Song PlaylistBackend::ReloadPlaylistItem(PlaylistItemPtr item) const {
+Song PlaylistBackend::ReloadSong(const Song &original_song) const {
 
-  const Song original_song = item->OriginalMetadata();
   if (!original_song.url().isLocalFile()) return Song();
 
   Song result = original_song;
@@ -299,27 +336,23 @@ Song PlaylistBackend::ReloadPlaylistItem(PlaylistItemPtr item) const {
 
 }
 
-// If song had a CUE and the CUE still exists, the metadata from it will be applied here.
+// If song had a CUE and the CUE still exists, the metadata from it is returned here.
+// An invalid song is returned if there is nothing to restore.
 
-PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, SharedPtr<NewSongFromQueryState> state) {
+Song PlaylistBackend::RestoreCueSong(const Song &song, SharedPtr<NewSongFromQueryState> state) {
 
-  // We need collection to run a CueParser; also, this method applies only to file-type PlaylistItems
-  if (item->source() != Song::Source::LocalFile) return item;
+  // We need collection to run a CueParser; also, this method applies only to local files
+  if (song.source() != Song::Source::LocalFile) return Song();
 
-  CueParser cue_parser(tagreader_client_, collection_backend_);
-
-  const Song song = item->EffectiveMetadata();
   // We're only interested in .cue songs here
-  if (!song.has_cue()) return item;
+  if (!song.has_cue()) return Song();
+
+  CueParser cue_parser(tagreader_client_, collection_backend_);
 
   QString cue_path = song.cue_path();
   // If .cue was deleted - reload the song
   if (!QFile::exists(cue_path)) {
-    const Song reloaded_song = ReloadPlaylistItem(item);
-    if (reloaded_song.is_valid()) {
-      item->SetOriginalMetadata(reloaded_song);
-    }
-    return item;
+    return ReloadSong(song);
   }
 
   SongList songs;
@@ -328,7 +361,7 @@ PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, SharedPtr<
 
     if (!state->cached_cues_.contains(cue_path)) {
       QFile cue_file(cue_path);
-      if (!cue_file.open(QIODevice::ReadOnly)) return item;
+      if (!cue_file.open(QIODevice::ReadOnly)) return Song();
 
       songs = cue_parser.Load(&cue_file, cue_path, QDir(cue_path.section(u'/', 0, -2))).songs;
       cue_file.close();
@@ -341,18 +374,13 @@ PlaylistItemPtr PlaylistBackend::RestoreCueData(PlaylistItemPtr item, SharedPtr<
 
   for (const Song &from_list : std::as_const(songs)) {
     if (from_list.url().toEncoded() == song.url().toEncoded() && from_list.beginning_nanosec() == song.beginning_nanosec()) {
-      // We found a matching section; replace the input item with a new one containing CUE metadata
-      return make_shared<SongPlaylistItem>(from_list);
+      // We found a matching section; use the CUE metadata
+      return from_list;
     }
   }
 
   // There's no such section in the related .cue -> reload the song
-  const Song reloaded_song = ReloadPlaylistItem(item);
-  if (reloaded_song.is_valid()) {
-    item->SetOriginalMetadata(reloaded_song);
-  }
-
-  return item;
+  return ReloadSong(song);
 
 }
 
@@ -27,9 +27,12 @@
 #include <QObject>
 #include <QMutex>
 #include <QHash>
+#include <QMap>
 #include <QList>
 #include <QSet>
 #include <QString>
+#include <QUuid>
+#include <QPromise>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
@@ -66,6 +69,8 @@ class PlaylistBackend : public QObject {
   };
   using PlaylistList = QList<Playlist>;
 
+  static const int kPlaylistItemsChunkSize;
+
   void Close();
   void ExitAsync();
 
@@ -74,9 +79,16 @@ class PlaylistBackend : public QObject {
   PlaylistList GetAllFavoritePlaylists();
   PlaylistBackend::Playlist GetPlaylist(const int id);
 
-  PlaylistItemPtrList GetPlaylistItems(const int playlist_id);
+  // Loads the items of a playlist in chunks of kPlaylistItemsChunkSize, adding each chunk as a separate result to the promise.
+  // The database is only locked while a chunk is read, and loading stops early if the promise is canceled.
+  // CUE data is not restored here, call RestoreCueData() for the items once they are needed.
+  void LoadPlaylistItems(QPromise<PlaylistItemPtrList> &promise, const int playlist_id);
   SongList GetPlaylistSongs(const int playlist_id);
 
+  // Re-reads the CUE sheets of the given songs, keyed by playlist item UUID.
+  // Only songs which changed are returned.
+  QMap<QUuid, Song> RestoreCueData(const QMap<QUuid, Song> &songs);
+
   void SetPlaylistOrder(const QList<int> &ids);
   void SetPlaylistUiPath(const int id, const QString &path);
 
@@ -104,10 +116,10 @@ class PlaylistBackend : public QObject {
   };
 
   static QString PlaylistItemsQuery();
-  PlaylistItemPtr NewPlaylistItemFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state);
+  PlaylistItemPtr NewPlaylistItemFromQuery(const SqlRow &row);
   Song NewSongFromQuery(const SqlRow &row, SharedPtr<NewSongFromQueryState> state);
-  Song ReloadPlaylistItem(PlaylistItemPtr item) const;
-  PlaylistItemPtr RestoreCueData(PlaylistItemPtr item, SharedPtr<NewSongFromQueryState> state);
+  Song ReloadSong(const Song &original_song) const;
+  Song RestoreCueSong(const Song &song, SharedPtr<NewSongFromQueryState> state);
 
   enum GetPlaylistsFlags {
     GetPlaylists_OpenInUi = 1,
@@ -81,6 +81,7 @@ constexpr QRgb kQueueBoxGradientColor1 = qRgb(102, 150, 227);
 constexpr QRgb kQueueBoxGradientColor2 = qRgb(77, 121, 200);
 constexpr int kQueueOpacitySteps = 10;
 constexpr float kQueueOpacityLowerBound = 0.4F;
+constexpr int kDisplayTextCacheSize = 1000;
 }  // namespace
 
 const int PlaylistDelegateBase::kMinHeight = 19;
@@ -299,6 +300,8 @@ bool PlaylistDelegateBase::helpEvent(QHelpEvent *event, QAbstractItemView *view,
 }
 
 
+LengthItemDelegate::LengthItemDelegate(QObject *parent) : PlaylistDelegateBase(parent), text_cache_(kDisplayTextCacheSize) {}
+
 QString LengthItemDelegate::displayText(const QVariant &value, const QLocale &locale) const {
 
   Q_UNUSED(locale)
@@ -306,11 +309,17 @@ QString LengthItemDelegate::displayText(const QVariant &value, const QLocale &lo
   bool ok = false;
   qint64 nanoseconds = value.toLongLong(&ok);
 
-  if (ok && nanoseconds > 0) return Utilities::PrettyTimeNanosec(nanoseconds);
-  return QString();
+  if (!ok || nanoseconds <= 0) return QString();
+
+  if (const QString *text = text_cache_.object(nanoseconds)) return *text;
+
+  const QString text = Utilities::PrettyTimeNanosec(nanoseconds);
+  text_cache_.insert(nanoseconds, new QString(text));
+  return text;
 
 }
 
+SizeItemDelegate::SizeItemDelegate(QObject *parent) : PlaylistDelegateBase(parent), text_cache_(kDisplayTextCacheSize) {}
 
 QString SizeItemDelegate::displayText(const QVariant &value, const QLocale &locale) const {
 
@@ -319,11 +328,21 @@ QString SizeItemDelegate::displayText(const QVariant &value, const QLocale &loca
   bool ok = false;
   qint64 bytes = value.toLongLong(&ok);
 
-  if (ok && bytes > 0) return Utilities::PrettySize(static_cast<quint64>(bytes));
-  return QString();
+  if (!ok || bytes <= 0) return QString();
+
+  if (const QString *text = text_cache_.object(bytes)) return *text;
+
+  const QString text = Utilities::PrettySize(static_cast<quint64>(bytes));
+  text_cache_.insert(bytes, new QString(text));
+  return text;
 
 }
 
+DateItemDelegate::DateItemDelegate(QObject *parent)
+    : PlaylistDelegateBase(parent),
+      date_time_format_(QLocale::system().dateTimeFormat(QLocale::ShortFormat)),
+      text_cache_(kDisplayTextCacheSize) {}
+
 QString DateItemDelegate::displayText(const QVariant &value, const QLocale &locale) const {
 
   Q_UNUSED(locale);
@@ -335,7 +354,11 @@ QString DateItemDelegate::displayText(const QVariant &value, const QLocale &loca
     return QString();
   }
 
-  return QDateTime::fromSecsSinceEpoch(time).toString(QLocale::system().dateTimeFormat(QLocale::ShortFormat));
+  if (const QString *text = text_cache_.object(time)) return *text;
+
+  const QString text = QDateTime::fromSecsSinceEpoch(time).toString(date_time_format_);
+  text_cache_.insert(time, new QString(text));
+  return text;
 
 }
 
@@ -31,6 +31,7 @@
 #include <QStyleOptionViewItem>
 #include <QTreeView>
 #include <QCompleter>
+#include <QCache>
 #include <QLocale>
 #include <QVariant>
 #include <QUrl>
@@ -95,24 +96,34 @@ class LengthItemDelegate : public PlaylistDelegateBase {
   Q_OBJECT
 
  public:
-  explicit LengthItemDelegate(QObject *parent) : PlaylistDelegateBase(parent) {}
+  explicit LengthItemDelegate(QObject *parent);
   QString displayText(const QVariant &value, const QLocale &locale) const override;
+
+ private:
+  mutable QCache<qint64, QString> text_cache_;
 };
 
 class SizeItemDelegate : public PlaylistDelegateBase {
   Q_OBJECT
 
  public:
-  explicit SizeItemDelegate(QObject *parent) : PlaylistDelegateBase(parent) {}
+  explicit SizeItemDelegate(QObject *parent);
   QString displayText(const QVariant &value, const QLocale &locale) const override;
+
+ private:
+  mutable QCache<qint64, QString> text_cache_;
 };
 
 class DateItemDelegate : public PlaylistDelegateBase {
   Q_OBJECT
 
  public:
-  explicit DateItemDelegate(QObject *parent) : PlaylistDelegateBase(parent) {}
+  explicit DateItemDelegate(QObject *parent);
   QString displayText(const QVariant &value, const QLocale &locale) const override;
+
+ private:
+  const QString date_time_format_;
+  mutable QCache<qint64, QString> text_cache_;
 };
 
 class LastPlayedItemDelegate : public PlaylistDelegateBase {
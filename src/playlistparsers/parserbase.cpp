@@ -83,20 +83,22 @@ void ParserBase::LoadSong(const QString &filename_or_url, const qint64 beginning
 
   const QUrl url = QUrl::fromLocalFile(filename);
 
-  // Search the collection
+  // Search the collection, the URL index answers without a query for most files that are not in it.
   if (collection_backend_ && collection_lookup) {
     Song collection_song;
-    if (track > 0) {
-      collection_song = collection_backend_->GetSongByUrlAndTrack(url, track);
-    }
-    if (!collection_song.is_valid()) {
-      collection_song = collection_backend_->GetSongByUrl(url, beginning);
+    if (collection_backend_->MayContainUrl(url)) {
+      if (track > 0) {
+        collection_song = collection_backend_->GetSongByUrlAndTrack(url, track);
+      }
+      if (!collection_song.is_valid()) {
+        collection_song = collection_backend_->GetSongByUrl(url, beginning);
+      }
     }
     // Try canonical path
     if (!collection_song.is_valid()) {
       const QString canonical_filepath = QFileInfo(filename).canonicalFilePath();
-      if (canonical_filepath != filename) {
-        const QUrl canonical_filepath_url = QUrl::fromLocalFile(canonical_filepath);
+      const QUrl canonical_filepath_url = QUrl::fromLocalFile(canonical_filepath);
+      if (!canonical_filepath.isEmpty() && canonical_filepath != filename && collection_backend_->MayContainUrl(canonical_filepath_url)) {
         if (track > 0) {
           collection_song = collection_backend_->GetSongByUrlAndTrack(canonical_filepath_url, track);
         }
@@ -22,6 +22,7 @@
 #include "config.h"
 
 #include <algorithm>
+#include <functional>
 #include <utility>
 
 #include <QObject>
@@ -29,6 +30,8 @@
 #include <QDataStream>
 #include <QBuffer>
 #include <QList>
+#include <QSet>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -46,7 +49,12 @@ namespace {
 constexpr char kRowsMimetype[] = "application/x-strawberry-queue-rows";
 }
 
-Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent), playlist_(playlist), total_length_ns_(0) {
+Queue::Queue(Playlist *playlist, QObject *parent)
+    : QAbstractProxyModel(parent),
+      source_row_positions_dirty_(false),
+      update_depth_(0),
+      playlist_(playlist),
+      total_length_ns_(0) {
 
   signal_item_count_changed_ = QObject::connect(this, &Queue::ItemCountChanged, this, &Queue::UpdateTotalLength);
   QObject::connect(this, &Queue::TotalLengthChanged, this, &Queue::UpdateSummaryText);
@@ -55,26 +63,37 @@ Queue::Queue(Playlist *playlist, QObject *parent) : QAbstractProxyModel(parent),
 
 }
 
-QModelIndex Queue::mapFromSource(const QModelIndex &source_index) const {
+void Queue::UpdateSourceRowPositions() const {
 
-  if (!source_index.isValid()) return QModelIndex();
+  if (!source_row_positions_dirty_) return;
 
-  const int source_row = source_index.row();
+  source_row_positions_.clear();
+  source_row_positions_.reserve(source_indexes_.count());
   for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) {
-      return index(i, source_index.column());
-    }
+    source_row_positions_.insert(source_indexes_[i].row(), i);
   }
-  return QModelIndex();
+  source_row_positions_dirty_ = false;
+
+}
+
+QModelIndex Queue::mapFromSource(const QModelIndex &source_index) const {
+
+  if (!source_index.isValid()) return QModelIndex();
+
+  UpdateSourceRowPositions();
+
+  const int position = source_row_positions_.value(source_index.row(), -1);
+  if (position == -1) return QModelIndex();
+
+  return index(position, source_index.column());
 
 }
 
 bool Queue::ContainsSourceRow(const int source_row) const {
 
-  for (int i = 0; i < source_indexes_.count(); ++i) {
-    if (source_indexes_[i].row() == source_row) return true;
-  }
-  return false;
+  UpdateSourceRowPositions();
+
+  return source_row_positions_.contains(source_row);
 
 }
 
@@ -92,6 +111,9 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
     QObject::disconnect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
     QObject::disconnect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::SourceRowsShifted);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::SourceRowsShifted);
+    QObject::disconnect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::SourceLayoutChanged);
   }
 
   QAbstractProxyModel::setSourceModel(source_model);
@@ -99,16 +121,35 @@ void Queue::setSourceModel(QAbstractItemModel *source_model) {
   QObject::connect(sourceModel(), &QAbstractItemModel::dataChanged, this, &Queue::SourceDataChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::rowsRemoved, this, &Queue::SourceLayoutChanged);
   QObject::connect(sourceModel(), &QAbstractItemModel::layoutChanged, this, &Queue::SourceLayoutChanged);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsInserted, this, &Queue::SourceRowsShifted);
+  QObject::connect(sourceModel(), &QAbstractItemModel::rowsMoved, this, &Queue::SourceRowsShifted);
+  QObject::connect(sourceModel(), &QAbstractItemModel::modelReset, this, &Queue::SourceLayoutChanged);
+
+  source_row_positions_dirty_ = true;
+
+}
+
+void Queue::SourceRowsShifted() {
+
+  // The persistent indexes already point to the new rows.
+  source_row_positions_dirty_ = true;
 
 }
 
 void Queue::SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right) {
 
+  // Emitted once for the queue rows of the changed source rows, the playlist changes a span of rows at a time.
+  int first_row = -1;
+  int last_row = -1;
   for (int row = top_left.row(); row <= bottom_right.row(); ++row) {
     QModelIndex proxy_index = mapFromSource(sourceModel()->index(row, 0));
     if (!proxy_index.isValid()) continue;
 
-    Q_EMIT dataChanged(proxy_index, proxy_index);
+    if (first_row == -1 || proxy_index.row() < first_row) first_row = proxy_index.row();
+    if (proxy_index.row() > last_row) last_row = proxy_index.row();
+  }
+  if (first_row != -1) {
+    Q_EMIT dataChanged(index(first_row, 0), index(last_row, 0));
   }
   Q_EMIT ItemCountChanged(ItemCount());
 
@@ -118,18 +159,13 @@ void Queue::SourceLayoutChanged() {
 
   QObject::disconnect(signal_item_count_changed_);
 
-  // Collect the invalid rows first, then remove them in descending order.
-  // This keeps the indexes valid across the begin/endRemoveRows signal emissions instead of mutating the list mid-iteration.
+  source_row_positions_dirty_ = true;
+
   QList<int> invalid_rows;
   for (int i = 0; i < source_indexes_.count(); ++i) {
     if (!source_indexes_[i].isValid()) invalid_rows << i;
   }
-  for (int j = static_cast<int>(invalid_rows.count()) - 1; j >= 0; --j) {
-    const int row = invalid_rows[j];
-    beginRemoveRows(QModelIndex(), row, row);
-    source_indexes_.removeAt(row);
-    endRemoveRows();
-  }
+  RemoveProxyRows(invalid_rows);
 
   signal_item_count_changed_ = QObject::connect(this, &Queue::ItemCountChanged, this, &Queue::UpdateTotalLength);
 
@@ -181,57 +217,130 @@ QVariant Queue::data(const QModelIndex &proxy_index, int role) const {
 
 }
 
+void Queue::BeginUpdate() {
+
+  ++update_depth_;
+
+}
+
+void Queue::EndUpdate() {
+
+  if (--update_depth_ == 0) {
+    Q_EMIT UpdateFinished();
+  }
+
+}
+
 void Queue::ToggleTracks(const QModelIndexList &source_indexes) {
 
+  BeginUpdate();
+
+  // Queued tracks are dequeued and the others are appended, each as one model operation.
+  QList<int> dequeue_rows;
+  QList<QPersistentModelIndex> enqueue_indexes;
+  QSet<int> seen_source_rows;
   for (const QModelIndex &source_index : source_indexes) {
-    QModelIndex proxy_index = mapFromSource(source_index);
+    if (!source_index.isValid() || seen_source_rows.contains(source_index.row())) continue;
+    seen_source_rows.insert(source_index.row());
+    const QModelIndex proxy_index = mapFromSource(source_index);
     if (proxy_index.isValid()) {
-      // Dequeue the track
-      const int row = proxy_index.row();
-      beginRemoveRows(QModelIndex(), row, row);
-      source_indexes_.removeAt(row);
-      endRemoveRows();
+      dequeue_rows << proxy_index.row();
     }
     else {
-      // Enqueue the track
-      const int row = static_cast<int>(source_indexes_.count());
-      beginInsertRows(QModelIndex(), row, row);
-      source_indexes_ << QPersistentModelIndex(source_index);
-      endInsertRows();
+      enqueue_indexes << QPersistentModelIndex(source_index);
     }
   }
 
+  RemoveProxyRows(dequeue_rows);
+
+  if (!enqueue_indexes.isEmpty()) {
+    const int row = static_cast<int>(source_indexes_.count());
+    beginInsertRows(QModelIndex(), row, row + static_cast<int>(enqueue_indexes.count()) - 1);
+    source_indexes_ << enqueue_indexes;
+    if (!source_row_positions_dirty_) {
+      for (int i = row; i < source_indexes_.count(); ++i) {
+        source_row_positions_.insert(source_indexes_[i].row(), i);
+      }
+    }
+    endInsertRows();
+  }
+
+  EndUpdate();
+
 }
 
 void Queue::InsertFirst(const QModelIndexList &source_indexes) {
 
   if (source_indexes.isEmpty()) return;
 
+  // Tracks already in the queue are removed to be reinserted at the beginning
+  QList<int> queued_rows;
+  QList<QPersistentModelIndex> insert_indexes;
+  QSet<int> seen_source_rows;
   for (const QModelIndex &source_index : source_indexes) {
-    QModelIndex proxy_index = mapFromSource(source_index);
+    if (!source_index.isValid() || seen_source_rows.contains(source_index.row())) continue;
+    seen_source_rows.insert(source_index.row());
+    const QModelIndex proxy_index = mapFromSource(source_index);
     if (proxy_index.isValid()) {
-      // Already in the queue, so remove it to be reinserted later
-      const int row = proxy_index.row();
-      beginRemoveRows(QModelIndex(), row, row);
-      source_indexes_.removeAt(row);
-      endRemoveRows();
+      queued_rows << proxy_index.row();
     }
+    insert_indexes << QPersistentModelIndex(source_index);
   }
 
-  const int rows = static_cast<int>(source_indexes.count());
+  if (insert_indexes.isEmpty()) return;
+
+  BeginUpdate();
+
+  RemoveProxyRows(queued_rows);
+
   // Enqueue the tracks at the beginning
-  beginInsertRows(QModelIndex(), 0, rows - 1);
-  int offset = 0;
-  for (const QModelIndex &source_index : source_indexes) {
-    source_indexes_.insert(offset, QPersistentModelIndex(source_index));
-    offset++;
-  }
+  beginInsertRows(QModelIndex(), 0, static_cast<int>(insert_indexes.count()) - 1);
+  source_indexes_ = insert_indexes + source_indexes_;
+  source_row_positions_dirty_ = true;
   endInsertRows();
 
+  EndUpdate();
+
+}
+
+void Queue::RemoveProxyRows(QList<int> proxy_rows) {
+
+  if (proxy_rows.isEmpty()) return;
+
+  // Remove contiguous runs from the bottom up, so each run is one model operation and doesn't shift the rows of the next.
+  std::sort(proxy_rows.begin(), proxy_rows.end(), std::greater<int>());
+  proxy_rows.erase(std::unique(proxy_rows.begin(), proxy_rows.end()), proxy_rows.end());
+
+  BeginUpdate();
+
+  int i = 0;
+  while (i < proxy_rows.count()) {
+    const int last = proxy_rows[i];
+    int first = last;
+    while (i + 1 < proxy_rows.count() && proxy_rows[i + 1] == first - 1) {
+      ++i;
+      --first;
+    }
+    ++i;
+    if (first < 0 || last >= source_indexes_.count()) continue;
+    beginRemoveRows(QModelIndex(), first, last);
+    source_indexes_.remove(first, last - first + 1);
+    source_row_positions_dirty_ = true;
+    endRemoveRows();
+  }
+
+  EndUpdate();
+
 }
 
 int Queue::PositionOf(const QModelIndex &source_index) const {
-  return mapFromSource(source_index).row();
+
+  if (!source_index.isValid()) return -1;
+
+  UpdateSourceRowPositions();
+
+  return source_row_positions_.value(source_index.row(), -1);
+
 }
 
 bool Queue::is_empty() const { return source_indexes_.isEmpty(); }
@@ -281,6 +390,8 @@ void Queue::Clear() {
 
   beginRemoveRows(QModelIndex(), 0, static_cast<int>(source_indexes_.count() - 1));
   source_indexes_.clear();
+  source_row_positions_.clear();
+  source_row_positions_dirty_ = false;
   endRemoveRows();
 
 }
@@ -304,6 +415,7 @@ void Queue::Move(const QList<int> &proxy_rows, int pos) {
   for (int i = start; i < start + moved_items.count(); ++i) {
     source_indexes_.insert(i, moved_items[i - start]);
   }
+  source_row_positions_dirty_ = true;
 
   // Update persistent indexes
   const QModelIndexList pindexes = persistentIndexList();
@@ -414,6 +526,7 @@ bool Queue::dropMimeData(const QMimeData *data, Qt::DropAction action, const int
       for (int i = 0; i < source_indexes.count(); ++i) {
         source_indexes_.insert(insert_point + i, source_indexes[i]);
       }
+      source_row_positions_dirty_ = true;
       endInsertRows();
     }
   }
@@ -450,6 +563,7 @@ int Queue::TakeNext() {
 
   beginRemoveRows(QModelIndex(), 0, 0);
   int ret = source_indexes_.takeFirst().row();
+  source_row_positions_dirty_ = true;
   endRemoveRows();
 
   return ret;
@@ -468,19 +582,6 @@ void Queue::Remove(QList<int> &proxy_rows) {
   // Order the rows
   std::stable_sort(proxy_rows.begin(), proxy_rows.end());
 
-  // Reflects immediately changes in the playlist
-  Q_EMIT layoutAboutToBeChanged();
-
-  int removed_rows = 0;
-  for (int row : proxy_rows) {
-    // After the first row, the row number needs to be updated
-    const int real_row = row - removed_rows;
-    beginRemoveRows(QModelIndex(), real_row, real_row);
-    source_indexes_.removeAt(real_row);
-    endRemoveRows();
-    removed_rows++;
-  }
-
-  Q_EMIT layoutChanged();
+  RemoveProxyRows(proxy_rows);
 
 }
@@ -28,6 +28,7 @@
 #include <QAbstractItemModel>
 #include <QAbstractProxyModel>
 #include <QList>
+#include <QHash>
 #include <QVariant>
 #include <QString>
 #include <QStringList>
@@ -48,6 +49,8 @@ class Queue : public QAbstractProxyModel {
   int PeekNext() const;
   int ItemCount() const;
   quint64 GetTotalLength() const;
+  // True while a bulk change made of several model operations is in progress, UpdateFinished() is emitted after it.
+  bool is_updating() const { return update_depth_ > 0; }
 
   // Modify the queue
   int TakeNext();
@@ -84,14 +87,26 @@ class Queue : public QAbstractProxyModel {
   void TotalLengthChanged(const quint64 length);
   void ItemCountChanged(const int count);
   void SummaryTextChanged(const QString &message);
+  void UpdateFinished();
 
  private Q_SLOTS:
   void SourceDataChanged(const QModelIndex &top_left, const QModelIndex &bottom_right);
   void SourceLayoutChanged();
+  void SourceRowsShifted();
   void UpdateTotalLength();
 
+ private:
+  void BeginUpdate();
+  void EndUpdate();
+  void RemoveProxyRows(QList<int> proxy_rows);
+  void UpdateSourceRowPositions() const;
+
  private:
   QList<QPersistentModelIndex> source_indexes_;
+  // Source row to queue position, rebuilt on demand after the queue or the rows of the source model changed.
+  mutable QHash<int, int> source_row_positions_;
+  mutable bool source_row_positions_dirty_;
+  int update_depth_;
   const Playlist *playlist_;
   quint64 total_length_ns_;
   QMetaObject::Connection signal_item_count_changed_;
@@ -40,6 +40,11 @@
 
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+// Station lists and country codes change slowly, keep search results for a day.
+constexpr qint64 kSearchCacheTtl = 24LL * 60LL * 60LL;
+}  // namespace
+
 const QStringList RadioBrowserService::kServers = {
     u"de1.api.radio-browser.info"_s,
     u"de2.api.radio-browser.info"_s
@@ -190,6 +195,7 @@ void RadioBrowserService::Search(const QString &query,
   url.setQuery(url_query);
 
   QNetworkRequest request(url);
+  request.setAttribute(NetworkAccessManager::kMetadataCacheTtlAttribute, kSearchCacheTtl);
   QNetworkReply *reply = network_->get(request);
   replies_ << reply;
   const int task_id = task_manager_->StartTask(tr("Searching Radio Browser"));
@@ -267,6 +273,7 @@ void RadioBrowserService::FetchCountries() {
   url.setPath(u"/json/countrycodes"_s);
 
   QNetworkRequest request(url);
+  request.setAttribute(NetworkAccessManager::kMetadataCacheTtlAttribute, kSearchCacheTtl);
   QNetworkReply *reply = network_->get(request);
   replies_ << reply;
   QObject::connect(reply, &QNetworkReply::finished, this, [this, reply]() { CountriesReply(reply); });
@@ -29,6 +29,7 @@
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
+#include "core/networkaccessmanager.h"
 #include "radioservice.h"
 
 RadioService::RadioService(const Song::Source source,
@@ -130,7 +131,15 @@ QJsonArray RadioService::ExtractJsonArray(const QByteArray &data) {
 
 QJsonArray RadioService::ExtractJsonArray(QNetworkReply *reply) {
 
-  return ExtractJsonArray(ExtractData(reply));
+  const QByteArray data = ExtractData(reply);
+  const QJsonArray json_array = ExtractJsonArray(data);
+
+  // Radio Browser answers errors with HTTP 200, keep only arrays in the metadata cache.
+  if (json_array.isEmpty() && !QJsonDocument::fromJson(data).isArray()) {
+    network_->RemoveFromMetadataCache(reply);
+  }
+
+  return json_array;
 
 }
 
@@ -188,6 +188,7 @@ void BackendSettingsPage::Load() {
   ui_->spinbox_low_watermark->setValue(s.value(kBufferLowWatermark, kDefaultBufferLowWatermark).toDouble());
   ui_->spinbox_high_watermark->setValue(s.value(kBufferHighWatermark, kDefaultBufferHighWatermark).toDouble());
   ui_->spinbox_device_warmup->setValue(s.value(kDeviceWarmupDuration, kDefaultDeviceWarmupDuration).toInt());
+  ui_->spinbox_preload->setValue(s.value(kPreloadDuration, kDefaultPreloadDuration).toInt());
 
   ui_->radiobutton_replaygain->setChecked(s.value(kRgEnabled, kDefaultRgEnabled).toBool());
   ui_->combobox_replaygainmode->setCurrentIndex(s.value(kRgMode, kDefaultRgMode).toInt());
@@ -454,6 +455,7 @@ void BackendSettingsPage::Save() {
   s.setValue(kBufferLowWatermark, ui_->spinbox_low_watermark->value());
   s.setValue(kBufferHighWatermark, ui_->spinbox_high_watermark->value());
   s.setValue(kDeviceWarmupDuration, ui_->spinbox_device_warmup->value());
+  s.setValue(kPreloadDuration, ui_->spinbox_preload->value());
 
   s.setValue(kRgEnabled, ui_->radiobutton_replaygain->isChecked());
   s.setValue(kRgMode, ui_->combobox_replaygainmode->currentIndex());
@@ -773,6 +775,7 @@ void BackendSettingsPage::BufferDefaults() {
   ui_->spinbox_low_watermark->setValue(kDefaultBufferLowWatermark);
   ui_->spinbox_high_watermark->setValue(kDefaultBufferHighWatermark);
   ui_->spinbox_device_warmup->setValue(kDefaultDeviceWarmupDuration);
+  ui_->spinbox_preload->setValue(kDefaultPreloadDuration);
 
 }
 
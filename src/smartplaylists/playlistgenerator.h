@@ -55,7 +55,7 @@ class PlaylistGenerator : public QObject, public enable_shared_from_this<Playlis
   static SharedPtr<PlaylistGenerator> Create(const Type type = Type::Query);
 
   // Should be called before Load on a new PlaylistGenerator
-  void set_collection_backend(SharedPtr<CollectionBackend> collection_backend) { collection_backend_ = collection_backend; }
+  virtual void set_collection_backend(SharedPtr<CollectionBackend> collection_backend) { collection_backend_ = collection_backend; }
   void set_name(const QString &name) { name_ = name; }
   SharedPtr<CollectionBackend> collection() const { return collection_backend_; }
   QString name() const { return name_; }
@@ -20,32 +20,68 @@
 
 #include "config.h"
 
+#include <cmath>
+#include <utility>
+
+#include <QtGlobal>
 #include <QIODevice>
 #include <QDataStream>
 #include <QByteArray>
 #include <QString>
 #include <QVariantList>
+#include <QList>
+#include <QPair>
+#include <QSet>
+#include <QHash>
+#include <QMutexLocker>
 
 #include "playlistquerygenerator.h"
 #include "collection/collectionbackend.h"
 
-PlaylistQueryGenerator::PlaylistQueryGenerator(QObject *parent) : PlaylistGenerator(parent), dynamic_(false), current_pos_(0) {}
+namespace {
+// Fetch the drawn songs in chunks, so the IN list stays well below the SQLite statement length limit.
+constexpr qint64 kSongsPerQuery = 500;
+}  // namespace
+
+PlaylistQueryGenerator::PlaylistQueryGenerator(QObject *parent) : PlaylistGenerator(parent), dynamic_(false), candidates_dirty_(true), current_pos_(0) {}
 
 PlaylistQueryGenerator::PlaylistQueryGenerator(const QString &name, const SmartPlaylistSearch &search, const bool dynamic, QObject *parent)
     : PlaylistGenerator(parent),
       search_(search),
       dynamic_(dynamic),
+      candidates_dirty_(true),
       current_pos_(0) {
 
   set_name(name);
 
 }
 
+void PlaylistQueryGenerator::set_collection_backend(SharedPtr<CollectionBackend> collection_backend) {
+
+  if (collection_backend_) {
+    QObject::disconnect(&*collection_backend_, nullptr, this, nullptr);
+  }
+
+  PlaylistGenerator::set_collection_backend(collection_backend);
+  InvalidateCandidates();
+
+  if (collection_backend_) {
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsAdded, this, &PlaylistQueryGenerator::InvalidateCandidates);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsDeleted, this, &PlaylistQueryGenerator::InvalidateCandidates);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsChanged, this, &PlaylistQueryGenerator::InvalidateCandidates);
+    QObject::connect(&*collection_backend_, &CollectionBackend::DatabaseReset, this, &PlaylistQueryGenerator::InvalidateCandidates);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsStatisticsChanged, this, &PlaylistQueryGenerator::StatisticsChanged);
+    QObject::connect(&*collection_backend_, &CollectionBackend::SongsRatingChanged, this, &PlaylistQueryGenerator::StatisticsChanged);
+  }
+
+}
+
 void PlaylistQueryGenerator::Load(const SmartPlaylistSearch &search) {
 
   search_ = search;
   dynamic_ = false;
   current_pos_ = 0;
+  InvalidateCandidates();
 
 }
 
@@ -54,6 +90,22 @@ void PlaylistQueryGenerator::Load(const QByteArray &data) {
   QDataStream s(data);
   s >> search_;
   s >> dynamic_;
+  InvalidateCandidates();
+
+}
+
+void PlaylistQueryGenerator::InvalidateCandidates() {
+
+  candidates_dirty_ = true;
+
+}
+
+void PlaylistQueryGenerator::StatisticsChanged() {
+
+  // Playing a song changes its statistics, only fetch the songs again when the search depends on them.
+  if (search_.uses_statistics()) {
+    InvalidateCandidates();
+  }
 
 }
 
@@ -78,16 +130,18 @@ PlaylistItemPtrList PlaylistQueryGenerator::Generate() {
 
 PlaylistItemPtrList PlaylistQueryGenerator::GenerateMore(const int count) {
 
+  if (search_.is_random()) {
+    return GenerateRandom(count);
+  }
+
   SmartPlaylistSearch search_copy = search_;
   search_copy.id_not_in_ = previous_ids_;
   if (count > 0) {
     search_copy.limit_ = count;
   }
 
-  if (search_copy.sort_type_ != SmartPlaylistSearch::SortType::Random) {
-    search_copy.first_item_ = current_pos_;
-    current_pos_ += search_copy.limit_;
-  }
+  search_copy.first_item_ = current_pos_;
+  current_pos_ += search_copy.limit_;
 
   QVariantList bound_values;
   const QString sql = search_copy.ToSql(collection_backend_->songs_table(), bound_values);
@@ -96,13 +150,84 @@ PlaylistItemPtrList PlaylistQueryGenerator::GenerateMore(const int count) {
   items.reserve(songs.count());
   for (const Song &song : songs) {
     items << PlaylistItem::NewFromSong(song);
-    previous_ids_ << song.id();
+  }
+  AddToPreviousIds(songs);
 
-    if (previous_ids_.count() > GetDynamicFuture() + GetDynamicHistory()) {
-      previous_ids_.removeFirst();
+  return items;
+
+}
+
+PlaylistItemPtrList PlaylistQueryGenerator::GenerateRandom(const int count) {
+
+  const int limit = count > 0 ? count : search_.limit_;
+
+  QList<int> ids;
+  {
+    QMutexLocker l(&sampler_mutex_);
+
+    if (candidates_dirty_.exchange(false)) {
+      QVariantList bound_values;
+      const QString sql = search_.ToIdSql(collection_backend_->songs_table(), bound_values);
+      const QList<QPair<int, double>> rows = collection_backend_->ExecuteIdQuery(sql, bound_values);
+      QList<int> candidate_ids;
+      QList<double> weights;
+      candidate_ids.reserve(rows.count());
+      for (const QPair<int, double> &row : rows) {
+        candidate_ids << row.first;
+        if (search_.sort_type_ == SmartPlaylistSearch::SortType::RandomByRating) {
+          // Unrated songs have a rating of -1, give them the same chance as songs rated zero.
+          weights << 1.0 + (4.0 * qMax(0.0, row.second));
+        }
+        else if (search_.sort_type_ == SmartPlaylistSearch::SortType::RandomByPlayCount) {
+          // Logarithmic, so a handful of songs played hundreds of times don't crowd out everything else.
+          weights << 1.0 + std::log2(1.0 + qMax(0.0, row.second));
+        }
+      }
+      sampler_.SetCandidates(candidate_ids, weights);
     }
+
+    const QSet<int> previous_ids(previous_ids_.constBegin(), previous_ids_.constEnd());
+    ids = sampler_.Draw(limit == -1 ? sampler_.count() : limit, previous_ids);
+  }
+
+  // Only now fetch the full songs, and only the ones that were drawn.
+  QHash<int, Song> songs_by_id;
+  songs_by_id.reserve(ids.count());
+  for (qint64 i = 0; i < ids.count(); i += kSongsPerQuery) {
+    const SongList chunk = collection_backend_->GetSongsById(ids.mid(i, kSongsPerQuery));
+    for (const Song &song : chunk) {
+      if (!song.unavailable()) {
+        songs_by_id.insert(song.id(), song);
+      }
+    }
+  }
+
+  SongList songs;
+  songs.reserve(songs_by_id.count());
+  for (const int id : std::as_const(ids)) {
+    if (songs_by_id.contains(id)) {
+      songs << songs_by_id.value(id);
+    }
+  }
+
+  PlaylistItemPtrList items;
+  items.reserve(songs.count());
+  for (const Song &song : std::as_const(songs)) {
+    items << PlaylistItem::NewFromSong(song);
   }
+  AddToPreviousIds(songs);
 
   return items;
 
 }
+
+void PlaylistQueryGenerator::AddToPreviousIds(const SongList &songs) {
+
+  for (const Song &song : songs) {
+    previous_ids_ << song.id();
+    if (previous_ids_.count() > GetDynamicFuture() + GetDynamicHistory()) {
+      previous_ids_.removeFirst();
+    }
+  }
+
+}
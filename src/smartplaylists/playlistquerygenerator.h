@@ -23,12 +23,17 @@
 
 #include "config.h"
 
+#include <atomic>
+
 #include <QList>
 #include <QByteArray>
 #include <QString>
+#include <QMutex>
 
+#include "includes/shared_ptr.h"
 #include "playlistgenerator.h"
 #include "smartplaylistsearch.h"
+#include "smartplaylistsampler.h"
 
 class PlaylistQueryGenerator : public PlaylistGenerator {
   Q_OBJECT
@@ -39,6 +44,8 @@ class PlaylistQueryGenerator : public PlaylistGenerator {
 
   Type type() const override { return Type::Query; }
 
+  void set_collection_backend(SharedPtr<CollectionBackend> collection_backend) override;
+
   void Load(const SmartPlaylistSearch &search);
   void Load(const QByteArray &data) override;
   QByteArray Save() const override;
@@ -51,10 +58,23 @@ class PlaylistQueryGenerator : public PlaylistGenerator {
   SmartPlaylistSearch search() const { return search_; }
   int GetDynamicFuture() override { return search_.limit_; }
 
+ private Q_SLOTS:
+  void InvalidateCandidates();
+  void StatisticsChanged();
+
+ private:
+  PlaylistItemPtrList GenerateRandom(const int count);
+  void AddToPreviousIds(const SongList &songs);
+
  private:
   SmartPlaylistSearch search_;
   bool dynamic_;
 
+  // IDs of all the songs matching a random search, fetched once and sampled for each refill until the collection changes.
+  QMutex sampler_mutex_;
+  SmartPlaylistSampler sampler_;
+  std::atomic<bool> candidates_dirty_;
+
   QList<int> previous_ids_;
   int current_pos_;
 };
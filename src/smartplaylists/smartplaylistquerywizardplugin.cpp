@@ -121,6 +121,7 @@ int SmartPlaylistQueryWizardPlugin::CreatePages(QWizard *wizard, int finish_page
   // Set the sort and limit radio buttons back to their defaults - they would
   // have been changed by setupUi
   sort_ui_->random->setChecked(true);
+  sort_ui_->random_weight->setCurrentIndex(0);
   sort_ui_->limit_none->setChecked(true);
 
   // Set up the preview widget that's already at the bottom of the sort page
@@ -139,6 +140,7 @@ int SmartPlaylistQueryWizardPlugin::CreatePages(QWizard *wizard, int finish_page
   QObject::connect(sort_ui_->limit_value, QOverload<int>::of(&QSpinBox::valueChanged), this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
   QObject::connect(sort_ui_->order, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
   QObject::connect(sort_ui_->random, &QRadioButton::toggled, this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
+  QObject::connect(sort_ui_->random_weight, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SmartPlaylistQueryWizardPlugin::UpdateSortPreview);
 
   // Configure the page text
   search_page_->setTitle(tr("Search terms"));
@@ -172,8 +174,19 @@ void SmartPlaylistQueryWizardPlugin::SetGenerator(PlaylistGeneratorPtr g) {
   }
 
   // Sort order
-  if (search.sort_type_ == SmartPlaylistSearch::SortType::Random) {
+  if (search.is_random()) {
     sort_ui_->random->setChecked(true);
+    switch (search.sort_type_) {
+      case SmartPlaylistSearch::SortType::RandomByRating:
+        sort_ui_->random_weight->setCurrentIndex(1);
+        break;
+      case SmartPlaylistSearch::SortType::RandomByPlayCount:
+        sort_ui_->random_weight->setCurrentIndex(2);
+        break;
+      default:
+        sort_ui_->random_weight->setCurrentIndex(0);
+        break;
+    }
   }
   else {
     sort_ui_->field->setChecked(true);
@@ -280,7 +293,17 @@ SmartPlaylistSearch SmartPlaylistQueryWizardPlugin::MakeSearch() const {
 
   // Sort order
   if (sort_ui_->random->isChecked()) {
-    ret.sort_type_ = SmartPlaylistSearch::SortType::Random;
+    switch (sort_ui_->random_weight->currentIndex()) {
+      case 1:
+        ret.sort_type_ = SmartPlaylistSearch::SortType::RandomByRating;
+        break;
+      case 2:
+        ret.sort_type_ = SmartPlaylistSearch::SortType::RandomByPlayCount;
+        break;
+      default:
+        ret.sort_type_ = SmartPlaylistSearch::SortType::Random;
+        break;
+    }
   }
   else {
     const bool ascending = sort_ui_->order->currentIndex() == 0;
@@ -0,0 +1,117 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <queue>
+#include <functional>
+
+#include <QList>
+#include <QSet>
+
+#include "smartplaylistsampler.h"
+
+SmartPlaylistSampler::SmartPlaylistSampler(const quint32 seed) : random_(seed), position_(0) {}
+
+void SmartPlaylistSampler::SetCandidates(const QList<int> &ids, const QList<double> &weights) {
+
+  Q_ASSERT(weights.isEmpty() || weights.count() == ids.count());
+
+  ids_ = ids;
+  weights_ = weights.count() == ids.count() ? weights : QList<double>();
+  position_ = 0;
+
+}
+
+void SmartPlaylistSampler::Clear() {
+
+  ids_.clear();
+  weights_.clear();
+  position_ = 0;
+
+}
+
+QList<int> SmartPlaylistSampler::Draw(const qint64 count, const QSet<int> &exclude) {
+
+  if (count <= 0 || ids_.isEmpty()) return QList<int>();
+
+  return is_weighted() ? DrawWeighted(count, exclude) : DrawShuffled(count, exclude);
+
+}
+
+QList<int> SmartPlaylistSampler::DrawShuffled(const qint64 count, const QSet<int> &exclude) {
+
+  const qint64 total = ids_.count();
+
+  QList<int> ids;
+  QSet<int> drawn;
+  // Look at every ID at most once, so this ends even when most of the IDs are excluded.
+  for (qint64 i = 0; i < total && ids.count() < count; ++i) {
+    if (position_ >= total) {
+      position_ = 0;
+    }
+    // One step of a Fisher-Yates shuffle, pick one of the IDs not drawn yet in this shuffle.
+    const qint64 j = position_ + random_.bounded(total - position_);
+    ids_.swapItemsAt(position_, j);
+    const int id = ids_[position_++];
+    if (exclude.contains(id) || drawn.contains(id)) continue;
+    drawn.insert(id);
+    ids << id;
+  }
+
+  return ids;
+
+}
+
+QList<int> SmartPlaylistSampler::DrawWeighted(const qint64 count, const QSet<int> &exclude) {
+
+  // Each ID gets the key log(u) / weight for a uniform random u, and the IDs with the largest keys are the sample.
+  // Only the best count keys are kept, so this is a single pass over the IDs without sorting them.
+  using Key = std::pair<double, int>;
+  std::priority_queue<Key, std::vector<Key>, std::greater<Key>> reservoir;
+
+  for (qint64 i = 0; i < ids_.count(); ++i) {
+    const int id = ids_[i];
+    const double weight = weights_[i];
+    if (weight <= 0.0 || exclude.contains(id)) continue;
+    const double u = random_.generateDouble();
+    const double key = u > 0.0 ? std::log(u) / weight : -std::numeric_limits<double>::infinity();
+    if (static_cast<qint64>(reservoir.size()) < count) {
+      reservoir.emplace(key, id);
+    }
+    else if (key > reservoir.top().first) {
+      reservoir.pop();
+      reservoir.emplace(key, id);
+    }
+  }
+
+  // The reservoir pops the smallest key first, the sample is returned with the largest key first.
+  QList<int> ids(static_cast<qint64>(reservoir.size()));
+  for (qint64 i = ids.count() - 1; i >= 0; --i) {
+    ids[i] = reservoir.top().second;
+    reservoir.pop();
+  }
+
+  return ids;
+
+}
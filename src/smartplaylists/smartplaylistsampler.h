@@ -0,0 +1,60 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SMARTPLAYLISTSAMPLER_H
+#define SMARTPLAYLISTSAMPLER_H
+
+#include "config.h"
+
+#include <QtGlobal>
+#include <QList>
+#include <QSet>
+#include <QRandomGenerator>
+
+// Draws random songs from the IDs of all songs matching a smart playlist search, so the database doesn't have to sort the whole result with ORDER BY random() every time.
+// Without weights the IDs are drawn in a seeded shuffle, so every song is drawn once before any song is drawn again.
+// With weights each draw is a weighted random sample (Efraimidis-Spirakis reservoir sampling), where a song with twice the weight is twice as likely to be picked.
+class SmartPlaylistSampler {
+ public:
+  explicit SmartPlaylistSampler(const quint32 seed = QRandomGenerator::global()->generate());
+
+  // Weights, if given, must have the same count as ids.
+  void SetCandidates(const QList<int> &ids, const QList<double> &weights = QList<double>());
+  void Clear();
+
+  bool is_empty() const { return ids_.isEmpty(); }
+  qint64 count() const { return ids_.count(); }
+  bool is_weighted() const { return !weights_.isEmpty(); }
+
+  // Returns up to count different IDs, leaving out the IDs in exclude.
+  QList<int> Draw(const qint64 count, const QSet<int> &exclude = QSet<int>());
+
+ private:
+  QList<int> DrawShuffled(const qint64 count, const QSet<int> &exclude);
+  QList<int> DrawWeighted(const qint64 count, const QSet<int> &exclude);
+
+ private:
+  QRandomGenerator random_;
+  QList<int> ids_;
+  QList<double> weights_;
+  // The IDs before this position are already drawn in the current shuffle.
+  qint64 position_;
+};
+
+#endif  // SMARTPLAYLISTSAMPLER_H
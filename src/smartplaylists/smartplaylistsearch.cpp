@@ -20,6 +20,8 @@
 
 #include "config.h"
 
+#include <algorithm>
+
 #include <QString>
 #include <QStringList>
 #include <QDataStream>
@@ -51,13 +53,11 @@ void SmartPlaylistSearch::Reset() {
 
 }
 
-QString SmartPlaylistSearch::ToSql(const QString &songs_table, QVariantList &bound_values) const {
+QStringList SmartPlaylistSearch::WhereClauses(QVariantList &bound_values) const {
 
-  QString sql = QStringLiteral("SELECT %1 FROM %2").arg(Song::kRowIdColumnSpec, songs_table);
-
-  // Add search terms
   QStringList where_clauses;
 
+  // Add search terms
   if (!terms_.isEmpty() && search_type_ != SearchType::All) {
     QStringList term_where_clauses;
     term_where_clauses.reserve(terms_.count());
@@ -68,6 +68,20 @@ QString SmartPlaylistSearch::ToSql(const QString &songs_table, QVariantList &bou
     where_clauses << u"("_s + term_where_clauses.join(boolean_op) + u")"_s;
   }
 
+  // We never want to include songs that have been deleted,
+  // but are still kept in the database in case the directory containing them has just been unmounted.
+  where_clauses << u"unavailable = 0"_s;
+
+  return where_clauses;
+
+}
+
+QString SmartPlaylistSearch::ToSql(const QString &songs_table, QVariantList &bound_values) const {
+
+  QString sql = QStringLiteral("SELECT %1 FROM %2").arg(Song::kRowIdColumnSpec, songs_table);
+
+  QStringList where_clauses = WhereClauses(bound_values);
+
   // Restrict the IDs of songs if we're making a dynamic playlist
   if (!id_not_in_.isEmpty()) {
     QString numbers;
@@ -77,16 +91,12 @@ QString SmartPlaylistSearch::ToSql(const QString &songs_table, QVariantList &bou
     where_clauses << u"(ROWID NOT IN ("_s + numbers + u"))"_s;
   }
 
-  // We never want to include songs that have been deleted,
-  // but are still kept in the database in case the directory containing them has just been unmounted.
-  where_clauses << u"unavailable = 0"_s;
-
   if (!where_clauses.isEmpty()) {
     sql += " WHERE "_L1 + where_clauses.join(" AND "_L1);
   }
 
   // Add sort by
-  if (sort_type_ == SortType::Random) {
+  if (is_random()) {
     sql += " ORDER BY random()"_L1;
   }
   else {
@@ -106,6 +116,20 @@ QString SmartPlaylistSearch::ToSql(const QString &songs_table, QVariantList &bou
 
 }
 
+QString SmartPlaylistSearch::ToIdSql(const QString &songs_table, QVariantList &bound_values) const {
+
+  QString columns = u"ROWID"_s;
+  if (sort_type_ == SortType::RandomByRating) {
+    columns += u", rating"_s;
+  }
+  else if (sort_type_ == SortType::RandomByPlayCount) {
+    columns += u", playcount"_s;
+  }
+
+  return QStringLiteral("SELECT %1 FROM %2 WHERE %3").arg(columns, songs_table, WhereClauses(bound_values).join(" AND "_L1));
+
+}
+
 bool SmartPlaylistSearch::is_valid() const {
 
   if (search_type_ == SearchType::All) return true;
@@ -113,6 +137,27 @@ bool SmartPlaylistSearch::is_valid() const {
 
 }
 
+bool SmartPlaylistSearch::is_random() const {
+
+  return sort_type_ == SortType::Random || sort_type_ == SortType::RandomByRating || sort_type_ == SortType::RandomByPlayCount;
+
+}
+
+bool SmartPlaylistSearch::uses_statistics() const {
+
+  if (sort_type_ == SortType::RandomByRating || sort_type_ == SortType::RandomByPlayCount) return true;
+
+  if (search_type_ == SearchType::All) return false;
+
+  return std::any_of(terms_.begin(), terms_.end(), [](const SmartPlaylistSearchTerm &term) {
+    return term.field_ == SmartPlaylistSearchTerm::Field::PlayCount ||
+           term.field_ == SmartPlaylistSearchTerm::Field::SkipCount ||
+           term.field_ == SmartPlaylistSearchTerm::Field::LastPlayed ||
+           term.field_ == SmartPlaylistSearchTerm::Field::Rating;
+  });
+
+}
+
 bool SmartPlaylistSearch::operator==(const SmartPlaylistSearch &other) const {
 
   return search_type_ == other.search_type_ &&
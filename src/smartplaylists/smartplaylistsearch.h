@@ -25,6 +25,7 @@
 
 #include <QList>
 #include <QString>
+#include <QStringList>
 #include <QVariantList>
 #include <QDataStream>
 
@@ -47,13 +48,18 @@ class SmartPlaylistSearch {
   enum class SortType {
     Random = 0,
     FieldAsc,
-    FieldDesc
+    FieldDesc,
+    RandomByRating,
+    RandomByPlayCount
   };
 
   explicit SmartPlaylistSearch();
   explicit SmartPlaylistSearch(const SearchType type, const TermList &terms, const SortType sort_type, const SmartPlaylistSearchTerm::Field sort_field, const int limit = PlaylistGenerator::kDefaultLimit);
 
   bool is_valid() const;
+  bool is_random() const;
+  // Whether the songs matching the search or their order depend on play statistics or rating.
+  bool uses_statistics() const;
   bool operator==(const SmartPlaylistSearch &other) const;
   bool operator!=(const SmartPlaylistSearch &other) const { return !(*this == other); }
 
@@ -69,6 +75,11 @@ class SmartPlaylistSearch {
 
   void Reset();
   QString ToSql(const QString &songs_table, QVariantList &bound_values) const;
+  // Selects the ROWID of every matching song without sorting, and for weighted random sorting the column to weight by.
+  QString ToIdSql(const QString &songs_table, QVariantList &bound_values) const;
+
+ private:
+  QStringList WhereClauses(QVariantList &bound_values) const;
 };
 
 QDataStream &operator<<(QDataStream &s, const SmartPlaylistSearch &search);
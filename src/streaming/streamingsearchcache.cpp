@@ -0,0 +1,106 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include <QString>
+#include <QElapsedTimer>
+
+#include "core/song.h"
+#include "streamingservice.h"
+#include "streamingsearchcache.h"
+
+namespace {
+// Shorter prefixes match too much of the catalog to be useful.
+constexpr int kMinPrefixLength = 2;
+}  // namespace
+
+StreamingSearchCache::StreamingSearchCache(const int max_queries, const qint64 max_age_msec)
+    : max_age_msec_(max_age_msec),
+      results_(max_queries) {}
+
+void StreamingSearchCache::Clear() {
+
+  results_.clear();
+
+}
+
+QString StreamingSearchCache::NormalizedQuery(const QString &query) {
+
+  return query.simplified().toLower();
+
+}
+
+QString StreamingSearchCache::Key(const StreamingService::SearchType type, const QString &normalized_query) {
+
+  return QString::number(static_cast<int>(type)) + QLatin1Char(':') + normalized_query;
+
+}
+
+void StreamingSearchCache::Insert(const StreamingService::SearchType type, const QString &query, const SongMap &songs) {
+
+  const QString normalized_query = NormalizedQuery(query);
+  if (normalized_query.isEmpty()) return;
+
+  Entry *entry = new Entry;
+  entry->songs = songs;
+  entry->age.start();
+  results_.insert(Key(type, normalized_query), entry);
+
+}
+
+bool StreamingSearchCache::FindNormalized(const StreamingService::SearchType type, const QString &normalized_query, SongMap *songs) {
+
+  const QString key = Key(type, normalized_query);
+  const Entry *entry = results_.object(key);
+  if (!entry) return false;
+
+  if (entry->age.hasExpired(max_age_msec_)) {
+    results_.remove(key);
+    return false;
+  }
+
+  *songs = entry->songs;
+
+  return true;
+
+}
+
+bool StreamingSearchCache::Find(const StreamingService::SearchType type, const QString &query, SongMap *songs) {
+
+  return FindNormalized(type, NormalizedQuery(query), songs);
+
+}
+
+bool StreamingSearchCache::FindPrefix(const StreamingService::SearchType type, const QString &query, QString *prefix_query, SongMap *songs) {
+
+  const QString normalized_query = NormalizedQuery(query);
+
+  for (qsizetype length = normalized_query.length() - 1; length >= kMinPrefixLength; --length) {
+    const QString prefix = normalized_query.left(length).trimmed();
+    if (prefix.length() < length) continue;
+    if (FindNormalized(type, prefix, songs)) {
+      *prefix_query = prefix;
+      return true;
+    }
+  }
+
+  return false;
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Jonas Kvinge <jonas@jkvinge.net>
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef STREAMINGSEARCHCACHE_H
+#define STREAMINGSEARCHCACHE_H
+
+#include "config.h"
+
+#include <QString>
+#include <QCache>
+#include <QElapsedTimer>
+
+#include "core/song.h"
+#include "streamingservice.h"
+
+// The results of recent searches on a streaming service, by search type and query.
+// The least recently used queries are dropped first, and results expire after a while so catalog changes are picked up.
+class StreamingSearchCache {
+ public:
+  explicit StreamingSearchCache(const int max_queries = kMaxQueries, const qint64 max_age_msec = kMaxAgeMsec);
+
+  static constexpr int kMaxQueries = 50;
+  static constexpr qint64 kMaxAgeMsec = 10LL * 60LL * 1000LL;
+
+  int count() const { return static_cast<int>(results_.count()); }
+
+  void Clear();
+  void Insert(const StreamingService::SearchType type, const QString &query, const SongMap &songs);
+
+  // Results of the same query.
+  bool Find(const StreamingService::SearchType type, const QString &query, SongMap *songs);
+  // Results of the longest query that the query starts with, while typing these are a superset of most results for the query.
+  bool FindPrefix(const StreamingService::SearchType type, const QString &query, QString *prefix_query, SongMap *songs);
+
+  static QString NormalizedQuery(const QString &query);
+
+ private:
+  struct Entry {
+    SongMap songs;
+    QElapsedTimer age;
+  };
+
+  static QString Key(const StreamingService::SearchType type, const QString &normalized_query);
+  bool FindNormalized(const StreamingService::SearchType type, const QString &normalized_query, SongMap *songs);
+
+ private:
+  const qint64 max_age_msec_;
+  QCache<QString, Entry> results_;
+};
+
+#endif  // STREAMINGSEARCHCACHE_H
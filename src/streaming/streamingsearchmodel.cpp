@@ -60,6 +60,11 @@ StreamingSearchModel::StreamingSearchModel(StreamingServicePtr service, QObject
 void StreamingSearchModel::AddResults(const StreamingSearchView::ResultList &results) {
 
   for (const StreamingSearchView::Result &result : results) {
+    // Results of a previous page or a preview from a cached query are only added once.
+    const QString result_key = ResultKey(result.metadata_);
+    if (result_keys_.contains(result_key)) continue;
+    result_keys_.insert(result_key);
+
     QStandardItem *parent = invisibleRootItem();
 
     // Find (or create) the container nodes for this result if we can.
@@ -292,9 +297,16 @@ QStandardItem *StreamingSearchModel::BuildContainers(const Song &s, QStandardIte
 
 }
 
+QString StreamingSearchModel::ResultKey(const Song &song) {
+
+  return song.artist_id() + QLatin1Char('/') + song.album_id() + QLatin1Char('/') + song.song_id() + QLatin1Char('/') + song.url().toString();
+
+}
+
 void StreamingSearchModel::Clear() {
 
   containers_.clear();
+  result_keys_.clear();
   clear();
 
 }
@@ -69,6 +69,9 @@ class StreamingSearchModel : public QStandardItemModel {
 
   void Clear();
 
+  int result_count() const { return static_cast<int>(result_keys_.count()); }
+  bool HasResult(const Song &song) const { return result_keys_.contains(ResultKey(song)); }
+
   StreamingSearchView::ResultList GetChildResults(const QModelIndexList &indexes) const;
   StreamingSearchView::ResultList GetChildResults(const QList<QStandardItem*> &items) const;
 
@@ -84,6 +87,7 @@ class StreamingSearchModel : public QStandardItemModel {
  private:
   QStandardItem *BuildContainers(const Song &s, QStandardItem *parent, ContainerKey *key, const int level = 0);
   void GetChildResults(const QStandardItem *item, StreamingSearchView::ResultList *results, QSet<const QStandardItem*> *visited) const;
+  static QString ResultKey(const Song &song);
 
  private:
   SharedPtr<StreamingService> service_;
@@ -94,6 +98,7 @@ class StreamingSearchModel : public QStandardItemModel {
   QPixmap no_cover_icon_;
   CollectionModel::Grouping group_by_;
   QMap<ContainerKey, QStandardItem*> containers_;
+  QSet<QString> result_keys_;
 };
 
 inline size_t qHash(const StreamingSearchModel::ContainerKey &key) {
@@ -21,6 +21,7 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -64,6 +65,7 @@
 #include <QShowEvent>
 #include <QHideEvent>
 
+#include "core/logging.h"
 #include "core/song.h"
 #include "core/iconloader.h"
 #include "core/settings.h"
@@ -76,6 +78,7 @@
 #include "covermanager/albumcoverloaderresult.h"
 #include "streamsongmimedata.h"
 #include "streamingservice.h"
+#include "streamingsearchcache.h"
 #include "streamingsearchitemdelegate.h"
 #include "streamingsearchmodel.h"
 #include "streamingsearchsortmodel.h"
@@ -95,6 +98,7 @@ constexpr char kSearchGroupBy2[] = "search_group_by2";
 constexpr char kSearchGroupBy3[] = "search_group_by3";
 constexpr int kSwapModelsTimeoutMsec = 250;
 constexpr int kDelayedSearchTimeoutMs = 200;
+constexpr int kResultsPageSize = 100;
 constexpr int kArtHeight = 32;
 }  // namespace
 
@@ -111,9 +115,11 @@ StreamingSearchView::StreamingSearchView(QWidget *parent)
       back_proxy_(nullptr),
       current_proxy_(front_proxy_),
       swap_models_timer_(new QTimer(this)),
+      add_results_timer_(new QTimer(this)),
       use_pretty_covers_(true),
       search_type_(StreamingService::SearchType::Artists),
       search_error_(false),
+      showing_prefix_results_(false),
       last_search_id_(0),
       searches_next_id_(1) {
 
@@ -191,6 +197,10 @@ void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPt
   swap_models_timer_->setInterval(kSwapModelsTimeoutMsec);
   QObject::connect(swap_models_timer_, &QTimer::timeout, this, &StreamingSearchView::SwapModels);
 
+  add_results_timer_->setSingleShot(true);
+  add_results_timer_->setInterval(0);
+  QObject::connect(add_results_timer_, &QTimer::timeout, this, &StreamingSearchView::AddQueuedResults);
+
   QObject::connect(ui_->radiobutton_search_artists, &QRadioButton::clicked, this, &StreamingSearchView::SearchArtistsClicked);
   QObject::connect(ui_->radiobutton_search_albums, &QRadioButton::clicked, this, &StreamingSearchView::SearchAlbumsClicked);
   QObject::connect(ui_->radiobutton_search_songs, &QRadioButton::clicked, this, &StreamingSearchView::SearchSongsClicked);
@@ -215,6 +225,9 @@ void StreamingSearchView::Init(const StreamingServicePtr service, const SharedPt
 
 void StreamingSearchView::ReloadSettings() {
 
+  // The settings can change the search results, like the number of results.
+  search_cache_.Clear();
+
   Settings s;
 
   // Collection settings
@@ -394,30 +407,53 @@ void StreamingSearchView::TextEdited(const QString &text) {
   const QString trimmed(text.trimmed());
 
   search_error_ = false;
+  showing_prefix_results_ = false;
   cover_loader_tasks_.clear();
 
   // Add results to the back model, switch models after some delay.
+  ClearQueuedResults();
   back_model_->Clear();
   current_model_ = back_model_;
   current_proxy_ = back_proxy_;
   swap_models_timer_->start();
 
-  // Cancel the last search (if any) and start the new one.
-  CancelSearch(last_search_id_);
-
   // If text query is empty, don't start a new search
   if (trimmed.isEmpty()) {
+    CancelSearch(last_search_id_);
     last_search_id_ = -1;
     ui_->label_helptext->setText(tr("Enter search terms above to find music"));
     ui_->label_status->clear();
     ui_->progressbar->hide();
     ui_->progressbar->reset();
+    return;
+  }
+
+  ui_->progressbar->reset();
+
+  // Show the results of a recent search for the same query right away.
+  SongMap songs;
+  if (search_cache_.Find(search_type_, trimmed, &songs)) {
+    qLog(Debug) << "Using cached" << Song::TextForSource(service_->source()) << "search results for" << trimmed;
+    CancelSearch(last_search_id_);
+    last_search_id_ = searches_next_id_++;
+    AddResults(last_search_id_, ResultsFromSongs(songs));
+    return;
+  }
+
+  // Keep waiting for a search for the same query instead of cancelling it and starting it again.
+  const int search_id = searches_next_id_++;
+  if (ReuseSearch(last_search_id_, search_id, trimmed, search_type_)) {
+    last_search_id_ = search_id;
   }
   else {
-    ui_->progressbar->reset();
+    // Cancel the last search (if any) and start the new one.
+    CancelSearch(last_search_id_);
     last_search_id_ = SearchAsync(trimmed, search_type_);
   }
 
+  // While typing, show the results of a shorter query that also match this query until the service replies.
+  ShowPrefixResults(trimmed);
+
 }
 
 void StreamingSearchView::SwapModels() {
@@ -486,7 +522,7 @@ int StreamingSearchView::SearchAsync(const QString &query, const StreamingServic
 void StreamingSearchView::SearchAsync(const int id, const QString &query, const StreamingService::SearchType type) {
 
   const int service_id = service_->Search(query, type);
-  pending_searches_[service_id] = PendingState(id, TokenizeQuery(query));
+  pending_searches_[service_id] = PendingState(id, query, type, TokenizeQuery(query));
 
 }
 
@@ -503,20 +539,26 @@ void StreamingSearchView::SearchDone(const int service_id, const SongMap &songs,
     return;
   }
 
-  ResultList results;
-  results.reserve(songs.count());
-  for (const Song &song : songs) {
-    Result result;
-    result.metadata_ = song;
-    results << result;
-  }
-
-  // Load cached pixmaps into the results
-  for (StreamingSearchView::ResultList::iterator it = results.begin(); it != results.end(); ++it) {
-    it->pixmap_cache_key_ = PixmapCacheKey(*it);
+  search_cache_.Insert(state.type_, state.query_, songs);
+
+  // The results of the shorter query might include songs the service didn't return for this query.
+  // Build the service's results in the back model and swap, so the view shows the same results as the cache does later.
+  if (search_id == last_search_id_ && showing_prefix_results_) {
+    showing_prefix_results_ = false;
+    ClearQueuedResults();
+    back_model_->Clear();
+    const bool swap_models = current_model_ != back_model_;
+    current_model_ = back_model_;
+    current_proxy_ = back_proxy_;
+    AddResults(search_id, ResultsFromSongs(songs));
+    if (swap_models) {
+      swap_models_timer_->stop();
+      SwapModels();
+    }
+    return;
   }
 
-  AddResults(search_id, results);
+  AddResults(search_id, ResultsFromSongs(songs));
 
 }
 
@@ -533,6 +575,68 @@ void StreamingSearchView::CancelSearch(const int id) {
 
 }
 
+bool StreamingSearchView::ReuseSearch(const int id, const int new_id, const QString &query, const StreamingService::SearchType type) {
+
+  for (QMap<int, DelayedSearch>::iterator it = delayed_searches_.begin(); it != delayed_searches_.end(); ++it) {
+    if (it.value().id_ == id) {
+      if (it.value().query_ != query || it.value().type_ != type) return false;
+      it.value().id_ = new_id;
+      return true;
+    }
+  }
+
+  for (QMap<int, PendingState>::iterator it = pending_searches_.begin(); it != pending_searches_.end(); ++it) {
+    if (it.value().orig_id_ == id) {
+      if (it.value().query_ != query || it.value().type_ != type) return false;
+      it.value().orig_id_ = new_id;
+      return true;
+    }
+  }
+
+  return false;
+
+}
+
+StreamingSearchView::ResultList StreamingSearchView::ResultsFromSongs(const SongMap &songs) const {
+
+  ResultList results;
+  results.reserve(songs.count());
+  for (const Song &song : songs) {
+    Result result;
+    result.metadata_ = song;
+    // Load cached pixmaps into the results
+    result.pixmap_cache_key_ = PixmapCacheKey(result);
+    results << result;
+  }
+
+  return results;
+
+}
+
+void StreamingSearchView::ShowPrefixResults(const QString &query) {
+
+  QString prefix_query;
+  SongMap prefix_songs;
+  if (!search_cache_.FindPrefix(search_type_, query, &prefix_query, &prefix_songs)) return;
+
+  const QStringList tokens = TokenizeQuery(query);
+  SongMap songs;
+  for (SongMap::const_iterator it = prefix_songs.constBegin(); it != prefix_songs.constEnd(); ++it) {
+    const Song &song = it.value();
+    if (Matches(tokens, song.effective_albumartist() + QLatin1Char(' ') + song.artist() + QLatin1Char(' ') + song.album() + QLatin1Char(' ') + song.title())) {
+      songs.insert(it.key(), song);
+    }
+  }
+
+  if (songs.isEmpty()) return;
+
+  qLog(Debug) << "Showing" << songs.count() << "of" << prefix_songs.count() << "cached" << Song::TextForSource(service_->source()) << "search results for" << prefix_query << "while searching for" << query;
+
+  showing_prefix_results_ = true;
+  QueueResults(ResultsFromSongs(songs));
+
+}
+
 void StreamingSearchView::AddResults(const int id, const StreamingSearchView::ResultList &results) {
 
   if (id != last_search_id_ || results.isEmpty()) return;
@@ -540,7 +644,45 @@ void StreamingSearchView::AddResults(const int id, const StreamingSearchView::Re
   ui_->label_status->clear();
   ui_->progressbar->reset();
   ui_->progressbar->hide();
-  current_model_->AddResults(results);
+  QueueResults(results);
+
+}
+
+void StreamingSearchView::QueueResults(const ResultList &results) {
+
+  // Results already in the model are skipped, so only the new results are inserted.
+  queued_results_.reserve(queued_results_.count() + results.count());
+  for (const Result &result : results) {
+    if (!current_model_->HasResult(result.metadata_)) {
+      queued_results_ << result;
+    }
+  }
+
+  if (queued_results_.isEmpty()) return;
+
+  // Add the first page right away, the rest after the view had a chance to update.
+  AddQueuedResults();
+
+}
+
+void StreamingSearchView::ClearQueuedResults() {
+
+  add_results_timer_->stop();
+  queued_results_.clear();
+
+}
+
+void StreamingSearchView::AddQueuedResults() {
+
+  if (queued_results_.isEmpty()) return;
+
+  const qsizetype count = std::min(static_cast<qsizetype>(kResultsPageSize), queued_results_.count());
+  current_model_->AddResults(queued_results_.mid(0, count));
+  queued_results_.remove(0, count);
+
+  if (!queued_results_.isEmpty()) {
+    add_results_timer_->start();
+  }
 
 }
 
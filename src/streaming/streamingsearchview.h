@@ -41,6 +41,7 @@
 #include "collection/collectionmodel.h"
 #include "covermanager/albumcoverloaderresult.h"
 #include "streamingservice.h"
+#include "streamingsearchcache.h"
 
 class QSortFilterProxyModel;
 class QMimeData;
@@ -82,9 +83,11 @@ class StreamingSearchView : public QWidget {
 
  protected:
   struct PendingState {
-    PendingState() : orig_id_(-1) {}
-    PendingState(int orig_id, const QStringList &tokens) : orig_id_(orig_id), tokens_(tokens) {}
+    PendingState() : orig_id_(-1), type_(StreamingService::SearchType::Artists) {}
+    PendingState(int orig_id, const QString &query, const StreamingService::SearchType type, const QStringList &tokens) : orig_id_(orig_id), query_(query), type_(type), tokens_(tokens) {}
     int orig_id_;
+    QString query_;
+    StreamingService::SearchType type_;
     QStringList tokens_;
 
     bool operator<(const PendingState &b) const {
@@ -123,6 +126,12 @@ class StreamingSearchView : public QWidget {
   void SearchAsync(const int id, const QString &query, const StreamingService::SearchType type);
   void SearchError(const int id, const QString &error);
   void CancelSearch(const int id);
+  bool ReuseSearch(const int id, const int new_id, const QString &query, const StreamingService::SearchType type);
+
+  ResultList ResultsFromSongs(const SongMap &songs) const;
+  void ShowPrefixResults(const QString &query);
+  void QueueResults(const ResultList &results);
+  void ClearQueuedResults();
 
   QString PixmapCacheKey(const Result &result) const;
   bool FindCachedPixmap(const Result &result, QPixmap *pixmap) const;
@@ -145,6 +154,7 @@ class StreamingSearchView : public QWidget {
   void ProgressSetMaximum(const int service_id, const int max);
   void UpdateProgress(const int service_id, const int progress);
   void AddResults(const int service_id, const StreamingSearchView::ResultList &results);
+  void AddQueuedResults();
 
   void FocusOnFilter(QKeyEvent *e);
 
@@ -192,16 +202,23 @@ class StreamingSearchView : public QWidget {
   QSortFilterProxyModel *current_proxy_;
 
   QTimer *swap_models_timer_;
+  QTimer *add_results_timer_;
 
   bool use_pretty_covers_;
   StreamingService::SearchType search_type_;
   bool search_error_;
+  // Whether the model shows filtered results of a shorter query, which are replaced when the service replies.
+  bool showing_prefix_results_;
   int last_search_id_;
   int searches_next_id_;
 
   QMap<int, DelayedSearch> delayed_searches_;
   QMap<int, PendingState> pending_searches_;
 
+  StreamingSearchCache search_cache_;
+  // Results waiting to be added to the current model, a page at a time so the view stays responsive.
+  ResultList queued_results_;
+
   QMap<quint64, QPair<QModelIndex, QString>> cover_loader_tasks_;
 };
 Q_DECLARE_METATYPE(StreamingSearchView::Result)
@@ -19,6 +19,8 @@
 
 #include "config.h"
 
+#include <algorithm>
+
 #include <QObject>
 #include <QDir>
 #include <QMimeDatabase>
@@ -28,6 +30,8 @@
 #include <QUrl>
 #include <QUrlQuery>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QScopeGuard>
 #include <QImage>
 #include <QImageReader>
 #include <QNetworkRequest>
@@ -53,9 +57,15 @@
 using namespace Qt::Literals::StringLiterals;
 
 namespace {
-constexpr int kMaxConcurrentAlbumsRequests = 3;
-constexpr int kMaxConcurrentAlbumSongsRequests = 3;
+constexpr int kMinConcurrentRequests = 1;
+constexpr int kMaxConcurrentRequests = 8;
+constexpr int kDefaultConcurrentRequests = 3;
 constexpr int kMaxConcurrentAlbumCoverRequests = 1;
+
+// Request concurrency is raised while replies stay close to the fastest reply seen, and lowered when the server starts queueing them.
+constexpr double kElapsedAverageWeight = 0.2;
+constexpr double kElapsedIncreaseFactor = 1.5;
+constexpr double kElapsedDecreaseFactor = 3.0;
 }  // namespace
 
 SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *url_handler, const SharedPtr<NetworkAccessManager> network, QObject *parent)
@@ -64,6 +74,14 @@ SubsonicRequest::SubsonicRequest(SubsonicService *service, SubsonicUrlHandler *u
       url_handler_(url_handler),
       timeouts_(new NetworkTimeouts(30000, this)),
       finished_(false),
+      collection_last_modified_(0),
+      indexes_last_modified_(0),
+      albums_reused_(0),
+      max_concurrent_requests_(kDefaultConcurrentRequests),
+      elapsed_average_(0.0),
+      elapsed_minimum_(0),
+      replies_since_concurrency_update_(0),
+      indexes_requests_active_(0),
       albums_requests_active_(0),
       album_songs_requests_active_(0),
       album_songs_requested_(0),
@@ -101,7 +119,10 @@ void SubsonicRequest::Reset() {
   album_cover_requests_queue_.clear();
   album_songs_requests_pending_.clear();
   album_covers_requests_sent_.clear();
+  indexes_last_modified_ = 0;
+  albums_reused_ = 0;
 
+  indexes_requests_active_ = 0;
   albums_requests_active_ = 0;
   album_songs_requests_active_ = 0;
   album_songs_requested_ = 0;
@@ -119,10 +140,68 @@ void SubsonicRequest::Reset() {
 
 }
 
+void SubsonicRequest::SetCollectionSongs(const SongList &songs, const qint64 last_modified) {
+
+  collection_album_songs_.clear();
+  for (const Song &song : songs) {
+    if (!song.album_id().isEmpty()) collection_album_songs_[song.album_id()] << song;
+  }
+  collection_last_modified_ = collection_album_songs_.isEmpty() ? 0 : last_modified;
+
+}
+
 void SubsonicRequest::GetAlbums() {
 
   Q_EMIT UpdateStatus(tr("Retrieving albums..."));
   Q_EMIT UpdateProgress(0);
+  AddIndexesRequest();
+
+}
+
+void SubsonicRequest::AddIndexesRequest() {
+
+  // getIndexes is only used for its lastModified value, with ifModifiedSince the server can tell us that nothing changed since the last sync.
+  ParamList params;
+  if (collection_last_modified_ > 0) params << Param(u"ifModifiedSince"_s, QString::number(collection_last_modified_));
+
+  ++indexes_requests_active_;
+  QNetworkReply *reply = CreateGetRequest(u"getIndexes"_s, params);
+  replies_ << reply;
+  const qint64 if_modified_since = collection_last_modified_;
+  QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, if_modified_since]() { IndexesReplyReceived(reply, if_modified_since); });
+  timeouts_->AddReply(reply);
+
+}
+
+void SubsonicRequest::IndexesReplyReceived(QNetworkReply *reply, const qint64 if_modified_since) {
+
+  if (!replies_.contains(reply)) return;
+  replies_.removeAll(reply);
+  QObject::disconnect(reply, nullptr, this, nullptr);
+  reply->deleteLater();
+
+  --indexes_requests_active_;
+
+  if (finished_) return;
+
+  const JsonObjectResult json_object_result = ParseJsonObject(reply);
+  if (json_object_result.success() && json_object_result.json_object.contains("indexes"_L1)) {
+    const QJsonObject object_indexes = json_object_result.json_object["indexes"_L1].toObject();
+    indexes_last_modified_ = object_indexes["lastModified"_L1].toVariant().toLongLong();
+  }
+  else {
+    Warn(u"Could not get collection modification time, doing a full sync."_s, json_object_result.error_message);
+  }
+
+  if (if_modified_since > 0 && indexes_last_modified_ > 0 && indexes_last_modified_ <= if_modified_since) {
+    qLog(Debug) << "Subsonic: Collection not modified since" << QDateTime::fromMSecsSinceEpoch(if_modified_since);
+    for (QHash<QString, SongList>::const_iterator it = collection_album_songs_.constBegin(); it != collection_album_songs_.constEnd(); ++it) {
+      ReuseCollectionAlbumSongs(it.key());
+    }
+    FinishCheck();
+    return;
+  }
+
   AddAlbumsRequest();
 
 }
@@ -133,13 +212,13 @@ void SubsonicRequest::AddAlbumsRequest(const int offset, const int size) {
   request.size = size;
   request.offset = offset;
   albums_requests_queue_.enqueue(request);
-  if (albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (albums_requests_active_ < max_concurrent_requests_) FlushAlbumsRequests();
 
 }
 
 void SubsonicRequest::FlushAlbumsRequests() {
 
-  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) {
+  while (!albums_requests_queue_.isEmpty() && albums_requests_active_ < max_concurrent_requests_) {
 
     const Request request = albums_requests_queue_.dequeue();
     ++albums_requests_active_;
@@ -148,16 +227,18 @@ void SubsonicRequest::FlushAlbumsRequests() {
     if (request.size > 0) params << Param(u"size"_s, QString::number(request.size));
     if (request.offset > 0) params << Param(u"offset"_s, QString::number(request.offset));
 
+    QElapsedTimer timer;
+    timer.start();
     QNetworkReply *reply = CreateGetRequest(u"getAlbumList2"_s, params);
     replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumsReplyReceived(reply, request.offset, request.size); });
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request, timer]() { AlbumsReplyReceived(reply, request.offset, request.size, timer.elapsed()); });
     timeouts_->AddReply(reply);
 
   }
 
 }
 
-void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested) {
+void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested, const qint64 elapsed) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
@@ -165,6 +246,7 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
   reply->deleteLater();
 
   --albums_requests_active_;
+  UpdateRequestConcurrency(elapsed, reply->error() == QNetworkReply::NoError);
 
   int albums_received = 0;
   const QScopeGuard finish_check = qScopeGuard([this, offset_requested, size_requested, &albums_received]() { AlbumsFinishCheck(offset_requested, size_requested, albums_received); });
@@ -252,6 +334,12 @@ void SubsonicRequest::AlbumsReplyReceived(QNetworkReply *reply, const int offset
 
     if (album_songs_requests_pending_.contains(album_id)) continue;
 
+    const int song_count = object_album.contains("songCount"_L1) ? object_album["songCount"_L1].toInt() : -1;
+    if (CollectionAlbumUpToDate(album_id, AlbumTimestamp(object_album), song_count)) {
+      ReuseCollectionAlbumSongs(album_id);
+      continue;
+    }
+
     Request request;
     request.album_id = album_id;
     request.album_artist = artist;
@@ -272,9 +360,11 @@ void SubsonicRequest::AlbumsFinishCheck(const int offset, const int size, const
     }
   }
 
-  if (!albums_requests_queue_.isEmpty() && albums_requests_active_ < kMaxConcurrentAlbumsRequests) FlushAlbumsRequests();
+  if (!albums_requests_queue_.isEmpty() && albums_requests_active_ < max_concurrent_requests_) FlushAlbumsRequests();
+
+  if (albums_requests_queue_.isEmpty() && albums_requests_active_ <= 0) { // Albums list is finished, get songs for new and changed albums.
 
-  if (albums_requests_queue_.isEmpty() && albums_requests_active_ <= 0) { // Albums list is finished, get songs for all albums.
+    qLog(Debug) << "Subsonic:" << album_songs_requests_pending_.count() << "new or changed albums," << albums_reused_ << "albums unchanged.";
 
     for (QHash<QString, Request>::const_iterator it = album_songs_requests_pending_.constBegin(); it != album_songs_requests_pending_.constEnd(); ++it) {
       const Request request = it.value();
@@ -303,24 +393,26 @@ void SubsonicRequest::AddAlbumSongsRequest(const QString &artist_id, const QStri
   request.offset = offset;
   album_songs_requests_queue_.enqueue(request);
   ++album_songs_requested_;
-  if (album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (album_songs_requests_active_ < max_concurrent_requests_) FlushAlbumSongsRequests();
 
 }
 
 void SubsonicRequest::FlushAlbumSongsRequests() {
 
-  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) {
+  while (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < max_concurrent_requests_) {
     const Request request = album_songs_requests_queue_.dequeue();
     ++album_songs_requests_active_;
+    QElapsedTimer timer;
+    timer.start();
     QNetworkReply *reply = CreateGetRequest(u"getAlbum"_s, ParamList() << Param(u"id"_s, request.album_id));
     replies_ << reply;
-    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist); });
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply, request, timer]() { AlbumSongsReplyReceived(reply, request.artist_id, request.album_id, request.album_artist, timer.elapsed()); });
     timeouts_->AddReply(reply);
   }
 
 }
 
-void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist) {
+void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist, const qint64 elapsed) {
 
   if (!replies_.contains(reply)) return;
   replies_.removeAll(reply);
@@ -329,10 +421,16 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
 
   --album_songs_requests_active_;
   ++album_songs_received_;
+  UpdateRequestConcurrency(elapsed, reply->error() == QNetworkReply::NoError);
 
   Q_EMIT UpdateProgress(album_songs_received_);
 
-  const QScopeGuard finish_check = qScopeGuard([this]() { SongsFinishCheck(); });
+  // Keep the songs we already have if the album could not be retrieved, otherwise they would be deleted from the collection.
+  bool success = false;
+  const QScopeGuard finish_check = qScopeGuard([this, &album_id, &success]() {
+    if (!success) ReuseCollectionAlbumSongs(album_id);
+    SongsFinishCheck();
+  });
 
   if (finished_) return;
 
@@ -369,11 +467,13 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
     return;
   }
   const QJsonArray array_songs = value_songs.toArray();
+  success = true;
 
   qint64 created = 0;
   if (object_album.contains("created"_L1)) {
     created = QDateTime::fromString(object_album["created"_L1].toString(), Qt::ISODate).toSecsSinceEpoch();
   }
+  const qint64 album_timestamp = AlbumTimestamp(object_album);
 
   QString album_cover_id;
   if (object_album.contains("coverArt"_L1)) {
@@ -397,7 +497,7 @@ void SubsonicRequest::AlbumSongsReplyReceived(QNetworkReply *reply, const QStrin
     const QJsonObject object_song = value_song.toObject();
 
     Song song(Song::Source::Subsonic);
-    ParseSong(song, object_song, artist_id, album_id, album_artist, album_cover_id, created);
+    ParseSong(song, object_song, artist_id, album_id, album_artist, album_cover_id, created, album_timestamp);
     if (!song.is_valid()) continue;
     if (song.disc() >= 2) multidisc = true;
     if (song.is_compilation()) compilation = true;
@@ -418,7 +518,7 @@ void SubsonicRequest::SongsFinishCheck() {
 
   if (finished_) return;
 
-  if (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < kMaxConcurrentAlbumSongsRequests) FlushAlbumSongsRequests();
+  if (!album_songs_requests_queue_.isEmpty() && album_songs_requests_active_ < max_concurrent_requests_) FlushAlbumSongsRequests();
 
   if (download_album_covers() &&
       album_songs_requests_queue_.isEmpty() &&
@@ -434,7 +534,7 @@ void SubsonicRequest::SongsFinishCheck() {
 
 }
 
-QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested, const QString &album_id_requested, const QString &album_artist, const QString &album_cover_id, const qint64 album_created) {
+QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested, const QString &album_id_requested, const QString &album_artist, const QString &album_cover_id, const qint64 album_created, const qint64 album_timestamp) {
 
   Q_UNUSED(artist_id_requested);
   Q_UNUSED(album_id_requested);
@@ -620,7 +720,8 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, c
   song.set_directory_id(0);
   song.set_filetype(filetype);
   song.set_filesize(size);
-  song.set_mtime(created);
+  // The album timestamp is stored as mtime so the next sync can tell whether the album changed.
+  song.set_mtime(album_timestamp > 0 ? album_timestamp : created);
   song.set_ctime(created);
   song.set_bitrate(bitrate);
   song.set_valid(true);
@@ -629,6 +730,72 @@ QString SubsonicRequest::ParseSong(Song &song, const QJsonObject &json_object, c
 
 }
 
+qint64 SubsonicRequest::AlbumTimestamp(const QJsonObject &object_album) {
+
+  // "changed" is an OpenSubsonic extension, fall back to "created" for other servers.
+  for (const QLatin1String &key : {"changed"_L1, "created"_L1}) {
+    if (object_album.contains(key)) {
+      const QDateTime datetime = QDateTime::fromString(object_album[key].toString(), Qt::ISODate);
+      if (datetime.isValid()) return datetime.toSecsSinceEpoch();
+    }
+  }
+
+  return 0;
+
+}
+
+bool SubsonicRequest::CollectionAlbumUpToDate(const QString &album_id, const qint64 album_timestamp, const int song_count) const {
+
+  if (album_timestamp <= 0 || !collection_album_songs_.contains(album_id)) return false;
+
+  const SongList &songs = collection_album_songs_[album_id];
+  if (song_count >= 0 && songs.count() != song_count) return false;
+
+  return std::all_of(songs.begin(), songs.end(), [album_timestamp](const Song &song) { return song.mtime() == album_timestamp; });
+
+}
+
+void SubsonicRequest::ReuseCollectionAlbumSongs(const QString &album_id) {
+
+  if (!collection_album_songs_.contains(album_id)) return;
+
+  const SongList songs = collection_album_songs_.value(album_id);
+  for (const Song &song : songs) {
+    songs_.insert(song.song_id(), song);
+  }
+  ++albums_reused_;
+
+}
+
+void SubsonicRequest::UpdateRequestConcurrency(const qint64 elapsed, const bool success) {
+
+  if (!success) {
+    max_concurrent_requests_ = std::max(kMinConcurrentRequests, max_concurrent_requests_ / 2);
+    replies_since_concurrency_update_ = 0;
+    return;
+  }
+
+  elapsed_average_ = elapsed_average_ <= 0.0 ? static_cast<double>(elapsed) : (elapsed_average_ * (1.0 - kElapsedAverageWeight)) + (static_cast<double>(elapsed) * kElapsedAverageWeight);
+  if (elapsed_minimum_ <= 0 || elapsed < elapsed_minimum_) elapsed_minimum_ = std::max(static_cast<qint64>(1), elapsed);
+
+  // Only adjust once per window of replies, so the effect of the previous change can be measured first.
+  if (++replies_since_concurrency_update_ < max_concurrent_requests_) return;
+  replies_since_concurrency_update_ = 0;
+
+  const int max_concurrent_requests = max_concurrent_requests_;
+  if (elapsed_average_ > static_cast<double>(elapsed_minimum_) * kElapsedDecreaseFactor) {
+    max_concurrent_requests_ = std::max(kMinConcurrentRequests, max_concurrent_requests_ - 1);
+  }
+  else if (elapsed_average_ < static_cast<double>(elapsed_minimum_) * kElapsedIncreaseFactor) {
+    max_concurrent_requests_ = std::min(kMaxConcurrentRequests, max_concurrent_requests_ + 1);
+  }
+
+  if (max_concurrent_requests_ != max_concurrent_requests) {
+    qLog(Debug) << "Subsonic: Average reply time" << qRound(elapsed_average_) << "ms, changing concurrent requests from" << max_concurrent_requests << "to" << max_concurrent_requests_;
+  }
+
+}
+
 void SubsonicRequest::GetAlbumCovers() {
 
   const SongList songs = songs_.values();
@@ -811,6 +978,7 @@ void SubsonicRequest::AlbumCoverFinishCheck() {
 void SubsonicRequest::FinishCheck() {
 
   if (!finished_ &&
+      indexes_requests_active_ <= 0 &&
       albums_requests_queue_.isEmpty() &&
       album_songs_requests_queue_.isEmpty() &&
       album_cover_requests_queue_.isEmpty() &&
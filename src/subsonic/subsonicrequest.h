@@ -56,9 +56,12 @@ class SubsonicRequest : public SubsonicBaseRequest {
 
   void ReloadSettings();
 
+  void SetCollectionSongs(const SongList &songs, const qint64 last_modified);
   void GetAlbums();
   void Reset();
 
+  qint64 last_modified() const { return indexes_last_modified_; }
+
  private:
   struct Request {
     explicit Request() : offset(0), size(0) {}
@@ -84,11 +87,14 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void UpdateProgress(const int progress);
 
  private Q_SLOTS:
-  void AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested);
-  void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist);
+  void IndexesReplyReceived(QNetworkReply *reply, const qint64 if_modified_since);
+  void AlbumsReplyReceived(QNetworkReply *reply, const int offset_requested, const int size_requested, const qint64 elapsed);
+  void AlbumSongsReplyReceived(QNetworkReply *reply, const QString &artist_id, const QString &album_id, const QString &album_artist, const qint64 elapsed);
   void AlbumCoverReceived(QNetworkReply *reply, const SubsonicRequest::AlbumCoverRequest &request);
 
  private:
+  void AddIndexesRequest();
+
   void AddAlbumsRequest(const int offset = 0, const int size = 500);
   void FlushAlbumsRequests();
 
@@ -98,7 +104,12 @@ class SubsonicRequest : public SubsonicBaseRequest {
   void AddAlbumSongsRequest(const QString &artist_id, const QString &album_id, const QString &album_artist, const int offset = 0);
   void FlushAlbumSongsRequests();
 
-  QString ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested = QString(), const QString &album_id_requested = QString(), const QString &album_artist = QString(), const QString &album_cover_id = QString(), const qint64 album_created = 0);
+  QString ParseSong(Song &song, const QJsonObject &json_object, const QString &artist_id_requested = QString(), const QString &album_id_requested = QString(), const QString &album_artist = QString(), const QString &album_cover_id = QString(), const qint64 album_created = 0, const qint64 album_timestamp = 0);
+
+  static qint64 AlbumTimestamp(const QJsonObject &object_album);
+  bool CollectionAlbumUpToDate(const QString &album_id, const qint64 album_timestamp, const int song_count) const;
+  void ReuseCollectionAlbumSongs(const QString &album_id);
+  void UpdateRequestConcurrency(const qint64 elapsed, const bool success);
 
   void GetAlbumCovers();
   void AddAlbumCoverRequest(const Song &song);
@@ -121,9 +132,20 @@ class SubsonicRequest : public SubsonicBaseRequest {
   QQueue<AlbumCoverRequest> album_cover_requests_queue_;
 
   QHash<QString, Request> album_songs_requests_pending_;
+  QHash<QString, SongList> collection_album_songs_;
+  qint64 collection_last_modified_;
+  qint64 indexes_last_modified_;
+  int albums_reused_;
+
+  int max_concurrent_requests_;
+  double elapsed_average_;
+  qint64 elapsed_minimum_;
+  int replies_since_concurrency_update_;
+
   QMultiMap<QString, QString> album_covers_requests_sent_;
   QMultiMap<QString, QUrl> album_covers_retrieved_;
 
+  int indexes_requests_active_;
   int albums_requests_active_;
 
   int album_songs_requests_active_;
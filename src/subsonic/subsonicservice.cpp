@@ -84,6 +84,8 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
       download_album_covers_(true),
       use_album_id_for_album_covers_(false),
       auth_method_(SubsonicSettings::AuthMethod::MD5),
+      last_modified_(0),
+      songs_request_id_(0),
       ping_redirects_(0) {
 
   url_handlers->Register(url_handler_);
@@ -92,6 +94,7 @@ SubsonicService::SubsonicService(const SharedPtr<TaskManager> task_manager,
   collection_backend_->moveToThread(database->thread());
   collection_backend_->Init(database, task_manager, Song::Source::Subsonic, QLatin1String(kSongsTable));
   collection_model_ = new CollectionModel(collection_backend_, albumcover_loader, this);
+  QObject::connect(&*collection_backend_, &CollectionBackend::GotSongs, this, &SubsonicService::CollectionSongsReceived);
 
   SubsonicService::ReloadSettings();
 
@@ -131,6 +134,7 @@ void SubsonicService::ReloadSettings() {
   download_album_covers_ = s.value(SubsonicSettings::kDownloadAlbumCovers, SubsonicSettings::kDefaultDownloadAlbumCovers).toBool();
   use_album_id_for_album_covers_ = s.value(SubsonicSettings::kUseAlbumIdForAlbumCovers, SubsonicSettings::kDefaultUseAlbumIdForAlbumCovers).toBool();
   auth_method_ = static_cast<SubsonicSettings::AuthMethod>(s.value(SubsonicSettings::kAuthMethod, static_cast<int>(SubsonicSettings::kDefaultAuthMethod)).toInt());
+  last_modified_ = s.value(SubsonicSettings::kLastModified, 0).toLongLong();
 
   s.endGroup();
 
@@ -423,6 +427,16 @@ void SubsonicService::GetSongs() {
   QObject::connect(&*songs_request_, &SubsonicRequest::ProgressSetMaximum, this, &SubsonicService::SongsProgressSetMaximum);
   QObject::connect(&*songs_request_, &SubsonicRequest::UpdateProgress, this, &SubsonicService::SongsUpdateProgress);
 
+  // Load the songs we already have first, so only new and changed albums are retrieved from the server.
+  collection_backend_->GetAllSongsAsync(++songs_request_id_);
+
+}
+
+void SubsonicService::CollectionSongsReceived(const SongList &songs, const int id) {
+
+  if (!songs_request_ || id != songs_request_id_) return;
+
+  songs_request_->SetCollectionSongs(songs, last_modified_);
   songs_request_->GetAlbums();
 
 }
@@ -431,10 +445,24 @@ void SubsonicService::DeleteSongs() {
 
   collection_backend_->DeleteAllAsync();
 
+  last_modified_ = 0;
+  Settings s;
+  s.beginGroup(SubsonicSettings::kSettingsGroup);
+  s.remove(SubsonicSettings::kLastModified);
+  s.endGroup();
+
 }
 
 void SubsonicService::SongsResultsReceived(const SongMap &songs, const QString &error) {
 
+  if (error.isEmpty() && songs_request_ && songs_request_->last_modified() > 0) {
+    last_modified_ = songs_request_->last_modified();
+    Settings s;
+    s.beginGroup(SubsonicSettings::kSettingsGroup);
+    s.setValue(SubsonicSettings::kLastModified, last_modified_);
+    s.endGroup();
+  }
+
   Q_EMIT SongsResults(songs, error);
 
   ResetSongsRequest();
@@ -105,6 +105,7 @@ class SubsonicService : public StreamingService {
  private Q_SLOTS:
   void HandlePingSSLErrors(const QList<QSslError> &ssl_errors);
   void HandlePingReply(QNetworkReply *reply, const QUrl &url, const QString &username, const QString &password, const SubsonicSettings::AuthMethod auth_method);
+  void CollectionSongsReceived(const SongList &songs, const int id);
   void SongsResultsReceived(const SongMap &songs, const QString &error);
 
  private:
@@ -127,7 +128,9 @@ class SubsonicService : public StreamingService {
   bool download_album_covers_;
   bool use_album_id_for_album_covers_;
   SubsonicSettings::AuthMethod auth_method_;
+  qint64 last_modified_;
 
+  int songs_request_id_;
   QStringList errors_;
   int ping_redirects_;
 
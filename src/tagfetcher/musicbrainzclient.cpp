@@ -149,6 +149,8 @@ JsonBaseRequest::JsonObjectResult MusicBrainzClient::ParseJsonObject(QNetworkRep
     }
   }
 
+  if (!result.success()) network_->RemoveFromMetadataCache(reply);
+
   return result;
 
 }
@@ -56,6 +56,7 @@ class MusicBrainzClient : public JsonBaseRequest {
   virtual bool authenticated() const override { return true; }
   virtual bool use_authorization_header() const override { return false; }
   virtual QByteArray authorization_header() const override { return QByteArray(); }
+  virtual qint64 metadata_cache_ttl() const override { return 30LL * 24LL * 60LL * 60LL; }
 
   struct Result {
    public:
@@ -25,7 +25,7 @@
 #include <utility>
 
 #include <QObject>
-#include <QtConcurrentMap>
+#include <QList>
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QString>
@@ -35,7 +35,7 @@
 #include "core/logging.h"
 #include "core/networkaccessmanager.h"
 #include "constants/timeconstants.h"
-#include "engine/chromaprinter.h"
+#include "engine/fingerprintservice.h"
 #include "acoustidclient.h"
 #include "musicbrainzclient.h"
 #include "tagfetcher.h"
@@ -48,7 +48,6 @@ using namespace Qt::StringLiterals;
 
 TagFetcher::TagFetcher(SharedPtr<NetworkAccessManager> network, QObject *parent)
     : QObject(parent),
-      fingerprint_watcher_(nullptr),
       acoustid_client_(new AcoustidClient(network, this)),
       musicbrainz_client_(new MusicBrainzClient(network, this)) {
 
@@ -61,22 +60,6 @@ bool TagFetcher::IsValidFingerprint(const QString &fingerprint) {
   return !fingerprint.isEmpty() && fingerprint.compare("NONE"_L1, Qt::CaseInsensitive) != 0 && fingerprint.size() >= kMinimumAcoustidFingerprintLength;
 }
 
-TagFetcher::FingerprintResult TagFetcher::GetFingerprint(const Song &song) {
-
-  Chromaprinter chromaprinter(song.url());
-  const QString fingerprint = chromaprinter.CreateFullFingerprint();
-  const QString error = chromaprinter.LastError();
-  if (fingerprint.isEmpty()) {
-    qLog(Warning) << "Tag fetch fingerprint generation failed for" << song.url() << ":" << error;
-  }
-  else {
-    qLog(Debug) << "Tag fetch fingerprint generated for" << song.url() << "length" << fingerprint.size();
-  }
-
-  return FingerprintResult(fingerprint, error);
-
-}
-
 QString TagFetcher::BuildUiErrorDetails(const QString &stage, const QString &reason, const QStringList &extra) {
 
   QStringList lines;
@@ -109,11 +92,19 @@ void TagFetcher::StartFetch(const SongList &songs) {
     }
   }
   else {
-    QFuture<FingerprintResult> future = QtConcurrent::mapped(songs_, GetFingerprint);
-    fingerprint_watcher_ = new QFutureWatcher<FingerprintResult>(this);
-    QObject::connect(fingerprint_watcher_, &QFutureWatcher<FingerprintResult>::resultReadyAt, this, &TagFetcher::FingerprintFound);
-    fingerprint_watcher_->setFuture(future);
-    for (const Song &song : std::as_const(songs_)) {
+    // The user is waiting for these, so they are created ahead of fingerprints for a collection scan.
+    for (int i = 0; i < songs_.count(); ++i) {
+      const Song song = songs_.value(i);
+      QFuture<FingerprintService::Result> future = FingerprintService::Instance()->Fingerprint(song.url(), FingerprintService::Algorithm::Full, FingerprintService::Priority::Interactive);
+      QFutureWatcher<FingerprintService::Result> *watcher = new QFutureWatcher<FingerprintService::Result>(this);
+      QObject::connect(watcher, &QFutureWatcher<FingerprintService::Result>::finished, this, [this, watcher, i]() {
+        fingerprint_watchers_.removeAll(watcher);
+        watcher->deleteLater();
+        if (watcher->isCanceled() || watcher->future().resultCount() == 0) return;
+        FingerprintFound(i, watcher->result());
+      });
+      watcher->setFuture(future);
+      fingerprint_watchers_ << watcher;
       Q_EMIT Progress(song, tr("Fingerprinting song"));
     }
   }
@@ -122,11 +113,12 @@ void TagFetcher::StartFetch(const SongList &songs) {
 
 void TagFetcher::Cancel() {
 
-  if (fingerprint_watcher_) {
-    fingerprint_watcher_->cancel();
-    fingerprint_watcher_->deleteLater();
-    fingerprint_watcher_ = nullptr;
+  for (QFutureWatcher<FingerprintService::Result> *watcher : std::as_const(fingerprint_watchers_)) {
+    watcher->disconnect(this);
+    watcher->cancel();
+    watcher->deleteLater();
   }
+  fingerprint_watchers_.clear();
 
   acoustid_client_->CancelAll();
   musicbrainz_client_->CancelAll();
@@ -134,16 +126,21 @@ void TagFetcher::Cancel() {
 
 }
 
-void TagFetcher::FingerprintFound(const int index) {
+void TagFetcher::FingerprintFound(const int index, const FingerprintService::Result &fingerprint_result) {
 
-  QFutureWatcher<FingerprintResult> *watcher = static_cast<QFutureWatcher<FingerprintResult>*>(sender());
-  if (!watcher || index < 0 || index >= songs_.count()) return;
+  if (index < 0 || index >= songs_.count()) return;
 
-  const FingerprintResult fingerprint_result = watcher->resultAt(index);
   const QString &fingerprint = fingerprint_result.fingerprint;
   const QString &fingerprint_error = fingerprint_result.error;
   const Song song = songs_.value(index);
 
+  if (fingerprint.isEmpty()) {
+    qLog(Warning) << "Tag fetch fingerprint generation failed for" << song.url() << ":" << fingerprint_error;
+  }
+  else {
+    qLog(Debug) << "Tag fetch fingerprint generated for" << song.url() << "length" << fingerprint.size();
+  }
+
   if (!IsValidFingerprint(fingerprint)) {
     QString reason = fingerprint_error;
     if (reason.isEmpty()) {
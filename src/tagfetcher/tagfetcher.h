@@ -25,12 +25,14 @@
 #include "config.h"
 
 #include <QObject>
+#include <QList>
 #include <QFutureWatcher>
 #include <QString>
 #include <QStringList>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
+#include "engine/fingerprintservice.h"
 #include "musicbrainzclient.h"
 
 class NetworkAccessManager;
@@ -53,23 +55,15 @@ class TagFetcher : public QObject {
   void ResultAvailable(const Song &original_song, const SongList &songs_guessed, const QString &error = QString());
 
  private Q_SLOTS:
-  void FingerprintFound(const int index);
   void PuidsFound(const int index, const QStringList &puid_list, const QString &error = QString());
   void TagsFetched(const int index, const MusicBrainzClient::ResultList &results, const QString &error = QString());
 
  private:
-  class FingerprintResult {
-   public:
-    explicit FingerprintResult(const QString &_fingerprint = QString(), const QString &_error = QString()) : fingerprint(_fingerprint), error(_error) {}
-    QString fingerprint;
-    QString error;
-  };
-
   static bool IsValidFingerprint(const QString &fingerprint);
-  static FingerprintResult GetFingerprint(const Song &song);
+  void FingerprintFound(const int index, const FingerprintService::Result &fingerprint_result);
   QString BuildUiErrorDetails(const QString &stage, const QString &reason, const QStringList &extra = QStringList());
 
-  QFutureWatcher<FingerprintResult> *fingerprint_watcher_;
+  QList<QFutureWatcher<FingerprintService::Result>*> fingerprint_watchers_;
   AcoustidClient *acoustid_client_;
   MusicBrainzClient *musicbrainz_client_;
 
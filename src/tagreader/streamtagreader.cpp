@@ -19,11 +19,14 @@
  */
 
 #include <algorithm>
+#include <utility>
 
+#include <QList>
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
 #include <QEventLoop>
+#include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QSslError>
@@ -36,27 +39,31 @@
 namespace {
 constexpr TagLibLengthType kTagLibPrefixCacheBytes = 64UL * 1024UL;
 constexpr TagLibLengthType kTagLibSuffixCacheBytes = 8UL * 1024UL;
+constexpr TagLibLengthType kMinReadAheadBytes = 16UL * 1024UL;
+constexpr TagLibLengthType kMaxReadAheadBytes = 1024UL * 1024UL;
+// Holes up to this size next to a request are read in the same request.
+constexpr TagLibLengthType kCoalesceGapBytes = 16UL * 1024UL;
 }  // namespace
 
 StreamTagReader::StreamTagReader(const QUrl &url,
                                  const QString &filename,
                                  const quint64 length,
                                  const QString &token_type,
-                                 const QString &access_token)
+                                 const QString &access_token,
+                                 QNetworkAccessManager *network)
     : url_(url),
       filename_(filename),
       encoded_filename_(filename_.toUtf8()),
       length_(static_cast<TagLibLengthType>(length)),
       token_type_(token_type),
       access_token_(access_token),
-      network_(new NetworkAccessManager),
+      own_network_(network ? nullptr : new NetworkAccessManager),
+      network_(network ? network : own_network_.get()),
       cursor_(0),
       cache_(length),
-      num_requests_(0) {
-
-  network_->setAutoDeleteReplies(true);
-
-}
+      num_requests_(0),
+      last_request_end_(0),
+      read_ahead_(kMinReadAheadBytes) {}
 
 TagLib::FileName StreamTagReader::name() const { return encoded_filename_.data(); }
 
@@ -67,53 +74,140 @@ TagLib::ByteVector StreamTagReader::readBlock(const TagLibLengthType length) {
   }
 
   const TagLibLengthType start = cursor_;
-  const TagLibLengthType end = std::min(cursor_ + length - 1, length_ - 1);
+  TagLibLengthType end = std::min(cursor_ + length - 1, length_ - 1);
 
   if (end < start) {
     return TagLib::ByteVector();
   }
 
-  if (CheckCache(start, end)) {
-    const TagLib::ByteVector cached = GetCache(start, end);
-    cursor_ += static_cast<TagLibLengthType>(cached.size());
-    return cached;
+  if (!CheckCache(start, end)) {
+    Fetch(QList<Range>() << RequestRange(start, end));
+    // Return what we got if the server sent less than requested.
+    if (!cache_.test(start)) {
+      return TagLib::ByteVector();
+    }
+    for (TagLibLengthType i = start + 1; i <= end; ++i) {
+      if (!cache_.test(i)) {
+        end = i - 1;
+        break;
+      }
+    }
   }
 
+  const TagLib::ByteVector cached = GetCache(start, end);
+  cursor_ += static_cast<TagLibLengthType>(cached.size());
+
+  return cached;
+
+}
+
+StreamTagReader::Range StreamTagReader::RequestRange(const TagLibLengthType start, const TagLibLengthType end) {
+
+  // Request the uncached part of the read as one range, even if there are cached bytes in between.
+  TagLibLengthType first = start;
+  while (first < end && cache_.test(first)) ++first;
+  TagLibLengthType last = end;
+  while (last > first && cache_.test(last)) --last;
+
+  // TagLib often keeps reading where the last request ended, for example when skipping frames or reading a large tag, so read further ahead each time it does.
+  if (first > last_request_end_ && first - last_request_end_ <= kCoalesceGapBytes) {
+    read_ahead_ = std::min(read_ahead_ * 2, kMaxReadAheadBytes);
+  }
+  else {
+    read_ahead_ = kMinReadAheadBytes;
+  }
+
+  // Read ahead until the first cached byte.
+  const TagLibLengthType read_ahead_end = std::min(first + read_ahead_ - 1, length_ - 1);
+  while (last < read_ahead_end && !cache_.test(last + 1)) ++last;
+
+  // Fill a small hole between the request and cached bytes, instead of leaving it for another request.
+  TagLibLengthType next_cached = last + 1;
+  while (next_cached < length_ && next_cached - last <= kCoalesceGapBytes && !cache_.test(next_cached)) ++next_cached;
+  if (next_cached < length_ && cache_.test(next_cached)) {
+    last = next_cached - 1;
+  }
+
+  last_request_end_ = last;
+
+  return Range(first, last);
+
+}
+
+QNetworkReply *StreamTagReader::CreateRequest(const Range &range) {
+
   QNetworkRequest network_request(url_);
   if (!token_type_.isEmpty() && !access_token_.isEmpty()) {
     network_request.setRawHeader("Authorization", token_type_.toUtf8() + " " + access_token_.toUtf8());
   }
-  network_request.setRawHeader("Range", QStringLiteral("bytes=%1-%2").arg(start).arg(end).toUtf8());
+  network_request.setRawHeader("Range", QStringLiteral("bytes=%1-%2").arg(range.start).arg(range.end).toUtf8());
   network_request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
   network_request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
 
   QNetworkReply *reply = network_->get(network_request);
   ++num_requests_;
 
+  return reply;
+
+}
+
+bool StreamTagReader::Fetch(const QList<Range> &ranges) {
+
+  QList<QNetworkReply*> replies;
+  replies.reserve(ranges.count());
+  for (const Range &range : ranges) {
+    replies << CreateRequest(range);
+  }
+
+  // The requests run in parallel, wait for all of them.
   QEventLoop event_loop;
-  QObject::connect(reply, &QNetworkReply::finished, &event_loop, &QEventLoop::quit);
-  event_loop.exec();
+  qsizetype pending_replies = replies.count();
+  for (QNetworkReply *reply : std::as_const(replies)) {
+    QObject::connect(reply, &QNetworkReply::finished, &event_loop, [&event_loop, &pending_replies]() {
+      if (--pending_replies == 0) event_loop.quit();
+    });
+  }
+  if (pending_replies > 0) {
+    event_loop.exec();
+  }
+
+  bool success = true;
+  for (qsizetype i = 0; i < replies.count(); ++i) {
+    if (!ReadReply(replies[i], ranges[i])) success = false;
+    replies[i]->deleteLater();
+  }
+
+  return success;
+
+}
+
+bool StreamTagReader::ReadReply(QNetworkReply *reply, const Range &range) {
 
   if (reply->error() != QNetworkReply::NoError) {
     qLog(Error) << "Unable to get tags from stream for" << url_ << "got error:" << reply->errorString();
-    return TagLib::ByteVector();
+    return false;
   }
 
+  int http_status_code = 0;
   if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
-    const int http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    http_status_code = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
     if (http_status_code >= 400) {
       qLog(Error) << "Unable to get tags from stream for" << url_ << "received HTTP code" << http_status_code;
-      return TagLib::ByteVector();
+      return false;
     }
   }
 
   const QByteArray data = reply->readAll();
-  const TagLib::ByteVector bytes(data.data(), static_cast<uint>(data.size()));
-  cursor_ += static_cast<TagLibLengthType>(data.size());
 
-  FillCache(start, bytes);
+  // A server without support for ranges sends the whole file.
+  if (http_status_code == 200 && static_cast<TagLibLengthType>(data.size()) == length_) {
+    FillCache(0, data);
+  }
+  else {
+    FillCache(range.start, data.left(static_cast<qsizetype>(range.end - range.start + 1U)));
+  }
 
-  return bytes;
+  return true;
 
 }
 
@@ -181,10 +275,11 @@ bool StreamTagReader::CheckCache(const TagLibLengthType start, const TagLibLengt
 
 }
 
-void StreamTagReader::FillCache(const TagLibLengthType start, const TagLib::ByteVector &data) {
+void StreamTagReader::FillCache(const TagLibLengthType start, const QByteArray &data) {
 
-  for (TagLibLengthType i = 0; i < data.size(); ++i) {
-    cache_.set(start + i, data[static_cast<int>(i)]);
+  const TagLibLengthType size = std::min(static_cast<TagLibLengthType>(data.size()), length_ - std::min(start, length_));
+  for (TagLibLengthType i = 0; i < size; ++i) {
+    cache_.set(start + i, data[static_cast<qsizetype>(i)]);
   }
 
 }
@@ -213,12 +308,24 @@ void StreamTagReader::PreCache() {
   //
   // So, if we precache the first 64KB and the last 8KB we should be sorted :-)
   // Ideally, we would use bytes=0-655364,-8096 but Google Drive does not seem
-  // to support multipart byte ranges yet so we have to make do with two requests.
+  // to support multipart byte ranges yet so we send the two requests in parallel.
+
+  if (length_ == 0) return;
+
+  const TagLibLengthType prefix_end = std::min(kTagLibPrefixCacheBytes, length_) - 1;
+  const TagLibLengthType suffix_start = length_ > kTagLibSuffixCacheBytes ? length_ - kTagLibSuffixCacheBytes : 0;
+
+  QList<Range> ranges;
+  if (suffix_start <= prefix_end + kCoalesceGapBytes) {
+    ranges << Range(0, length_ - 1);
+  }
+  else {
+    ranges << Range(0, prefix_end) << Range(suffix_start, length_ - 1);
+  }
+  Fetch(ranges);
 
-  seek(0, TagLib::IOStream::Beginning);
-  readBlock(kTagLibPrefixCacheBytes);
-  seek(kTagLibSuffixCacheBytes, TagLib::IOStream::End);
-  readBlock(kTagLibSuffixCacheBytes);
-  clear();
+  // Reading on after the prefix continues with a larger read-ahead.
+  last_request_end_ = prefix_end;
+  read_ahead_ = kTagLibPrefixCacheBytes;
 
 }
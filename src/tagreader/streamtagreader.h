@@ -24,6 +24,7 @@
 #include <taglib/tiostream.h>
 #include <google/sparsetable>
 
+#include <QList>
 #include <QByteArray>
 #include <QString>
 #include <QUrl>
@@ -41,6 +42,12 @@ using TagLibUOffsetType = ulong;
 using TagLibOffsetType = long;
 #endif
 
+class QNetworkAccessManager;
+class QNetworkReply;
+
+// Reads a file over HTTP for TagLib, caching the bytes read.
+// Uncached reads are extended by a read-ahead which grows while TagLib keeps reading past the cached bytes, and small holes up to cached bytes are filled in the same request.
+// Pass the same network access manager for all files in a batch so the HTTP connections are reused, it must belong to the calling thread.
 class StreamTagReader : public TagLib::IOStream {
 
  public:
@@ -48,7 +55,8 @@ class StreamTagReader : public TagLib::IOStream {
                            const QString &filename,
                            const quint64 length,
                            const QString &token_type,
-                           const QString &access_token);
+                           const QString &access_token,
+                           QNetworkAccessManager *network = nullptr);
 
   virtual TagLib::FileName name() const override;
   virtual TagLib::ByteVector readBlock(const TagLibLengthType length) override;
@@ -69,11 +77,23 @@ class StreamTagReader : public TagLib::IOStream {
 
   int num_requests() const { return num_requests_; }
 
+  // Reads the beginning and the end of the file, where the headers and tags usually are, with parallel requests.
   void PreCache();
 
  private:
+  struct Range {
+    Range(const TagLibLengthType _start, const TagLibLengthType _end) : start(_start), end(_end) {}
+    TagLibLengthType start;
+    TagLibLengthType end;
+  };
+
+  Range RequestRange(const TagLibLengthType start, const TagLibLengthType end);
+  QNetworkReply *CreateRequest(const Range &range);
+  bool Fetch(const QList<Range> &ranges);
+  bool ReadReply(QNetworkReply *reply, const Range &range);
+
   bool CheckCache(const TagLibLengthType start, const TagLibLengthType end);
-  void FillCache(const TagLibLengthType start, const TagLib::ByteVector &data);
+  void FillCache(const TagLibLengthType start, const QByteArray &data);
   TagLib::ByteVector GetCache(const TagLibLengthType start, const TagLibLengthType end);
 
  private:
@@ -84,11 +104,16 @@ class StreamTagReader : public TagLib::IOStream {
   const QString token_type_;
   const QString access_token_;
 
-  ScopedPtr<NetworkAccessManager> network_;
+  ScopedPtr<NetworkAccessManager> own_network_;
+  QNetworkAccessManager *network_;
 
   TagLibLengthType cursor_;
   google::sparsetable<char> cache_;
   int num_requests_;
+
+  // End of the last request, and the current read-ahead size, doubled each time a read continues after it.
+  TagLibLengthType last_request_end_;
+  TagLibLengthType read_ahead_;
 };
 
 #endif  // STREAMTAGREADER_H
@@ -30,7 +30,11 @@
 #include <QScopeGuard>
 
 #include "core/logging.h"
+#include "core/tracing.h"
 #include "core/song.h"
+#ifdef HAVE_STREAMTAGREADER
+#  include "core/networkaccessmanager.h"
+#endif
 
 #include "tagreaderclient.h"
 #include "tagreadertaglib.h"
@@ -63,6 +67,11 @@ TagReaderClient::TagReaderClient(QObject *parent)
 
   setObjectName(QLatin1String(QObject::metaObject()->className()));
 
+#ifdef HAVE_STREAMTAGREADER
+  // Shared by all streams read by this client, it's moved to the client's thread with it.
+  tagreader_.set_stream_network(new NetworkAccessManager(this));
+#endif
+
 }
 
 void TagReaderClient::ExitAsync() {
@@ -163,6 +172,8 @@ void TagReaderClient::ProcessRequest(TagReaderRequestPtr request) {
 
   Q_ASSERT(QThread::currentThread() == thread());
 
+  TRACE_SCOPE("tagreader", "Tag reader request");
+
   TagReaderReplyPtr reply = request->reply;
 
   TagReaderResult result;
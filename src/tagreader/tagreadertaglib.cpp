@@ -98,6 +98,8 @@
 #include <QFileInfo>
 #include <QUrl>
 #include <QDateTime>
+#include <QThread>
+#include <QNetworkAccessManager>
 #include <QtDebug>
 
 #include "includes/scoped_ptr.h"
@@ -303,7 +305,12 @@ class TagLibFileRefFactory : public FileRefFactory {
   Q_DISABLE_COPY(TagLibFileRefFactory)
 };
 
-TagReaderTagLib::TagReaderTagLib() : factory_(new TagLibFileRefFactory) {}
+TagReaderTagLib::TagReaderTagLib()
+    : factory_(new TagLibFileRefFactory)
+#ifdef HAVE_STREAMTAGREADER
+      , stream_network_(nullptr)
+#endif
+{}
 
 TagReaderTagLib::~TagReaderTagLib() {
   delete factory_;
@@ -590,7 +597,8 @@ TagReaderResult TagReaderTagLib::ReadStream(const QUrl &url,
   song->set_ctime(static_cast<qint64>(mtime));
   song->set_mtime(static_cast<qint64>(mtime));
 
-  ScopedPtr<StreamTagReader> stream = make_unique<StreamTagReader>(url, filename, size, token_type, access_token);
+  QNetworkAccessManager *network = stream_network_ && stream_network_->thread() == QThread::currentThread() ? stream_network_ : nullptr;
+  ScopedPtr<StreamTagReader> stream = make_unique<StreamTagReader>(url, filename, size, token_type, access_token, network);
   stream->PreCache();
 
   if (stream->num_requests() > 2) {
@@ -48,6 +48,8 @@
 #include "savetagcoverdata.h"
 #include "tagid3v2version.h"
 
+class QNetworkAccessManager;
+
 #undef TStringToQString
 #undef QStringToTString
 
@@ -71,6 +73,9 @@ class TagReaderTagLib : public TagReaderBase {
   TagReaderResult ReadFile(const QString &filename, Song *song) const override;
 #ifdef HAVE_STREAMTAGREADER
   TagReaderResult ReadStream(const QUrl &url, const QString &filename, const quint64 size, const quint64 mtime, const QString &token_type, const QString &access_token, Song *song) const override;
+
+  // Network access manager used for reading streams from its thread, so the connections are reused between files.
+  void set_stream_network(QNetworkAccessManager *network) { stream_network_ = network; }
 #endif
 
   TagReaderResult WriteFile(const QString &filename, const Song &song, const SaveTagsOptions save_tags_options, const SaveTagCoverData &save_tag_cover_data, const TagID3v2Version tag_id3v2_version) const override;
@@ -129,6 +134,9 @@ class TagReaderTagLib : public TagReaderBase {
 
  private:
   FileRefFactory *factory_;
+#ifdef HAVE_STREAMTAGREADER
+  QNetworkAccessManager *stream_network_;
+#endif
 
   Q_DISABLE_COPY(TagReaderTagLib)
 };
@@ -56,8 +56,10 @@
 #include <QShowEvent>
 #include <QCloseEvent>
 
+#include "includes/shared_ptr.h"
 #include "core/iconloader.h"
 #include "core/settings.h"
+#include "core/taskmanager.h"
 #include "constants/filefilterconstants.h"
 #include "constants/transcodersettings.h"
 #include "utilities/screenutils.h"
@@ -87,8 +89,9 @@ static bool ComparePresetsByName(const TranscoderPreset &left, const TranscoderP
   return left.name_ < right.name_;
 }
 
-TranscodeDialog::TranscodeDialog(QMainWindow *mainwindow, QWidget *parent)
+TranscodeDialog::TranscodeDialog(const SharedPtr<TaskManager> task_manager, QMainWindow *mainwindow, QWidget *parent)
     : QDialog(parent),
+      task_manager_(task_manager),
       mainwindow_(mainwindow),
       ui_(new Ui_TranscodeDialog),
       log_ui_(new Ui_TranscodeLogDialog),
@@ -96,7 +99,8 @@ TranscodeDialog::TranscodeDialog(QMainWindow *mainwindow, QWidget *parent)
       transcoder_(new Transcoder(this)),
       queued_(0),
       finished_success_(0),
-      finished_failed_(0) {
+      finished_failed_(0),
+      task_id_(-1) {
 
   ui_->setupUi(this);
 
@@ -155,6 +159,7 @@ TranscodeDialog::TranscodeDialog(QMainWindow *mainwindow, QWidget *parent)
   QObject::connect(transcoder_, &Transcoder::JobComplete, this, &TranscodeDialog::JobComplete);
   QObject::connect(transcoder_, &Transcoder::LogLine, this, &TranscodeDialog::LogLine);
   QObject::connect(transcoder_, &Transcoder::AllJobsComplete, this, &TranscodeDialog::AllJobsComplete);
+  QObject::connect(transcoder_, &Transcoder::ThroughputChanged, this, &TranscodeDialog::ThroughputChanged);
 
 }
 
@@ -227,9 +232,14 @@ void TranscodeDialog::SetWorking(bool working) {
 
   if (working) {
     progress_timer_.start(kProgressInterval, this);
+    if (task_id_ == -1) task_id_ = task_manager_->StartTask(tr("Transcoding files"));
   }
   else {
     progress_timer_.stop();
+    if (task_id_ != -1) {
+      task_manager_->SetTaskFinished(task_id_);
+      task_id_ = -1;
+    }
   }
 
 }
@@ -259,6 +269,7 @@ void TranscodeDialog::Start() {
   queued_ = file_model->rowCount();
   finished_success_ = 0;
   finished_failed_ = 0;
+  throughput_.clear();
   UpdateStatusText();
 
   // Start transcoding
@@ -304,6 +315,10 @@ void TranscodeDialog::UpdateProgress() {
 
   ui_->progress_bar->setValue(progress);
 
+  if (task_id_ != -1) {
+    task_manager_->SetTaskProgress(task_id_, static_cast<quint64>(progress), static_cast<quint64>(ui_->progress_bar->maximum()));
+  }
+
 }
 
 void TranscodeDialog::UpdateStatusText() {
@@ -322,10 +337,25 @@ void TranscodeDialog::UpdateStatusText() {
     sections << u"<font color=\"#b60000\">"_s + tr("%n failed", "", finished_failed_) + u"</font>"_s;
   }
 
+  if (queued_ && !throughput_.isEmpty()) {
+    sections << throughput_;
+  }
+
   ui_->progress_text->setText(sections.join(", "_L1));
 
 }
 
+void TranscodeDialog::ThroughputChanged(const double realtime_factor, const double bytes_per_second) {
+
+  throughput_ = Transcoder::ThroughputText(realtime_factor, bytes_per_second);
+  UpdateStatusText();
+
+  if (task_id_ != -1) {
+    task_manager_->SetTaskName(task_id_, tr("Transcoding files (%1)").arg(throughput_));
+  }
+
+}
+
 void TranscodeDialog::AllJobsComplete() {
   SetWorking(false);
 }
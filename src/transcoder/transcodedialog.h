@@ -30,12 +30,15 @@
 #include <QString>
 #include <QStringList>
 
+#include "includes/shared_ptr.h"
+
 class QWidget;
 class QMainWindow;
 class QPushButton;
 class QTimerEvent;
 class QShowEvent;
 class QCloseEvent;
+class TaskManager;
 class Transcoder;
 class Ui_TranscodeDialog;
 class Ui_TranscodeLogDialog;
@@ -45,7 +48,7 @@ class TranscodeDialog : public QDialog {
   Q_OBJECT
 
  public:
-  explicit TranscodeDialog(QMainWindow *mainwindow, QWidget *parent = nullptr);
+  explicit TranscodeDialog(const SharedPtr<TaskManager> task_manager, QMainWindow *mainwindow, QWidget *parent = nullptr);
   ~TranscodeDialog() override;
 
   void SetFilenames(const QStringList &filenames);
@@ -73,6 +76,7 @@ class TranscodeDialog : public QDialog {
   void Cancel();
   void JobComplete(const QString &input, const QString &output, bool success);
   void AllJobsComplete();
+  void ThroughputChanged(const double realtime_factor, const double bytes_per_second);
   void LogLine(const QString &message);
   void Options();
   void AddDestination();
@@ -80,6 +84,7 @@ class TranscodeDialog : public QDialog {
   void reject() override;
 
  private:
+  const SharedPtr<TaskManager> task_manager_;
   QMainWindow *mainwindow_;
   Ui_TranscodeDialog *ui_;
   Ui_TranscodeLogDialog *log_ui_;
@@ -98,6 +103,8 @@ class TranscodeDialog : public QDialog {
   int queued_;
   int finished_success_;
   int finished_failed_;
+  int task_id_;
+  QString throughput_;
 };
 
 #endif  // TRANSCODEDIALOG_H
@@ -25,6 +25,8 @@
 
 #include <algorithm>
 #include <memory>
+#include <ctime>
+#include <utility>
 
 #include <glib.h>
 #include <glib/gtypes.h>
@@ -40,6 +42,7 @@
 #include <QVariant>
 #include <QString>
 #include <QSettings>
+#include <QTimerEvent>
 
 #include "includes/shared_ptr.h"
 #include "core/logging.h"
@@ -47,11 +50,22 @@
 #include "core/signalchecker.h"
 #include "core/settings.h"
 #include "constants/transcodersettings.h"
+#include "constants/timeconstants.h"
 #include "transcoder.h"
 
 using std::make_shared;
 using namespace Qt::Literals::StringLiterals;
 
+namespace {
+constexpr int kSampleInterval = 2000;
+// Above this share of all cores the jobs are CPU bound, and more threads would only slow each other down.
+constexpr double kCpuSaturation = 0.9;
+// An extra thread has to improve the throughput by at least this much, otherwise the disk is the bottleneck.
+constexpr double kMinThroughputGain = 0.05;
+constexpr int kThreadsProbeDelay = 5;
+constexpr double kRealtimeFactorWeight = 0.3;
+}  // namespace
+
 int Transcoder::JobFinishedEvent::sEventType = -1;
 
 TranscoderPreset::TranscoderPreset(const Song::FileType filetype, const QString &name, const QString &extension, const QString &codec_mimetype, const QString &muxer_mimetype)
@@ -196,7 +210,16 @@ void Transcoder::JobState::PostFinished(const bool success) {
 Transcoder::Transcoder(QObject *parent, const QString &settings_postfix)
     : QObject(parent),
       max_threads_(QThread::idealThreadCount()),
-      settings_postfix_(settings_postfix) {
+      threads_limit_(std::max(1, QThread::idealThreadCount() / 2)),
+      settings_postfix_(settings_postfix),
+      sample_cpu_clock_(0),
+      finished_bytes_(0),
+      finished_nsec_(0),
+      sampled_bytes_(0),
+      sampled_nsec_(0),
+      last_bytes_per_second_(0.0),
+      last_threads_limit_(0),
+      threads_probe_delay_(0) {
 
   if (JobFinishedEvent::sEventType == -1)
     JobFinishedEvent::sEventType = QEvent::registerEventType();
@@ -321,13 +344,29 @@ void Transcoder::AddJob(const QString &input, const TranscoderPreset &preset, co
   job.input = input;
   job.preset = preset;
   job.output = output;
+  job.input_size = QFileInfo(input).size();
   queued_jobs_ << job;
 
 }
 
 void Transcoder::Start() {
 
-  Q_EMIT LogLine(tr("Transcoding %1 files using %2 threads").arg(queued_jobs_.count()).arg(max_threads()));
+  Q_EMIT LogLine(tr("Transcoding %1 files using %2 threads").arg(queued_jobs_.count()).arg(threads_limit()));
+
+  SortQueuedJobs();
+
+  if (current_jobs_.isEmpty()) {
+    total_elapsed_.start();
+    sample_elapsed_.start();
+    sample_cpu_clock_ = std::clock();
+    finished_bytes_ = 0;
+    finished_nsec_ = 0;
+    sampled_bytes_ = 0;
+    sampled_nsec_ = 0;
+    last_bytes_per_second_ = 0.0;
+    last_threads_limit_ = 0;
+  }
+  if (!sample_timer_.isActive()) sample_timer_.start(kSampleInterval, this);
 
   Q_FOREVER {
     StartJobStatus status = MaybeStartNextJob();
@@ -338,9 +377,16 @@ void Transcoder::Start() {
 
 Transcoder::StartJobStatus Transcoder::MaybeStartNextJob() {
 
-  if (current_jobs_.count() >= max_threads()) return StartJobStatus::AllThreadsBusy;
+  if (current_jobs_.count() >= threads_limit()) return StartJobStatus::AllThreadsBusy;
   if (queued_jobs_.isEmpty()) {
     if (current_jobs_.isEmpty()) {
+      if (sample_timer_.isActive()) {
+        sample_timer_.stop();
+        if (finished_bytes_ > 0 && total_elapsed_.isValid() && total_elapsed_.elapsed() > 0) {
+          const double seconds = static_cast<double>(total_elapsed_.elapsed()) / 1000.0;
+          Q_EMIT LogLine(tr("Finished transcoding in %1 seconds (%2)").arg(seconds, 0, 'f', 1).arg(ThroughputText(static_cast<double>(finished_nsec_) / (seconds * kNsecPerSec), static_cast<double>(finished_bytes_) / seconds)));
+        }
+      }
       Q_EMIT AllJobsComplete();
     }
 
@@ -478,6 +524,7 @@ bool Transcoder::StartJob(const Job &job) {
   }
 
   // Start the pipeline
+  state->timer_.start();
   gst_element_set_state(state->pipeline_, GST_STATE_PLAYING);
 
   // GStreamer now transcodes in another thread, so we can return now and do something else.
@@ -524,6 +571,8 @@ bool Transcoder::event(QEvent *e) {
       }
     }
 
+    JobFinished(**it, finished_event->success_);
+
     // Remove it from the list - this will also destroy the GStreamer pipeline
     current_jobs_.erase(it);
 
@@ -540,10 +589,159 @@ bool Transcoder::event(QEvent *e) {
 
 }
 
+void Transcoder::JobFinished(const JobState &state, const bool success) {
+
+  if (!success || !state.pipeline_) return;
+
+  gint64 duration = 0;
+  gst_element_query_duration(state.pipeline_, GST_FORMAT_TIME, &duration);
+  finished_bytes_ += state.job_.input_size;
+  if (duration <= 0) return;
+  finished_nsec_ += duration;
+
+  const qint64 elapsed = state.timer_.elapsed();
+  if (elapsed <= 0) return;
+
+  const double realtime_factor = static_cast<double>(duration) / (static_cast<double>(elapsed) * kNsecPerMsec);
+  const QString &preset_name = state.job_.preset.name_;
+  if (realtime_factors_.contains(preset_name)) {
+    realtime_factors_[preset_name] = (realtime_factors_[preset_name] * (1.0 - kRealtimeFactorWeight)) + (realtime_factor * kRealtimeFactorWeight);
+  }
+  else {
+    realtime_factors_[preset_name] = realtime_factor;
+    // The first speed of a preset can change the order of the queued jobs, later ones only refine it.
+    SortQueuedJobs();
+  }
+
+  qLog(Debug) << "Transcoded" << state.job_.input << "to" << preset_name << "at" << realtime_factor << "x realtime";
+
+}
+
+void Transcoder::SortQueuedJobs() {
+
+  // Presets without a finished job yet are assumed to be as fast as the average of the others.
+  double default_realtime_factor = 1.0;
+  if (!realtime_factors_.isEmpty()) {
+    double realtime_factors_sum = 0.0;
+    for (const double realtime_factor : std::as_const(realtime_factors_)) {
+      realtime_factors_sum += realtime_factor;
+    }
+    default_realtime_factor = realtime_factors_sum / static_cast<double>(realtime_factors_.count());
+  }
+
+  // Start the jobs expected to take the longest first, so a long job started last doesn't leave the other threads idle at the end.
+  // A job takes longer the larger the file is, and the slower its preset is.
+  const auto job_cost = [this, default_realtime_factor](const Job &job) {
+    return static_cast<double>(job.input_size) / realtime_factors_.value(job.preset.name_, default_realtime_factor);
+  };
+  std::stable_sort(queued_jobs_.begin(), queued_jobs_.end(), [&job_cost](const Job &a, const Job &b) { return job_cost(a) > job_cost(b); });
+
+}
+
+void Transcoder::timerEvent(QTimerEvent *e) {
+
+  if (e->timerId() == sample_timer_.timerId()) {
+    SampleThroughput();
+    return;
+  }
+
+  QObject::timerEvent(e);
+
+}
+
+void Transcoder::SampleThroughput() {
+
+  const qint64 elapsed = sample_elapsed_.restart();
+  if (elapsed <= 0) return;
+
+  // Count finished jobs fully and running jobs by their position, so the throughput doesn't jump when a large file finishes.
+  qint64 processed_bytes = finished_bytes_;
+  qint64 processed_nsec = finished_nsec_;
+  for (const SharedPtr<JobState> &state : std::as_const(current_jobs_)) {
+    if (!state->pipeline_) continue;
+    gint64 position = 0;
+    gint64 duration = 0;
+    gst_element_query_position(state->pipeline_, GST_FORMAT_TIME, &position);
+    gst_element_query_duration(state->pipeline_, GST_FORMAT_TIME, &duration);
+    if (position <= 0 || duration <= 0) continue;
+    processed_nsec += position;
+    processed_bytes += static_cast<qint64>(static_cast<double>(state->job_.input_size) * (static_cast<double>(position) / static_cast<double>(duration)));
+  }
+
+  const double seconds = static_cast<double>(elapsed) / 1000.0;
+  const double bytes_per_second = static_cast<double>(std::max(static_cast<qint64>(0), processed_bytes - sampled_bytes_)) / seconds;
+  const double realtime_factor = static_cast<double>(std::max(static_cast<qint64>(0), processed_nsec - sampled_nsec_)) / (seconds * kNsecPerSec);
+  sampled_bytes_ = processed_bytes;
+  sampled_nsec_ = processed_nsec;
+
+  // CPU time used by the whole process across all cores during the last sample.
+  const std::clock_t cpu_clock = std::clock();
+  const double cpu_seconds = static_cast<double>(cpu_clock - sample_cpu_clock_) / CLOCKS_PER_SEC;
+  sample_cpu_clock_ = cpu_clock;
+  const double cpu_usage = cpu_seconds / (seconds * std::max(1, QThread::idealThreadCount()));
+
+  Q_EMIT ThroughputChanged(realtime_factor, bytes_per_second);
+
+  AdjustThreadsLimit(realtime_factor, bytes_per_second, cpu_usage);
+
+}
+
+void Transcoder::AdjustThreadsLimit(const double realtime_factor, const double bytes_per_second, const double cpu_usage) {
+
+  const int current_threads_limit = threads_limit();
+  threads_limit_ = NextThreadsLimit(bytes_per_second, cpu_usage, static_cast<int>(current_jobs_.count()), !queued_jobs_.isEmpty());
+
+  if (threads_limit_ != current_threads_limit) {
+    Q_EMIT LogLine(tr("Using %1 threads at %2").arg(threads_limit_).arg(ThroughputText(realtime_factor, bytes_per_second)));
+    Q_FOREVER {
+      const StartJobStatus status = MaybeStartNextJob();
+      if (status == StartJobStatus::AllThreadsBusy || status == StartJobStatus::NoMoreJobs) break;
+    }
+  }
+
+}
+
+int Transcoder::NextThreadsLimit(const double bytes_per_second, const double cpu_usage, const int running_jobs, const bool jobs_queued) {
+
+  const int current_threads_limit = threads_limit();
+  int next_threads_limit = current_threads_limit;
+
+  if (cpu_usage > kCpuSaturation) {
+    if (current_threads_limit > 1 && running_jobs >= current_threads_limit) {
+      next_threads_limit = current_threads_limit - 1;
+    }
+    threads_probe_delay_ = kThreadsProbeDelay;
+  }
+  else if (last_threads_limit_ > 0 && current_threads_limit > last_threads_limit_ && bytes_per_second < last_bytes_per_second_ * (1.0 + kMinThroughputGain)) {
+    // The extra thread didn't help, go back and wait a while before trying again.
+    next_threads_limit = last_threads_limit_;
+    threads_probe_delay_ = kThreadsProbeDelay;
+  }
+  else if (threads_probe_delay_ > 0) {
+    --threads_probe_delay_;
+  }
+  else if (current_threads_limit < max_threads_ && running_jobs >= current_threads_limit && jobs_queued) {
+    next_threads_limit = current_threads_limit + 1;
+  }
+
+  last_threads_limit_ = current_threads_limit;
+  last_bytes_per_second_ = bytes_per_second;
+
+  return next_threads_limit;
+
+}
+
+QString Transcoder::ThroughputText(const double realtime_factor, const double bytes_per_second) {
+
+  return tr("%1x realtime, %2 MB/s").arg(realtime_factor, 0, 'f', 1).arg(bytes_per_second / (1024.0 * 1024.0), 0, 'f', 1);
+
+}
+
 void Transcoder::Cancel() {
 
   // Remove all pending jobs
   queued_jobs_.clear();
+  sample_timer_.stop();
 
   // Stop the running ones
   JobStateList::iterator it = current_jobs_.begin();
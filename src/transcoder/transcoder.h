@@ -28,13 +28,19 @@
 #include <glib-object.h>
 #include <gst/gst.h>
 
+#include <algorithm>
+#include <ctime>
+
 #include <QObject>
 #include <QList>
 #include <QMap>
+#include <QHash>
 #include <QMetaType>
 #include <QSet>
 #include <QString>
 #include <QEvent>
+#include <QElapsedTimer>
+#include <QBasicTimer>
 
 #include "includes/shared_ptr.h"
 #include "core/song.h"
@@ -54,6 +60,8 @@ Q_DECLARE_METATYPE(TranscoderPreset)
 class Transcoder : public QObject {
   Q_OBJECT
 
+  friend class TranscoderTest;
+
  public:
   explicit Transcoder(QObject *parent = nullptr, const QString &settings_postfix = QLatin1String(""));
 
@@ -64,6 +72,14 @@ class Transcoder : public QObject {
   int max_threads() const { return max_threads_; }
   void set_max_threads(int count) { max_threads_ = count; }
 
+  // Number of jobs currently allowed to run, adjusted between 1 and max_threads() from the observed CPU usage and throughput.
+  int threads_limit() const { return std::min(threads_limit_, max_threads_); }
+
+  // Average speed of finished jobs for a preset, as a multiple of realtime, or 0 if no job with the preset has finished yet.
+  double RealtimeFactor(const TranscoderPreset &preset) const { return realtime_factors_.value(preset.name_, 0.0); }
+
+  static QString ThroughputText(const double realtime_factor, const double bytes_per_second);
+
   static QString GetFile(const QString &input, const TranscoderPreset &preset, const QString &output = QString());
   void AddJob(const QString &input, const TranscoderPreset &preset, const QString &output);
 
@@ -78,16 +94,20 @@ class Transcoder : public QObject {
   void JobComplete(const QString &input, const QString &output, const bool success);
   void LogLine(const QString &message);
   void AllJobsComplete();
+  void ThroughputChanged(const double realtime_factor, const double bytes_per_second);
 
  protected:
   bool event(QEvent *e) override;
+  void timerEvent(QTimerEvent *e) override;
 
  private:
   // The description of a file to transcode - lives in the main thread.
   struct Job {
+    Job() : input_size(0) {}
     QString input;
     QString output;
     TranscoderPreset preset;
+    qint64 input_size;
   };
 
   // State held by a job and shared across gstreamer callbacks - lives in the job's thread.
@@ -106,6 +126,7 @@ class Transcoder : public QObject {
     Transcoder *parent_;
     GstElement *pipeline_;
     GstElement *convert_element_;
+    QElapsedTimer timer_;
 
    private:
     Q_DISABLE_COPY(JobState)
@@ -133,6 +154,11 @@ class Transcoder : public QObject {
 
   StartJobStatus MaybeStartNextJob();
   bool StartJob(const Job &job);
+  void JobFinished(const JobState &state, const bool success);
+  void SortQueuedJobs();
+  void SampleThroughput();
+  void AdjustThreadsLimit(const double realtime_factor, const double bytes_per_second, const double cpu_usage);
+  int NextThreadsLimit(const double bytes_per_second, const double cpu_usage, const int running_jobs, const bool jobs_queued);
 
   GstElement *CreateElement(const QString &factory_name, GstElement *bin = nullptr, const QString &name = QString());
   GstElement *CreateElementForMimeType(GstElementFactoryListType element_type, const QString &mime_type, GstElement *bin = nullptr);
@@ -145,9 +171,24 @@ class Transcoder : public QObject {
   using JobStateList = QList<SharedPtr<JobState>>;
 
   int max_threads_;
+  int threads_limit_;
   QList<Job> queued_jobs_;
   JobStateList current_jobs_;
   QString settings_postfix_;
+
+  QHash<QString, double> realtime_factors_;
+
+  QBasicTimer sample_timer_;
+  QElapsedTimer sample_elapsed_;
+  QElapsedTimer total_elapsed_;
+  std::clock_t sample_cpu_clock_;
+  qint64 finished_bytes_;
+  qint64 finished_nsec_;
+  qint64 sampled_bytes_;
+  qint64 sampled_nsec_;
+  double last_bytes_per_second_;
+  int last_threads_limit_;
+  int threads_probe_delay_;
 };
 
 #endif  // TRANSCODER_H
@@ -24,9 +24,16 @@
 
 #ifdef Q_OS_UNIX
 #  include <unistd.h>
+#  include <sys/stat.h>
 #  include <cstring>
 #endif
 
+#ifdef Q_OS_LINUX
+#  include <fcntl.h>
+#  include <sys/ioctl.h>
+#  include <linux/fs.h>
+#endif
+
 #ifdef Q_OS_WIN32
 #  include <io.h>
 #endif
@@ -36,6 +43,8 @@
 #include <QIODevice>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QStorageInfo>
 
 #include "core/logging.h"
 #include "includes/scoped_ptr.h"
@@ -220,4 +229,84 @@ bool CopyFileContents(const QString &source, const QString &destination) {
 
 }
 
+// Whether both paths are on the same filesystem, so a file can be moved between them with a rename.
+bool OnSameFilesystem(const QString &path1, const QString &path2) {
+
+#ifdef Q_OS_UNIX
+  struct stat stat1 {};
+  struct stat stat2 {};
+  if (stat(QFile::encodeName(path1).constData(), &stat1) != 0 || stat(QFile::encodeName(path2).constData(), &stat2) != 0) {
+    return false;
+  }
+  return stat1.st_dev == stat2.st_dev;
+#else
+  const QStorageInfo storage1(QFileInfo(path1).absolutePath());
+  const QStorageInfo storage2(QFileInfo(path2).absolutePath());
+  return storage1.isValid() && storage2.isValid() && storage1.rootPath() == storage2.rootPath();
+#endif
+
+}
+
+// Copies source to destination, which must not exist.
+// On Linux the file is cloned (reflink) or copied inside the kernel with copy_file_range() when the filesystems allow it, otherwise this falls back to QFile::copy().
+bool CloneOrCopyFile(const QString &source, const QString &destination) {
+
+#ifdef Q_OS_LINUX
+  QFile source_file(source);
+  if (!source_file.open(QIODevice::ReadOnly)) {
+    qLog(Error) << "Failed to open" << source << "for reading:" << source_file.errorString();
+    return false;
+  }
+
+  QFile destination_file(destination);
+  if (!destination_file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+    qLog(Error) << "Failed to open" << destination << "for writing:" << destination_file.errorString();
+    return false;
+  }
+
+  bool success = false;
+#ifdef FICLONE
+  success = ioctl(destination_file.handle(), FICLONE, source_file.handle()) == 0;
+#endif
+  if (!success) {
+    qint64 remaining = source_file.size();
+    success = true;
+    while (remaining > 0) {
+      const ssize_t bytes_copied = copy_file_range(source_file.handle(), nullptr, destination_file.handle(), nullptr, static_cast<size_t>(remaining), 0);
+      if (bytes_copied <= 0) {
+        // Not supported between these filesystems (or by this kernel), copy in user space below.
+        success = false;
+        break;
+      }
+      remaining -= bytes_copied;
+    }
+  }
+
+  if (success) {
+    destination_file.setPermissions(source_file.permissions());
+    return true;
+  }
+
+  destination_file.close();
+  destination_file.remove();
+#endif  // Q_OS_LINUX
+
+  return QFile::copy(source, destination);
+
+}
+
+void PrefetchFile(const QString &filename) {
+
+#ifdef Q_OS_LINUX
+  // Ask the kernel to start reading the file into the page cache, this returns immediately.
+  const int fd = ::open(QFile::encodeName(filename).constData(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) return;
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  ::close(fd);
+#else
+  Q_UNUSED(filename)
+#endif
+
+}
+
 }  // namespace Utilities
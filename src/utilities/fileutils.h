@@ -33,6 +33,9 @@ bool CopyRecursive(const QString &source, const QString &destination);
 bool RemoveRecursive(const QString &path);
 bool FilenameOnGVFS(const QString &filename);
 bool CopyFileContents(const QString &source, const QString &destination);
+bool OnSameFilesystem(const QString &path1, const QString &path2);
+bool CloneOrCopyFile(const QString &source, const QString &destination);
+void PrefetchFile(const QString &filename);
 
 }  // namespace Utilities
 
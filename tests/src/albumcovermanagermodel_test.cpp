@@ -0,0 +1,141 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QString>
+#include <QUrl>
+#include <QImage>
+#include <QIcon>
+#include <QPixmap>
+#include <QColor>
+#include <QSignalSpy>
+
+#include "includes/shared_ptr.h"
+#include "collection/collectionbackend.h"
+#include "covermanager/albumcovermanagermodel.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+class AlbumCoverManagerModelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    QImage nocover(8, 8, QImage::Format_ARGB32);
+    nocover.fill(Qt::gray);
+    model_ = new AlbumCoverManagerModel(SharedPtr<CollectionBackend>(), QIcon(QPixmap::fromImage(nocover)));
+  }
+
+  void TearDown() override {
+    delete model_;
+  }
+
+  static CollectionBackend::Album MakeAlbum(const QString &album, const QUrl &art_manual = QUrl()) {
+    return CollectionBackend::Album(u"Artist"_s, album, false, QUrl(), art_manual, false, QList<QUrl>() << QUrl(u"file:///music/"_s + album + u"/01.flac"_s), Song::FileType::FLAC, QString());
+  }
+
+  static QImage MakeCover() {
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    return image;
+  }
+
+  AlbumCoverManagerModel *model_;
+};
+
+TEST_F(AlbumCoverManagerModelTest, DisplayText) {
+
+  model_->SetAlbums(CollectionBackend::AlbumList() << MakeAlbum(u"One"_s), true);
+  EXPECT_EQ(model_->rowCount(), 1);
+  EXPECT_EQ(model_->index(0).data(Qt::DisplayRole).toString(), u"Artist - One"_s);
+
+  model_->SetAlbums(CollectionBackend::AlbumList() << MakeAlbum(u"One"_s), false);
+  EXPECT_EQ(model_->index(0).data(Qt::DisplayRole).toString(), u"One"_s);
+
+}
+
+TEST_F(AlbumCoverManagerModelTest, NeedsCoverOnlyWithArt) {
+
+  model_->SetAlbums(CollectionBackend::AlbumList() << MakeAlbum(u"With"_s, QUrl(u"file:///covers/with.jpg"_s)) << MakeAlbum(u"Without"_s), true);
+
+  EXPECT_TRUE(model_->NeedsCover(0));
+  EXPECT_TRUE(model_->HasCover(0));
+  EXPECT_FALSE(model_->NeedsCover(1));
+  EXPECT_FALSE(model_->HasCover(1));
+
+}
+
+TEST_F(AlbumCoverManagerModelTest, LoadedCoverIsKept) {
+
+  model_->SetAlbums(CollectionBackend::AlbumList() << MakeAlbum(u"One"_s, QUrl(u"file:///covers/one.jpg"_s)), true);
+
+  QSignalSpy spy(model_, &AlbumCoverManagerModel::dataChanged);
+  model_->SetCover(0, MakeCover());
+
+  EXPECT_EQ(spy.count(), 1);
+  EXPECT_FALSE(model_->NeedsCover(0));
+  EXPECT_TRUE(model_->HasCover(0));
+
+}
+
+TEST_F(AlbumCoverManagerModelTest, MissingCoverIsNotLoadedAgain) {
+
+  model_->SetAlbums(CollectionBackend::AlbumList() << MakeAlbum(u"One"_s, QUrl(u"file:///covers/missing.jpg"_s)), true);
+
+  model_->SetNoCover(0);
+  EXPECT_FALSE(model_->NeedsCover(0));
+  EXPECT_FALSE(model_->HasCover(0));
+
+}
+
+TEST_F(AlbumCoverManagerModelTest, ChangedArtDropsIcon) {
+
+  model_->SetAlbums(CollectionBackend::AlbumList() << MakeAlbum(u"One"_s, QUrl(u"file:///covers/one.jpg"_s)), true);
+  model_->SetCover(0, MakeCover());
+  ASSERT_FALSE(model_->NeedsCover(0));
+
+  EXPECT_TRUE(model_->setData(model_->index(0), QUrl(u"file:///covers/new.jpg"_s), AlbumCoverManagerModel::Role_ArtManual));
+  EXPECT_EQ(model_->album(0).art_manual, QUrl(u"file:///covers/new.jpg"_s));
+  EXPECT_TRUE(model_->NeedsCover(0));
+
+}
+
+TEST_F(AlbumCoverManagerModelTest, IconCacheIsBounded) {
+
+  CollectionBackend::AlbumList albums;
+  for (int i = 0; i < 100; ++i) {
+    albums << MakeAlbum(QString::number(i), QUrl(u"file:///covers/"_s + QString::number(i) + u".jpg"_s));
+  }
+  model_->SetAlbums(albums, true);
+
+  // 1 MB per cover, more than fits in the cache.
+  QImage image(512, 512, QImage::Format_ARGB32);
+  image.fill(Qt::blue);
+  for (int i = 0; i < 100; ++i) {
+    model_->SetCover(i, image);
+  }
+
+  // The least recently used icons were dropped, and will be loaded again when they come into view.
+  EXPECT_TRUE(model_->NeedsCover(0));
+  EXPECT_FALSE(model_->NeedsCover(99));
+
+}
+
+}  // namespace
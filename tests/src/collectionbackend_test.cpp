@@ -318,6 +318,61 @@ TEST_F(SingleSong, DeleteSongs) {
 
 }
 
+TEST_F(SingleSong, MayContainUrl) {
+
+  // The index is loaded on the first lookup and updated when songs are added.
+  EXPECT_FALSE(backend_->MayContainUrl(song_.url()));
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  EXPECT_TRUE(backend_->MayContainUrl(song_.url()));
+  EXPECT_FALSE(backend_->MayContainUrl(QUrl::fromLocalFile(u"bar.flac"_s)));
+
+  // Deleting all songs clears it.
+  backend_->DeleteAll();
+  EXPECT_FALSE(backend_->MayContainUrl(song_.url()));
+
+}
+
+TEST_F(SingleSong, GetSongsByUrls) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song song2 = MakeDummySong(1);
+  song2.set_title(u"Title 2"_s);
+  song2.set_url(QUrl::fromLocalFile(u"bar.flac"_s));
+  backend_->AddOrUpdateSongs(SongList() << song2);
+
+  const SongList songs = backend_->GetSongsByUrls(QList<QUrl>() << song_.url() << song2.url() << QUrl::fromLocalFile(u"baz.flac"_s));
+  ASSERT_EQ(2, songs.count());
+  QStringList titles;
+  for (const Song &song : songs) titles << song.title();
+  titles.sort();
+  EXPECT_EQ(QStringList() << u"Title"_s << u"Title 2"_s, titles);
+
+}
+
+TEST_F(SingleSong, LoadedSongsShareStrings) {
+
+  AddDummySong();
+  if (HasFatalFailure()) return;
+
+  Song song2 = MakeDummySong(1);
+  song2.set_title(u"Title 2"_s);
+  song2.set_artist(u"Artist"_s);
+  song2.set_album(u"Album"_s);
+  song2.set_url(QUrl::fromLocalFile(u"bar.flac"_s));
+  backend_->AddOrUpdateSongs(SongList() << song2);
+
+  const SongList songs = backend_->GetSongsByUrls(QList<QUrl>() << song_.url() << song2.url());
+  ASSERT_EQ(2, songs.count());
+  EXPECT_EQ(songs[0].artist().constData(), songs[1].artist().constData());
+  EXPECT_EQ(songs[0].album().constData(), songs[1].album().constData());
+
+}
+
 TEST_F(SingleSong, MarkSongsUnavailable) {
 
   AddDummySong();
@@ -792,4 +847,66 @@ TEST_F(ChangeDirPath, RewritesSubdirectoryPaths) {
 
 }
 
+class CompilationsNeedUpdating : public CollectionBackendTest {
+ protected:
+  void SetUp() override {
+    CollectionBackendTest::SetUp();
+    backend_->AddDirectory(u"/music"_s);
+  }
+
+  static Song MakeSong(const QString &path, const QString &artist, const QString &album) {
+    Song song = MakeDummySong(1);
+    song.set_url(QUrl::fromLocalFile(path));
+    song.set_artist(artist);
+    song.set_album(album);
+    song.set_title(QFileInfo(path).baseName());
+    return song;
+  }
+};
+
+TEST_F(CompilationsNeedUpdating, OnlyChangedSongsAreEmitted) {
+
+  backend_->AddOrUpdateSongs(SongList() << MakeSong(u"/music/va/01.flac"_s, u"Artist 1"_s, u"Various"_s)
+                                        << MakeSong(u"/music/va/02.flac"_s, u"Artist 2"_s, u"Various"_s)
+                                        << MakeSong(u"/music/album/01.flac"_s, u"Artist 1"_s, u"Album"_s)
+                                        << MakeSong(u"/music/album/02.flac"_s, u"Artist 1"_s, u"Album"_s)
+                                        << MakeSong(u"/music/other/01.flac"_s, u"Artist 3"_s, u"Various"_s));
+
+  QSignalSpy changed_spy(&*backend_, &CollectionBackend::SongsChanged);
+
+  backend_->CompilationsNeedUpdating();
+
+  // Only the two songs by different artists in the same directory are compilations.
+  ASSERT_EQ(1, changed_spy.count());
+  const SongList songs_changed = *(reinterpret_cast<SongList*>(changed_spy[0][0].data()));
+  ASSERT_EQ(2, songs_changed.count());
+  for (const Song &song : songs_changed) {
+    EXPECT_EQ(u"Various"_s, song.album());
+    EXPECT_TRUE(song.compilation_detected());
+  }
+
+  const SongList compilation_songs = backend_->GetCompilationSongs(u"Various"_s);
+  EXPECT_EQ(2, compilation_songs.count());
+
+  // Nothing changed, so a second pass should not emit anything.
+  changed_spy.clear();
+  backend_->CompilationsNeedUpdating();
+  EXPECT_EQ(0, changed_spy.count());
+
+  // Make the album single-artist again, the flag should be cleared for the remaining song.
+  Song song = backend_->GetSongByUrl(QUrl::fromLocalFile(u"/music/va/02.flac"_s));
+  ASSERT_TRUE(song.is_valid());
+  backend_->DeleteSongs(SongList() << song);
+
+  changed_spy.clear();
+  backend_->CompilationsNeedUpdating();
+  ASSERT_EQ(1, changed_spy.count());
+  const SongList songs_cleared = *(reinterpret_cast<SongList*>(changed_spy[0][0].data()));
+  ASSERT_EQ(1, songs_cleared.count());
+  EXPECT_EQ(u"01"_s, songs_cleared[0].title());
+  EXPECT_FALSE(songs_cleared[0].compilation_detected());
+  EXPECT_TRUE(backend_->GetCompilationSongs(u"Various"_s).isEmpty());
+
+}
+
 } // namespace
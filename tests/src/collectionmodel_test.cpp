@@ -627,4 +627,78 @@ TEST_F(CollectionModelTest, BulkUpdatePreservesViewState) {
 
 }
 
+TEST_F(CollectionModelTest, LazyLoadingFetchesChildrenOnDemand) {
+
+  backend_->AddDirectory(u"/tmp"_s);
+  backend_->AddOrUpdateSongs(MakeSongs(200, u"lazy"_s));
+  Drain();
+  ASSERT_EQ(200, model_->song_nodes().count());
+
+  model_->SetLazyLoading(true);
+  Drain();
+
+  // Only the artist containers are loaded.
+  EXPECT_TRUE(model_->song_nodes().isEmpty());
+  ASSERT_EQ(50, model_->container_nodes(0).count());
+  EXPECT_TRUE(model_->container_nodes(1).isEmpty());
+
+  CollectionItem *artist = model_->container_nodes(0).value(u"lazy_artist_0"_s);
+  ASSERT_TRUE(artist);
+  const QModelIndex artist_index = model_->ItemToIndex(artist);
+  EXPECT_TRUE(model_->hasChildren(artist_index));
+  EXPECT_TRUE(model_->canFetchMore(artist_index));
+  EXPECT_EQ(0, model_->rowCount(artist_index));
+
+  // The children are fetched in the background.
+  model_->fetchMore(artist_index);
+  EXPECT_FALSE(model_->canFetchMore(artist_index));
+  EXPECT_EQ(0, model_->rowCount(artist_index));
+  Drain();
+
+  EXPECT_FALSE(model_->canFetchMore(artist_index));
+  EXPECT_EQ(4, model_->rowCount(artist_index));
+  EXPECT_EQ(4, model_->song_nodes().count());
+
+  // Getting the songs of a container that is not expanded reads them without adding them to the model.
+  CollectionItem *other_artist = model_->container_nodes(0).value(u"lazy_artist_1"_s);
+  ASSERT_TRUE(other_artist);
+  EXPECT_EQ(4, model_->GetChildSongs(model_->ItemToIndex(other_artist)).count());
+  EXPECT_TRUE(model_->canFetchMore(model_->ItemToIndex(other_artist)));
+  EXPECT_EQ(4, model_->song_nodes().count());
+
+  // Searching loads the rest in the background.
+  collection_filter_->SetFilterString(u"lazy_title_199"_s);
+  EXPECT_EQ(4, model_->song_nodes().count());
+  Drain();
+  EXPECT_EQ(200, model_->song_nodes().count());
+  EXPECT_FALSE(model_->canFetchMore(model_->ItemToIndex(other_artist)));
+
+}
+
+TEST_F(CollectionModelTest, LazyLoadingAppliesUpdatesAfterFetch) {
+
+  backend_->AddDirectory(u"/tmp"_s);
+  backend_->AddOrUpdateSongs(MakeSongs(200, u"lazy"_s));
+  Drain();
+
+  model_->SetLazyLoading(true);
+  Drain();
+  ASSERT_TRUE(model_->song_nodes().isEmpty());
+
+  CollectionItem *artist = model_->container_nodes(0).value(u"lazy_artist_0"_s);
+  ASSERT_TRUE(artist);
+  const QModelIndex artist_index = model_->ItemToIndex(artist);
+  const SongList artist_songs = model_->GetChildSongs(artist_index);
+  ASSERT_EQ(4, artist_songs.count());
+
+  // A removal arriving while the container is fetched must not be undone by the fetched songs.
+  model_->fetchMore(artist_index);
+  model_->RemoveSongs(SongList() << artist_songs.first());
+  Drain();
+
+  EXPECT_EQ(3, model_->rowCount(artist_index));
+  EXPECT_EQ(3, model_->song_nodes().count());
+
+}
+
 }  // namespace
@@ -0,0 +1,166 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QUrl>
+#include <QStorageInfo>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/memorydatabase.h"
+#include "core/taskmanager.h"
+#include "constants/filesystemconstants.h"
+#include "collection/collectionlibrary.h"
+#include "collection/collectionbackend.h"
+#include "collection/collectiondirectory.h"
+#include "collection/collectionwatcher.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=returning-void-expression
+
+namespace {
+
+class CollectionWatcherTest : public ::testing::Test {
+ protected:
+  CollectionWatcherTest() : temp_dir_(QDir::current().filePath(u"collectionwatcher_test-XXXXXX"_s)) {}
+
+  void SetUp() override {
+
+    ASSERT_TRUE(temp_dir_.isValid());
+    path_ = temp_dir_.path();
+    // The watcher ignores directories on tmpfs.
+    if (kRejectedFileSystems.contains(QStorageInfo(path_).fileSystemType())) {
+      GTEST_SKIP() << "Temporary directory is on a rejected filesystem";
+    }
+
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    task_manager_ = make_shared<TaskManager>();
+    backend_ = make_shared<CollectionBackend>();
+    backend_->Init(database_, task_manager_, Song::Source::Collection, QLatin1String(CollectionLibrary::kSongsTable), QLatin1String(CollectionLibrary::kDirsTable), QLatin1String(CollectionLibrary::kSubdirsTable));
+    backend_->AddDirectory(path_);
+
+    filename_ = path_ + u"/song.flac"_s;
+    QFile file(filename_);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("data");
+    file.close();
+
+    const QFileInfo fileinfo(filename_);
+    Song song;
+    song.Init(u"Title"_s, u"Artist"_s, u"Album"_s, 123);
+    song.set_source(Song::Source::Collection);
+    song.set_directory_id(1);
+    song.set_url(QUrl::fromLocalFile(filename_));
+    song.set_basefilename(fileinfo.fileName());
+    song.set_filetype(Song::FileType::FLAC);
+    song.set_filesize(fileinfo.size());
+    song.set_mtime(fileinfo.lastModified().toSecsSinceEpoch());
+    song.set_ctime(fileinfo.lastModified().toSecsSinceEpoch());
+    backend_->AddOrUpdateSongs(SongList() << song);
+
+    CollectionDirectory dir;
+    dir.id = 1;
+    dir.path = path_;
+    CollectionSubdirectory subdir;
+    subdir.directory_id = 1;
+    subdir.path = path_;
+    subdir.mtime = QFileInfo(path_).lastModified().toSecsSinceEpoch();
+
+    // The subdirectory is unchanged since it was scanned, so adding the directory only starts watching it.
+    watcher_ = make_shared<CollectionWatcher>(Song::Source::Collection, task_manager_, nullptr, backend_);
+    watcher_->AddDirectory(dir, CollectionSubdirectoryList() << subdir);
+
+  }
+
+  QTemporaryDir temp_dir_;
+  QString path_;
+  QString filename_;
+  SharedPtr<MemoryDatabase> database_;
+  SharedPtr<TaskManager> task_manager_;
+  SharedPtr<CollectionBackend> backend_;
+  SharedPtr<CollectionWatcher> watcher_;
+};
+
+TEST_F(CollectionWatcherTest, MovedFileKeepsSong) {
+
+  const Song old_song = backend_->GetSongById(1);
+  ASSERT_TRUE(old_song.is_valid());
+
+  QSignalSpy spy_new_or_updated(&*watcher_, &CollectionWatcher::NewOrUpdatedSongs);
+  QSignalSpy spy_unavailable(&*watcher_, &CollectionWatcher::SongsUnavailable);
+  QSignalSpy spy_deleted(&*watcher_, &CollectionWatcher::SongsDeleted);
+
+  const QString new_filename = path_ + u"/renamed.flac"_s;
+  ASSERT_TRUE(QFile::rename(filename_, new_filename));
+
+  // The move is matched to the song in the database instead of reading the file again.
+  ASSERT_TRUE(spy_new_or_updated.wait(5000));
+  const SongList songs = spy_new_or_updated.first().first().value<SongList>();
+  ASSERT_EQ(1, songs.count());
+  EXPECT_EQ(old_song.id(), songs.first().id());
+  EXPECT_EQ(QUrl::fromLocalFile(new_filename), songs.first().url());
+  EXPECT_EQ(u"renamed.flac"_s, songs.first().basefilename());
+  EXPECT_EQ(u"Title"_s, songs.first().title());
+  EXPECT_EQ(0, spy_unavailable.count());
+  EXPECT_EQ(0, spy_deleted.count());
+
+}
+
+TEST_F(CollectionWatcherTest, RemovedFileMarksSongUnavailable) {
+
+  QSignalSpy spy_unavailable(&*watcher_, &CollectionWatcher::SongsUnavailable);
+
+  ASSERT_TRUE(QFile::remove(filename_));
+
+  ASSERT_TRUE(spy_unavailable.wait(5000));
+  const SongList songs = spy_unavailable.first().first().value<SongList>();
+  ASSERT_EQ(1, songs.count());
+  EXPECT_EQ(QUrl::fromLocalFile(filename_), songs.first().url());
+
+}
+
+TEST_F(CollectionWatcherTest, FileMovedOutMarksSongUnavailable) {
+
+  QTemporaryDir other_dir(QDir::current().filePath(u"collectionwatcher_test-XXXXXX"_s));
+  ASSERT_TRUE(other_dir.isValid());
+
+  QSignalSpy spy_unavailable(&*watcher_, &CollectionWatcher::SongsUnavailable);
+  QSignalSpy spy_new_or_updated(&*watcher_, &CollectionWatcher::NewOrUpdatedSongs);
+
+  ASSERT_TRUE(QFile::rename(filename_, other_dir.path() + u"/song.flac"_s));
+
+  // Without a matching IN_MOVED_TO the file is gone from the collection.
+  ASSERT_TRUE(spy_unavailable.wait(5000));
+  EXPECT_EQ(1, spy_unavailable.first().first().value<SongList>().count());
+  EXPECT_EQ(0, spy_new_or_updated.count());
+
+}
+
+}  // namespace
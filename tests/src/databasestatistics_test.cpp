@@ -0,0 +1,213 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+
+#include "includes/shared_ptr.h"
+#include "core/memorydatabase.h"
+#include "core/databasestatistics.h"
+#include "core/sqlquery.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+namespace {
+
+class DatabaseStatisticsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    statistics_ = DatabaseStatistics::Instance();
+    statistics_->Reset();
+    DatabaseStatistics::SetEnabled(true);
+  }
+
+  void TearDown() override {
+    DatabaseStatistics::SetEnabled(false);
+    statistics_->set_slow_threshold_msec(100);
+    statistics_->Reset();
+  }
+
+  SharedPtr<MemoryDatabase> database_;
+  DatabaseStatistics *statistics_;
+};
+
+TEST_F(DatabaseStatisticsTest, HistogramBuckets) {
+
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(0), 0);
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(99), 0);
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(100), 1);
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(9999), 2);
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(100000), 4);
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(1000000), 5);
+  EXPECT_EQ(DatabaseStatistics::HistogramBucket(100000000), 5);
+
+}
+
+TEST_F(DatabaseStatisticsTest, PreparedStatementIsCountedOnce) {
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  const QString statement = u"SELECT ROWID FROM songs WHERE title = :title"_s;
+  for (int i = 0; i < 3; ++i) {
+    SqlQuery q(db);
+    ASSERT_TRUE(q.prepare(statement));
+    q.BindValue(u":title"_s, QString::number(i));
+    ASSERT_TRUE(q.Exec());
+  }
+
+  const QHash<QString, DatabaseStatistics::StatementStats> statement_stats = statistics_->statement_stats();
+  ASSERT_TRUE(statement_stats.contains(statement));
+
+  const DatabaseStatistics::StatementStats &stats = statement_stats[statement];
+  EXPECT_EQ(stats.count, 3);
+  qint64 histogram_count = 0;
+  for (const qint64 bucket_count : stats.histogram) {
+    histogram_count += bucket_count;
+  }
+  EXPECT_EQ(histogram_count, 3);
+
+}
+
+TEST_F(DatabaseStatisticsTest, InlinedValuesAreCountedOnce) {
+
+  EXPECT_EQ(DatabaseStatistics::NormalizeStatement(u"SELECT ROWID FROM songs WHERE ROWID IN (1,2, 3) AND artist = 'O''Brien' AND year > -1"_s), u"SELECT ROWID FROM songs WHERE ROWID IN (?) AND artist = ? AND year > ?"_s);
+  EXPECT_EQ(DatabaseStatistics::NormalizeStatement(u"SELECT ROWID FROM device_1_songs WHERE title = :title"_s), u"SELECT ROWID FROM device_1_songs WHERE title = :title"_s);
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  for (int i = 1; i <= 3; ++i) {
+    QStringList ids;
+    for (int id = 0; id < i; ++id) {
+      ids << QString::number(id);
+    }
+    SqlQuery q(db);
+    ASSERT_TRUE(q.prepare(u"SELECT ROWID FROM songs WHERE ROWID IN (%1) AND year > %2"_s.arg(ids.join(u','), QString::number(i))));
+    ASSERT_TRUE(q.Exec());
+  }
+
+  const QHash<QString, DatabaseStatistics::StatementStats> statement_stats = statistics_->statement_stats();
+  ASSERT_EQ(statement_stats.count(), 1);
+  EXPECT_EQ(statement_stats.constBegin().key(), u"SELECT ROWID FROM songs WHERE ROWID IN (?) AND year > ?"_s);
+  EXPECT_EQ(statement_stats.constBegin().value().count, 3);
+
+}
+
+TEST_F(DatabaseStatisticsTest, StatementsAreCapped) {
+
+  for (int i = 0; i < DatabaseStatistics::kMaxStatements + 10; ++i) {
+    statistics_->AddStatement(u"SELECT ROWID FROM songs_%1"_s.arg(i), 1);
+  }
+
+  const QHash<QString, DatabaseStatistics::StatementStats> statement_stats = statistics_->statement_stats();
+  EXPECT_EQ(statement_stats.count(), DatabaseStatistics::kMaxStatements + 1);
+  ASSERT_TRUE(statement_stats.contains(DatabaseStatistics::OtherStatements()));
+  EXPECT_EQ(statement_stats[DatabaseStatistics::OtherStatements()].count, 10);
+
+}
+
+TEST_F(DatabaseStatisticsTest, DisabledRecordsNothing) {
+
+  DatabaseStatistics::SetEnabled(false);
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  SqlQuery q(db);
+  ASSERT_TRUE(q.prepare(u"SELECT ROWID FROM songs"_s));
+  ASSERT_TRUE(q.Exec());
+
+  EXPECT_TRUE(statistics_->statement_stats().isEmpty());
+  EXPECT_EQ(statistics_->mutex_stats().locks, 0);
+
+}
+
+TEST_F(DatabaseStatisticsTest, SlowQueryHasQueryPlan) {
+
+  statistics_->set_slow_threshold_msec(0);
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  SqlQuery q(db);
+  ASSERT_TRUE(q.prepare(u"SELECT ROWID FROM songs WHERE artist = :artist"_s));
+  q.BindValue(u":artist"_s, u"Artist"_s);
+  ASSERT_TRUE(q.Exec());
+
+  const QList<DatabaseStatistics::SlowEvent> slow_events = statistics_->slow_events();
+  ASSERT_FALSE(slow_events.isEmpty());
+
+  const DatabaseStatistics::SlowEvent &slow_event = slow_events.constLast();
+  EXPECT_EQ(slow_event.type, DatabaseStatistics::SlowEvent::Type::Query);
+  EXPECT_TRUE(slow_event.statement.contains(u"Artist"_s));
+  EXPECT_FALSE(slow_event.query_plan.isEmpty());
+
+}
+
+TEST_F(DatabaseStatisticsTest, ContendedMutexWaitIsRecorded) {
+
+  statistics_->set_slow_threshold_msec(10);
+
+  database_->Mutex()->lock();
+  QThread *thread = QThread::create([this]() {
+    QMutexLocker l(database_->Mutex());
+  });
+  thread->setObjectName(u"Waiting thread"_s);
+  thread->start();
+  QThread::msleep(50);
+  database_->Mutex()->unlock();
+  thread->wait();
+  delete thread;
+
+  const DatabaseStatistics::MutexStats mutex_stats = statistics_->mutex_stats();
+  EXPECT_EQ(mutex_stats.locks, 2);
+  EXPECT_EQ(mutex_stats.contended_locks, 1);
+  EXPECT_GE(mutex_stats.max_wait_usec, 10000);
+  EXPECT_GE(mutex_stats.max_hold_usec, 10000);
+
+  bool wait_found = false;
+  bool hold_found = false;
+  const QList<DatabaseStatistics::SlowEvent> slow_events = statistics_->slow_events();
+  for (const DatabaseStatistics::SlowEvent &slow_event : slow_events) {
+    if (slow_event.type == DatabaseStatistics::SlowEvent::Type::MutexWait) {
+      wait_found = true;
+      EXPECT_EQ(slow_event.thread_name, u"Waiting thread"_s);
+      EXPECT_EQ(slow_event.owner_thread_name, u"Main"_s);
+    }
+    else if (slow_event.type == DatabaseStatistics::SlowEvent::Type::MutexHold) {
+      hold_found = true;
+      EXPECT_EQ(slow_event.thread_name, u"Main"_s);
+    }
+  }
+  EXPECT_TRUE(wait_found);
+  EXPECT_TRUE(hold_found);
+
+}
+
+}  // namespace
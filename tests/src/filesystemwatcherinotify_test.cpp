@@ -0,0 +1,155 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QFile>
+#include <QDir>
+#include <QString>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+
+#include "core/filesystemwatcherinotify.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+class FileSystemWatcherInotifyTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    path_ = temp_dir_.path();
+    watcher_.AddPath(path_);
+  }
+
+  static void WriteFile(const QString &filename) {
+    QFile file(filename);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("data");
+    file.close();
+  }
+
+  QTemporaryDir temp_dir_;
+  QString path_;
+  FileSystemWatcherInotify watcher_;
+};
+
+TEST_F(FileSystemWatcherInotifyTest, SupportsFileEvents) {
+
+  EXPECT_TRUE(watcher_.SupportsFileEvents());
+
+}
+
+TEST_F(FileSystemWatcherInotifyTest, FailedWatchDisablesFileEvents) {
+
+  // A path that can't be watched means changes there are missed, so the collection still has to be scanned periodically.
+  const QString missing_path = path_ + u"/missing"_s;
+  watcher_.AddPath(missing_path);
+  EXPECT_EQ(1, watcher_.failed_watches());
+  EXPECT_FALSE(watcher_.SupportsFileEvents());
+
+  watcher_.RemovePath(missing_path);
+  EXPECT_EQ(0, watcher_.failed_watches());
+  EXPECT_TRUE(watcher_.SupportsFileEvents());
+
+}
+
+TEST_F(FileSystemWatcherInotifyTest, ReportsChangedFile) {
+
+  QSignalSpy spy_changed(&watcher_, &FileSystemWatcherInterface::FileChanged);
+  QSignalSpy spy_path(&watcher_, &FileSystemWatcherInterface::PathChanged);
+
+  const QString filename = path_ + u"/song.flac"_s;
+  WriteFile(filename);
+
+  ASSERT_TRUE(spy_changed.wait(2000));
+  EXPECT_EQ(filename, spy_changed.first().first().toString());
+  EXPECT_EQ(0, spy_path.count());
+
+}
+
+TEST_F(FileSystemWatcherInotifyTest, PairsMoves) {
+
+  const QString old_filename = path_ + u"/old.flac"_s;
+  const QString new_filename = path_ + u"/new.flac"_s;
+  WriteFile(old_filename);
+
+  QSignalSpy spy_changed(&watcher_, &FileSystemWatcherInterface::FileChanged);
+  ASSERT_TRUE(spy_changed.wait(2000));
+
+  QSignalSpy spy_moved(&watcher_, &FileSystemWatcherInterface::FileMoved);
+  QSignalSpy spy_removed(&watcher_, &FileSystemWatcherInterface::FileRemoved);
+  ASSERT_TRUE(QFile::rename(old_filename, new_filename));
+
+  ASSERT_TRUE(spy_moved.wait(2000));
+  EXPECT_EQ(old_filename, spy_moved.first().at(0).toString());
+  EXPECT_EQ(new_filename, spy_moved.first().at(1).toString());
+  EXPECT_EQ(0, spy_removed.count());
+
+}
+
+TEST_F(FileSystemWatcherInotifyTest, ReportsMoveOutAsRemoved) {
+
+  QTemporaryDir other_dir;
+  ASSERT_TRUE(other_dir.isValid());
+
+  const QString filename = path_ + u"/song.flac"_s;
+  WriteFile(filename);
+
+  QSignalSpy spy_changed(&watcher_, &FileSystemWatcherInterface::FileChanged);
+  ASSERT_TRUE(spy_changed.wait(2000));
+
+  QSignalSpy spy_removed(&watcher_, &FileSystemWatcherInterface::FileRemoved);
+  ASSERT_TRUE(QFile::rename(filename, other_dir.path() + u"/song.flac"_s));
+
+  ASSERT_TRUE(spy_removed.wait(2000));
+  EXPECT_EQ(filename, spy_removed.first().first().toString());
+
+}
+
+TEST_F(FileSystemWatcherInotifyTest, ReportsRemovedFile) {
+
+  const QString filename = path_ + u"/song.flac"_s;
+  WriteFile(filename);
+
+  QSignalSpy spy_changed(&watcher_, &FileSystemWatcherInterface::FileChanged);
+  ASSERT_TRUE(spy_changed.wait(2000));
+
+  QSignalSpy spy_removed(&watcher_, &FileSystemWatcherInterface::FileRemoved);
+  ASSERT_TRUE(QFile::remove(filename));
+
+  ASSERT_TRUE(spy_removed.wait(2000));
+  EXPECT_EQ(filename, spy_removed.first().first().toString());
+
+}
+
+TEST_F(FileSystemWatcherInotifyTest, ReportsSubdirectoryAsPathChanged) {
+
+  QSignalSpy spy_path(&watcher_, &FileSystemWatcherInterface::PathChanged);
+  ASSERT_TRUE(QDir(path_).mkdir(u"album"_s));
+
+  ASSERT_TRUE(spy_path.wait(2000));
+  EXPECT_EQ(path_, spy_path.first().first().toString());
+
+}
+
+}  // namespace
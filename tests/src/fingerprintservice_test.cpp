@@ -0,0 +1,172 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QFuture>
+#include <QThread>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "engine/fingerprintservice.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Pretends to decode the file for a while, and records the order and the concurrency per host.
+class FakeFingerprinter {
+ public:
+  FakeFingerprinter() : readers_(0), max_readers_(0) {}
+
+  FingerprintService::Result Fingerprint(const QUrl &url, const FingerprintService::Algorithm algorithm) {
+
+    {
+      QMutexLocker l(&mutex_);
+      order_ << url.path();
+      max_readers_ = std::max(max_readers_, ++readers_);
+    }
+
+    QThread::msleep(20);
+
+    {
+      QMutexLocker l(&mutex_);
+      --readers_;
+    }
+
+    FingerprintService::Result result;
+    if (!url.path().contains(u"broken"_s)) {
+      result.fingerprint = (algorithm == FingerprintService::Algorithm::Legacy ? u"legacy"_s : u"full"_s) + url.path();
+    }
+    return result;
+
+  }
+
+  QStringList order() const {
+    QMutexLocker l(&mutex_);
+    return order_;
+  }
+
+  int max_readers() const {
+    QMutexLocker l(&mutex_);
+    return max_readers_;
+  }
+
+ private:
+  mutable QMutex mutex_;
+  QStringList order_;
+  int readers_;
+  int max_readers_;
+};
+
+void SetFakeFingerprinter(FingerprintService *service, FakeFingerprinter *fingerprinter) {
+  service->set_fingerprint_function([fingerprinter](const QUrl &url, const FingerprintService::Algorithm algorithm) { return fingerprinter->Fingerprint(url, algorithm); });
+}
+
+TEST(FingerprintServiceTest, CreatesFingerprints) {
+
+  FakeFingerprinter fingerprinter;
+  FingerprintService service(2);
+  SetFakeFingerprinter(&service, &fingerprinter);
+
+  QFuture<FingerprintService::Result> legacy = service.Fingerprint(QUrl(u"http://disk/a"_s), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+  QFuture<FingerprintService::Result> full = service.Fingerprint(QUrl(u"http://disk/b"_s), FingerprintService::Algorithm::Full, FingerprintService::Priority::Interactive);
+  QFuture<FingerprintService::Result> broken = service.Fingerprint(QUrl(u"http://disk/broken"_s), FingerprintService::Algorithm::Full, FingerprintService::Priority::Interactive);
+
+  EXPECT_EQ(legacy.result().fingerprint, u"legacy/a"_s);
+  EXPECT_EQ(full.result().fingerprint, u"full/b"_s);
+  EXPECT_TRUE(broken.result().fingerprint.isEmpty());
+
+  const FingerprintService::Stats stats = service.stats();
+  EXPECT_EQ(stats.fingerprints, 2);
+  EXPECT_EQ(stats.failures, 1);
+  EXPECT_GT(stats.fingerprints_per_second(), 0.0);
+
+}
+
+TEST(FingerprintServiceTest, InteractiveBeforeBackground) {
+
+  FakeFingerprinter fingerprinter;
+  FingerprintService service(1);
+  SetFakeFingerprinter(&service, &fingerprinter);
+
+  QList<QFuture<FingerprintService::Result>> futures;
+  for (int i = 0; i < 3; ++i) {
+    futures << service.Fingerprint(QUrl(u"http://disk/background"_s + QString::number(i)), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+  }
+  futures << service.Fingerprint(QUrl(u"http://disk/interactive"_s), FingerprintService::Algorithm::Full, FingerprintService::Priority::Interactive);
+
+  for (QFuture<FingerprintService::Result> &future : futures) {
+    future.waitForFinished();
+  }
+
+  // At most the first background request was started before the interactive request arrived.
+  const QStringList order = fingerprinter.order();
+  ASSERT_EQ(order.count(), 4);
+  EXPECT_LE(order.indexOf(u"/interactive"_s), 1);
+
+}
+
+TEST(FingerprintServiceTest, LimitsReadersPerDevice) {
+
+  FakeFingerprinter fingerprinter;
+  FingerprintService service(4, 1);
+  SetFakeFingerprinter(&service, &fingerprinter);
+
+  QList<QFuture<FingerprintService::Result>> futures;
+  for (int i = 0; i < 6; ++i) {
+    futures << service.Fingerprint(QUrl(u"http://disk/"_s + QString::number(i)), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+  }
+
+  for (QFuture<FingerprintService::Result> &future : futures) {
+    EXPECT_FALSE(future.result().fingerprint.isEmpty());
+  }
+
+  EXPECT_EQ(fingerprinter.max_readers(), 1);
+  EXPECT_EQ(service.stats().fingerprints, 6);
+
+}
+
+TEST(FingerprintServiceTest, CancelledRequestIsDropped) {
+
+  FakeFingerprinter fingerprinter;
+  FingerprintService service(1);
+  SetFakeFingerprinter(&service, &fingerprinter);
+
+  QFuture<FingerprintService::Result> first = service.Fingerprint(QUrl(u"http://disk/first"_s), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+  QFuture<FingerprintService::Result> cancelled = service.Fingerprint(QUrl(u"http://disk/cancelled"_s), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+  QFuture<FingerprintService::Result> last = service.Fingerprint(QUrl(u"http://disk/last"_s), FingerprintService::Algorithm::Legacy, FingerprintService::Priority::Background);
+  cancelled.cancel();
+
+  first.waitForFinished();
+  last.waitForFinished();
+  cancelled.waitForFinished();
+
+  EXPECT_TRUE(cancelled.isCanceled());
+  EXPECT_FALSE(fingerprinter.order().contains(u"/cancelled"_s));
+
+}
+
+}  // namespace
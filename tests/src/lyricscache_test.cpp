@@ -0,0 +1,92 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QString>
+#include <QTemporaryDir>
+
+#include "lyrics/lyricscache.h"
+#include "lyrics/lyricssearchrequest.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+LyricsSearchRequest MakeRequest(const QString &artist, const QString &album, const QString &title, const qint64 duration) {
+
+  LyricsSearchRequest request;
+  request.artist = artist;
+  request.album = album;
+  request.title = title;
+  request.duration = duration;
+  return request;
+
+}
+
+TEST(LyricsCacheTest, KeyIsNormalized) {
+
+  EXPECT_EQ(LyricsCache::Key(MakeRequest(u"The  Artist"_s, u"Album"_s, u"Title"_s, 200)), LyricsCache::Key(MakeRequest(u"the artist"_s, u"ALBUM"_s, u" title "_s, 200)));
+  EXPECT_NE(LyricsCache::Key(MakeRequest(u"Artist"_s, u"Album"_s, u"Title"_s, 200)), LyricsCache::Key(MakeRequest(u"Artist"_s, u"Album"_s, u"Title"_s, 201)));
+  EXPECT_NE(LyricsCache::Key(MakeRequest(u"Artist"_s, u"Album"_s, u"Title"_s, 200)), LyricsCache::Key(MakeRequest(u"Artist"_s, u"Other Album"_s, u"Title"_s, 200)));
+
+}
+
+TEST(LyricsCacheTest, StoresLyricsAndProvider) {
+
+  QTemporaryDir cache_dir;
+  ASSERT_TRUE(cache_dir.isValid());
+
+  const QString key = LyricsCache::Key(MakeRequest(u"Artist"_s, u"Album"_s, u"Title"_s, 200));
+  {
+    LyricsCache cache(cache_dir.path());
+    LyricsCache::Entry entry;
+    EXPECT_FALSE(cache.Lookup(key, &entry));
+    cache.Insert(key, u"lrclib"_s, u"Some lyrics"_s);
+  }
+
+  // A new instance reads the entry back from disk.
+  LyricsCache cache(cache_dir.path());
+  LyricsCache::Entry entry;
+  ASSERT_TRUE(cache.Lookup(key, &entry));
+  EXPECT_EQ(u"lrclib"_s, entry.provider);
+  EXPECT_EQ(u"Some lyrics"_s, entry.lyrics);
+  EXPECT_FALSE(entry.negative());
+
+}
+
+TEST(LyricsCacheTest, StoresNegativeResults) {
+
+  QTemporaryDir cache_dir;
+  ASSERT_TRUE(cache_dir.isValid());
+
+  LyricsCache cache(cache_dir.path());
+  const QString key = LyricsCache::Key(MakeRequest(u"Artist"_s, u"Album"_s, u"Instrumental"_s, 300));
+  cache.Insert(key, QString(), QString());
+
+  LyricsCache::Entry entry;
+  ASSERT_TRUE(cache.Lookup(key, &entry));
+  EXPECT_TRUE(entry.negative());
+  EXPECT_TRUE(entry.provider.isEmpty());
+
+}
+
+}  // namespace
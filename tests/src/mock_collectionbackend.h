@@ -59,6 +59,8 @@ class MockCollectionBackend : public CollectionBackendInterface {
 
   MOCK_METHOD1(GetSongsByUrl, SongList(const QUrl&));
   MOCK_METHOD2(GetSongByUrl, Song(const QUrl&, qint64));
+  MOCK_METHOD1(GetSongsByUrls, SongList(const QList<QUrl>&));
+  MOCK_METHOD1(MayContainUrl, bool(const QUrl&));
 
   MOCK_METHOD1(AddDirectory, void(const QString&));
   MOCK_METHOD1(RemoveDirectory, void(const Directory&));
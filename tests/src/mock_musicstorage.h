@@ -0,0 +1,81 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MOCK_MUSICSTORAGE_H
+#define MOCK_MUSICSTORAGE_H
+
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "core/song.h"
+#include "core/musicstorage.h"
+
+// Storage that records the calls made to it instead of writing anywhere, like a device that takes its files in batches.
+class FakeMusicStorage : public MusicStorage {
+ public:
+  explicit FakeMusicStorage(const int batch_size = 0) : batch_size_(batch_size), fail_commit_(false), commits_(0) {}
+
+  Song::Source source() const override { return Song::Source::Device; }
+
+  int CopyBatchSize() const override { return batch_size_; }
+
+  bool CopyToStorage(const CopyJob &job, QString &error_text) override {
+    if (failing_sources_.contains(job.source_)) {
+      error_text = QStringLiteral("Could not copy %1").arg(job.source_);
+      return false;
+    }
+    pending_ << job.source_;
+    return true;
+  }
+
+  bool CommitCopyBatch(QString &error_text) override {
+    ++commits_;
+    if (fail_commit_) {
+      error_text = QStringLiteral("Writing database failed");
+      pending_.clear();
+      return false;
+    }
+    committed_ << pending_;
+    batches_ << pending_.count();
+    pending_.clear();
+    return true;
+  }
+
+  bool DeleteFromStorage(const DeleteJob &job) override { Q_UNUSED(job); return true; }
+
+  void set_fail_commit(const bool fail_commit) { fail_commit_ = fail_commit; }
+  void add_failing_source(const QString &source) { failing_sources_.insert(source); }
+
+  int commits() const { return commits_; }
+  QStringList committed() const { return committed_; }
+  QList<qint64> batches() const { return batches_; }
+
+ private:
+  const int batch_size_;
+  bool fail_commit_;
+  int commits_;
+  QSet<QString> failing_sources_;
+  QStringList pending_;
+  QStringList committed_;
+  QList<qint64> batches_;
+};
+
+#endif  // MOCK_MUSICSTORAGE_H
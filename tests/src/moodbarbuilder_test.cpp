@@ -0,0 +1,145 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include "gtest_include.h"
+
+#include <QtGlobal>
+#include <QByteArray>
+
+#include "moodbar/moodbarbuilder.h"
+#include "moodbar/moodbarstreamingbuilder.h"
+
+namespace {
+
+constexpr int kBands = 128;
+constexpr int kRate = 44100;
+constexpr int kWidth = 1000;
+
+// Feeds the same deterministic spectrum frames, slowly changing with some noise, to both builders.
+void AddFrames(MoodbarBuilder *builder, MoodbarStreamingBuilder *streaming_builder, const int frame_count) {
+
+  quint32 seed = 1;
+  double magnitudes[kBands];
+  for (int i = 0; i < frame_count; ++i) {
+    const double t = static_cast<double>(i) / frame_count;
+    for (int band = 0; band < kBands; ++band) {
+      seed = seed * 1664525U + 1013904223U;
+      const double noise = static_cast<double>(seed >> 8) / static_cast<double>(1 << 24);
+      magnitudes[band] = (1.0 + 0.8 * std::sin(t * (12 + band % 7) * 3.0 + band)) * (0.7 + 0.6 * noise) / (1.0 + band * 0.05);
+    }
+    builder->AddFrame(magnitudes, kBands);
+    streaming_builder->AddFrame(magnitudes, kBands);
+  }
+
+}
+
+void CompareColors(const QByteArray &expected, const QByteArray &actual, double *mean_difference, int *max_difference) {
+
+  ASSERT_EQ(expected.size(), actual.size());
+
+  double total = 0;
+  *max_difference = 0;
+  for (qsizetype i = 0; i < expected.size(); ++i) {
+    const int difference = std::abs(static_cast<int>(static_cast<uchar>(expected[i])) - static_cast<int>(static_cast<uchar>(actual[i])));
+    total += difference;
+    *max_difference = std::max(*max_difference, difference);
+  }
+  *mean_difference = total / static_cast<double>(expected.size());
+
+}
+
+}  // namespace
+
+TEST(MoodbarStreamingBuilderTest, EmptyInputHasWidth) {
+
+  MoodbarStreamingBuilder streaming_builder;
+  streaming_builder.Init(kBands, kRate);
+
+  EXPECT_EQ(streaming_builder.Finish(kWidth).size(), kWidth * 3);
+  EXPECT_EQ(streaming_builder.frame_count(), 0);
+
+}
+
+TEST(MoodbarStreamingBuilderTest, ShortTrackMatchesMoodbarBuilder) {
+
+  MoodbarBuilder builder;
+  MoodbarStreamingBuilder streaming_builder;
+  builder.Init(kBands, kRate);
+  streaming_builder.Init(kBands, kRate);
+
+  AddFrames(&builder, &streaming_builder, 1500);
+  EXPECT_EQ(streaming_builder.frames_per_bucket(), 1);
+
+  EXPECT_EQ(streaming_builder.Finish(kWidth), builder.Finish(kWidth));
+
+}
+
+TEST(MoodbarStreamingBuilderTest, LongTrackIsCloseToMoodbarBuilder) {
+
+  MoodbarBuilder builder;
+  MoodbarStreamingBuilder streaming_builder;
+  builder.Init(kBands, kRate);
+  streaming_builder.Init(kBands, kRate);
+
+  AddFrames(&builder, &streaming_builder, 20000);
+  EXPECT_GT(streaming_builder.frames_per_bucket(), 1);
+
+  double mean_difference = 0;
+  int max_difference = 0;
+  CompareColors(builder.Finish(kWidth), streaming_builder.Finish(kWidth), &mean_difference, &max_difference);
+
+  EXPECT_LT(mean_difference, 8.0);
+  EXPECT_LT(max_difference, 48);
+
+}
+
+TEST(MoodbarStreamingBuilderTest, WorkingBucketsAreBounded) {
+
+  MoodbarStreamingBuilder streaming_builder;
+  streaming_builder.Init(kBands, kRate);
+
+  double magnitudes[kBands];
+  std::fill(magnitudes, magnitudes + kBands, 1.0);
+  for (int i = 0; i < 100000; ++i) {
+    magnitudes[i % kBands] = 1.0 + (i % 13);
+    streaming_builder.AddFrame(magnitudes, kBands);
+    ASSERT_LT(streaming_builder.working_bucket_count(), MoodbarStreamingBuilder::kMaxWorkingBuckets);
+  }
+
+  EXPECT_EQ(streaming_builder.frame_count(), 100000);
+  EXPECT_EQ(streaming_builder.Finish(kWidth).size(), kWidth * 3);
+
+}
+
+TEST(MoodbarStreamingBuilderTest, IgnoresFramesWithTooManyBands) {
+
+  MoodbarStreamingBuilder streaming_builder;
+  streaming_builder.Init(kBands, kRate);
+
+  double magnitudes[kBands * 2];
+  std::fill(magnitudes, magnitudes + kBands * 2, 1.0);
+  streaming_builder.AddFrame(magnitudes, kBands * 2);
+
+  EXPECT_EQ(streaming_builder.frame_count(), 0);
+
+}
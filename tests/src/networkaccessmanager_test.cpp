@@ -0,0 +1,180 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QUrl>
+#include <QThread>
+#include <QEventLoop>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QStandardPaths>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QAbstractNetworkCache>
+
+#include "core/networkaccessmanager.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Answers every request with the same body and ETag, and 304 Not Modified when the request has a matching If-None-Match.
+// The response asks not to be stored, so it's only cached when the metadata cache pins it.
+class HttpServer {
+ public:
+  HttpServer() {
+    QObject::connect(&server_, &QTcpServer::newConnection, &server_, [this]() {
+      while (QTcpSocket *socket = server_.nextPendingConnection()) {
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { Read(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+      }
+    });
+    server_.listen(QHostAddress::LocalHost);
+  }
+
+  QUrl url(const QString &path) const { return QUrl(u"http://127.0.0.1:%1%2"_s.arg(server_.serverPort()).arg(path)); }
+  const QList<QByteArray> &requests() const { return requests_; }
+
+ private:
+  void Read(QTcpSocket *socket) {
+    QByteArray &buffer = buffers_[socket];
+    buffer.append(socket->readAll());
+    if (!buffer.contains("\r\n\r\n")) return;
+    requests_ << buffer;
+
+    QByteArray response;
+    if (buffer.contains("If-None-Match: \"v1\"")) {
+      response = "HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nCache-Control: no-store\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    else {
+      const QByteArray body = "[\"result\"]";
+      response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nETag: \"v1\"\r\nCache-Control: no-store\r\nContent-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    }
+    buffers_.remove(socket);
+    socket->write(response);
+    socket->disconnectFromHost();
+  }
+
+  QTcpServer server_;
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  QList<QByteArray> requests_;
+};
+
+class NetworkAccessManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    QStandardPaths::setTestModeEnabled(true);
+    network_.cache()->clear();
+  }
+
+  // Gets the URL with the metadata cache enabled, the reply is deleted with the test.
+  QNetworkReply *Get(const QUrl &url, const qint64 time_to_live) {
+    QNetworkRequest request(url);
+    request.setAttribute(NetworkAccessManager::kMetadataCacheTtlAttribute, time_to_live);
+    QNetworkReply *reply = network_.get(request);
+    reply->setParent(&network_);
+    QEventLoop loop;
+    QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    if (!reply->isFinished()) loop.exec();
+    return reply;
+  }
+
+  static bool FromCache(QNetworkReply *reply) {
+    return reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+  }
+
+  HttpServer server_;
+  NetworkAccessManager network_;
+};
+
+TEST_F(NetworkAccessManagerTest, CachedResponseIsUsedWithinTimeToLive) {
+
+  const QUrl url = server_.url(u"/search"_s);
+  const NetworkAccessManager::MetadataCacheStats stats = NetworkAccessManager::metadata_cache_stats();
+
+  QNetworkReply *reply = Get(url, 3600);
+  EXPECT_EQ(QNetworkReply::NoError, reply->error());
+  EXPECT_FALSE(FromCache(reply));
+  EXPECT_EQ("[\"result\"]", reply->readAll());
+
+  reply = Get(url, 3600);
+  EXPECT_EQ(QNetworkReply::NoError, reply->error());
+  EXPECT_TRUE(FromCache(reply));
+  EXPECT_EQ("[\"result\"]", reply->readAll());
+
+  EXPECT_EQ(1, server_.requests().count());
+  EXPECT_EQ(stats.misses + 1, NetworkAccessManager::metadata_cache_stats().misses);
+  EXPECT_EQ(stats.hits + 1, NetworkAccessManager::metadata_cache_stats().hits);
+
+}
+
+TEST_F(NetworkAccessManagerTest, ExpiredResponseIsRevalidated) {
+
+  const QUrl url = server_.url(u"/countries"_s);
+  const NetworkAccessManager::MetadataCacheStats stats = NetworkAccessManager::metadata_cache_stats();
+
+  QNetworkReply *reply = Get(url, 1);
+  EXPECT_FALSE(FromCache(reply));
+
+  QThread::msleep(1100);
+
+  reply = Get(url, 1);
+  EXPECT_EQ(QNetworkReply::NoError, reply->error());
+  EXPECT_TRUE(FromCache(reply));
+  EXPECT_EQ("[\"result\"]", reply->readAll());
+
+  ASSERT_EQ(2, server_.requests().count());
+  EXPECT_TRUE(server_.requests()[1].contains("If-None-Match: \"v1\""));
+  EXPECT_EQ(stats.revalidated + 1, NetworkAccessManager::metadata_cache_stats().revalidated);
+
+}
+
+TEST_F(NetworkAccessManagerTest, RemovedResponseIsFetchedAgain) {
+
+  const QUrl url = server_.url(u"/error"_s);
+
+  QNetworkReply *reply = Get(url, 3600);
+  EXPECT_FALSE(FromCache(reply));
+  network_.RemoveFromMetadataCache(reply);
+
+  reply = Get(url, 3600);
+  EXPECT_FALSE(FromCache(reply));
+  EXPECT_EQ(2, server_.requests().count());
+
+}
+
+TEST_F(NetworkAccessManagerTest, ResponseWithoutTimeToLiveIsNotCached) {
+
+  const QUrl url = server_.url(u"/uncached"_s);
+
+  EXPECT_FALSE(FromCache(Get(url, 0)));
+  EXPECT_FALSE(FromCache(Get(url, 0)));
+  EXPECT_EQ(2, server_.requests().count());
+
+}
+
+}  // namespace
@@ -128,6 +128,48 @@ TEST_F(OrganizeFormatTest, Blocks) {
 
 }
 
+TEST_F(OrganizeFormatTest, FormatReusedForSongs) {
+
+  format_.set_format(u"%artist/{%year - }%album/{%disc-}%track"_s);
+  ASSERT_TRUE(format_.IsValid());
+
+  song_.set_artist(u"artist"_s);
+  song_.set_album(u"album"_s);
+  song_.set_year(2001);
+  song_.set_track(3);
+  EXPECT_EQ(u"artist/2001_-_album/03"_s, format_.GetFilenameForSong(song_).filename);
+
+  song_.set_year(0);
+  song_.set_disc(2);
+  song_.set_track(12);
+  EXPECT_EQ(u"artist/album/2-12"_s, format_.GetFilenameForSong(song_).filename);
+
+  format_.set_format(u"%title"_s);
+  song_.set_title(u"title"_s);
+  EXPECT_EQ(u"title"_s, format_.GetFilenameForSong(song_).filename);
+
+}
+
+TEST_F(OrganizeFormatTest, UniqueFilename) {
+
+  song_.set_artist(u"artist"_s);
+  song_.set_album(u"album"_s);
+
+  format_.set_format(u"%artist/%album"_s);
+  EXPECT_FALSE(format_.GetFilenameForSong(song_).unique_filename);
+
+  format_.set_format(u"%artist/%album/{%track}"_s);
+  EXPECT_FALSE(format_.GetFilenameForSong(song_).unique_filename);
+
+  song_.set_track(1);
+  EXPECT_TRUE(format_.GetFilenameForSong(song_).unique_filename);
+
+  format_.set_format(u"%artist/%album/%title"_s);
+  song_.set_title(u"title"_s);
+  EXPECT_TRUE(format_.GetFilenameForSong(song_).unique_filename);
+
+}
+
 TEST_F(OrganizeFormatTest, ReplaceSpaces) {
 
   song_.set_title(u"The Song Title"_s);
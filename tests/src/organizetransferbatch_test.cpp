@@ -0,0 +1,212 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+#include <QTemporaryDir>
+
+#include "includes/shared_ptr.h"
+#include "core/song.h"
+#include "core/musicstorage.h"
+#include "organize/organizetransferbatch.h"
+#include "mock_musicstorage.h"
+
+using std::make_shared;
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+MusicStorage::CopyJob MakeJob(const QString &source) {
+
+  MusicStorage::CopyJob job;
+  job.source_ = source;
+  job.destination_ = source + u".dest"_s;
+  return job;
+
+}
+
+QString MakeKey(const QString &source) {
+
+  Song song;
+  song.set_url(QUrl::fromLocalFile(source));
+  song.set_filesize(1000);
+  song.set_mtime(1);
+  return OrganizeTransferBatch::JournalKey(song, source + u".dest"_s);
+
+}
+
+TEST(OrganizeTransferBatchTest, CommitsInBatches) {
+
+  SharedPtr<FakeMusicStorage> storage = make_shared<FakeMusicStorage>(2);
+  OrganizeTransferBatch batch(storage);
+  EXPECT_EQ(2, batch.batch_size());
+
+  batch.Add(1, MakeKey(u"/a.mp3"_s), MakeJob(u"/a.mp3"_s));
+  EXPECT_FALSE(batch.IsFull());
+  batch.Add(2, MakeKey(u"/b.mp3"_s), MakeJob(u"/b.mp3"_s));
+  EXPECT_TRUE(batch.IsFull());
+
+  // Nothing is copied before the batch is committed.
+  EXPECT_EQ(0, storage->commits());
+
+  const OrganizeTransferBatch::ResultList results = batch.Commit();
+  ASSERT_EQ(2, results.count());
+  EXPECT_EQ(1, results[0].id);
+  EXPECT_TRUE(results[0].success);
+  EXPECT_EQ(2, results[1].id);
+  EXPECT_TRUE(results[1].success);
+  EXPECT_TRUE(batch.IsEmpty());
+
+  EXPECT_EQ(1, storage->commits());
+  EXPECT_EQ(QList<qint64>() << 2, storage->batches());
+  EXPECT_EQ(QStringList() << u"/a.mp3"_s << u"/b.mp3"_s, storage->committed());
+  EXPECT_TRUE(batch.IsTransferred(MakeKey(u"/a.mp3"_s)));
+
+}
+
+TEST(OrganizeTransferBatchTest, FailedCommitFailsWholeBatch) {
+
+  SharedPtr<FakeMusicStorage> storage = make_shared<FakeMusicStorage>(10);
+  storage->set_fail_commit(true);
+  OrganizeTransferBatch batch(storage);
+
+  batch.Add(1, MakeKey(u"/a.mp3"_s), MakeJob(u"/a.mp3"_s));
+  batch.Add(2, MakeKey(u"/b.mp3"_s), MakeJob(u"/b.mp3"_s));
+
+  const OrganizeTransferBatch::ResultList results = batch.Commit();
+  ASSERT_EQ(2, results.count());
+  for (const OrganizeTransferBatch::Result &result : results) {
+    EXPECT_FALSE(result.success);
+    EXPECT_EQ(u"Writing database failed"_s, result.error_text);
+  }
+  EXPECT_FALSE(batch.IsTransferred(MakeKey(u"/a.mp3"_s)));
+
+}
+
+TEST(OrganizeTransferBatchTest, FailedCopyOnlyFailsThatFile) {
+
+  SharedPtr<FakeMusicStorage> storage = make_shared<FakeMusicStorage>(10);
+  storage->add_failing_source(u"/b.mp3"_s);
+  OrganizeTransferBatch batch(storage);
+
+  batch.Add(1, MakeKey(u"/a.mp3"_s), MakeJob(u"/a.mp3"_s));
+  batch.Add(2, MakeKey(u"/b.mp3"_s), MakeJob(u"/b.mp3"_s));
+  batch.Add(3, MakeKey(u"/c.mp3"_s), MakeJob(u"/c.mp3"_s));
+
+  const OrganizeTransferBatch::ResultList results = batch.Commit();
+  ASSERT_EQ(3, results.count());
+  EXPECT_TRUE(results[0].success);
+  EXPECT_FALSE(results[1].success);
+  EXPECT_FALSE(results[1].error_text.isEmpty());
+  EXPECT_TRUE(results[2].success);
+
+  EXPECT_EQ(QStringList() << u"/a.mp3"_s << u"/c.mp3"_s, storage->committed());
+  EXPECT_TRUE(batch.IsTransferred(MakeKey(u"/a.mp3"_s)));
+  EXPECT_FALSE(batch.IsTransferred(MakeKey(u"/b.mp3"_s)));
+
+}
+
+TEST(OrganizeTransferBatchTest, JournalResumesInterruptedTransfer) {
+
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  const QString journal_filename = dir.path() + u"/transfer.journal"_s;
+
+  SharedPtr<FakeMusicStorage> storage = make_shared<FakeMusicStorage>(1);
+  {
+    OrganizeTransferBatch batch(storage, journal_filename);
+    batch.Add(1, MakeKey(u"/a.mp3"_s), MakeJob(u"/a.mp3"_s));
+    batch.Commit();
+    batch.Add(2, MakeKey(u"/b.mp3"_s), MakeJob(u"/b.mp3"_s));
+    // Interrupted before the second batch is committed.
+  }
+  ASSERT_TRUE(QFile::exists(journal_filename));
+
+  OrganizeTransferBatch batch(storage, journal_filename);
+  EXPECT_TRUE(batch.IsTransferred(MakeKey(u"/a.mp3"_s)));
+  EXPECT_FALSE(batch.IsTransferred(MakeKey(u"/b.mp3"_s)));
+
+  // A changed source file is transferred again.
+  Song song;
+  song.set_url(QUrl::fromLocalFile(u"/a.mp3"_s));
+  song.set_filesize(2000);
+  song.set_mtime(1);
+  EXPECT_FALSE(batch.IsTransferred(OrganizeTransferBatch::JournalKey(song, u"/a.mp3.dest"_s)));
+
+  batch.Add(2, MakeKey(u"/b.mp3"_s), MakeJob(u"/b.mp3"_s));
+  batch.Commit();
+
+  // An unsuccessful transfer keeps the journal, a successful one removes it.
+  batch.Finish(false);
+  EXPECT_TRUE(QFile::exists(journal_filename));
+  batch.Finish(true);
+  EXPECT_FALSE(QFile::exists(journal_filename));
+  EXPECT_FALSE(batch.IsTransferred(MakeKey(u"/a.mp3"_s)));
+
+}
+
+TEST(OrganizeTransferBatchTest, JournalIsScopedToJob) {
+
+  const QStringList keys = QStringList() << MakeKey(u"/a.mp3"_s) << MakeKey(u"/b.mp3"_s);
+  const QString journal_filename = OrganizeTransferBatch::JournalFilename(u"device"_s, keys);
+  EXPECT_FALSE(journal_filename.isEmpty());
+
+  // The same job resumes from the same journal, regardless of the order of the files.
+  EXPECT_EQ(journal_filename, OrganizeTransferBatch::JournalFilename(u"device"_s, QStringList() << keys[1] << keys[0]));
+
+  // Other files or another device start a new journal.
+  EXPECT_NE(journal_filename, OrganizeTransferBatch::JournalFilename(u"device"_s, QStringList() << keys[0]));
+  EXPECT_NE(journal_filename, OrganizeTransferBatch::JournalFilename(u"other device"_s, keys));
+
+  EXPECT_TRUE(OrganizeTransferBatch::JournalFilename(QString(), keys).isEmpty());
+
+}
+
+TEST(OrganizeTransferBatchTest, ExpiredJournalIsRemoved) {
+
+  QTemporaryDir dir;
+  ASSERT_TRUE(dir.isValid());
+  const QString journal_filename = dir.path() + u"/transfer-test.journal"_s;
+
+  SharedPtr<FakeMusicStorage> storage = make_shared<FakeMusicStorage>(1);
+  {
+    OrganizeTransferBatch batch(storage, journal_filename);
+    batch.Add(1, MakeKey(u"/a.mp3"_s), MakeJob(u"/a.mp3"_s));
+    batch.Commit();
+  }
+
+  QFile file(journal_filename);
+  ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+  ASSERT_TRUE(file.setFileTime(QDateTime::currentDateTime().addDays(-8), QFileDevice::FileModificationTime));
+  file.close();
+
+  OrganizeTransferBatch batch(storage, journal_filename);
+  EXPECT_FALSE(batch.IsTransferred(MakeKey(u"/a.mp3"_s)));
+  EXPECT_FALSE(QFile::exists(journal_filename));
+
+}
+
+}  // namespace
@@ -20,14 +20,17 @@
  */
 
 #include <memory>
+#include <algorithm>
 
 #include "gtest_include.h"
 
 #include "test_utils.h"
 
+#include "constants/timeconstants.h"
 #include "collection/collectionplaylistitem.h"
 #include "playlist/playlist.h"
 #include "playlist/songplaylistitem.h"
+#include "queue/queue.h"
 #include "tagreader/tagreaderclient.h"
 #include "tagreader/tagreaderreply.h"
 #include "tagreader/tagreaderresult.h"
@@ -39,6 +42,8 @@
 #include <QThread>
 #include <QEventLoop>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QSignalSpy>
 
 using ::testing::Return;
 
@@ -785,4 +790,106 @@ TEST_F(PlaylistTest, FailedSaveReloadsActualDiskStateRatherThanStalePreEditChain
 
 }
 
+TEST_F(PlaylistTest, DisplayCacheDroppedOnMetadataChange) {
+
+  Song song;
+  song.Init(u"Title"_s, u"Artist"_s, u"Album"_s, 123);
+
+  PlaylistItemPtr item = std::make_shared<SongPlaylistItem>(song, false);
+  playlist_.InsertItems(PlaylistItemPtrList() << item, -1);
+  const QModelIndex idx = playlist_.index(0, static_cast<int>(Playlist::Column::Artist));
+
+  ASSERT_EQ(u"Artist"_s, playlist_.data(idx));
+
+  Song new_metadata = item->OriginalMetadata();
+  new_metadata.set_artist(u"NewArtist"_s);
+  playlist_.UpdateItemMetadata(0, item, new_metadata, false);
+
+  EXPECT_EQ(u"NewArtist"_s, playlist_.data(idx));
+  EXPECT_EQ(u"Title"_s, playlist_.data(playlist_.index(0, static_cast<int>(Playlist::Column::Title))));
+
+}
+
+TEST_F(PlaylistTest, BulkQueueChangeEmitsOneDataChanged) {
+
+  PlaylistItemPtrList items;
+  for (int i = 0; i < 10; ++i) {
+    items << MakeMockItemP(QStringLiteral("Title %1").arg(i));
+  }
+  playlist_.InsertItems(items);
+
+  QSignalSpy spy_data_changed(&playlist_, &Playlist::dataChanged);
+  QSignalSpy spy_queue_changed(&playlist_, &Playlist::QueueChanged);
+
+  playlist_.queue()->ToggleTracks(QModelIndexList() << playlist_.index(1, 0) << playlist_.index(3, 0) << playlist_.index(5, 0) << playlist_.index(7, 0));
+
+  ASSERT_EQ(1, spy_data_changed.count());
+  EXPECT_EQ(1, spy_data_changed[0][0].toModelIndex().row());
+  EXPECT_EQ(7, spy_data_changed[0][1].toModelIndex().row());
+  EXPECT_EQ(0, spy_queue_changed.count());
+
+  spy_data_changed.clear();
+
+  // Dequeuing tracks that aren't next to each other in the queue takes several model operations.
+  playlist_.queue()->ToggleTracks(QModelIndexList() << playlist_.index(3, 0) << playlist_.index(7, 0));
+
+  ASSERT_EQ(1, spy_data_changed.count());
+  EXPECT_EQ(3, spy_data_changed[0][0].toModelIndex().row());
+  EXPECT_EQ(7, spy_data_changed[0][1].toModelIndex().row());
+  EXPECT_EQ(1, spy_queue_changed.count());
+
+  EXPECT_EQ(0, playlist_.data(playlist_.index(1, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(-1, playlist_.data(playlist_.index(3, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(1, playlist_.data(playlist_.index(5, 0), Playlist::Role_QueuePosition).toInt());
+  EXPECT_EQ(-1, playlist_.data(playlist_.index(7, 0), Playlist::Role_QueuePosition).toInt());
+
+}
+
+// Reads the DisplayRole of every column one page of rows at a time, like a view scrolling through a large playlist and repainting each page twice.
+// Disabled by default, run it with --gtest_also_run_disabled_tests --gtest_filter=*ScrollLargePlaylistBenchmark.
+TEST_F(PlaylistTest, DISABLED_ScrollLargePlaylistBenchmark) {
+
+  constexpr int kRows = 100000;
+  constexpr int kPageRows = 40;
+
+  PlaylistItemPtrList items;
+  items.reserve(kRows);
+  for (int i = 0; i < kRows; ++i) {
+    Song song;
+    song.Init(u"Title %1"_s.arg(i), u"Artist %1"_s.arg(i % 500), u"Album %1"_s.arg(i % 2000), 180LL * kNsecPerSec);
+    song.set_track(i % 20 + 1);
+    items << std::make_shared<SongPlaylistItem>(song, false);
+  }
+  playlist_.InsertItems(items, -1);
+  ASSERT_EQ(kRows, playlist_.rowCount(QModelIndex()));
+
+  qint64 first_paint_nsec = 0;
+  qint64 repaint_nsec = 0;
+  int frames = 0;
+  QElapsedTimer timer;
+  for (int top = 0; top < kRows; top += kPageRows) {
+    const int bottom = std::min(top + kPageRows, kRows);
+    for (int pass = 0; pass < 2; ++pass) {
+      timer.start();
+      for (int row = top; row < bottom; ++row) {
+        for (int column = 0; column < Playlist::ColumnCount; ++column) {
+          playlist_.data(playlist_.index(row, column));
+        }
+      }
+      (pass == 0 ? first_paint_nsec : repaint_nsec) += timer.nsecsElapsed();
+    }
+    ++frames;
+  }
+
+  EXPECT_EQ(u"Title %1"_s.arg(kRows - 1), playlist_.data(playlist_.index(kRows - 1, static_cast<int>(Playlist::Column::Title))));
+
+  RecordProperty("frames", frames);
+  RecordProperty("first_paint_usec_per_frame", static_cast<int>(first_paint_nsec / frames / 1000));
+  RecordProperty("repaint_usec_per_frame", static_cast<int>(repaint_nsec / frames / 1000));
+
+  // Repainting a page is served from the display cache.
+  EXPECT_LT(repaint_nsec, first_paint_nsec);
+
+}
+
 }  // namespace
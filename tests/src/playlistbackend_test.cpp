@@ -0,0 +1,182 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QString>
+#include <QUrl>
+#include <QUuid>
+#include <QFile>
+#include <QIODevice>
+#include <QPromise>
+#include <QFuture>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+
+#include "includes/shared_ptr.h"
+#include "constants/timeconstants.h"
+#include "core/song.h"
+#include "core/database.h"
+#include "playlist/playlist.h"
+#include "playlist/playlistbackend.h"
+#include "playlist/playlistitem.h"
+#include "playlist/playlistitemsavedata.h"
+#include "playlist/playlistsequence.h"
+#include "mock_settingsprovider.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+namespace {
+
+class PlaylistBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    // The playlist is restored in a background thread, so the database has to be a file every thread can connect to.
+    database_ = make_shared<Database>(nullptr, nullptr, temp_dir_.filePath(u"strawberry.db"_s));
+    backend_ = make_shared<PlaylistBackend>(database_, nullptr, nullptr);
+    playlist_id_ = backend_->CreatePlaylist(u"Test"_s, QString());
+  }
+
+  void TearDown() override {
+    backend_.reset();
+    database_->Close();
+  }
+
+  static PlaylistItemSaveData MakeSaveData(const Song &song) {
+    PlaylistItemSaveData save_data;
+    save_data.source = song.source();
+    save_data.uuid = QUuid::createUuid();
+    save_data.song = song;
+    return save_data;
+  }
+
+  static Song MakeSong(const QString &filename, const QString &title) {
+    Song song(Song::Source::LocalFile);
+    song.set_url(QUrl::fromLocalFile(filename));
+    song.set_title(title);
+    song.set_valid(true);
+    return song;
+  }
+
+  QList<PlaylistItemPtrList> LoadPlaylistItems(const bool cancel = false) {
+    QPromise<PlaylistItemPtrList> promise;
+    QFuture<PlaylistItemPtrList> future = promise.future();
+    promise.start();
+    if (cancel) future.cancel();
+    backend_->LoadPlaylistItems(promise, playlist_id_);
+    promise.finish();
+    return future.results();
+  }
+
+  QTemporaryDir temp_dir_;
+  SharedPtr<Database> database_;
+  SharedPtr<PlaylistBackend> backend_;
+  int playlist_id_;
+};
+
+TEST_F(PlaylistBackendTest, ItemsAreLoadedInChunks) {
+
+  PlaylistItemSaveDataList items;
+  for (int i = 0; i < PlaylistBackend::kPlaylistItemsChunkSize + 10; ++i) {
+    items << MakeSaveData(MakeSong(temp_dir_.filePath(QStringLiteral("%1.flac").arg(i)), QStringLiteral("Title %1").arg(i)));
+  }
+  backend_->SavePlaylist(playlist_id_, items, -1, nullptr);
+
+  const QList<PlaylistItemPtrList> chunks = LoadPlaylistItems();
+  ASSERT_EQ(2, chunks.count());
+  ASSERT_EQ(PlaylistBackend::kPlaylistItemsChunkSize, chunks[0].count());
+  ASSERT_EQ(10, chunks[1].count());
+
+  // The items keep their playlist order across the chunks.
+  EXPECT_EQ(u"Title 0"_s, chunks[0].first()->EffectiveMetadata().title());
+  EXPECT_EQ(items[PlaylistBackend::kPlaylistItemsChunkSize].uuid, chunks[1].first()->uuid());
+  EXPECT_EQ(QStringLiteral("Title %1").arg(PlaylistBackend::kPlaylistItemsChunkSize + 9), chunks[1].last()->EffectiveMetadata().title());
+
+}
+
+TEST_F(PlaylistBackendTest, CanceledLoadStops) {
+
+  backend_->SavePlaylist(playlist_id_, PlaylistItemSaveDataList() << MakeSaveData(MakeSong(temp_dir_.filePath(u"0.flac"_s), u"Title"_s)), -1, nullptr);
+
+  EXPECT_TRUE(LoadPlaylistItems(true).isEmpty());
+
+}
+
+TEST_F(PlaylistBackendTest, CueDataIsRestoredWhenDisplayedOrPlayed) {
+
+  const QString filename = temp_dir_.filePath(u"album.flac"_s);
+  const QString cue_path = temp_dir_.filePath(u"album.cue"_s);
+  {
+    QFile file(filename);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+  }
+  {
+    QFile cue_file(cue_path);
+    ASSERT_TRUE(cue_file.open(QIODevice::WriteOnly));
+    cue_file.write("FILE \"album.flac\" WAVE\n"
+                   "  TRACK 01 AUDIO\n"
+                   "    TITLE \"Cue Title 1\"\n"
+                   "    INDEX 01 00:00:00\n"
+                   "  TRACK 02 AUDIO\n"
+                   "    TITLE \"Cue Title 2\"\n"
+                   "    INDEX 01 01:00:00\n");
+  }
+
+  Song song1 = MakeSong(filename, u"Stored Title 1"_s);
+  song1.set_cue_path(cue_path);
+  song1.set_beginning_nanosec(0);
+  Song song2 = MakeSong(filename, u"Stored Title 2"_s);
+  song2.set_cue_path(cue_path);
+  song2.set_beginning_nanosec(60 * kNsecPerSec);
+  backend_->SavePlaylist(playlist_id_, PlaylistItemSaveDataList() << MakeSaveData(song1) << MakeSaveData(song2), -1, nullptr);
+
+  PlaylistSequence sequence(nullptr, new DummySettingsProvider);
+  Playlist playlist(nullptr, nullptr, backend_, nullptr, nullptr, playlist_id_);
+  playlist.set_sequence(&sequence);
+  QSignalSpy spy_loaded(&playlist, &Playlist::PlaylistLoaded);
+  ASSERT_TRUE(spy_loaded.wait(5000));
+  ASSERT_EQ(2, playlist.rowCount());
+
+  // The CUE sheets are not read while loading.
+  EXPECT_EQ(u"Stored Title 1"_s, playlist.item_at(0)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Stored Title 2"_s, playlist.item_at(1)->EffectiveMetadata().title());
+
+  QSignalSpy spy_changed(&playlist, &Playlist::PlaylistItemMetadataChanged);
+
+  playlist.data(playlist.index(0, static_cast<int>(Playlist::Column::Title)), Qt::DisplayRole);
+  ASSERT_TRUE(spy_changed.wait(5000));
+  EXPECT_EQ(u"Cue Title 1"_s, playlist.item_at(0)->EffectiveMetadata().title());
+  EXPECT_EQ(u"Stored Title 2"_s, playlist.item_at(1)->EffectiveMetadata().title());
+
+  // Playback starts with the stored metadata, the CUE data follows.
+  playlist.set_current_row(1);
+  EXPECT_EQ(u"Stored Title 2"_s, playlist.item_at(1)->EffectiveMetadata().title());
+  ASSERT_TRUE(spy_changed.wait(5000));
+  EXPECT_EQ(u"Cue Title 2"_s, playlist.item_at(1)->EffectiveMetadata().title());
+
+}
+
+}  // namespace
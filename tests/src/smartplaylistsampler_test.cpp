@@ -0,0 +1,148 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QList>
+#include <QSet>
+
+#include "smartplaylists/smartplaylistsampler.h"
+
+namespace {
+
+QList<int> MakeIds(const int count) {
+
+  QList<int> ids;
+  for (int i = 1; i <= count; ++i) {
+    ids << i;
+  }
+  return ids;
+
+}
+
+TEST(SmartPlaylistSamplerTest, EmptyDrawsNothing) {
+
+  SmartPlaylistSampler sampler(1);
+  EXPECT_TRUE(sampler.is_empty());
+  EXPECT_TRUE(sampler.Draw(10).isEmpty());
+
+}
+
+TEST(SmartPlaylistSamplerTest, SameSeedSameOrder) {
+
+  SmartPlaylistSampler sampler1(42);
+  SmartPlaylistSampler sampler2(42);
+  sampler1.SetCandidates(MakeIds(100));
+  sampler2.SetCandidates(MakeIds(100));
+
+  EXPECT_EQ(sampler1.Draw(20), sampler2.Draw(20));
+
+}
+
+TEST(SmartPlaylistSamplerTest, ShuffleDrawsEverySongOnce) {
+
+  SmartPlaylistSampler sampler(7);
+  sampler.SetCandidates(MakeIds(50));
+
+  QSet<int> drawn;
+  for (int i = 0; i < 5; ++i) {
+    const QList<int> ids = sampler.Draw(10);
+    ASSERT_EQ(ids.count(), 10);
+    for (const int id : ids) {
+      EXPECT_FALSE(drawn.contains(id)) << id << " was drawn twice";
+      drawn.insert(id);
+    }
+  }
+
+  EXPECT_EQ(drawn.count(), 50);
+
+  // The next shuffle starts when all songs are drawn.
+  EXPECT_EQ(sampler.Draw(10).count(), 10);
+
+}
+
+TEST(SmartPlaylistSamplerTest, DrawAll) {
+
+  SmartPlaylistSampler sampler(3);
+  sampler.SetCandidates(MakeIds(30));
+
+  const QList<int> ids = sampler.Draw(sampler.count());
+  EXPECT_EQ(QSet<int>(ids.begin(), ids.end()).count(), 30);
+
+}
+
+TEST(SmartPlaylistSamplerTest, ExcludesPreviousSongs) {
+
+  SmartPlaylistSampler sampler(11);
+  sampler.SetCandidates(MakeIds(10));
+
+  const QSet<int> exclude = QSet<int>() << 1 << 2 << 3 << 4 << 5 << 6 << 7;
+  for (int i = 0; i < 10; ++i) {
+    const QList<int> ids = sampler.Draw(3, exclude);
+    for (const int id : ids) {
+      EXPECT_FALSE(exclude.contains(id));
+    }
+  }
+
+}
+
+TEST(SmartPlaylistSamplerTest, WeightedDrawsDifferentSongs) {
+
+  SmartPlaylistSampler sampler(5);
+  sampler.SetCandidates(MakeIds(20), QList<double>(20, 1.0));
+  ASSERT_TRUE(sampler.is_weighted());
+
+  const QList<int> ids = sampler.Draw(20);
+  EXPECT_EQ(ids.count(), 20);
+  EXPECT_EQ(QSet<int>(ids.begin(), ids.end()).count(), 20);
+
+}
+
+TEST(SmartPlaylistSamplerTest, WeightedFavorsHeavySongs) {
+
+  SmartPlaylistSampler sampler(9);
+  QList<double> weights(100, 1.0);
+  weights[0] = 100.0;
+  sampler.SetCandidates(MakeIds(100), weights);
+
+  int heavy_drawn = 0;
+  for (int i = 0; i < 100; ++i) {
+    const QList<int> ids = sampler.Draw(1);
+    ASSERT_EQ(ids.count(), 1);
+    if (ids.first() == 1) ++heavy_drawn;
+  }
+
+  // The heavy song has about a 50% chance for each draw, against 1% for the others.
+  EXPECT_GT(heavy_drawn, 25);
+
+}
+
+TEST(SmartPlaylistSamplerTest, WeightedSkipsZeroWeightAndExcluded) {
+
+  SmartPlaylistSampler sampler(13);
+  sampler.SetCandidates(QList<int>() << 1 << 2 << 3, QList<double>() << 0.0 << 1.0 << 1.0);
+
+  const QList<int> ids = sampler.Draw(3, QSet<int>() << 2);
+  EXPECT_EQ(ids, QList<int>() << 3);
+
+}
+
+}  // namespace
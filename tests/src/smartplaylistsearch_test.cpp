@@ -82,6 +82,26 @@ TEST(SmartPlaylistSearchTest, SaveAndLoadRoundTrip) {
   EXPECT_TRUE(loaded == search);
 }
 
+TEST(SmartPlaylistSearchTest, IdSqlIsNotSorted) {
+
+  SmartPlaylistSearch search = GenreSearch();
+  QVariantList bound_values;
+  QString sql = search.ToIdSql(u"songs"_s, bound_values);
+  EXPECT_TRUE(sql.startsWith("SELECT ROWID FROM songs WHERE "_L1)) << "sql: " << sql.toStdString();
+  EXPECT_TRUE(sql.contains("genre"_L1)) << "sql: " << sql.toStdString();
+  EXPECT_TRUE(sql.contains("unavailable = 0"_L1)) << "sql: " << sql.toStdString();
+  EXPECT_FALSE(sql.contains("ORDER BY"_L1)) << "sql: " << sql.toStdString();
+  EXPECT_EQ(bound_values.count(), 1);
+
+  search.sort_type_ = SmartPlaylistSearch::SortType::RandomByRating;
+  bound_values.clear();
+  sql = search.ToIdSql(u"songs"_s, bound_values);
+  EXPECT_TRUE(sql.startsWith("SELECT ROWID, rating FROM songs"_L1)) << "sql: " << sql.toStdString();
+  EXPECT_TRUE(search.is_random());
+  EXPECT_TRUE(search.uses_statistics());
+
+}
+
 // Mirrors what SmartPlaylistsModel does: write the generator into a Settings array, then read it back in a fresh Settings object.
 TEST(SmartPlaylistSearchTest, SettingsRoundTrip) {
 
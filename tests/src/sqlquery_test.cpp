@@ -0,0 +1,136 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+
+#include "gtest_include.h"
+
+#include <QString>
+#include <QVariant>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+#include <QSqlResult>
+
+#include "includes/shared_ptr.h"
+#include "core/memorydatabase.h"
+#include "core/sqlquery.h"
+
+using namespace Qt::Literals::StringLiterals;
+using std::make_shared;
+
+namespace {
+
+class SqlQueryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    database_ = make_shared<MemoryDatabase>(nullptr);
+    QMutexLocker l(database_->Mutex());
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    ASSERT_TRUE(q.prepare(u"CREATE TABLE sqlquery_test (value INTEGER)"_s));
+    ASSERT_TRUE(q.Exec());
+    SqlQuery insert_query(db);
+    ASSERT_TRUE(insert_query.prepare(u"INSERT INTO sqlquery_test (value) VALUES (1)"_s));
+    ASSERT_TRUE(insert_query.Exec());
+  }
+
+  SharedPtr<MemoryDatabase> database_;
+};
+
+TEST_F(SqlQueryTest, PreparedStatementIsReused) {
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  const QString statement = u"SELECT value FROM sqlquery_test WHERE value = :value"_s;
+
+  const QSqlResult *result = nullptr;
+  {
+    SqlQuery q(db);
+    ASSERT_TRUE(q.PrepareCached(database_.get(), statement));
+    q.BindValue(u":value"_s, 1);
+    ASSERT_TRUE(q.Exec());
+    ASSERT_TRUE(q.next());
+    result = q.result();
+  }
+
+  SqlQuery q(db);
+  ASSERT_TRUE(q.PrepareCached(database_.get(), statement));
+  EXPECT_EQ(result, q.result());
+
+  // The value bound by the previous query is not used again.
+  ASSERT_TRUE(q.Exec());
+  EXPECT_FALSE(q.next());
+
+  q.BindValue(u":value"_s, 1);
+  ASSERT_TRUE(q.Exec());
+  ASSERT_TRUE(q.next());
+  EXPECT_EQ(1, q.value(0).toInt());
+
+}
+
+TEST_F(SqlQueryTest, NestedQueriesDontShareStatement) {
+
+  QMutexLocker l(database_->Mutex());
+  QSqlDatabase db(database_->Connect());
+
+  const QString statement = u"SELECT value FROM sqlquery_test"_s;
+
+  SqlQuery outer_query(db);
+  ASSERT_TRUE(outer_query.PrepareCached(database_.get(), statement));
+  ASSERT_TRUE(outer_query.Exec());
+  ASSERT_TRUE(outer_query.next());
+
+  {
+    SqlQuery inner_query(db);
+    ASSERT_TRUE(inner_query.PrepareCached(database_.get(), statement));
+    EXPECT_NE(outer_query.result(), inner_query.result());
+    ASSERT_TRUE(inner_query.Exec());
+    ASSERT_TRUE(inner_query.next());
+  }
+
+  EXPECT_EQ(1, outer_query.value(0).toInt());
+
+}
+
+TEST_F(SqlQueryTest, ClosedConnectionDropsStatements) {
+
+  QMutexLocker l(database_->Mutex());
+
+  const QString statement = u"SELECT version FROM schema_version"_s;
+
+  {
+    QSqlDatabase db(database_->Connect());
+    SqlQuery q(db);
+    ASSERT_TRUE(q.PrepareCached(database_.get(), statement));
+    ASSERT_TRUE(q.Exec());
+  }
+
+  database_->Close();
+
+  QSqlDatabase db(database_->Connect());
+  SqlQuery q(db);
+  ASSERT_TRUE(q.PrepareCached(database_.get(), statement));
+  EXPECT_EQ(db.driver(), q.driver());
+  ASSERT_TRUE(q.Exec());
+  EXPECT_TRUE(q.next());
+
+}
+
+}  // namespace
@@ -0,0 +1,111 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QString>
+#include <QThread>
+
+#include "core/song.h"
+#include "streaming/streamingservice.h"
+#include "streaming/streamingsearchcache.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+SongMap MakeSongs(const QString &title) {
+
+  Song song(Song::Source::Tidal);
+  song.set_title(title);
+  song.set_song_id(title);
+
+  SongMap songs;
+  songs.insert(title, song);
+  return songs;
+
+}
+
+TEST(StreamingSearchCacheTest, FindsSameQuery) {
+
+  StreamingSearchCache cache;
+  cache.Insert(StreamingService::SearchType::Songs, u"Beatles"_s, MakeSongs(u"Help"_s));
+
+  SongMap songs;
+  EXPECT_TRUE(cache.Find(StreamingService::SearchType::Songs, u"  beatles "_s, &songs));
+  ASSERT_EQ(songs.count(), 1);
+  EXPECT_EQ(songs.first().title(), u"Help"_s);
+
+  EXPECT_FALSE(cache.Find(StreamingService::SearchType::Albums, u"beatles"_s, &songs));
+  EXPECT_FALSE(cache.Find(StreamingService::SearchType::Songs, u"beatle"_s, &songs));
+
+}
+
+TEST(StreamingSearchCacheTest, LeastRecentlyUsedIsDropped) {
+
+  StreamingSearchCache cache(2);
+  cache.Insert(StreamingService::SearchType::Songs, u"one"_s, MakeSongs(u"1"_s));
+  cache.Insert(StreamingService::SearchType::Songs, u"two"_s, MakeSongs(u"2"_s));
+
+  SongMap songs;
+  EXPECT_TRUE(cache.Find(StreamingService::SearchType::Songs, u"one"_s, &songs));
+
+  cache.Insert(StreamingService::SearchType::Songs, u"three"_s, MakeSongs(u"3"_s));
+  EXPECT_EQ(cache.count(), 2);
+  EXPECT_TRUE(cache.Find(StreamingService::SearchType::Songs, u"one"_s, &songs));
+  EXPECT_FALSE(cache.Find(StreamingService::SearchType::Songs, u"two"_s, &songs));
+  EXPECT_TRUE(cache.Find(StreamingService::SearchType::Songs, u"three"_s, &songs));
+
+}
+
+TEST(StreamingSearchCacheTest, FindsLongestPrefix) {
+
+  StreamingSearchCache cache;
+  cache.Insert(StreamingService::SearchType::Artists, u"be"_s, MakeSongs(u"be"_s));
+  cache.Insert(StreamingService::SearchType::Artists, u"beat"_s, MakeSongs(u"beat"_s));
+
+  QString prefix_query;
+  SongMap songs;
+  EXPECT_TRUE(cache.FindPrefix(StreamingService::SearchType::Artists, u"Beatles"_s, &prefix_query, &songs));
+  EXPECT_EQ(prefix_query, u"beat"_s);
+  EXPECT_EQ(songs.first().title(), u"beat"_s);
+
+  // The query itself is not a prefix.
+  EXPECT_TRUE(cache.FindPrefix(StreamingService::SearchType::Artists, u"beat"_s, &prefix_query, &songs));
+  EXPECT_EQ(prefix_query, u"be"_s);
+
+  EXPECT_FALSE(cache.FindPrefix(StreamingService::SearchType::Songs, u"beatles"_s, &prefix_query, &songs));
+  EXPECT_FALSE(cache.FindPrefix(StreamingService::SearchType::Artists, u"abba"_s, &prefix_query, &songs));
+
+}
+
+TEST(StreamingSearchCacheTest, ResultsExpire) {
+
+  StreamingSearchCache cache(StreamingSearchCache::kMaxQueries, 10);
+  cache.Insert(StreamingService::SearchType::Songs, u"beatles"_s, MakeSongs(u"Help"_s));
+
+  QThread::msleep(20);
+
+  SongMap songs;
+  EXPECT_FALSE(cache.Find(StreamingService::SearchType::Songs, u"beatles"_s, &songs));
+  EXPECT_EQ(cache.count(), 0);
+
+}
+
+}  // namespace
@@ -0,0 +1,181 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config.h"
+
+#include "gtest_include.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QUrl>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+
+#include "mock_networkaccessmanager.h"
+#include "tagreader/streamtagreader.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+// Serves byte ranges of a file like an HTTP server, counting the requests.
+class RangeNetworkAccessManager : public QNetworkAccessManager {
+ public:
+  explicit RangeNetworkAccessManager(const QByteArray &data, const bool ranges_supported = true) : data_(data), ranges_supported_(ranges_supported), requests_(0) {}
+
+  int requests() const { return requests_; }
+
+ protected:
+  QNetworkReply *createRequest(Operation op, const QNetworkRequest &network_request, QIODevice *outgoing_data) override {
+
+    Q_UNUSED(op)
+    Q_UNUSED(outgoing_data)
+
+    ++requests_;
+
+    MockNetworkReply *reply = nullptr;
+    const QByteArray range = network_request.rawHeader("Range");
+    if (ranges_supported_ && range.startsWith("bytes=")) {
+      const QList<QByteArray> range_parts = range.mid(6).split('-');
+      const qsizetype start = range_parts.value(0).toLongLong();
+      const qsizetype end = range_parts.value(1).toLongLong();
+      reply = new MockNetworkReply(data_.mid(start, end - start + 1), this);
+      reply->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 206);
+    }
+    else {
+      reply = new MockNetworkReply(data_, this);
+      reply->setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+    }
+
+    QTimer::singleShot(0, reply, [reply]() { reply->Done(); });
+
+    return reply;
+
+  }
+
+ private:
+  const QByteArray data_;
+  const bool ranges_supported_;
+  int requests_;
+};
+
+class StreamTagReaderTest : public ::testing::Test {
+ protected:
+  static QByteArray MakeData(const qsizetype size) {
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i) {
+      data[i] = static_cast<char>((i * 31 + i / 251) & 0xFF);
+    }
+    return data;
+  }
+
+  static QByteArray Read(StreamTagReader *stream, const qsizetype position, const qsizetype length) {
+    stream->seek(static_cast<TagLibOffsetType>(position), TagLib::IOStream::Beginning);
+    const TagLib::ByteVector bytes = stream->readBlock(static_cast<TagLibLengthType>(length));
+    return QByteArray(bytes.data(), static_cast<qsizetype>(bytes.size()));
+  }
+};
+
+TEST_F(StreamTagReaderTest, SmallFileIsReadInOneRequest) {
+
+  const QByteArray data = MakeData(50 * 1024);
+  RangeNetworkAccessManager network(data);
+  StreamTagReader stream(QUrl(u"https://example.com/file.mp3"_s), u"file.mp3"_s, static_cast<quint64>(data.size()), QString(), QString(), &network);
+
+  stream.PreCache();
+  EXPECT_EQ(network.requests(), 1);
+
+  EXPECT_EQ(Read(&stream, 0, 1024), data.mid(0, 1024));
+  EXPECT_EQ(Read(&stream, data.size() - 2048, 2048), data.right(2048));
+  EXPECT_EQ(network.requests(), 1);
+
+}
+
+TEST_F(StreamTagReaderTest, HeaderAndTrailerArePrefetched) {
+
+  const QByteArray data = MakeData(4 * 1024 * 1024);
+  RangeNetworkAccessManager network(data);
+  StreamTagReader stream(QUrl(u"https://example.com/file.mp3"_s), u"file.mp3"_s, static_cast<quint64>(data.size()), QString(), QString(), &network);
+
+  stream.PreCache();
+  EXPECT_EQ(network.requests(), 2);
+
+  // The typical reads for the tags of an MP3.
+  EXPECT_EQ(Read(&stream, 0, 1024), data.mid(0, 1024));
+  EXPECT_EQ(Read(&stream, 2048, 40000), data.mid(2048, 40000));
+  EXPECT_EQ(Read(&stream, data.size() - 2048, 2048), data.right(2048));
+  EXPECT_EQ(network.requests(), 2);
+
+}
+
+TEST_F(StreamTagReaderTest, SequentialReadsGrowReadAhead) {
+
+  const QByteArray data = MakeData(4 * 1024 * 1024);
+  RangeNetworkAccessManager network(data);
+  StreamTagReader stream(QUrl(u"https://example.com/file.m4a"_s), u"file.m4a"_s, static_cast<quint64>(data.size()), QString(), QString(), &network);
+
+  stream.PreCache();
+
+  // Read 1 MB after the prefix in 4 KB blocks.
+  stream.seek(64 * 1024, TagLib::IOStream::Beginning);
+  QByteArray read_data;
+  for (int i = 0; i < 256; ++i) {
+    const TagLib::ByteVector bytes = stream.readBlock(4096);
+    read_data.append(bytes.data(), static_cast<qsizetype>(bytes.size()));
+  }
+
+  EXPECT_EQ(read_data, data.mid(64 * 1024, 1024 * 1024));
+  EXPECT_LE(network.requests(), 2 + 4);
+
+}
+
+TEST_F(StreamTagReaderTest, HoleBeforeCachedBytesIsFilled) {
+
+  const QByteArray data = MakeData(4 * 1024 * 1024);
+  RangeNetworkAccessManager network(data);
+  StreamTagReader stream(QUrl(u"https://example.com/file.ogg"_s), u"file.ogg"_s, static_cast<quint64>(data.size()), QString(), QString(), &network);
+
+  stream.PreCache();
+  ASSERT_EQ(network.requests(), 2);
+
+  // A read a bit before the trailer is extended up to the trailer.
+  const qsizetype position = data.size() - 8 * 1024 - 20 * 1024;
+  EXPECT_EQ(Read(&stream, position, 1024), data.mid(position, 1024));
+  EXPECT_EQ(network.requests(), 3);
+
+  EXPECT_EQ(Read(&stream, position, data.size() - position), data.mid(position));
+  EXPECT_EQ(network.requests(), 3);
+
+}
+
+TEST_F(StreamTagReaderTest, ServerWithoutRanges) {
+
+  const QByteArray data = MakeData(200 * 1024);
+  RangeNetworkAccessManager network(data, false);
+  StreamTagReader stream(QUrl(u"https://example.com/file.flac"_s), u"file.flac"_s, static_cast<quint64>(data.size()), QString(), QString(), &network);
+
+  EXPECT_EQ(Read(&stream, 100 * 1024, 1024), data.mid(100 * 1024, 1024));
+  EXPECT_EQ(Read(&stream, 0, data.size()), data);
+  EXPECT_EQ(network.requests(), 1);
+
+}
+
+}  // namespace
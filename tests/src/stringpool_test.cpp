@@ -0,0 +1,98 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QString>
+
+#include "core/song.h"
+#include "core/stringpool.h"
+
+namespace {
+
+// Strings built at runtime, string literals are static data that the pool never prunes.
+QString MakeString(const char *str) {
+  return QString::fromUtf8(str);
+}
+
+TEST(StringPoolTest, InternSharesData) {
+
+  const QString a = StringPool::Intern(MakeString("Shared artist"));
+  const QString b = StringPool::Intern(MakeString("Shared artist"));
+  EXPECT_EQ(a, b);
+  EXPECT_EQ(a.constData(), b.constData());
+
+}
+
+TEST(StringPoolTest, EmptyAndLongStringsAreNotInterned) {
+
+  StringPool::Prune();
+  const qsizetype count = StringPool::Count();
+
+  EXPECT_TRUE(StringPool::Intern(QString()).isEmpty());
+  const QString long_string = MakeString("Long").repeated(100);
+  EXPECT_EQ(long_string, StringPool::Intern(long_string));
+  EXPECT_EQ(count, StringPool::Count());
+
+}
+
+TEST(StringPoolTest, PruneRemovesUnusedStrings) {
+
+  StringPool::Prune();
+  const qsizetype count = StringPool::Count();
+
+  const QString used = StringPool::Intern(MakeString("Used album"));
+  StringPool::Intern(MakeString("Unused album"));
+  EXPECT_EQ(count + 2, StringPool::Count());
+
+  EXPECT_EQ(1, StringPool::Prune());
+  EXPECT_EQ(count + 1, StringPool::Count());
+
+  // The string still in use stays in the pool.
+  EXPECT_EQ(used.constData(), StringPool::Intern(MakeString("Used album")).constData());
+
+}
+
+TEST(StringPoolTest, PoolIsPrunedWhenItGrows) {
+
+  StringPool::Prune();
+
+  for (int i = 0; i < 10000; ++i) {
+    StringPool::Intern(QString::number(i));
+  }
+
+  // None of the strings were kept, so the pool never grows far past the minimum size before it's pruned.
+  EXPECT_LE(StringPool::Count(), 2048);
+
+}
+
+TEST(StringPoolTest, SongSettersDontIntern) {
+
+  StringPool::Prune();
+  const qsizetype count = StringPool::Count();
+
+  Song song;
+  song.set_artist(MakeString("Streaming artist"));
+  song.set_album(MakeString("Streaming album"));
+  song.set_genre(MakeString("Streaming genre"));
+  EXPECT_EQ(count, StringPool::Count());
+
+}
+
+}  // namespace
@@ -0,0 +1,120 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QString>
+#include <QSet>
+#include <QThread>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "core/tracing.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace {
+
+void TracedFunction() {
+  TRACE_SCOPE("test", "Traced function");
+  QThread::msleep(2);
+}
+
+QJsonArray TraceEvents() {
+  return QJsonDocument::fromJson(tracing::ExportChromeTrace()).object().value("traceEvents"_L1).toArray();
+}
+
+TEST(TracingTest, DisabledRecordsNothing) {
+
+  tracing::Start();
+  tracing::Stop();
+
+  TracedFunction();
+
+  EXPECT_EQ(tracing::EventCount(), 0);
+
+}
+
+TEST(TracingTest, RecordsCompleteEvents) {
+
+  tracing::Start();
+  TracedFunction();
+  TracedFunction();
+  tracing::Stop();
+
+  EXPECT_EQ(tracing::EventCount(), 2);
+
+  int complete_events = 0;
+  const QJsonArray trace_events = TraceEvents();
+  for (const QJsonValue &value : trace_events) {
+    const QJsonObject trace_event = value.toObject();
+    if (trace_event.value("ph"_L1).toString() != "X"_L1) continue;
+    ++complete_events;
+    EXPECT_EQ(trace_event.value("name"_L1).toString(), u"Traced function"_s);
+    EXPECT_EQ(trace_event.value("cat"_L1).toString(), u"test"_s);
+    EXPECT_GE(trace_event.value("dur"_L1).toInteger(), 1000);
+  }
+  EXPECT_EQ(complete_events, 2);
+
+}
+
+TEST(TracingTest, RecordsEveryThread) {
+
+  tracing::Start();
+  TracedFunction();
+  QThread *thread = QThread::create(&TracedFunction);
+  thread->setObjectName(u"Traced thread"_s);
+  thread->start();
+  thread->wait();
+  delete thread;
+  tracing::Stop();
+
+  QSet<qint64> thread_ids;
+  QSet<QString> thread_names;
+  const QJsonArray trace_events = TraceEvents();
+  for (const QJsonValue &value : trace_events) {
+    const QJsonObject trace_event = value.toObject();
+    if (trace_event.value("ph"_L1).toString() == "X"_L1) {
+      thread_ids.insert(trace_event.value("tid"_L1).toInteger());
+    }
+    else if (trace_event.value("ph"_L1).toString() == "M"_L1) {
+      thread_names.insert(trace_event.value("args"_L1).toObject().value("name"_L1).toString());
+    }
+  }
+
+  EXPECT_EQ(thread_ids.count(), 2);
+  EXPECT_TRUE(thread_names.contains(u"Traced thread"_s));
+
+}
+
+TEST(TracingTest, StartClearsEvents) {
+
+  tracing::Start();
+  TracedFunction();
+  tracing::Stop();
+  ASSERT_EQ(tracing::EventCount(), 1);
+
+  tracing::Start();
+  EXPECT_EQ(tracing::EventCount(), 0);
+  tracing::Stop();
+
+}
+
+}  // namespace
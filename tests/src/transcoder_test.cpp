@@ -0,0 +1,163 @@
+/*
+ * Strawberry Music Player
+ * Copyright 2026, Strawberry contributors
+ *
+ * Strawberry is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Strawberry is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Strawberry.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gtest_include.h"
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QIODevice>
+#include <QTemporaryDir>
+
+#include "core/song.h"
+#include "transcoder/transcoder.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+// clazy:excludeall=non-pod-global-static,returning-void-expression
+
+// Declared at file scope so that Transcoder's "friend class TranscoderTest;" resolves to this class.
+class TranscoderTest : public ::testing::Test {
+ protected:
+  TranscoderTest() : transcoder_(nullptr, u"_test"_s) {}
+
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    transcoder_.set_max_threads(4);
+    transcoder_.threads_limit_ = 2;
+  }
+
+  void AddJob(const QString &filename, const qint64 size, const TranscoderPreset &preset) {
+    const QString input = temp_dir_.filePath(filename);
+    QFile file(input);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(size, file.write(QByteArray(size, '\0')));
+    file.close();
+    transcoder_.AddJob(input, preset, input + u".out"_s);
+  }
+
+  QStringList QueuedJobs() const {
+    QStringList filenames;
+    for (const Transcoder::Job &job : transcoder_.queued_jobs_) {
+      filenames << QFileInfo(job.input).fileName();
+    }
+    return filenames;
+  }
+
+  void SortQueuedJobs() { transcoder_.SortQueuedJobs(); }
+  void SetRealtimeFactor(const TranscoderPreset &preset, const double realtime_factor) { transcoder_.realtime_factors_[preset.name_] = realtime_factor; }
+
+  // Takes a throughput sample and applies the new threads limit, like AdjustThreadsLimit() does.
+  int Sample(const double bytes_per_second, const double cpu_usage, const int running_jobs, const bool jobs_queued = true) {
+    transcoder_.threads_limit_ = transcoder_.NextThreadsLimit(bytes_per_second, cpu_usage, running_jobs, jobs_queued);
+    return transcoder_.threads_limit();
+  }
+
+  QTemporaryDir temp_dir_;
+  Transcoder transcoder_;
+};
+
+namespace {
+
+TEST_F(TranscoderTest, LargestJobsStartFirst) {
+
+  const TranscoderPreset preset = Transcoder::PresetForFileType(Song::FileType::OggOpus);
+  AddJob(u"small.flac"_s, 10, preset);
+  AddJob(u"large.flac"_s, 1000, preset);
+  AddJob(u"medium.flac"_s, 100, preset);
+
+  SortQueuedJobs();
+
+  EXPECT_EQ(QStringList() << u"large.flac"_s << u"medium.flac"_s << u"small.flac"_s, QueuedJobs());
+
+}
+
+TEST_F(TranscoderTest, SlowPresetsStartFirst) {
+
+  const TranscoderPreset opus = Transcoder::PresetForFileType(Song::FileType::OggOpus);
+  const TranscoderPreset wav = Transcoder::PresetForFileType(Song::FileType::WAV);
+  AddJob(u"copy.wav"_s, 1000, wav);
+  AddJob(u"encode.flac"_s, 200, opus);
+
+  // Writing WAV is 100 times faster than encoding Opus, so the smaller Opus job takes longer.
+  SetRealtimeFactor(wav, 1000.0);
+  SetRealtimeFactor(opus, 10.0);
+  SortQueuedJobs();
+
+  EXPECT_EQ(QStringList() << u"encode.flac"_s << u"copy.wav"_s, QueuedJobs());
+
+}
+
+TEST_F(TranscoderTest, UnknownPresetUsesAverageSpeed) {
+
+  const TranscoderPreset opus = Transcoder::PresetForFileType(Song::FileType::OggOpus);
+  const TranscoderPreset vorbis = Transcoder::PresetForFileType(Song::FileType::OggVorbis);
+  AddJob(u"vorbis.flac"_s, 150, vorbis);
+  AddJob(u"opus.flac"_s, 200, opus);
+
+  // A finished Opus job alone doesn't make the jobs of other presets look faster or slower.
+  SetRealtimeFactor(opus, 50.0);
+  SortQueuedJobs();
+
+  EXPECT_EQ(QStringList() << u"opus.flac"_s << u"vorbis.flac"_s, QueuedJobs());
+
+}
+
+TEST_F(TranscoderTest, ThreadsIncreaseWhileAllBusy) {
+
+  EXPECT_EQ(3, Sample(100.0, 0.5, 2));
+  EXPECT_EQ(4, Sample(200.0, 0.5, 3));
+  // Never more than max_threads().
+  EXPECT_EQ(4, Sample(300.0, 0.5, 4));
+
+}
+
+TEST_F(TranscoderTest, ThreadsDontIncreaseWhenIdleOrDone) {
+
+  EXPECT_EQ(2, Sample(100.0, 0.5, 1));
+  EXPECT_EQ(2, Sample(100.0, 0.5, 2, false));
+
+}
+
+TEST_F(TranscoderTest, ThreadsDecreaseWhenCpuSaturated) {
+
+  EXPECT_EQ(1, Sample(100.0, 0.95, 2));
+  // Never less than one.
+  EXPECT_EQ(1, Sample(100.0, 0.95, 1));
+
+}
+
+TEST_F(TranscoderTest, ExtraThreadWithoutGainIsReverted) {
+
+  EXPECT_EQ(3, Sample(100.0, 0.5, 2));
+
+  // The third thread only made it 2% faster, so the disk is the bottleneck.
+  EXPECT_EQ(2, Sample(102.0, 0.5, 3));
+
+  // It waits a few samples before trying another thread.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(2, Sample(100.0, 0.5, 2));
+  }
+  EXPECT_EQ(3, Sample(100.0, 0.5, 2));
+
+}
+
+}  // namespace